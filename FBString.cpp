@@ -1,4 +1,10 @@
 #include "FBString.h"
+#include "FBStringConv.h"
+#include "FBStringSimd.h"
+#include <climits>
+#include <cmath>
+#include <cstdio>
+#include <functional>
 
 // 默认构造函数
 FBString::FBString() : core_() {}
@@ -6,6 +12,12 @@ FBString::FBString() : core_() {}
 // 使用 C 风格字符串构造
 FBString::FBString(const char* str) : core_(str, std::strlen(str)) {}
 
+// 使用指定长度的字符序列构造
+FBString::FBString(const char* str, size_t size) : core_(str, size) {}
+
+// 拷贝视图引用的内容
+FBString::FBString(FBStringView str) : core_(str.data(), str.size()) {}
+
 // 拷贝构造函数
 FBString::FBString(const FBString& other) : core_(other.core_) {}
 
@@ -17,6 +29,20 @@ FBString& FBString::operator=(const FBString& other) {
     return *this;
 }
 
+// 移动构造函数
+FBString::FBString(FBString&& other) noexcept : core_(std::move(other.core_)) {}
+
+// 移动赋值运算符
+FBString& FBString::operator=(FBString&& other) noexcept {
+    core_ = std::move(other.core_);
+    return *this;
+}
+
+// 交换两个字符串的内容
+void FBString::swap(FBString& other) noexcept {
+    core_.swap(other.core_);
+}
+
 // 析构函数
 FBString::~FBString() {}
 
@@ -30,6 +56,11 @@ size_t FBString::size() const {
     return core_.size();
 }
 
+// 判断内容是否保存在对象内部
+bool FBString::is_inline() const {
+    return core_.is_inline();
+}
+
 // 清空字符串
 void FBString::clear() {
     core_.clear();
@@ -45,11 +76,41 @@ void FBString::resize(size_t newSize) {
     core_.resize(newSize);
 }
 
+// 在末尾扩展 delta 个未初始化的字符
+char* FBString::expand_noinit(size_t delta) {
+    return core_.expand_noinit(delta);
+}
+
 // 追加字符串
 void FBString::append(const char* str) {
     core_.append(str, std::strlen(str));
 }
 
+// 追加 FBString 对象
+void FBString::append(const FBString& str) {
+    core_.append(str.core_);
+}
+
+// 追加即将销毁的 FBString 对象
+void FBString::append(FBString&& str) {
+    if (core_.empty()) {
+        core_ = std::move(str.core_);
+    } else {
+        core_.append(str.core_);
+    }
+}
+
+// 追加运算符
+FBString& FBString::operator+=(const FBString& str) {
+    append(str);
+    return *this;
+}
+
+FBString& FBString::operator+=(const char* str) {
+    append(str);
+    return *this;
+}
+
 // 插入字符串
 void FBString::insert(size_t pos, const char* str) {
     core_.insert(pos, str, std::strlen(str));
@@ -65,6 +126,122 @@ size_t FBString::find(const char* str, size_t pos) const {
     return core_.find(str, pos);
 }
 
+// 原地去掉两端的字符
+FBString& FBString::trim() {
+    return keep(FBStringView(*this).trim());
+}
+
+FBString& FBString::trim(const FBByteSet& chars) {
+    return keep(FBStringView(*this).trim(chars));
+}
+
+// 原地去掉开头的字符
+FBString& FBString::ltrim() {
+    return keep(FBStringView(*this).ltrim());
+}
+
+FBString& FBString::ltrim(const FBByteSet& chars) {
+    return keep(FBStringView(*this).ltrim(chars));
+}
+
+// 原地去掉末尾的字符
+FBString& FBString::rtrim() {
+    return keep(FBStringView(*this).rtrim());
+}
+
+FBString& FBString::rtrim(const FBByteSet& chars) {
+    return keep(FBStringView(*this).rtrim(chars));
+}
+
+// 原地把 ASCII 字母转换为大写
+FBString& FBString::to_upper() {
+    return toggleCase('a', 'z');
+}
+
+// 原地把 ASCII 字母转换为小写
+FBString& FBString::to_lower() {
+    return toggleCase('A', 'Z');
+}
+
+// 返回转换为大写后的副本
+FBString FBString::to_upper_copy() const {
+    return toggleCaseCopy('a', 'z');
+}
+
+// 返回转换为小写后的副本
+FBString FBString::to_lower_copy() const {
+    return toggleCaseCopy('A', 'Z');
+}
+
+// 原地翻转 [lo, hi] 范围内字母的大小写
+FBString& FBString::toggleCase(char lo, char hi) {
+    const char* first = core_.data();
+    const char* last = first + core_.size();
+    const char* p = FBStringSimd::findInRange(first, last, lo, hi);
+    if (p == last) return *this;
+    if (core_.is_shared()) {
+        // 先解除共享再转换要遍历两遍，直接生成转换后的副本只需一遍
+        *this = toggleCaseCopy(lo, hi);
+        return *this;
+    }
+    const size_t offset = p - first;
+    char* data = core_.mutable_data();
+    FBStringSimd::toggleCaseInRange(data + offset, data + offset, core_.size() - offset, lo, hi);
+    return *this;
+}
+
+// 返回翻转 [lo, hi] 范围内字母大小写后的副本
+FBString FBString::toggleCaseCopy(char lo, char hi) const {
+    const char* first = core_.data();
+    const char* last = first + core_.size();
+    const char* p = FBStringSimd::findInRange(first, last, lo, hi);
+    if (p == last) return *this;
+    const size_t offset = p - first;
+    FBString result;
+    result.resize_and_overwrite(core_.size(), [&](char* out, size_t n) -> size_t {
+        std::memcpy(out, first, offset);
+        FBStringSimd::toggleCaseInRange(out + offset, p, n - offset, lo, hi);
+        return n;
+    });
+    return result;
+}
+
+// 原地保留视图 kept 对应的部分
+FBString& FBString::keep(FBStringView kept) {
+    if (kept.size() != core_.size()) {
+        core_.substr_inplace(kept.data() - core_.data(), kept.size());
+    }
+    return *this;
+}
+
+// 惰性切分字符串
+FBSplitRange FBString::split(char delimiter) const {
+    return FBSplitRange(*this, delimiter);
+}
+
+FBSplitRange FBString::split(FBStringView delimiter) const {
+    return FBSplitRange(*this, delimiter);
+}
+
+FBSplitRange FBString::split(const FBByteSet& delimiters) const {
+    return FBSplitRange(*this, delimiters);
+}
+
+// 校验内容是否为合法的 UTF-8
+bool FBString::validate_utf8() const {
+    return core_.validate_encoding();
+}
+
+// 统计 UTF-8 码点个数
+size_t FBString::count_code_points() const {
+    return core_.count_code_points();
+}
+
+// 计算散列值
+size_t FBString::hash() const {
+    return core_.hash();
+}
+
 // 比较运算符
 bool FBString::operator==(const FBString& other) const {
     return core_ == other.core_;
@@ -95,6 +272,52 @@ std::ostream& operator<<(std::ostream& os, const FBString& str) {
     return os << str.c_str();
 }
 
+// 拼接运算符
+FBString operator+(const FBString& lhs, const FBString& rhs) {
+    FBString result;
+    result.reserve(lhs.size() + rhs.size());
+    result.core_.append(lhs.core_);
+    result.core_.append(rhs.core_);
+    return result;
+}
+
+FBString operator+(FBString&& lhs, const FBString& rhs) {
+    lhs.core_.append(rhs.core_);
+    return std::move(lhs);
+}
+
+FBString operator+(const FBString& lhs, FBString&& rhs) {
+    if (rhs.core_.capacity() >= lhs.size() + rhs.size()) {
+        // 右操作数的容量足够，直接在其头部插入
+        rhs.core_.insert(0, lhs.c_str(), lhs.size());
+        return std::move(rhs);
+    }
+    return lhs + static_cast<const FBString&>(rhs);
+}
+
+FBString operator+(FBString&& lhs, FBString&& rhs) {
+    return std::move(lhs) + static_cast<const FBString&>(rhs);
+}
+
+FBString operator+(const FBString& lhs, const char* rhs) {
+    size_t n = std::strlen(rhs);
+    FBString result;
+    result.reserve(lhs.size() + n);
+    result.core_.append(lhs.core_);
+    result.core_.append(rhs, n);
+    return result;
+}
+
+FBString operator+(FBString&& lhs, const char* rhs) {
+    lhs.core_.append(rhs);
+    return std::move(lhs);
+}
+
+// 交换两个字符串的内容
+void swap(FBString& a, FBString& b) noexcept {
+    a.swap(b);
+}
+
 // 与 std::string 互相转换
 FBString::FBString(const std::string& str) : core_(str.c_str(), str.size()) {}
 
@@ -106,3 +329,376 @@ FBString& FBString::operator=(const std::string& str) {
 FBString::operator std::string() const {
     return std::string(core_.c_str(), core_.size());
 }
+
+// 转换为字符串视图
+FBString::operator FBStringView() const {
+    return FBStringView(core_.data(), core_.size());
+}
+
+// 取得字符串片段
+FBString::Piece FBString::toPiece(const FBString& str) {
+    Piece piece = {str.c_str(), str.size()};
+    return piece;
+}
+
+FBString::Piece FBString::toPiece(FBStringView str) {
+    Piece piece = {str.data(), str.size()};
+    return piece;
+}
+
+FBString::Piece FBString::toPiece(const std::string& str) {
+    Piece piece = {str.data(), str.size()};
+    return piece;
+}
+
+FBString::Piece FBString::toPiece(const char* str) {
+    Piece piece = {str, std::strlen(str)};
+    return piece;
+}
+
+// 解析占位符：p 指向 '{' 之后的位置，返回 '}' 之后的位置
+static const char* parsePlaceholder(const char* p, size_t& nextArg, size_t numArgs, size_t& index, FBFormatArg::Spec& spec) {
+    spec.zeroPad = false;
+    spec.width = 0;
+    spec.precision = -1;
+    spec.type = 0;
+
+    // 参数索引：省略时按顺序取下一个参数
+    if (*p >= '0' && *p <= '9') {
+        index = 0;
+        while (*p >= '0' && *p <= '9') {
+            index = index * 10 + (*p++ - '0');
+            // 超出参数个数时立即报错，不会继续累加而溢出
+            if (index >= numArgs) {
+                throw std::invalid_argument("FBString::format: argument index out of range");
+            }
+        }
+    } else {
+        index = nextArg++;
+    }
+    if (index >= numArgs) {
+        throw std::invalid_argument("FBString::format: argument index out of range");
+    }
+
+    if (*p == ':') {
+        ++p;
+        if (*p == '0') {
+            spec.zeroPad = true;
+            ++p;
+        }
+        while (*p >= '0' && *p <= '9') {
+            spec.width = spec.width * 10 + (*p++ - '0');
+            if (spec.width > INT_MAX) {
+                throw std::invalid_argument("FBString::format: width/precision too large");
+            }
+        }
+        if (*p == '.') {
+            ++p;
+            if (*p < '0' || *p > '9') {
+                throw std::invalid_argument("FBString::format: missing precision");
+            }
+            spec.precision = 0;
+            while (*p >= '0' && *p <= '9') {
+                // 先检查再乘，避免有符号溢出
+                if (spec.precision > (INT_MAX - (*p - '0')) / 10) {
+                    throw std::invalid_argument("FBString::format: width/precision too large");
+                }
+                spec.precision = spec.precision * 10 + (*p++ - '0');
+            }
+        }
+        if (*p != '}' && *p != '\0') {
+            spec.type = *p++;
+        }
+    }
+    if (*p != '}') {
+        throw std::invalid_argument("FBString::format: invalid placeholder");
+    }
+    return p + 1;
+}
+
+// 按已校验的格式串写入结果，返回写入的字符数
+static size_t writeFormatted(char* out, const char* fmt, const FBFormatArg* args, size_t numArgs) {
+    char* begin = out;
+    size_t nextArg = 0;
+    for (const char* p = fmt; *p;) {
+        size_t run = std::strcspn(p, "{}");
+        std::memcpy(out, p, run);
+        out += run;
+        p += run;
+        if (*p == '\0') break;
+        if (p[0] == p[1]) {
+            *out++ = *p;
+            p += 2;
+        } else {
+            size_t index;
+            FBFormatArg::Spec spec;
+            p = parsePlaceholder(p + 1, nextArg, numArgs, index, spec);
+            out += args[index].write(out, spec);
+        }
+    }
+    return static_cast<size_t>(out - begin);
+}
+
+// 按格式串追加已擦除类型的参数
+void FBString::formatImpl(const char* fmt, const FBFormatArg* args, size_t numArgs) {
+    // 第一遍：校验格式串并估算输出长度上界，出错时字符串保持不变
+    size_t estimate = 0;
+    size_t nextArg = 0;
+    for (const char* p = fmt; *p;) {
+        size_t run = std::strcspn(p, "{}");
+        estimate += run;
+        p += run;
+        if (*p == '\0') break;
+        if (p[0] == p[1]) {
+            ++estimate;
+            p += 2;
+        } else if (*p == '}') {
+            throw std::invalid_argument("FBString::format: unmatched '}'");
+        } else {
+            size_t index;
+            FBFormatArg::Spec spec;
+            p = parsePlaceholder(p + 1, nextArg, numArgs, index, spec);
+            estimate += args[index].estimateSize(spec);
+        }
+    }
+
+    // 第二遍：一次性扩容后直接写入存储
+    size_t oldSize = core_.size();
+    const char* oldData = core_.c_str();
+    for (size_t i = 0; i < numArgs; ++i) {
+        if (args[i].refersTo(oldData, oldSize)) {
+            // 参数指向自身时扩容会使其失效（小型存储的字节也会被改写为指针和大小），
+            // 因此写入新的缓冲区，当前内容保持不动，写完后再交换
+            FBString result;
+            char* begin = result.core_.expand_noinit(oldSize + estimate, true);
+            std::memcpy(begin, oldData, oldSize);
+            size_t written = writeFormatted(begin + oldSize, fmt, args, numArgs);
+            result.core_.resize(oldSize + written);
+            swap(result);
+            return;
+        }
+    }
+    char* begin = core_.expand_noinit(estimate, true);
+    size_t written = writeFormatted(begin, fmt, args, numArgs);
+    core_.resize(oldSize + written);
+}
+
+// 构造格式化参数
+FBFormatArg::FBFormatArg() : kind_(Kind::None) {
+    value_.int_ = 0;
+}
+
+FBFormatArg::FBFormatArg(bool value) : kind_(Kind::Bool) {
+    value_.bool_ = value;
+}
+
+FBFormatArg::FBFormatArg(char value) : kind_(Kind::Char) {
+    value_.char_ = value;
+}
+
+FBFormatArg::FBFormatArg(int value) : kind_(Kind::Int) {
+    value_.int_ = value;
+}
+
+FBFormatArg::FBFormatArg(long value) : kind_(Kind::Int) {
+    value_.int_ = value;
+}
+
+FBFormatArg::FBFormatArg(long long value) : kind_(Kind::Int) {
+    value_.int_ = value;
+}
+
+FBFormatArg::FBFormatArg(unsigned value) : kind_(Kind::UInt) {
+    value_.uint_ = value;
+}
+
+FBFormatArg::FBFormatArg(unsigned long value) : kind_(Kind::UInt) {
+    value_.uint_ = value;
+}
+
+FBFormatArg::FBFormatArg(unsigned long long value) : kind_(Kind::UInt) {
+    value_.uint_ = value;
+}
+
+FBFormatArg::FBFormatArg(float value) : kind_(Kind::Float) {
+    value_.double_ = value;
+}
+
+FBFormatArg::FBFormatArg(double value) : kind_(Kind::Double) {
+    value_.double_ = value;
+}
+
+FBFormatArg::FBFormatArg(const char* value) : kind_(Kind::String) {
+    value_.string_.data = value;
+    value_.string_.size = std::strlen(value);
+}
+
+FBFormatArg::FBFormatArg(const std::string& value) : kind_(Kind::String) {
+    value_.string_.data = value.data();
+    value_.string_.size = value.size();
+}
+
+FBFormatArg::FBFormatArg(const FBString& value) : kind_(Kind::String) {
+    value_.string_.data = value.c_str();
+    value_.string_.size = value.size();
+}
+
+FBFormatArg::FBFormatArg(FBStringView value) : kind_(Kind::String) {
+    value_.string_.data = value.data();
+    value_.string_.size = value.size();
+}
+
+// 判断字符串参数是否指向给定区域
+bool FBFormatArg::refersTo(const char* data, size_t size) const {
+    return kind_ == Kind::String
+        && std::less_equal<const char*>()(data, value_.string_.data)
+        && std::less<const char*>()(value_.string_.data, data + size);
+}
+
+// 估算格式化结果长度的上界
+size_t FBFormatArg::estimateSize(const Spec& spec) const {
+    size_t size = 0;
+    switch (kind_) {
+        case Kind::Bool:
+            if (spec.type != 0 && spec.type != 's') break;
+            size = 5;
+            return std::max(size, spec.width);
+        case Kind::Char:
+            if (spec.type != 0 && spec.type != 'c') break;
+            return std::max<size_t>(1, spec.width);
+        case Kind::Int:
+        case Kind::UInt:
+            if (spec.type != 0 && spec.type != 'd' && spec.type != 'x' && spec.type != 'X') break;
+            // 64 位整数最多 20 位十进制数字，另加符号
+            return std::max<size_t>(21, spec.width);
+        case Kind::Float:
+        case Kind::Double: {
+            int precision = spec.precision < 0 ? 6 : spec.precision;
+            if (spec.type == 0 && spec.precision < 0) {
+                // 最短往返表示最多 24 个字符
+                return std::max<size_t>(24, spec.width);
+            } else if (spec.type == 'f') {
+                // 整数部分位数由二进制指数估算：log10(2) < 0.30103
+                int exponent = 0;
+                std::frexp(value_.double_, &exponent);
+                size = (exponent > 0 ? static_cast<size_t>(exponent) * 30103 / 100000 : 0) + 2;
+            } else if (spec.type == 'e' || spec.type == 'g') {
+                size = 8;
+            } else if (spec.type == 0) {
+                precision = spec.precision < 0 ? 17 : spec.precision;
+                size = 8;
+            } else {
+                break;
+            }
+            size += static_cast<size_t>(precision) + 2;
+            return std::max(size, spec.width);
+        }
+        case Kind::String:
+            if (spec.type != 0 && spec.type != 's') break;
+            size = value_.string_.size;
+            if (spec.precision >= 0) {
+                size = std::min(size, static_cast<size_t>(spec.precision));
+            }
+            return std::max(size, spec.width);
+        case Kind::None:
+            break;
+    }
+    throw std::invalid_argument("FBString::format: invalid format spec for argument");
+}
+
+// 写入格式化结果
+size_t FBFormatArg::write(char* out, const Spec& spec) const {
+    switch (kind_) {
+        case Kind::Bool:
+            return value_.bool_ ? writeText(out, "true", 4, spec) : writeText(out, "false", 5, spec);
+        case Kind::Char:
+            return writeText(out, &value_.char_, 1, spec);
+        case Kind::Int:
+        case Kind::UInt:
+            return writeInteger(out, spec);
+        case Kind::Float:
+        case Kind::Double: {
+            if (spec.type == 0 && spec.precision < 0) {
+                return writeShortest(out, spec);
+            }
+            // 指定了精度或类型时由 snprintf 直接写入目标存储，估算时已预留结尾 null 字符的位置
+            char conversion[8] = "%";
+            char* c = conversion + 1;
+            if (spec.zeroPad) *c++ = '0';
+            *c++ = '*';
+            *c++ = '.';
+            *c++ = '*';
+            *c++ = spec.type == 0 ? 'g' : spec.type;
+            *c = '\0';
+            int precision = spec.precision >= 0 ? spec.precision : (spec.type == 0 ? 17 : 6);
+            int written = std::snprintf(out, estimateSize(spec) + 1, conversion, static_cast<int>(spec.width), precision, value_.double_);
+            return written > 0 ? static_cast<size_t>(written) : 0;
+        }
+        case Kind::String: {
+            size_t size = value_.string_.size;
+            if (spec.precision >= 0) {
+                size = std::min(size, static_cast<size_t>(spec.precision));
+            }
+            return writeText(out, value_.string_.data, size, spec);
+        }
+        case Kind::None:
+            break;
+    }
+    return 0;
+}
+
+// 写入整数（含符号、进制和填充）
+size_t FBFormatArg::writeInteger(char* out, const Spec& spec) const {
+    bool negative = kind_ == Kind::Int && value_.int_ < 0;
+    unsigned long long magnitude = kind_ == Kind::UInt ? value_.uint_
+        : negative ? 0ULL - static_cast<unsigned long long>(value_.int_) : static_cast<unsigned long long>(value_.int_);
+    bool hex = spec.type == 'x' || spec.type == 'X';
+
+    size_t digits = hex ? FBStringConv::digits16(magnitude) : FBStringConv::digits10(magnitude);
+    size_t length = digits + (negative ? 1 : 0);
+    size_t padding = spec.width > length ? spec.width - length : 0;
+
+    char* p = out;
+    if (!spec.zeroPad) {
+        std::memset(p, ' ', padding);
+        p += padding;
+    }
+    if (negative) *p++ = '-';
+    if (spec.zeroPad) {
+        std::memset(p, '0', padding);
+        p += padding;
+    }
+    if (hex) {
+        FBStringConv::writeHex(p, magnitude, digits, spec.type == 'X');
+    } else {
+        FBStringConv::writeDecimal(p, magnitude, digits);
+    }
+    return length + padding;
+}
+
+// 写入浮点数的最短往返表示（含填充）
+size_t FBFormatArg::writeShortest(char* out, const Spec& spec) const {
+    const FBStringConv::FloatDecimal decimal = kind_ == Kind::Float
+        ? FBStringConv::toDecimal(static_cast<float>(value_.double_))
+        : FBStringConv::toDecimal(value_.double_);
+    size_t length = FBStringConv::floatLength(decimal, FBFloatFormat::General);
+    size_t padding = spec.width > length ? spec.width - length : 0;
+    bool finite = !decimal.nan && !decimal.infinity;
+
+    FBStringConv::writeFloat(out + padding, decimal, FBFloatFormat::General);
+    std::memset(out, spec.zeroPad && finite ? '0' : ' ', padding);
+    if (spec.zeroPad && finite && decimal.negative && padding > 0) {
+        // 0 填充在符号之后
+        out[0] = '-';
+        out[padding] = '0';
+    }
+    return length + padding;
+}
+
+// 写入文本（左对齐并用空格填充）
+size_t FBFormatArg::writeText(char* out, const char* data, size_t size, const Spec& spec) {
+    std::memcpy(out, data, size);
+    size_t padding = spec.width > size ? spec.width - size : 0;
+    std::memset(out + size, ' ', padding);
+    return size + padding;
+}
@@ -2,8 +2,13 @@
 #define FBSTRING_H
 
 #include "FBStringCore.h"
+#include "FBStringView.h"
+#include "FBStringSplit.h"
 #include <ostream>
 #include <string>
+#include <iterator>
+
+class FBFormatArg;
 
 // FBString 类用于封装 FBStringCore 并提供更高级的字符串操作接口
 class FBString {
@@ -20,6 +25,19 @@ public:
      */
     FBString(const char* str);
 
+    /**
+     * 使用指定长度的字符序列构造
+     * @param str 字符序列起始位置，可以包含 null 字符
+     * @param size 字符个数
+     */
+    FBString(const char* str, size_t size);
+
+    /**
+     * 拷贝视图引用的内容
+     * @param str 字符串视图
+     */
+    explicit FBString(FBStringView str);
+
     /**
      * 拷贝构造函数
      * @param other 要复制的 FBString 对象
@@ -33,6 +51,26 @@ public:
      */
     FBString& operator=(const FBString& other);
 
+    /**
+     * 移动构造函数
+     * 直接接管 other 的存储，不触发引用计数操作。
+     * @param other 要移动的 FBString 对象
+     */
+    FBString(FBString&& other) noexcept;
+
+    /**
+     * 移动赋值运算符
+     * @param other 要移动的 FBString 对象
+     * @return 当前对象的引用
+     */
+    FBString& operator=(FBString&& other) noexcept;
+
+    /**
+     * 交换两个字符串的内容
+     * @param other 要交换的 FBString 对象
+     */
+    void swap(FBString& other) noexcept;
+
     /**
      * 析构函数
      * 释放所有分配的资源。
@@ -51,6 +89,13 @@ public:
      */
     size_t size() const;
 
+    /**
+     * 判断内容是否保存在对象内部（小型存储）
+     * 为 true 时从 c_str() 起至少 24 个字节可读（64 位平台上 32 个）；用 (data, size) 构造的不超过 22 字节（64 位平台上 30 字节）的字符串总是保存在对象内部。
+     * @return 保存在对象内部时返回 true
+     */
+    bool is_inline() const;
+
     /**
      * 清空字符串
      * 将字符串重置为空。
@@ -69,12 +114,48 @@ public:
      */
     void resize(size_t newSize);
 
+    /**
+     * 调整字符串大小，并由 op 直接写入存储
+     * @param n 可写入的最大长度
+     * @param op 写入操作，签名为 size_t op(char* p, size_t n)，返回最终长度
+     */
+    template <typename Operation>
+    void resize_and_overwrite(size_t n, Operation op);
+
+    /**
+     * 在末尾扩展 delta 个未初始化的字符
+     * @param delta 要扩展的字符数
+     * @return 指向新增区域起始位置的指针，调用方必须写满该区域
+     */
+    char* expand_noinit(size_t delta);
+
     /**
      * 追加字符串
      * @param str 要追加的字符串
      */
     void append(const char* str);
 
+    /**
+     * 追加 FBString 对象
+     * @param str 要追加的字符串
+     */
+    void append(const FBString& str);
+
+    /**
+     * 追加即将销毁的 FBString 对象
+     * 当前字符串为空时直接接管 str 的存储。
+     * @param str 要追加的字符串
+     */
+    void append(FBString&& str);
+
+    /**
+     * 追加运算符
+     * @param str 要追加的字符串
+     * @return 当前对象的引用
+     */
+    FBString& operator+=(const FBString& str);
+    FBString& operator+=(const char* str);
+
     /**
      * 插入字符串
      * @param pos 插入位置
@@ -97,6 +178,69 @@ public:
      */
     size_t find(const char* str, size_t pos = 0) const;
 
+    /**
+     * 原地去掉两端、开头或末尾的字符
+     * 独占存储时只调整大小（去掉开头时移动剩余部分），不分配内存；共享存储时只复制剩余部分。
+     * 只需要结果的视图时，用 FBStringView(str).trim() 可以避免修改字符串。
+     * @param chars 要去掉的字节集合，省略时为 ASCII 空白字符
+     * @return 当前对象的引用
+     */
+    FBString& trim();
+    FBString& trim(const FBByteSet& chars);
+    FBString& ltrim();
+    FBString& ltrim(const FBByteSet& chars);
+    FBString& rtrim();
+    FBString& rtrim(const FBByteSet& chars);
+
+    /**
+     * 原地把 ASCII 字母转换为大写或小写
+     * 先用 SIMD 查找第一个需要转换的字符：没有时不解除共享也不写入；
+     * 存储被共享时一次性生成转换后的副本，独占时直接在原存储上转换。非 ASCII 字节保持不变。
+     * @return 当前对象的引用
+     */
+    FBString& to_upper();
+    FBString& to_lower();
+
+    /**
+     * 返回 ASCII 字母转换为大写或小写后的副本
+     * 没有需要转换的字符时返回共享存储的副本，否则一次性写入结果的存储。
+     * @return 转换后的字符串
+     */
+    FBString to_upper_copy() const;
+    FBString to_lower_copy() const;
+
+    /**
+     * 惰性切分字符串
+     * 字段是指向当前存储的视图，迭代期间字符串不能被修改或销毁。
+     * @param delimiter 单字符分隔符、分隔子串或分隔字节集合
+     * @return 产出字段视图的范围
+     * @throws invalid_argument 如果分隔子串为空
+     */
+    FBSplitRange split(char delimiter) const;
+    FBSplitRange split(FBStringView delimiter) const;
+    FBSplitRange split(const FBByteSet& delimiters) const;
+
+    /**
+     * 校验内容是否为合法的 UTF-8
+     * 大型字符串的结果会被缓存，共享存储的副本和未修改时的重复调用不再扫描。
+     * @return 合法返回 true
+     */
+    bool validate_utf8() const;
+
+    /**
+     * 统计 UTF-8 码点个数
+     * 不做校验，需要时先调用 validate_utf8()。
+     * @return 码点个数
+     */
+    size_t count_code_points() const;
+
+    /**
+     * 计算散列值，与内容相同的 FBStringView 的散列值一致
+     * 大型字符串的结果会被缓存，共享存储的副本和未修改时的重复调用不再扫描。
+     * @return 散列值
+     */
+    size_t hash() const;
+
     /**
      * 比较运算符
      * @param other 要比较的 FBString 对象
@@ -117,6 +261,20 @@ public:
      */
     friend std::ostream& operator<<(std::ostream& os, const FBString& str);
 
+    /**
+     * 拼接运算符
+     * 左值拼接时一次性预留结果所需的空间；右值操作数的存储会被复用。
+     * @param lhs 左操作数
+     * @param rhs 右操作数
+     * @return 拼接后的字符串
+     */
+    friend FBString operator+(const FBString& lhs, const FBString& rhs);
+    friend FBString operator+(FBString&& lhs, const FBString& rhs);
+    friend FBString operator+(const FBString& lhs, FBString&& rhs);
+    friend FBString operator+(FBString&& lhs, FBString&& rhs);
+    friend FBString operator+(const FBString& lhs, const char* rhs);
+    friend FBString operator+(FBString&& lhs, const char* rhs);
+
     /**
      * 与 std::string 互相转换
      * @param str std::string 对象
@@ -125,8 +283,312 @@ public:
     FBString& operator=(const std::string& str);
     operator std::string() const;
 
+    /**
+     * 转换为字符串视图
+     * 视图引用当前存储，在字符串被修改或销毁后失效。
+     * @return 引用全部内容的视图
+     */
+    operator FBStringView() const;
+
+    /**
+     * 用分隔符连接范围内的字符串
+     * 先累加总长度，再按最终长度一次性分配（结果足够短时留在小型存储中），最后逐段 memcpy。
+     * 元素可以是 FBString、FBStringView、std::string 或 C 风格字符串；范围需支持多次遍历。
+     * @param range 要连接的字符串范围
+     * @param sep 分隔符
+     * @return 连接后的字符串
+     */
+    template <typename Range>
+    static FBString join(const Range& range, const char* sep);
+
+    template <typename Range>
+    static FBString join(const Range& range, const FBString& sep);
+
+    /**
+     * 用分隔符连接范围内元素投影出的字符串
+     * proj 会对每个元素调用两次（计算长度和拷贝各一次），应当开销很小，例如返回成员的引用。
+     * @param range 要连接的元素范围
+     * @param sep 分隔符
+     * @param proj 投影函数，返回 FBString、FBStringView、std::string 或 C 风格字符串
+     * @return 连接后的字符串
+     */
+    template <typename Range, typename Projection>
+    static FBString join(const Range& range, const char* sep, Projection proj);
+
+    /**
+     * 格式化字符串
+     * 占位符语法为 {[索引][:[0][宽度][.精度][类型]]}，{{ 和 }} 表示字面的花括号。
+     * 先估算输出长度上界并一次性扩容，再把各参数直接写入存储，不经过中间缓冲区。
+     * 参数类型在编译期检查，支持整数、浮点数、bool、char、C 风格字符串、std::string、FBString 和 FBStringView。
+     * @param fmt 格式串
+     * @param args 格式化参数
+     * @return 格式化后的字符串
+     * @throws invalid_argument 如果格式串不合法、与参数类型不匹配，或宽度、精度超过 INT_MAX
+     */
+    template <typename... Args>
+    static FBString format(const char* fmt, const Args&... args);
+
+    /**
+     * 追加格式化结果
+     * 参数可以引用当前字符串本身，此时写入新的缓冲区后再替换当前内容。
+     * @param fmt 格式串
+     * @param args 格式化参数
+     * @throws invalid_argument 如果格式串不合法、与参数类型不匹配，或宽度、精度超过 INT_MAX，此时字符串保持不变
+     */
+    template <typename... Args>
+    void append_format(const char* fmt, const Args&... args);
+
 private:
+    /** 连接时使用的字符串片段 */
+    struct Piece {
+        const char* data;
+        size_t size;
+    };
+
+    /** 恒等投影 */
+    struct Identity {
+        template <typename T>
+        const T& operator()(const T& value) const { return value; }
+    };
+
+    /** 取得字符串片段 */
+    static Piece toPiece(const FBString& str);
+    static Piece toPiece(FBStringView str);
+    static Piece toPiece(const std::string& str);
+    static Piece toPiece(const char* str);
+
+    /** 连接迭代器范围内投影出的字符串 */
+    template <typename Iterator, typename Projection>
+    static FBString joinImpl(Iterator first, Iterator last, Piece sep, Projection proj);
+
+    /** 原地翻转 [lo, hi] 范围内字母的大小写 */
+    FBString& toggleCase(char lo, char hi);
+
+    /** 返回翻转 [lo, hi] 范围内字母大小写后的副本 */
+    FBString toggleCaseCopy(char lo, char hi) const;
+
+    /** 原地保留视图 kept 对应的部分，kept 必须引用当前存储 */
+    FBString& keep(FBStringView kept);
+
+    /** 按格式串追加已擦除类型的参数 */
+    void formatImpl(const char* fmt, const FBFormatArg* args, size_t numArgs);
+
     FBStringCore core_; /**< 核心存储对象 */
 };
 
+/**
+ * 格式化参数
+ * 把受支持的参数类型擦除为统一表示，供 FBString::format 使用；
+ * 不受支持的类型无法构造 FBFormatArg，因此在编译期报错。
+ * 字符串类参数只保存指针，FBFormatArg 不能比被引用的参数活得更久。
+ */
+class FBFormatArg {
+public:
+    /** 占位符中的格式说明 */
+    struct Spec {
+        bool zeroPad;   /**< 数值是否用 0 填充到指定宽度 */
+        size_t width;   /**< 最小宽度 */
+        int precision;  /**< 精度，-1 表示未指定 */
+        char type;      /**< 类型字符，0 表示默认格式 */
+    };
+
+    FBFormatArg();
+    FBFormatArg(bool value);
+    FBFormatArg(char value);
+    FBFormatArg(int value);
+    FBFormatArg(long value);
+    FBFormatArg(long long value);
+    FBFormatArg(unsigned value);
+    FBFormatArg(unsigned long value);
+    FBFormatArg(unsigned long long value);
+    FBFormatArg(float value);
+    FBFormatArg(double value);
+    FBFormatArg(const char* value);
+    FBFormatArg(const std::string& value);
+    FBFormatArg(const FBString& value);
+    FBFormatArg(FBStringView value);
+
+    /**
+     * 估算格式化结果长度的上界
+     * @param spec 格式说明
+     * @return 输出长度上界
+     * @throws invalid_argument 如果格式说明不适用于该参数
+     */
+    size_t estimateSize(const Spec& spec) const;
+
+    /**
+     * 写入格式化结果
+     * @param out 输出位置，至少有 estimateSize(spec) + 1 个字节可写
+     * @param spec 格式说明
+     * @return 实际写入的字符数
+     */
+    size_t write(char* out, const Spec& spec) const;
+
+    /**
+     * 判断字符串参数是否指向给定区域
+     * @param data 区域起始位置
+     * @param size 区域长度
+     * @return 是字符串参数且起始位置在 [data, data + size) 内时返回 true
+     */
+    bool refersTo(const char* data, size_t size) const;
+
+private:
+    /** 参数类别 */
+    enum class Kind {
+        None,
+        Bool,
+        Char,
+        Int,
+        UInt,
+        Float,
+        Double,
+        String
+    };
+
+    /** 字符串参数 */
+    struct StringRef {
+        const char* data;
+        size_t size;
+    };
+
+    /** 写入整数（含符号、进制和填充） */
+    size_t writeInteger(char* out, const Spec& spec) const;
+
+    /** 写入浮点数的最短往返表示（含填充） */
+    size_t writeShortest(char* out, const Spec& spec) const;
+
+    /** 写入文本（左对齐并用空格填充） */
+    static size_t writeText(char* out, const char* data, size_t size, const Spec& spec);
+
+    Kind kind_; /**< 参数类别 */
+    union {
+        bool bool_;
+        char char_;
+        long long int_;
+        unsigned long long uint_;
+        double double_;
+        StringRef string_;
+    } value_; /**< 参数值 */
+};
+
+/**
+ * 交换两个字符串的内容
+ * @param a 第一个字符串
+ * @param b 第二个字符串
+ */
+void swap(FBString& a, FBString& b) noexcept;
+
+// 调整字符串大小，并由 op 直接写入存储
+template <typename Operation>
+void FBString::resize_and_overwrite(size_t n, Operation op) {
+    core_.resize_and_overwrite(n, op);
+}
+
+// 格式化字符串
+template <typename... Args>
+FBString FBString::format(const char* fmt, const Args&... args) {
+    FBString result;
+    result.append_format(fmt, args...);
+    return result;
+}
+
+// 追加格式化结果
+template <typename... Args>
+void FBString::append_format(const char* fmt, const Args&... args) {
+    // 末尾多放一个空参数，避免无参数时出现零长度数组
+    const FBFormatArg argArray[] = {FBFormatArg(args)..., FBFormatArg()};
+    formatImpl(fmt, argArray, sizeof...(Args));
+}
+
+// 用分隔符连接范围内的字符串
+template <typename Range>
+FBString FBString::join(const Range& range, const char* sep) {
+    return joinImpl(std::begin(range), std::end(range), toPiece(sep), Identity());
+}
+
+template <typename Range>
+FBString FBString::join(const Range& range, const FBString& sep) {
+    return joinImpl(std::begin(range), std::end(range), toPiece(sep), Identity());
+}
+
+// 用分隔符连接范围内元素投影出的字符串
+template <typename Range, typename Projection>
+FBString FBString::join(const Range& range, const char* sep, Projection proj) {
+    return joinImpl(std::begin(range), std::end(range), toPiece(sep), proj);
+}
+
+// 连接迭代器范围内投影出的字符串
+template <typename Iterator, typename Projection>
+FBString FBString::joinImpl(Iterator first, Iterator last, Piece sep, Projection proj) {
+    // 第一遍：累加最终长度
+    size_t total = 0;
+    size_t count = 0;
+    for (Iterator it = first; it != last; ++it, ++count) {
+        total += toPiece(proj(*it)).size;
+    }
+    if (count > 1) {
+        total += sep.size * (count - 1);
+    }
+
+    // 第二遍：一次性分配后逐段拷贝
+    FBString result;
+    result.resize_and_overwrite(total, [&](char* p, size_t) -> size_t {
+        for (Iterator it = first; it != last; ++it) {
+            if (it != first) {
+                std::memcpy(p, sep.data, sep.size);
+                p += sep.size;
+            }
+            const auto& value = proj(*it); // 投影结果可能是临时对象，需延长其生命周期
+            Piece piece = toPiece(value);
+            std::memcpy(p, piece.data, piece.size);
+            p += piece.size;
+        }
+        return total;
+    });
+    return result;
+}
+
+namespace std {
+// 使 FBString 可以直接作为无序容器的键
+template <>
+struct hash<FBString> {
+    size_t operator()(const FBString& str) const {
+        return str.hash();
+    }
+};
+} // namespace std
+
+// 在 C++20 的 std::format 中直接格式化 FBString
+#if __cplusplus >= 202002L && defined(__has_include)
+#if __has_include(<format>)
+#include <format>
+#include <string_view>
+#ifdef __cpp_lib_format
+namespace std {
+template <>
+struct formatter<FBString, char> : formatter<string_view, char> {
+    template <typename FormatContext>
+    auto format(const FBString& str, FormatContext& ctx) const {
+        return formatter<string_view, char>::format(string_view(str.c_str(), str.size()), ctx);
+    }
+};
+} // namespace std
+#endif
+#endif
+#endif
+
+// 定义 USE_FMT 时，在 fmt 库中直接格式化 FBString
+#ifdef USE_FMT
+#include <fmt/format.h>
+namespace fmt {
+template <>
+struct formatter<FBString> : formatter<string_view> {
+    template <typename FormatContext>
+    auto format(const FBString& str, FormatContext& ctx) const -> decltype(ctx.out()) {
+        return formatter<string_view>::format(string_view(str.c_str(), str.size()), ctx);
+    }
+};
+} // namespace fmt
+#endif
+
 #endif // FBSTRING_H
@@ -0,0 +1,411 @@
+#include "FBStringCodec.h"
+#include "FBStringSimd.h"
+#include <functional>
+
+#if defined(FBSTRING_HAS_AVX2)
+#include <immintrin.h>
+#elif defined(FBSTRING_HAS_SSSE3)
+#include <tmmintrin.h>
+#endif
+
+static const char kBase64Standard[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+static const char kBase64UrlSafe[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+static const char kHexLower[] = "0123456789abcdef";
+static const char kHexUpper[] = "0123456789ABCDEF";
+static const unsigned char kInvalid = 0xFF;
+
+// 标量解码用的字符 → 数值表，非法字符对应 kInvalid
+struct FBCodecDecodeTables {
+    unsigned char base64[2][256];
+    unsigned char hex[256];
+
+    FBCodecDecodeTables() {
+        for (int c = 0; c < 256; ++c) {
+            base64[0][c] = base64[1][c] = hex[c] = kInvalid;
+        }
+        for (int i = 0; i < 64; ++i) {
+            base64[0][static_cast<unsigned char>(kBase64Standard[i])] = static_cast<unsigned char>(i);
+            base64[1][static_cast<unsigned char>(kBase64UrlSafe[i])] = static_cast<unsigned char>(i);
+        }
+        for (int i = 0; i < 16; ++i) {
+            hex[static_cast<unsigned char>(kHexLower[i])] = static_cast<unsigned char>(i);
+            hex[static_cast<unsigned char>(kHexUpper[i])] = static_cast<unsigned char>(i);
+        }
+    }
+};
+
+// 解码表只在第一次使用时构造
+static const FBCodecDecodeTables& decodeTables() {
+    static const FBCodecDecodeTables tables;
+    return tables;
+}
+
+#if defined(FBSTRING_HAS_SSSE3)
+// base64 编码查表：6 位值按区间（A-Z、a-z、0-9、两个符号）映射到一个索引，再由该表给出要加上的偏移
+static inline __m128i base64ShiftTable(FBBase64Alphabet alphabet) {
+    const char c62 = alphabet == FBBase64Alphabet::UrlSafe ? '-' : '+';
+    const char c63 = alphabet == FBBase64Alphabet::UrlSafe ? '_' : '/';
+    return _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                         '0' - 52, '0' - 52, '0' - 52, static_cast<char>(c62 - 62), static_cast<char>(c63 - 63), 'A', 0, 0);
+}
+
+// 把 16 字节中前 12 个字节编码为 16 个 base64 字符
+static inline __m128i base64EncodeBlock(__m128i in, __m128i shiftTable) {
+    // 每 3 个字节 b0 b1 b2 重排成 b1 b0 b2 b1，使 4 个 6 位组可以用 16 位乘法移到各自的字节里
+    in = _mm_shuffle_epi8(in, _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));
+    const __m128i t0 = _mm_mulhi_epu16(_mm_and_si128(in, _mm_set1_epi32(0x0FC0FC00)), _mm_set1_epi32(0x04000040));
+    const __m128i t1 = _mm_mullo_epi16(_mm_and_si128(in, _mm_set1_epi32(0x003F03F0)), _mm_set1_epi32(0x01000010));
+    const __m128i indices = _mm_or_si128(t0, t1);
+    // 52 ~ 63 → 1 ~ 12，小于 26 → 13，26 ~ 51 → 0
+    __m128i range = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+    range = _mm_or_si128(range, _mm_and_si128(_mm_cmpgt_epi8(_mm_set1_epi8(26), indices), _mm_set1_epi8(13)));
+    return _mm_add_epi8(indices, _mm_shuffle_epi8(shiftTable, range));
+}
+
+// 校验并转换 16 个 base64 字符，再拼接为 12 个字节（写在结果的前 12 字节）
+static inline bool base64DecodeBlock(__m128i in, bool urlSafe, __m128i& out) {
+    if (urlSafe) {
+        // 拒绝 '+' 和 '/'，再把 '-'、'_' 换成它们，之后与标准字母表走同一套查表
+        const __m128i other = _mm_or_si128(_mm_cmpeq_epi8(in, _mm_set1_epi8('+')), _mm_cmpeq_epi8(in, _mm_set1_epi8('/')));
+        if (_mm_movemask_epi8(other) != 0) return false;
+        in = _mm_xor_si128(in, _mm_and_si128(_mm_cmpeq_epi8(in, _mm_set1_epi8('-')), _mm_set1_epi8('-' ^ '+')));
+        in = _mm_xor_si128(in, _mm_and_si128(_mm_cmpeq_epi8(in, _mm_set1_epi8('_')), _mm_set1_epi8('_' ^ '/')));
+    }
+    // 高低半字节各查一张表，两者有交集说明字符不在字母表里
+    const __m128i lowTable = _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                                           0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+    const __m128i highTable = _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+                                            0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+    const __m128i rollTable = _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m128i mask2F = _mm_set1_epi8(0x2F);
+    const __m128i highNibbles = _mm_and_si128(_mm_srli_epi32(in, 4), mask2F);
+    const __m128i lowNibbles = _mm_and_si128(in, mask2F);
+    const __m128i hits = _mm_and_si128(_mm_shuffle_epi8(lowTable, lowNibbles), _mm_shuffle_epi8(highTable, highNibbles));
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(hits, _mm_setzero_si128())) != 0xFFFF) return false;
+    // 按高半字节（'/' 单独处理）加上偏移得到 6 位值
+    const __m128i roll = _mm_shuffle_epi8(rollTable, _mm_add_epi8(_mm_cmpeq_epi8(in, mask2F), highNibbles));
+    in = _mm_add_epi8(in, roll);
+    // 相邻两个 6 位值拼成 12 位，再两两拼成 24 位，最后去掉每 4 字节中的空字节并恢复大端顺序
+    const __m128i merged = _mm_madd_epi16(_mm_maddubs_epi16(in, _mm_set1_epi32(0x01400140)), _mm_set1_epi32(0x00011000));
+    out = _mm_shuffle_epi8(merged, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+    return true;
+}
+
+// 把 16 个十六进制字符转换为 16 个 4 位值
+static inline bool hexDecodeNibbles(__m128i in, __m128i& values) {
+    const __m128i digit = _mm_sub_epi8(in, _mm_set1_epi8('0'));
+    const __m128i alpha = _mm_sub_epi8(_mm_or_si128(in, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+    const __m128i isDigit = _mm_cmpeq_epi8(_mm_min_epu8(digit, _mm_set1_epi8(9)), digit);
+    const __m128i isAlpha = _mm_cmpeq_epi8(_mm_min_epu8(alpha, _mm_set1_epi8(5)), alpha);
+    if (_mm_movemask_epi8(_mm_or_si128(isDigit, isAlpha)) != 0xFFFF) return false;
+    values = _mm_or_si128(_mm_and_si128(isDigit, digit), _mm_andnot_si128(isDigit, _mm_add_epi8(alpha, _mm_set1_epi8(10))));
+    return true;
+}
+#endif
+
+#if defined(FBSTRING_HAS_AVX2)
+// 把两个 128 位通道中各自前 12 个字节编码为 32 个 base64 字符
+static inline __m256i base64EncodeBlock(__m256i in, __m256i shiftTable) {
+    in = _mm256_shuffle_epi8(in, _mm256_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10,
+                                                  1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));
+    const __m256i t0 = _mm256_mulhi_epu16(_mm256_and_si256(in, _mm256_set1_epi32(0x0FC0FC00)), _mm256_set1_epi32(0x04000040));
+    const __m256i t1 = _mm256_mullo_epi16(_mm256_and_si256(in, _mm256_set1_epi32(0x003F03F0)), _mm256_set1_epi32(0x01000010));
+    const __m256i indices = _mm256_or_si256(t0, t1);
+    __m256i range = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+    range = _mm256_or_si256(range, _mm256_and_si256(_mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices), _mm256_set1_epi8(13)));
+    return _mm256_add_epi8(indices, _mm256_shuffle_epi8(shiftTable, range));
+}
+
+// 校验并转换 32 个 base64 字符，拼接为 24 个字节（写在结果的前 24 字节）
+static inline bool base64DecodeBlock(__m256i in, bool urlSafe, __m256i& out) {
+    if (urlSafe) {
+        const __m256i other = _mm256_or_si256(_mm256_cmpeq_epi8(in, _mm256_set1_epi8('+')), _mm256_cmpeq_epi8(in, _mm256_set1_epi8('/')));
+        if (_mm256_movemask_epi8(other) != 0) return false;
+        in = _mm256_xor_si256(in, _mm256_and_si256(_mm256_cmpeq_epi8(in, _mm256_set1_epi8('-')), _mm256_set1_epi8('-' ^ '+')));
+        in = _mm256_xor_si256(in, _mm256_and_si256(_mm256_cmpeq_epi8(in, _mm256_set1_epi8('_')), _mm256_set1_epi8('_' ^ '/')));
+    }
+    const __m256i lowTable = _mm256_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A,
+                                              0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+    const __m256i highTable = _mm256_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+                                               0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+    const __m256i rollTable = _mm256_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0,
+                                               0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m256i mask2F = _mm256_set1_epi8(0x2F);
+    const __m256i highNibbles = _mm256_and_si256(_mm256_srli_epi32(in, 4), mask2F);
+    const __m256i lowNibbles = _mm256_and_si256(in, mask2F);
+    const __m256i hits = _mm256_and_si256(_mm256_shuffle_epi8(lowTable, lowNibbles), _mm256_shuffle_epi8(highTable, highNibbles));
+    if (!_mm256_testz_si256(hits, hits)) return false;
+    const __m256i roll = _mm256_shuffle_epi8(rollTable, _mm256_add_epi8(_mm256_cmpeq_epi8(in, mask2F), highNibbles));
+    in = _mm256_add_epi8(in, roll);
+    const __m256i merged = _mm256_madd_epi16(_mm256_maddubs_epi16(in, _mm256_set1_epi32(0x01400140)), _mm256_set1_epi32(0x00011000));
+    out = _mm256_shuffle_epi8(merged, _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+                                                       2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+    // 两个通道各 12 个字节，合并到前 24 字节
+    out = _mm256_permutevar8x32_epi32(out, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7));
+    return true;
+}
+
+// 把 32 个十六进制字符转换为 32 个 4 位值
+static inline bool hexDecodeNibbles(__m256i in, __m256i& values) {
+    const __m256i digit = _mm256_sub_epi8(in, _mm256_set1_epi8('0'));
+    const __m256i alpha = _mm256_sub_epi8(_mm256_or_si256(in, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a'));
+    const __m256i isDigit = _mm256_cmpeq_epi8(_mm256_min_epu8(digit, _mm256_set1_epi8(9)), digit);
+    const __m256i isAlpha = _mm256_cmpeq_epi8(_mm256_min_epu8(alpha, _mm256_set1_epi8(5)), alpha);
+    if (_mm256_movemask_epi8(_mm256_or_si256(isDigit, isAlpha)) != -1) return false;
+    values = _mm256_blendv_epi8(_mm256_add_epi8(alpha, _mm256_set1_epi8(10)), digit, isDigit);
+    return true;
+}
+#endif
+
+// 计算 base64 编码后的长度
+size_t FBStringCodec::base64EncodedLength(size_t n, FBBase64Alphabet alphabet) {
+    if (alphabet == FBBase64Alphabet::Standard) return (n + 2) / 3 * 4;
+    return n / 3 * 4 + (n % 3 == 0 ? 0 : n % 3 + 1);
+}
+
+// 计算 base64 解码后的长度
+bool FBStringCodec::base64DecodedLength(const char* text, size_t n, size_t& length) {
+    size_t padding = 0;
+    while (padding < 2 && padding < n && text[n - 1 - padding] == '=') ++padding;
+    if (padding > 0 && n % 4 != 0) return false;
+    const size_t m = n - padding;
+    if (m % 4 == 1) return false;
+    length = m / 4 * 3 + (m % 4 == 0 ? 0 : m % 4 - 1);
+    return true;
+}
+
+// base64 编码
+void FBStringCodec::base64Encode(char* out, const char* data, size_t n, FBBase64Alphabet alphabet) {
+    const char* chars = alphabet == FBBase64Alphabet::UrlSafe ? kBase64UrlSafe : kBase64Standard;
+    const unsigned char* in = reinterpret_cast<const unsigned char*>(data);
+    size_t i = 0;
+#if defined(FBSTRING_HAS_AVX2)
+    const __m128i shiftTable128 = base64ShiftTable(alphabet);
+    const __m256i shiftTable = _mm256_broadcastsi128_si256(shiftTable128);
+    // 两个通道分别读取 [i, i + 16) 和 [i + 12, i + 28)，各用前 12 个字节
+    for (; i + 28 <= n; i += 24, out += 32) {
+        const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        const __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i + 12));
+        const __m256i block = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), base64EncodeBlock(block, shiftTable));
+    }
+#elif defined(FBSTRING_HAS_SSSE3)
+    const __m128i shiftTable128 = base64ShiftTable(alphabet);
+#endif
+#if defined(FBSTRING_HAS_SSSE3)
+    for (; i + 16 <= n; i += 12, out += 16) {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), base64EncodeBlock(block, shiftTable128));
+    }
+#endif
+    for (; i + 3 <= n; i += 3, out += 4) {
+        const uint32_t v = (static_cast<uint32_t>(in[i]) << 16) | (static_cast<uint32_t>(in[i + 1]) << 8) | in[i + 2];
+        out[0] = chars[v >> 18];
+        out[1] = chars[(v >> 12) & 0x3F];
+        out[2] = chars[(v >> 6) & 0x3F];
+        out[3] = chars[v & 0x3F];
+    }
+    const size_t rest = n - i;
+    if (rest == 0) return;
+    const uint32_t v = (static_cast<uint32_t>(in[i]) << 16) | (rest == 2 ? static_cast<uint32_t>(in[i + 1]) << 8 : 0);
+    *out++ = chars[v >> 18];
+    *out++ = chars[(v >> 12) & 0x3F];
+    if (rest == 2) *out++ = chars[(v >> 6) & 0x3F];
+    if (alphabet == FBBase64Alphabet::Standard) {
+        *out++ = '=';
+        if (rest == 1) *out = '=';
+    }
+}
+
+// base64 解码
+bool FBStringCodec::base64Decode(char* out, const char* text, size_t n, FBBase64Alphabet alphabet) {
+    const bool urlSafe = alphabet == FBBase64Alphabet::UrlSafe;
+    for (size_t padding = 0; padding < 2 && n > 0 && text[n - 1] == '='; ++padding) --n;
+    const unsigned char* in = reinterpret_cast<const unsigned char*>(text);
+    size_t i = 0;
+    // SIMD 路径每块会多写 4 或 8 个字节，剩余输入足够长时这些字节仍落在输出范围内
+#if defined(FBSTRING_HAS_AVX2)
+    for (; i + 48 <= n; i += 32, out += 24) {
+        __m256i block;
+        if (!base64DecodeBlock(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i)), urlSafe, block)) return false;
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), block);
+    }
+#endif
+#if defined(FBSTRING_HAS_SSSE3)
+    for (; i + 24 <= n; i += 16, out += 12) {
+        __m128i block;
+        if (!base64DecodeBlock(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i)), urlSafe, block)) return false;
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), block);
+    }
+#endif
+    const unsigned char* table = decodeTables().base64[urlSafe ? 1 : 0];
+    for (; i + 4 <= n; i += 4, out += 3) {
+        const unsigned a = table[in[i]], b = table[in[i + 1]], c = table[in[i + 2]], d = table[in[i + 3]];
+        if (((a | b | c | d) & 0xC0) != 0) return false;
+        const uint32_t v = (a << 18) | (b << 12) | (c << 6) | d;
+        out[0] = static_cast<char>(v >> 16);
+        out[1] = static_cast<char>(v >> 8);
+        out[2] = static_cast<char>(v);
+    }
+    const size_t rest = n - i;
+    if (rest == 0) return true;
+    if (rest == 1) return false;
+    const unsigned a = table[in[i]], b = table[in[i + 1]], c = rest == 3 ? table[in[i + 2]] : 0;
+    if (((a | b | c) & 0xC0) != 0) return false;
+    const uint32_t v = (a << 18) | (b << 12) | (c << 6);
+    out[0] = static_cast<char>(v >> 16);
+    if (rest == 3) out[1] = static_cast<char>(v >> 8);
+    return true;
+}
+
+// 十六进制编码
+void FBStringCodec::hexEncode(char* out, const char* data, size_t n, bool uppercase) {
+    const char* digits = uppercase ? kHexUpper : kHexLower;
+    const unsigned char* in = reinterpret_cast<const unsigned char*>(data);
+    size_t i = 0;
+#if defined(FBSTRING_HAS_SSSE3)
+    const __m128i table = _mm_loadu_si128(reinterpret_cast<const __m128i*>(digits));
+    const __m128i lowMask = _mm_set1_epi8(0x0F);
+#endif
+#if defined(FBSTRING_HAS_AVX2)
+    const __m256i table256 = _mm256_broadcastsi128_si256(table);
+    const __m256i lowMask256 = _mm256_set1_epi8(0x0F);
+    for (; i + 32 <= n; i += 32, out += 64) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+        const __m256i hi = _mm256_shuffle_epi8(table256, _mm256_and_si256(_mm256_srli_epi16(v, 4), lowMask256));
+        const __m256i lo = _mm256_shuffle_epi8(table256, _mm256_and_si256(v, lowMask256));
+        // unpack 在通道内交错，结果是 [0, 8) [16, 24) 和 [8, 16) [24, 32)，再按通道重组
+        const __m256i first = _mm256_unpacklo_epi8(hi, lo);
+        const __m256i second = _mm256_unpackhi_epi8(hi, lo);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), _mm256_permute2x128_si256(first, second, 0x20));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 32), _mm256_permute2x128_si256(first, second, 0x31));
+    }
+#endif
+#if defined(FBSTRING_HAS_SSSE3)
+    for (; i + 16 <= n; i += 16, out += 32) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        const __m128i hi = _mm_shuffle_epi8(table, _mm_and_si128(_mm_srli_epi16(v, 4), lowMask));
+        const __m128i lo = _mm_shuffle_epi8(table, _mm_and_si128(v, lowMask));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_unpacklo_epi8(hi, lo));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16), _mm_unpackhi_epi8(hi, lo));
+    }
+#endif
+    for (; i < n; ++i, out += 2) {
+        out[0] = digits[in[i] >> 4];
+        out[1] = digits[in[i] & 0x0F];
+    }
+}
+
+// 十六进制解码
+bool FBStringCodec::hexDecode(char* out, const char* text, size_t n) {
+    const unsigned char* in = reinterpret_cast<const unsigned char*>(text);
+    size_t i = 0;
+#if defined(FBSTRING_HAS_AVX2)
+    const __m256i weights256 = _mm256_set1_epi16(0x0110);
+    for (; i + 64 <= n; i += 64, out += 32) {
+        __m256i first, second;
+        if (!hexDecodeNibbles(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i)), first) ||
+            !hexDecodeNibbles(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i + 32)), second)) {
+            return false;
+        }
+        // 相邻两个 4 位值按 16 * 高 + 低 拼成字节，packus 在通道内交错，再恢复顺序
+        const __m256i bytes = _mm256_packus_epi16(_mm256_maddubs_epi16(first, weights256), _mm256_maddubs_epi16(second, weights256));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), _mm256_permute4x64_epi64(bytes, 0xD8));
+    }
+#endif
+#if defined(FBSTRING_HAS_SSSE3)
+    const __m128i weights = _mm_set1_epi16(0x0110);
+    for (; i + 32 <= n; i += 32, out += 16) {
+        __m128i first, second;
+        if (!hexDecodeNibbles(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i)), first) ||
+            !hexDecodeNibbles(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i + 16)), second)) {
+            return false;
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_packus_epi16(_mm_maddubs_epi16(first, weights), _mm_maddubs_epi16(second, weights)));
+    }
+#endif
+    const unsigned char* table = decodeTables().hex;
+    for (; i + 2 <= n; i += 2) {
+        const unsigned hi = table[in[i]], lo = table[in[i + 1]];
+        if (((hi | lo) & 0xF0) != 0) return false;
+        *out++ = static_cast<char>((hi << 4) | lo);
+    }
+    return i == n;
+}
+
+// 扩展 out 的存储；data 可能指向 out 自身，扩容后需按偏移量重新定位
+static char* expandFor(FBString& out, size_t delta, const char*& data, size_t n) {
+    const char* oldData = out.c_str();
+    const bool aliased = std::less_equal<const char*>()(oldData, data) && std::less<const char*>()(data, oldData + out.size()) && n > 0;
+    const size_t offset = aliased ? static_cast<size_t>(data - oldData) : 0;
+    char* p = out.expand_noinit(delta);
+    if (aliased) data = out.c_str() + offset;
+    return p;
+}
+
+// base64 编码并追加
+void append_base64(FBString& out, FBStringView data, FBBase64Alphabet alphabet) {
+    const char* in = data.data();
+    char* p = expandFor(out, FBStringCodec::base64EncodedLength(data.size(), alphabet), in, data.size());
+    FBStringCodec::base64Encode(p, in, data.size(), alphabet);
+}
+
+// base64 解码并追加
+void append_from_base64(FBString& out, FBStringView text, FBBase64Alphabet alphabet) {
+    size_t length;
+    if (!FBStringCodec::base64DecodedLength(text.data(), text.size(), length)) throw std::invalid_argument("Invalid base64");
+    const size_t oldSize = out.size();
+    const char* in = text.data();
+    char* p = expandFor(out, length, in, text.size());
+    if (!FBStringCodec::base64Decode(p, in, text.size(), alphabet)) {
+        out.resize(oldSize);
+        throw std::invalid_argument("Invalid base64");
+    }
+}
+
+// 十六进制编码并追加
+void append_hex(FBString& out, FBStringView data, bool uppercase) {
+    const char* in = data.data();
+    char* p = expandFor(out, data.size() * 2, in, data.size());
+    FBStringCodec::hexEncode(p, in, data.size(), uppercase);
+}
+
+// 十六进制解码并追加
+void append_from_hex(FBString& out, FBStringView text) {
+    if (text.size() % 2 != 0) throw std::invalid_argument("Invalid hex");
+    const size_t oldSize = out.size();
+    const char* in = text.data();
+    char* p = expandFor(out, text.size() / 2, in, text.size());
+    if (!FBStringCodec::hexDecode(p, in, text.size())) {
+        out.resize(oldSize);
+        throw std::invalid_argument("Invalid hex");
+    }
+}
+
+// base64 编码
+FBString to_base64(FBStringView data, FBBase64Alphabet alphabet) {
+    FBString result;
+    append_base64(result, data, alphabet);
+    return result;
+}
+
+// base64 解码
+FBString from_base64(FBStringView text, FBBase64Alphabet alphabet) {
+    FBString result;
+    append_from_base64(result, text, alphabet);
+    return result;
+}
+
+// 十六进制编码
+FBString to_hex(FBStringView data, bool uppercase) {
+    FBString result;
+    append_hex(result, data, uppercase);
+    return result;
+}
+
+// 十六进制解码
+FBString from_hex(FBStringView text) {
+    FBString result;
+    append_from_hex(result, text);
+    return result;
+}
@@ -0,0 +1,142 @@
+#ifndef FBSTRING_CODEC_H
+#define FBSTRING_CODEC_H
+
+#include "FBString.h"
+#include "FBStringView.h"
+#include <stdexcept>
+
+// base64 使用的字母表
+enum class FBBase64Alphabet {
+    Standard, /**< RFC 4648 第 4 节：A-Z a-z 0-9 + /，编码时补 '=' */
+    UrlSafe   /**< RFC 4648 第 5 节：A-Z a-z 0-9 - _，编码时不补 '=' */
+};
+
+// FBStringCodec 提供 base64 与十六进制的编解码内核：先算出结果的精确长度，再由内核直接写入目标存储
+class FBStringCodec {
+public:
+    /**
+     * 计算 base64 编码后的长度
+     * @param n 输入字节数
+     * @param alphabet 字母表，决定是否补 '='
+     * @return 编码后的字符数
+     */
+    static size_t base64EncodedLength(size_t n, FBBase64Alphabet alphabet);
+
+    /**
+     * 计算 base64 解码后的长度
+     * 末尾最多两个 '=' 不计入数据；有 '=' 时总长度必须是 4 的倍数。不检查其余字符是否合法。
+     * @param text 输入
+     * @param n 字符数
+     * @param length 输出参数，解码后的字节数
+     * @return 长度合法返回 true
+     */
+    static bool base64DecodedLength(const char* text, size_t n, size_t& length);
+
+    /**
+     * base64 编码
+     * SIMD 路径每次把 12（SSSE3）或 24（AVX2）个字节用 pshufb 重排成 6 位一组，再查表转换为字符。
+     * @param out 输出位置，至少有 base64EncodedLength(n, alphabet) 个字节可写
+     * @param data 输入
+     * @param n 输入字节数
+     * @param alphabet 字母表
+     */
+    static void base64Encode(char* out, const char* data, size_t n, FBBase64Alphabet alphabet);
+
+    /**
+     * base64 解码
+     * SIMD 路径每次按高低半字节查表校验并转换 16（SSSE3）或 32（AVX2）个字符，再用乘加指令拼接成字节。
+     * @param out 输出位置，至少有 base64DecodedLength 给出的字节数可写
+     * @param text 输入，末尾可以带 '='
+     * @param n 字符数，必须已通过 base64DecodedLength 检查
+     * @param alphabet 字母表，另一字母表特有的字符视为非法
+     * @return 输入合法返回 true；返回 false 时输出内容未定义
+     */
+    static bool base64Decode(char* out, const char* text, size_t n, FBBase64Alphabet alphabet);
+
+    /**
+     * 十六进制编码，输出 2 * n 个字符
+     * @param out 输出位置，至少有 2 * n 个字节可写
+     * @param data 输入
+     * @param n 输入字节数
+     * @param uppercase 是否使用大写字母
+     */
+    static void hexEncode(char* out, const char* data, size_t n, bool uppercase);
+
+    /**
+     * 十六进制解码，大小写字母均可
+     * @param out 输出位置，至少有 n / 2 个字节可写
+     * @param text 输入
+     * @param n 字符数，必须是偶数
+     * @return 输入合法返回 true；返回 false 时输出内容未定义
+     */
+    static bool hexDecode(char* out, const char* text, size_t n);
+};
+
+/**
+ * base64 编码并追加到 out 末尾
+ * 按精确长度扩展 out 的存储后由内核直接写入，不经过临时缓冲区。
+ * @param out 目标字符串
+ * @param data 要编码的数据
+ * @param alphabet 字母表
+ */
+void append_base64(FBString& out, FBStringView data, FBBase64Alphabet alphabet = FBBase64Alphabet::Standard);
+
+/**
+ * base64 解码并追加到 out 末尾
+ * @param out 目标字符串；抛出异常时保持不变
+ * @param text 要解码的文本
+ * @param alphabet 字母表
+ * @throws invalid_argument 如果输入不是合法的 base64
+ */
+void append_from_base64(FBString& out, FBStringView text, FBBase64Alphabet alphabet = FBBase64Alphabet::Standard);
+
+/**
+ * 十六进制编码并追加到 out 末尾
+ * @param out 目标字符串
+ * @param data 要编码的数据
+ * @param uppercase 是否使用大写字母
+ */
+void append_hex(FBString& out, FBStringView data, bool uppercase = false);
+
+/**
+ * 十六进制解码并追加到 out 末尾
+ * @param out 目标字符串；抛出异常时保持不变
+ * @param text 要解码的文本
+ * @throws invalid_argument 如果输入长度为奇数或包含非十六进制字符
+ */
+void append_from_hex(FBString& out, FBStringView text);
+
+/**
+ * base64 编码
+ * @param data 要编码的数据
+ * @param alphabet 字母表
+ * @return 编码结果
+ */
+FBString to_base64(FBStringView data, FBBase64Alphabet alphabet = FBBase64Alphabet::Standard);
+
+/**
+ * base64 解码
+ * @param text 要解码的文本
+ * @param alphabet 字母表
+ * @return 解码结果
+ * @throws invalid_argument 如果输入不是合法的 base64
+ */
+FBString from_base64(FBStringView text, FBBase64Alphabet alphabet = FBBase64Alphabet::Standard);
+
+/**
+ * 十六进制编码
+ * @param data 要编码的数据
+ * @param uppercase 是否使用大写字母
+ * @return 编码结果
+ */
+FBString to_hex(FBStringView data, bool uppercase = false);
+
+/**
+ * 十六进制解码
+ * @param text 要解码的文本
+ * @return 解码结果
+ * @throws invalid_argument 如果输入长度为奇数或包含非十六进制字符
+ */
+FBString from_hex(FBStringView text);
+
+#endif // FBSTRING_CODEC_H
@@ -0,0 +1,936 @@
+#include "FBStringConv.h"
+#include "FBStringSimd.h"
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <string>
+#include <type_traits>
+
+#ifdef FBSTRING_HAS_SSSE3
+#include <tmmintrin.h>
+#endif
+
+// 两位十进制数字表："00" ~ "99"
+static const char kDigitPairs[201] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+// 计算无符号整数的十进制位数
+size_t FBStringConv::digits10(unsigned long long value) {
+    size_t result = 1;
+    for (;;) {
+        if (value < 10ULL) return result;
+        if (value < 100ULL) return result + 1;
+        if (value < 1000ULL) return result + 2;
+        if (value < 10000ULL) return result + 3;
+        value /= 10000ULL;
+        result += 4;
+    }
+}
+
+// 写入无符号整数的十进制表示
+void FBStringConv::writeDecimal(char* out, unsigned long long value, size_t digits) {
+    char* p = out + digits;
+    while (value >= 100) {
+        size_t index = static_cast<size_t>(value % 100) * 2;
+        value /= 100;
+        *--p = kDigitPairs[index + 1];
+        *--p = kDigitPairs[index];
+    }
+    if (value >= 10) {
+        size_t index = static_cast<size_t>(value) * 2;
+        *--p = kDigitPairs[index + 1];
+        *--p = kDigitPairs[index];
+    } else {
+        *--p = static_cast<char>('0' + value);
+    }
+}
+
+// 计算无符号整数的十六进制位数
+size_t FBStringConv::digits16(unsigned long long value) {
+#if defined(__GNUC__)
+    return (64 - __builtin_clzll(value | 1) + 3) / 4;
+#else
+    size_t result = 1;
+    while (value >= 16) {
+        value >>= 4;
+        ++result;
+    }
+    return result;
+#endif
+}
+
+// 写入无符号整数的十六进制表示
+void FBStringConv::writeHex(char* out, unsigned long long value, size_t digits, bool uppercase) {
+    const char* hexChars = uppercase ? "0123456789ABCDEF" : "0123456789abcdef";
+    for (char* p = out + digits; p != out; value >>= 4) {
+        *--p = hexChars[value & 0xF];
+    }
+}
+
+// 把带符号整数写入新字符串
+static FBString signedToFBString(long long value) {
+    bool negative = value < 0;
+    unsigned long long magnitude = negative ? 0ULL - static_cast<unsigned long long>(value) : static_cast<unsigned long long>(value);
+    size_t digits = FBStringConv::digits10(magnitude);
+    FBString result;
+    result.resize_and_overwrite(digits + (negative ? 1 : 0), [&](char* p, size_t n) -> size_t {
+        if (negative) *p++ = '-';
+        FBStringConv::writeDecimal(p, magnitude, digits);
+        return n;
+    });
+    return result;
+}
+
+// 把无符号整数写入新字符串
+static FBString unsignedToFBString(unsigned long long value) {
+    size_t digits = FBStringConv::digits10(value);
+    FBString result;
+    result.resize_and_overwrite(digits, [&](char* p, size_t n) -> size_t {
+        FBStringConv::writeDecimal(p, value, digits);
+        return n;
+    });
+    return result;
+}
+
+// 把无符号整数以十六进制写入新字符串
+static FBString hexToFBString(unsigned long long value, bool uppercase) {
+    size_t digits = FBStringConv::digits16(value);
+    FBString result;
+    result.resize_and_overwrite(digits, [&](char* p, size_t n) -> size_t {
+        FBStringConv::writeHex(p, value, digits, uppercase);
+        return n;
+    });
+    return result;
+}
+
+// 整数转换为十进制字符串
+FBString to_fbstring(int value) {
+    return signedToFBString(value);
+}
+
+FBString to_fbstring(long value) {
+    return signedToFBString(value);
+}
+
+FBString to_fbstring(long long value) {
+    return signedToFBString(value);
+}
+
+FBString to_fbstring(unsigned value) {
+    return unsignedToFBString(value);
+}
+
+FBString to_fbstring(unsigned long value) {
+    return unsignedToFBString(value);
+}
+
+FBString to_fbstring(unsigned long long value) {
+    return unsignedToFBString(value);
+}
+
+// 整数转换为十六进制字符串
+FBString to_fbstring_hex(int value, bool uppercase) {
+    return hexToFBString(static_cast<unsigned>(value), uppercase);
+}
+
+FBString to_fbstring_hex(long value, bool uppercase) {
+    return hexToFBString(static_cast<unsigned long>(value), uppercase);
+}
+
+FBString to_fbstring_hex(long long value, bool uppercase) {
+    return hexToFBString(static_cast<unsigned long long>(value), uppercase);
+}
+
+FBString to_fbstring_hex(unsigned value, bool uppercase) {
+    return hexToFBString(value, uppercase);
+}
+
+FBString to_fbstring_hex(unsigned long value, bool uppercase) {
+    return hexToFBString(value, uppercase);
+}
+
+FBString to_fbstring_hex(unsigned long long value, bool uppercase) {
+    return hexToFBString(value, uppercase);
+}
+
+// Grisu2 使用的 64 位尾数的浮点数：value = f × 2^e
+struct DiyFp {
+    uint64_t f;
+    int e;
+
+    DiyFp(uint64_t f, int e) : f(f), e(e) {}
+
+    // 相减（要求指数相同且 x >= y）
+    static DiyFp sub(const DiyFp& x, const DiyFp& y) {
+        return DiyFp(x.f - y.f, x.e);
+    }
+
+    // 相乘并取高 64 位（四舍五入）
+    static DiyFp mul(const DiyFp& x, const DiyFp& y) {
+        const uint64_t uLo = x.f & 0xFFFFFFFFu;
+        const uint64_t uHi = x.f >> 32;
+        const uint64_t vLo = y.f & 0xFFFFFFFFu;
+        const uint64_t vHi = y.f >> 32;
+        const uint64_t p0 = uLo * vLo;
+        const uint64_t p1 = uLo * vHi;
+        const uint64_t p2 = uHi * vLo;
+        const uint64_t p3 = uHi * vHi;
+        uint64_t q = (p0 >> 32) + (p1 & 0xFFFFFFFFu) + (p2 & 0xFFFFFFFFu);
+        q += uint64_t(1) << 31;
+        return DiyFp(p3 + (p2 >> 32) + (p1 >> 32) + (q >> 32), x.e + y.e + 64);
+    }
+
+    // 规格化，使最高位为 1
+    static DiyFp normalize(DiyFp x) {
+        while ((x.f >> 63) == 0) {
+            x.f <<= 1;
+            x.e--;
+        }
+        return x;
+    }
+
+    // 规格化到指定指数
+    static DiyFp normalizeTo(const DiyFp& x, int targetExponent) {
+        return DiyFp(x.f << (x.e - targetExponent), targetExponent);
+    }
+};
+
+// 浮点数及其相邻值的中点
+struct Boundaries {
+    DiyFp w;
+    DiyFp minus;
+    DiyFp plus;
+};
+
+// 按 FloatType 自身的精度计算 value 及其上下边界
+template <typename FloatType, typename BitsType>
+static Boundaries computeBoundaries(FloatType value) {
+    const int precision = std::numeric_limits<FloatType>::digits;
+    const int bias = std::numeric_limits<FloatType>::max_exponent - 1 + (precision - 1);
+    const int minExponent = 1 - bias;
+    const uint64_t hiddenBit = uint64_t(1) << (precision - 1);
+
+    BitsType rawBits;
+    std::memcpy(&rawBits, &value, sizeof(value));
+    const uint64_t bits = rawBits;
+    const uint64_t biasedExponent = bits >> (precision - 1);
+    const uint64_t fraction = bits & (hiddenBit - 1);
+
+    const DiyFp v = biasedExponent == 0
+        ? DiyFp(fraction, minExponent)
+        : DiyFp(fraction + hiddenBit, static_cast<int>(biasedExponent) - bias);
+
+    // 尾数为 2 的幂时，下方相邻值更近
+    const bool lowerBoundaryIsCloser = fraction == 0 && biasedExponent > 1;
+    const DiyFp mPlus(2 * v.f + 1, v.e - 1);
+    const DiyFp mMinus = lowerBoundaryIsCloser ? DiyFp(4 * v.f - 1, v.e - 2) : DiyFp(2 * v.f - 1, v.e - 1);
+
+    const DiyFp wPlus = DiyFp::normalize(mPlus);
+    const DiyFp wMinus = DiyFp::normalizeTo(mMinus, wPlus.e);
+    Boundaries result = {DiyFp::normalize(v), wMinus, wPlus};
+    return result;
+}
+
+// 缓存的 10 的幂：10^k ≈ f × 2^e
+struct CachedPower {
+    uint64_t f;
+    int e;
+    int k;
+};
+
+// 乘以缓存的幂之后，二进制指数落在 [kAlpha, kGamma] 中
+static const int kAlpha = -60;
+static const int kGamma = -32;
+
+// 取得使 e + cached.e + 64 落在 [kAlpha, kGamma] 中的缓存幂
+static CachedPower cachedPowerForBinaryExponent(int e) {
+    static const CachedPower kCachedPowers[] = {
+    {0xAB70FE17C79AC6CAULL, -1060, -300},
+    {0xFF77B1FCBEBCDC4FULL, -1034, -292},
+    {0xBE5691EF416BD60CULL, -1007, -284},
+    {0x8DD01FAD907FFC3CULL, -980, -276},
+    {0xD3515C2831559A83ULL, -954, -268},
+    {0x9D71AC8FADA6C9B5ULL, -927, -260},
+    {0xEA9C227723EE8BCBULL, -901, -252},
+    {0xAECC49914078536DULL, -874, -244},
+    {0x823C12795DB6CE57ULL, -847, -236},
+    {0xC21094364DFB5637ULL, -821, -228},
+    {0x9096EA6F3848984FULL, -794, -220},
+    {0xD77485CB25823AC7ULL, -768, -212},
+    {0xA086CFCD97BF97F4ULL, -741, -204},
+    {0xEF340A98172AACE5ULL, -715, -196},
+    {0xB23867FB2A35B28EULL, -688, -188},
+    {0x84C8D4DFD2C63F3BULL, -661, -180},
+    {0xC5DD44271AD3CDBAULL, -635, -172},
+    {0x936B9FCEBB25C996ULL, -608, -164},
+    {0xDBAC6C247D62A584ULL, -582, -156},
+    {0xA3AB66580D5FDAF6ULL, -555, -148},
+    {0xF3E2F893DEC3F126ULL, -529, -140},
+    {0xB5B5ADA8AAFF80B8ULL, -502, -132},
+    {0x87625F056C7C4A8BULL, -475, -124},
+    {0xC9BCFF6034C13053ULL, -449, -116},
+    {0x964E858C91BA2655ULL, -422, -108},
+    {0xDFF9772470297EBDULL, -396, -100},
+    {0xA6DFBD9FB8E5B88FULL, -369, -92},
+    {0xF8A95FCF88747D94ULL, -343, -84},
+    {0xB94470938FA89BCFULL, -316, -76},
+    {0x8A08F0F8BF0F156BULL, -289, -68},
+    {0xCDB02555653131B6ULL, -263, -60},
+    {0x993FE2C6D07B7FACULL, -236, -52},
+    {0xE45C10C42A2B3B06ULL, -210, -44},
+    {0xAA242499697392D3ULL, -183, -36},
+    {0xFD87B5F28300CA0EULL, -157, -28},
+    {0xBCE5086492111AEBULL, -130, -20},
+    {0x8CBCCC096F5088CCULL, -103, -12},
+    {0xD1B71758E219652CULL, -77, -4},
+    {0x9C40000000000000ULL, -50, 4},
+    {0xE8D4A51000000000ULL, -24, 12},
+    {0xAD78EBC5AC620000ULL, 3, 20},
+    {0x813F3978F8940984ULL, 30, 28},
+    {0xC097CE7BC90715B3ULL, 56, 36},
+    {0x8F7E32CE7BEA5C70ULL, 83, 44},
+    {0xD5D238A4ABE98068ULL, 109, 52},
+    {0x9F4F2726179A2245ULL, 136, 60},
+    {0xED63A231D4C4FB27ULL, 162, 68},
+    {0xB0DE65388CC8ADA8ULL, 189, 76},
+    {0x83C7088E1AAB65DBULL, 216, 84},
+    {0xC45D1DF942711D9AULL, 242, 92},
+    {0x924D692CA61BE758ULL, 269, 100},
+    {0xDA01EE641A708DEAULL, 295, 108},
+    {0xA26DA3999AEF774AULL, 322, 116},
+    {0xF209787BB47D6B85ULL, 348, 124},
+    {0xB454E4A179DD1877ULL, 375, 132},
+    {0x865B86925B9BC5C2ULL, 402, 140},
+    {0xC83553C5C8965D3DULL, 428, 148},
+    {0x952AB45CFA97A0B3ULL, 455, 156},
+    {0xDE469FBD99A05FE3ULL, 481, 164},
+    {0xA59BC234DB398C25ULL, 508, 172},
+    {0xF6C69A72A3989F5CULL, 534, 180},
+    {0xB7DCBF5354E9BECEULL, 561, 188},
+    {0x88FCF317F22241E2ULL, 588, 196},
+    {0xCC20CE9BD35C78A5ULL, 614, 204},
+    {0x98165AF37B2153DFULL, 641, 212},
+    {0xE2A0B5DC971F303AULL, 667, 220},
+    {0xA8D9D1535CE3B396ULL, 694, 228},
+    {0xFB9B7CD9A4A7443CULL, 720, 236},
+    {0xBB764C4CA7A44410ULL, 747, 244},
+    {0x8BAB8EEFB6409C1AULL, 774, 252},
+    {0xD01FEF10A657842CULL, 800, 260},
+    {0x9B10A4E5E9913129ULL, 827, 268},
+    {0xE7109BFBA19C0C9DULL, 853, 276},
+    {0xAC2820D9623BF429ULL, 880, 284},
+    {0x80444B5E7AA7CF85ULL, 907, 292},
+    {0xBF21E44003ACDD2DULL, 933, 300},
+    {0x8E679C2F5E44FF8FULL, 960, 308},
+    {0xD433179D9C8CB841ULL, 986, 316},
+    {0x9E19DB92B4E31BA9ULL, 1013, 324},
+    };
+    const int minDecimalExponent = -300;
+    const int decimalStep = 8;
+
+    // k = ceil((kAlpha - e - 1) * log10(2))
+    const int f = kAlpha - e - 1;
+    const int k = (f * 78913) / (1 << 18) + static_cast<int>(f > 0);
+    const int index = (-minDecimalExponent + k + (decimalStep - 1)) / decimalStep;
+    assert(index >= 0 && index < static_cast<int>(sizeof(kCachedPowers) / sizeof(kCachedPowers[0])));
+    const CachedPower cached = kCachedPowers[index];
+    assert(kAlpha <= cached.e + e + 64 && cached.e + e + 64 <= kGamma);
+    return cached;
+}
+
+// 返回不超过 n 的最大 10 的幂及其位数
+static int largestPow10(uint32_t n, uint32_t& pow10) {
+    static const uint32_t kPowers[] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000};
+    int digits = 10;
+    while (digits > 1 && n < kPowers[digits - 1]) {
+        --digits;
+    }
+    pow10 = kPowers[digits - 1];
+    return digits;
+}
+
+// 把最后一位数字向 w 靠近
+static void grisu2Round(char* buf, int len, uint64_t dist, uint64_t delta, uint64_t rest, uint64_t tenK) {
+    while (rest < dist && delta - rest >= tenK && (rest + tenK < dist || dist - rest > rest + tenK - dist)) {
+        buf[len - 1]--;
+        rest += tenK;
+    }
+}
+
+// 生成 (M-, M+) 区间内最短的数字串
+static void grisu2DigitGen(char* buffer, int& length, int& decimalExponent, DiyFp mMinus, DiyFp w, DiyFp mPlus) {
+    uint64_t delta = DiyFp::sub(mPlus, mMinus).f;
+    uint64_t dist = DiyFp::sub(mPlus, w).f;
+
+    // 把 M+ 拆成整数部分 p1 和小数部分 p2
+    const DiyFp one(uint64_t(1) << -mPlus.e, mPlus.e);
+    uint32_t p1 = static_cast<uint32_t>(mPlus.f >> -one.e);
+    uint64_t p2 = mPlus.f & (one.f - 1);
+
+    uint32_t pow10;
+    int n = largestPow10(p1, pow10);
+    while (n > 0) {
+        const uint32_t d = p1 / pow10;
+        p1 %= pow10;
+        buffer[length++] = static_cast<char>('0' + d);
+        n--;
+        const uint64_t rest = (uint64_t(p1) << -one.e) + p2;
+        if (rest <= delta) {
+            decimalExponent += n;
+            grisu2Round(buffer, length, dist, delta, rest, uint64_t(pow10) << -one.e);
+            return;
+        }
+        pow10 /= 10;
+    }
+
+    int m = 0;
+    for (;;) {
+        p2 *= 10;
+        const uint64_t d = p2 >> -one.e;
+        p2 &= one.f - 1;
+        buffer[length++] = static_cast<char>('0' + d);
+        m++;
+        delta *= 10;
+        dist *= 10;
+        if (p2 <= delta) break;
+    }
+    decimalExponent -= m;
+    grisu2Round(buffer, length, dist, delta, p2, one.f);
+}
+
+// Grisu2：计算正有限浮点数的最短数字串
+static void grisu2(char* buffer, int& length, int& decimalExponent, const Boundaries& b) {
+    const CachedPower cached = cachedPowerForBinaryExponent(b.plus.e);
+    const DiyFp c(cached.f, cached.e);
+
+    const DiyFp w = DiyFp::mul(b.w, c);
+    const DiyFp wMinus = DiyFp::mul(b.minus, c);
+    const DiyFp wPlus = DiyFp::mul(b.plus, c);
+
+    // 收缩区间以抵消乘法的舍入误差
+    const DiyFp mMinus(wMinus.f + 1, wMinus.e);
+    const DiyFp mPlus(wPlus.f - 1, wPlus.e);
+
+    length = 0;
+    decimalExponent = -cached.k;
+    grisu2DigitGen(buffer, length, decimalExponent, mMinus, w, mPlus);
+}
+
+// 处理符号、零与特殊值后调用 Grisu2
+template <typename FloatType, typename BitsType>
+static FBStringConv::FloatDecimal floatToDecimal(FloatType value) {
+    FBStringConv::FloatDecimal decimal;
+    decimal.length = 0;
+    decimal.exponent = 0;
+    decimal.negative = std::signbit(value);
+    decimal.nan = value != value;
+    decimal.infinity = !decimal.nan && (value == std::numeric_limits<FloatType>::infinity() || value == -std::numeric_limits<FloatType>::infinity());
+    if (decimal.nan || decimal.infinity) {
+        return decimal;
+    }
+    if (value == 0) {
+        decimal.digits[0] = '0';
+        decimal.length = 1;
+        return decimal;
+    }
+    grisu2(decimal.digits, decimal.length, decimal.exponent, computeBoundaries<FloatType, BitsType>(decimal.negative ? -value : value));
+    return decimal;
+}
+
+// 计算浮点数的最短往返十进制表示
+FBStringConv::FloatDecimal FBStringConv::toDecimal(double value) {
+    return floatToDecimal<double, uint64_t>(value);
+}
+
+FBStringConv::FloatDecimal FBStringConv::toDecimal(float value) {
+    return floatToDecimal<float, uint32_t>(value);
+}
+
+// 定点表示的长度（不含符号）
+static size_t fixedLength(const FBStringConv::FloatDecimal& d) {
+    int point = d.length + d.exponent; // 小数点位于第 point 位数字之后
+    if (point <= 0) return static_cast<size_t>(2 - point + d.length);  // 0.000ddd
+    if (point < d.length) return static_cast<size_t>(d.length + 1);    // dd.ddd
+    return static_cast<size_t>(point);                                 // ddd000
+}
+
+// 科学计数法的长度（不含符号）
+static size_t scientificLength(const FBStringConv::FloatDecimal& d) {
+    int exponent = d.length + d.exponent - 1;
+    unsigned absExponent = static_cast<unsigned>(exponent < 0 ? -exponent : exponent);
+    size_t exponentDigits = absExponent >= 100 ? 3 : 2;
+    return static_cast<size_t>(d.length) + (d.length > 1 ? 1 : 0) + 2 + exponentDigits;
+}
+
+// 计算十进制表示按指定格式输出时的长度
+size_t FBStringConv::floatLength(const FloatDecimal& decimal, FBFloatFormat format) {
+    size_t sign = decimal.negative && !decimal.nan ? 1 : 0;
+    if (decimal.nan || decimal.infinity) return sign + 3;
+    switch (format) {
+        case FBFloatFormat::Fixed:
+            return sign + fixedLength(decimal);
+        case FBFloatFormat::Scientific:
+            return sign + scientificLength(decimal);
+        case FBFloatFormat::General:
+            break;
+    }
+    return sign + std::min(fixedLength(decimal), scientificLength(decimal));
+}
+
+// 按指定格式写入十进制表示
+void FBStringConv::writeFloat(char* out, const FloatDecimal& decimal, FBFloatFormat format) {
+    if (decimal.nan) {
+        std::memcpy(out, "nan", 3);
+        return;
+    }
+    if (decimal.negative) *out++ = '-';
+    if (decimal.infinity) {
+        std::memcpy(out, "inf", 3);
+        return;
+    }
+    if (format == FBFloatFormat::General) {
+        format = fixedLength(decimal) <= scientificLength(decimal) ? FBFloatFormat::Fixed : FBFloatFormat::Scientific;
+    }
+
+    const char* digits = decimal.digits;
+    int length = decimal.length;
+    if (format == FBFloatFormat::Fixed) {
+        int point = length + decimal.exponent;
+        if (point <= 0) {
+            *out++ = '0';
+            *out++ = '.';
+            std::memset(out, '0', static_cast<size_t>(-point));
+            std::memcpy(out - point, digits, static_cast<size_t>(length));
+        } else if (point < length) {
+            std::memcpy(out, digits, static_cast<size_t>(point));
+            out[point] = '.';
+            std::memcpy(out + point + 1, digits + point, static_cast<size_t>(length - point));
+        } else {
+            std::memcpy(out, digits, static_cast<size_t>(length));
+            std::memset(out + length, '0', static_cast<size_t>(point - length));
+        }
+        return;
+    }
+
+    // 科学计数法：d[.ddd]e±XX
+    *out++ = digits[0];
+    if (length > 1) {
+        *out++ = '.';
+        std::memcpy(out, digits + 1, static_cast<size_t>(length - 1));
+        out += length - 1;
+    }
+    int exponent = length + decimal.exponent - 1;
+    *out++ = 'e';
+    *out++ = exponent < 0 ? '-' : '+';
+    unsigned absExponent = static_cast<unsigned>(exponent < 0 ? -exponent : exponent);
+    if (absExponent < 10) {
+        *out++ = '0'; // 指数至少两位
+    }
+    writeDecimal(out, absExponent, digits10(absExponent));
+}
+
+// 把浮点数写入新字符串
+template <typename FloatType>
+static FBString floatToFBString(FloatType value, FBFloatFormat format) {
+    const FBStringConv::FloatDecimal decimal = FBStringConv::toDecimal(value);
+    FBString result;
+    result.resize_and_overwrite(FBStringConv::floatLength(decimal, format), [&](char* p, size_t n) -> size_t {
+        FBStringConv::writeFloat(p, decimal, format);
+        return n;
+    });
+    return result;
+}
+
+// 浮点数转换为最短的往返字符串
+FBString to_fbstring(double value, FBFloatFormat format) {
+    return floatToFBString(value, format);
+}
+
+FBString to_fbstring(float value, FBFloatFormat format) {
+    return floatToFBString(value, format);
+}
+
+// 构造解析结果
+static FBParseResult parseResult(const char* ptr, FBParseError ec) {
+    FBParseResult result = {ptr, ec};
+    return result;
+}
+
+// 判断是否为十进制数字
+static inline bool isDigit(char c) {
+    return static_cast<unsigned char>(c - '0') <= 9;
+}
+
+// 按小端序读取 8 个字节，使第一个字符位于最低字节
+static inline uint64_t loadEightBytes(const char* p) {
+    uint64_t bytes;
+    std::memcpy(&bytes, p, sizeof(bytes));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    bytes = __builtin_bswap64(bytes);
+#endif
+    return bytes;
+}
+
+// SWAR 判断 8 个字节是否都是 '0' ~ '9'：高半字节必须是 3，且加 6 后不进位
+static inline bool isEightDigits(uint64_t bytes) {
+    return ((bytes & 0xF0F0F0F0F0F0F0F0ULL) |
+            (((bytes + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4)) == 0x3333333333333333ULL;
+}
+
+// SWAR 把 8 位数字转换为整数：相邻两位、四位、八位依次合并，共 3 次乘法
+static inline uint32_t parseEightDigits(uint64_t bytes) {
+    const uint64_t mask = 0x000000FF000000FFULL;
+    const uint64_t mul1 = 0x000F424000000064ULL; // 100 + (1000000 << 32)
+    const uint64_t mul2 = 0x0000271000000001ULL; // 1 + (10000 << 32)
+    bytes -= 0x3030303030303030ULL;
+    bytes = (bytes * 10) + (bytes >> 8);
+    bytes = (((bytes & mask) * mul1) + (((bytes >> 16) & mask) * mul2)) >> 32;
+    return static_cast<uint32_t>(bytes);
+}
+
+#ifdef FBSTRING_HAS_SSSE3
+// SSSE3 检查并转换 16 位数字：先用 pmaddubsw 合并相邻两位，再用 pmaddwd 逐级合并
+static inline bool parseSixteenDigits(const char* p, uint64_t& value) {
+    const __m128i chunk = _mm_sub_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)), _mm_set1_epi8('0'));
+    const __m128i nine = _mm_set1_epi8(9);
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(chunk, nine), nine)) != 0xFFFF) return false;
+    const __m128i pairs = _mm_maddubs_epi16(chunk, _mm_setr_epi8(10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1));
+    const __m128i quads = _mm_madd_epi16(pairs, _mm_setr_epi16(100, 1, 100, 1, 100, 1, 100, 1));
+    const __m128i packed = _mm_packs_epi32(quads, quads);
+    const __m128i octets = _mm_madd_epi16(packed, _mm_setr_epi16(10000, 1, 10000, 1, 10000, 1, 10000, 1));
+    const uint64_t high = static_cast<uint32_t>(_mm_cvtsi128_si32(octets));
+    const uint64_t low = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_srli_si128(octets, 4)));
+    value = high * 100000000ULL + low;
+    return true;
+}
+#endif
+
+// 解析十进制数字串，返回数字串之后的位置
+// 19 位以内不会溢出，按 16/8 位一组批量转换；之后逐位检查溢出，溢出时仍消耗全部数字
+static const char* parseUnsignedDigits(const char* p, const char* last, uint64_t& value, bool& overflow) {
+    value = 0;
+    overflow = false;
+    const char* safeEnd = p + std::min<ptrdiff_t>(last - p, 19);
+#ifdef FBSTRING_HAS_SSSE3
+    if (safeEnd - p >= 16 && parseSixteenDigits(p, value)) {
+        p += 16;
+    }
+#endif
+    while (safeEnd - p >= 8) {
+        const uint64_t bytes = loadEightBytes(p);
+        if (!isEightDigits(bytes)) break;
+        value = value * 100000000ULL + parseEightDigits(bytes);
+        p += 8;
+    }
+    while (p < safeEnd && isDigit(*p)) {
+        value = value * 10 + static_cast<unsigned>(*p - '0');
+        ++p;
+    }
+    if (p != safeEnd) return p;
+
+    const uint64_t maxValue = std::numeric_limits<uint64_t>::max();
+    for (; p < last && isDigit(*p); ++p) {
+        const unsigned digit = static_cast<unsigned>(*p - '0');
+        if (!overflow && value <= (maxValue - digit) / 10) {
+            value = value * 10 + digit;
+        } else {
+            overflow = true;
+        }
+    }
+    return p;
+}
+
+// 解析整数
+template <typename IntType>
+static FBParseResult parseInteger(const char* first, const char* last, IntType& value) {
+    typedef typename std::make_unsigned<IntType>::type UnsignedType;
+    const char* p = first;
+    bool negative = false;
+    if (std::numeric_limits<IntType>::is_signed && p != last && *p == '-') {
+        negative = true;
+        ++p;
+    }
+    if (p == last || !isDigit(*p)) return parseResult(first, FBParseError::InvalidArgument);
+
+    uint64_t magnitude;
+    bool overflow;
+    p = parseUnsignedDigits(p, last, magnitude, overflow);
+    const uint64_t limit = static_cast<uint64_t>(std::numeric_limits<IntType>::max()) + (negative ? 1 : 0);
+    if (overflow || magnitude > limit) return parseResult(p, FBParseError::OutOfRange);
+
+    const UnsignedType bits = static_cast<UnsignedType>(magnitude);
+    value = static_cast<IntType>(negative ? static_cast<UnsignedType>(0 - bits) : bits);
+    return parseResult(p, FBParseError::None);
+}
+
+FBParseResult parse(const char* first, const char* last, int& value) {
+    return parseInteger(first, last, value);
+}
+
+FBParseResult parse(const char* first, const char* last, long& value) {
+    return parseInteger(first, last, value);
+}
+
+FBParseResult parse(const char* first, const char* last, long long& value) {
+    return parseInteger(first, last, value);
+}
+
+FBParseResult parse(const char* first, const char* last, unsigned& value) {
+    return parseInteger(first, last, value);
+}
+
+FBParseResult parse(const char* first, const char* last, unsigned long& value) {
+    return parseInteger(first, last, value);
+}
+
+FBParseResult parse(const char* first, const char* last, unsigned long long& value) {
+    return parseInteger(first, last, value);
+}
+
+// 扫描得到的十进制浮点数：value = mantissa × 10^exponent（mantissa 最多保留 19 位有效数字）
+struct DecimalScan {
+    uint64_t mantissa;      /**< 前 19 位有效数字 */
+    long exponent;          /**< mantissa 对应的十进制指数 */
+    bool truncated;         /**< 是否丢弃了非零的有效数字 */
+    bool negative;          /**< 是否为负数 */
+    const char* intBegin;   /**< 整数部分 */
+    const char* intEnd;
+    const char* fracBegin;  /**< 小数部分 */
+    const char* fracEnd;
+    long textExponent;      /**< 文本中的指数部分（已限幅） */
+};
+
+// 不区分大小写地匹配 ASCII 小写单词
+static bool matchWord(const char* p, const char* last, const char* word) {
+    for (; *word; ++p, ++word) {
+        if (p == last || (*p | 0x20) != *word) return false;
+    }
+    return true;
+}
+
+// 解析 inf、infinity、nan、nan(...)；不匹配时返回 nullptr
+template <typename FloatType>
+static const char* parseSpecial(const char* p, const char* last, bool negative, FloatType& result) {
+    if (matchWord(p, last, "inf")) {
+        p += matchWord(p, last, "infinity") ? 8 : 3;
+        result = negative ? -std::numeric_limits<FloatType>::infinity() : std::numeric_limits<FloatType>::infinity();
+        return p;
+    }
+    if (matchWord(p, last, "nan")) {
+        p += 3;
+        if (p != last && *p == '(') {
+            const char* q = p + 1;
+            while (q != last && (isDigit(*q) || ((*q | 0x20) >= 'a' && (*q | 0x20) <= 'z') || *q == '_')) ++q;
+            if (q != last && *q == ')') p = q + 1;
+        }
+        result = negative ? -std::numeric_limits<FloatType>::quiet_NaN() : std::numeric_limits<FloatType>::quiet_NaN();
+        return p;
+    }
+    return nullptr;
+}
+
+// 累加一段数字到 19 位有效数字的尾数中，返回数字串之后的位置
+// 多出的数字只记录指数与是否非零；inFraction 为 true 时每个保留的数字使指数减一
+static const char* scanDigits(const char* p, const char* last, DecimalScan& scan, int& digitCount, bool inFraction) {
+    if (scan.mantissa == 0) {
+        // 前导零不是有效数字：整数部分直接跳过，小数部分只影响指数
+        const char* zeros = p;
+        while (p < last && *p == '0') ++p;
+        if (inFraction) scan.exponent -= static_cast<long>(p - zeros);
+    }
+    while (digitCount + 8 <= 19 && last - p >= 8) {
+        const uint64_t bytes = loadEightBytes(p);
+        if (!isEightDigits(bytes)) break;
+        scan.mantissa = scan.mantissa * 100000000ULL + parseEightDigits(bytes);
+        digitCount += 8;
+        if (inFraction) scan.exponent -= 8;
+        p += 8;
+    }
+    for (; p < last && isDigit(*p); ++p) {
+        if (digitCount < 19) {
+            scan.mantissa = scan.mantissa * 10 + static_cast<unsigned>(*p - '0');
+            ++digitCount;
+            if (inFraction) --scan.exponent;
+        } else {
+            if (!inFraction) ++scan.exponent;
+            if (*p != '0') scan.truncated = true;
+        }
+    }
+    return p;
+}
+
+// 扫描十进制浮点数文本，返回数字之后的位置；不是合法的数时返回 nullptr
+static const char* scanDecimal(const char* p, const char* last, DecimalScan& scan) {
+    const long exponentLimit = 1L << 24;
+    int digitCount = 0;
+    scan.mantissa = 0;
+    scan.exponent = 0;
+    scan.truncated = false;
+    scan.textExponent = 0;
+
+    scan.intBegin = p;
+    p = scanDigits(p, last, scan, digitCount, false);
+    scan.intEnd = p;
+    scan.fracBegin = scan.fracEnd = p;
+    if (p < last && *p == '.') {
+        scan.fracBegin = p + 1;
+        p = scanDigits(p + 1, last, scan, digitCount, true);
+        scan.fracEnd = p;
+    }
+    if (scan.intBegin == scan.intEnd && scan.fracBegin == scan.fracEnd) return nullptr;
+
+    // 指数部分：e 之后没有数字时不属于这个数
+    if (p < last && (*p | 0x20) == 'e') {
+        const char* q = p + 1;
+        bool negativeExponent = false;
+        if (q < last && (*q == '+' || *q == '-')) {
+            negativeExponent = *q == '-';
+            ++q;
+        }
+        if (q < last && isDigit(*q)) {
+            long exponent = 0;
+            for (; q < last && isDigit(*q); ++q) {
+                if (exponent < exponentLimit) exponent = exponent * 10 + (*q - '0');
+            }
+            scan.textExponent = negativeExponent ? -exponent : exponent;
+            scan.exponent += scan.textExponent;
+            p = q;
+        }
+    }
+    return p;
+}
+
+// 精确的 10 的幂
+static const double kExactPowersOfTen[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+static const float kExactPowersOfTenF[] = {
+    1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f
+};
+
+// Clinger 快速路径：尾数与 10 的幂都能精确表示时，一次乘除即为正确舍入的结果
+static bool fastPath(const DecimalScan& scan, double& result) {
+    const uint64_t maxMantissa = uint64_t(1) << 53;
+    if (scan.truncated || scan.mantissa > maxMantissa) return false;
+    if (scan.exponent >= -22 && scan.exponent < 0) {
+        result = static_cast<double>(scan.mantissa) / kExactPowersOfTen[-scan.exponent];
+        return true;
+    }
+    if (scan.exponent >= 0 && scan.exponent <= 22) {
+        result = static_cast<double>(scan.mantissa) * kExactPowersOfTen[scan.exponent];
+        return true;
+    }
+    // 指数稍大时先把多出的部分乘进尾数，只要尾数仍然精确
+    if (scan.exponent > 22 && scan.exponent <= 22 + 15) {
+        uint64_t mantissa = scan.mantissa;
+        for (long i = 22; i < scan.exponent; ++i) {
+            mantissa *= 10;
+            if (mantissa > maxMantissa) return false;
+        }
+        result = static_cast<double>(mantissa) * 1e22;
+        return true;
+    }
+    return false;
+}
+
+static bool fastPath(const DecimalScan& scan, float& result) {
+    const uint64_t maxMantissa = uint64_t(1) << 24;
+    if (scan.truncated || scan.mantissa > maxMantissa || scan.exponent < -10 || scan.exponent > 10) return false;
+    const float mantissa = static_cast<float>(scan.mantissa);
+    result = scan.exponent < 0 ? mantissa / kExactPowersOfTenF[-scan.exponent] : mantissa * kExactPowersOfTenF[scan.exponent];
+    return true;
+}
+
+// 慢速路径的 strtod/strtof
+static void strtoFloat(const char* str, double& result) {
+    result = std::strtod(str, nullptr);
+}
+
+static void strtoFloat(const char* str, float& result) {
+    result = std::strtof(str, nullptr);
+}
+
+// 慢速路径：把全部数字和调整后的指数写成不含小数点的规范形式，再交给 strtod/strtof
+// 规范形式中没有小数点，因此结果不受当前 locale 的小数点字符影响
+template <typename FloatType>
+static FloatType slowPath(const DecimalScan& scan) {
+    const size_t intDigits = scan.intEnd - scan.intBegin;
+    const size_t fracDigits = scan.fracEnd - scan.fracBegin;
+    const size_t maxLength = intDigits + fracDigits + 24;
+    char stackBuffer[128];
+    std::string heapBuffer;
+    char* buffer = stackBuffer;
+    if (maxLength > sizeof(stackBuffer)) {
+        heapBuffer.resize(maxLength);
+        buffer = &heapBuffer[0];
+    }
+
+    char* p = buffer;
+    std::memcpy(p, scan.intBegin, intDigits);
+    p += intDigits;
+    std::memcpy(p, scan.fracBegin, fracDigits);
+    p += fracDigits;
+    const long exponent = scan.textExponent - static_cast<long>(fracDigits);
+    *p++ = 'e';
+    if (exponent < 0) *p++ = '-';
+    const unsigned long long absExponent = exponent < 0 ? 0ULL - static_cast<unsigned long long>(exponent) : exponent;
+    const size_t exponentDigits = FBStringConv::digits10(absExponent);
+    FBStringConv::writeDecimal(p, absExponent, exponentDigits);
+    p[exponentDigits] = '\0';
+
+    FloatType result;
+    strtoFloat(buffer, result);
+    return result;
+}
+
+// 解析浮点数
+template <typename FloatType>
+static FBParseResult parseFloating(const char* first, const char* last, FloatType& value) {
+    const char* p = first;
+    DecimalScan scan;
+    scan.negative = p != last && *p == '-';
+    if (scan.negative) ++p;
+    if (p == last) return parseResult(first, FBParseError::InvalidArgument);
+
+    if (!isDigit(*p) && *p != '.') {
+        FloatType special;
+        const char* end = parseSpecial(p, last, scan.negative, special);
+        if (!end) return parseResult(first, FBParseError::InvalidArgument);
+        value = special;
+        return parseResult(end, FBParseError::None);
+    }
+
+    const char* end = scanDecimal(p, last, scan);
+    if (!end) return parseResult(first, FBParseError::InvalidArgument);
+
+    FloatType result;
+    if (scan.mantissa == 0 && !scan.truncated) {
+        result = 0;
+    } else if (!fastPath(scan, result)) {
+        result = slowPath<FloatType>(scan);
+        // 上溢为无穷大或下溢为零都视为超出范围
+        if (std::isinf(result) || result == 0) return parseResult(end, FBParseError::OutOfRange);
+    }
+    value = scan.negative ? -result : result;
+    return parseResult(end, FBParseError::None);
+}
+
+FBParseResult parse(const char* first, const char* last, float& value) {
+    return parseFloating(first, last, value);
+}
+
+FBParseResult parse(const char* first, const char* last, double& value) {
+    return parseFloating(first, last, value);
+}
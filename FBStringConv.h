@@ -0,0 +1,199 @@
+#ifndef FBSTRING_CONV_H
+#define FBSTRING_CONV_H
+
+#include "FBString.h"
+#include "FBStringView.h"
+#include <stdexcept>
+
+/** 浮点数输出格式 */
+enum class FBFloatFormat {
+    General,    /**< 定点与科学计数法中较短的一种，长度相同时取定点 */
+    Fixed,      /**< 定点表示，例如 "123.45" */
+    Scientific  /**< 科学计数法，例如 "1.2345e+02" */
+};
+
+/** 数值解析的错误类型 */
+enum class FBParseError {
+    None,             /**< 解析成功 */
+    InvalidArgument,  /**< 开头不是合法的数字 */
+    OutOfRange        /**< 数字合法，但超出目标类型的表示范围 */
+};
+
+/** 数值解析结果 */
+struct FBParseResult {
+    const char* ptr;  /**< 第一个未被解析的字符；InvalidArgument 时等于输入起始位置 */
+    FBParseError ec;  /**< 错误类型 */
+};
+
+// FBStringConv 提供数值与字符串之间转换的底层工具，结果直接写入调用方给定的存储
+class FBStringConv {
+public:
+    /** 浮点数的最短十进制表示：|value| = digits × 10^exponent */
+    struct FloatDecimal {
+        char digits[18];  /**< 有效数字，不含小数点 */
+        int length;       /**< 有效数字个数 */
+        int exponent;     /**< 十进制指数 */
+        bool negative;    /**< 是否为负数 */
+        bool nan;         /**< 是否为 NaN */
+        bool infinity;    /**< 是否为无穷大 */
+    };
+
+    /**
+     * 计算无符号整数的十进制位数
+     * @param value 要计算的整数
+     * @return 十进制位数（1 ~ 20）
+     */
+    static size_t digits10(unsigned long long value);
+
+    /**
+     * 写入无符号整数的十进制表示
+     * 使用两位一组的查表法，从低位向高位写入，不产生结尾的 null 字符。
+     * @param out 输出位置，至少有 digits 个字节可写
+     * @param value 要写入的整数
+     * @param digits value 的十进制位数，必须等于 digits10(value)
+     */
+    static void writeDecimal(char* out, unsigned long long value, size_t digits);
+
+    /**
+     * 计算无符号整数的十六进制位数
+     * @param value 要计算的整数
+     * @return 十六进制位数（1 ~ 16）
+     */
+    static size_t digits16(unsigned long long value);
+
+    /**
+     * 写入无符号整数的十六进制表示
+     * @param out 输出位置，至少有 digits 个字节可写
+     * @param value 要写入的整数
+     * @param digits value 的十六进制位数，必须等于 digits16(value)
+     * @param uppercase 是否使用大写字母
+     */
+    static void writeHex(char* out, unsigned long long value, size_t digits, bool uppercase);
+
+    /**
+     * 计算浮点数的最短往返十进制表示
+     * 使用 Grisu2 算法：结果总能经 strtod/strtof 还原为原值，绝大多数情况下也是最短的。
+     * float 按 float 自身的精度计算，因此 0.1f 得到 "1" × 10^-1 而不是其 double 展开。
+     * @param value 要转换的浮点数
+     * @return 十进制表示
+     */
+    static FloatDecimal toDecimal(double value);
+    static FloatDecimal toDecimal(float value);
+
+    /**
+     * 计算十进制表示按指定格式输出时的长度
+     * @param decimal 十进制表示
+     * @param format 输出格式
+     * @return 输出长度
+     */
+    static size_t floatLength(const FloatDecimal& decimal, FBFloatFormat format);
+
+    /**
+     * 按指定格式写入十进制表示，不产生结尾的 null 字符
+     * @param out 输出位置，至少有 floatLength(decimal, format) 个字节可写
+     * @param decimal 十进制表示
+     * @param format 输出格式
+     */
+    static void writeFloat(char* out, const FloatDecimal& decimal, FBFloatFormat format);
+};
+
+/**
+ * 整数转换为十进制字符串
+ * 数字直接写入结果的存储；64 位整数最多 20 位，始终留在小型存储中，不会分配内存。
+ * @param value 要转换的整数
+ * @return 转换后的字符串
+ */
+FBString to_fbstring(int value);
+FBString to_fbstring(long value);
+FBString to_fbstring(long long value);
+FBString to_fbstring(unsigned value);
+FBString to_fbstring(unsigned long value);
+FBString to_fbstring(unsigned long long value);
+
+/**
+ * 整数转换为十六进制字符串（不带 0x 前缀）
+ * 负数按其类型宽度的补码输出，例如 to_fbstring_hex(-1) 为 "ffffffff"。
+ * @param value 要转换的整数
+ * @param uppercase 是否使用大写字母
+ * @return 转换后的字符串
+ */
+FBString to_fbstring_hex(int value, bool uppercase = false);
+FBString to_fbstring_hex(long value, bool uppercase = false);
+FBString to_fbstring_hex(long long value, bool uppercase = false);
+FBString to_fbstring_hex(unsigned value, bool uppercase = false);
+FBString to_fbstring_hex(unsigned long value, bool uppercase = false);
+FBString to_fbstring_hex(unsigned long long value, bool uppercase = false);
+
+/**
+ * 浮点数转换为最短的往返字符串
+ * 结果能被 strtod/strtof 还原为原值；通用格式最多 24 个字符，64 位平台上小型存储可容纳 30 个字符，结果总是保存在对象内部。
+ * NaN 与无穷大输出为 "nan"、"inf"、"-inf"。
+ * @param value 要转换的浮点数
+ * @param format 输出格式
+ * @return 转换后的字符串
+ */
+FBString to_fbstring(double value, FBFloatFormat format = FBFloatFormat::General);
+FBString to_fbstring(float value, FBFloatFormat format = FBFloatFormat::General);
+
+/**
+ * 从字符序列开头解析十进制数，语义与 std::from_chars 一致
+ * 不跳过空白，不接受 '+' 号和十六进制；不依赖 locale，也不要求以 null 结尾。
+ * 整数按 8 位一组用 SWAR 转换，支持 SSSE3 时 16 位一组用 SIMD 转换。
+ * 浮点数接受 [-]数字[.数字][e[+|-]数字]、inf、infinity、nan（不区分大小写）；
+ * 能精确计算时直接用浮点乘除得到结果，否则交给 strtod 处理不含小数点的规范化副本。
+ * 出错时 value 保持不变。
+ * @param first 输入起始位置
+ * @param last 输入结束位置
+ * @param value 解析结果
+ * @return 解析结果，ptr 指向第一个未被解析的字符
+ */
+FBParseResult parse(const char* first, const char* last, int& value);
+FBParseResult parse(const char* first, const char* last, long& value);
+FBParseResult parse(const char* first, const char* last, long long& value);
+FBParseResult parse(const char* first, const char* last, unsigned& value);
+FBParseResult parse(const char* first, const char* last, unsigned long& value);
+FBParseResult parse(const char* first, const char* last, unsigned long long& value);
+FBParseResult parse(const char* first, const char* last, float& value);
+FBParseResult parse(const char* first, const char* last, double& value);
+
+/**
+ * 从字符串开头解析数值
+ * FBString 可以隐式转换为 FBStringView，因此同样适用于 FBString。
+ * @param str 输入字符串
+ * @param value 解析结果
+ * @return 解析结果，ptr 指向第一个未被解析的字符
+ */
+template <typename T>
+FBParseResult parse(FBStringView str, T& value);
+
+/**
+ * 把整个字符串解析为数值
+ * @param str 输入字符串，必须完整地是一个数
+ * @return 解析结果
+ * @throws invalid_argument 如果字符串不是一个完整的数
+ * @throws out_of_range 如果数值超出 T 的表示范围
+ */
+template <typename T>
+T parse(FBStringView str);
+
+// 从字符串开头解析数值
+template <typename T>
+FBParseResult parse(FBStringView str, T& value) {
+    return parse(str.begin(), str.end(), value);
+}
+
+// 把整个字符串解析为数值
+template <typename T>
+T parse(FBStringView str) {
+    T value = T();
+    FBParseResult result = parse(str.begin(), str.end(), value);
+    if (result.ec == FBParseError::OutOfRange && result.ptr == str.end()) {
+        throw std::out_of_range("Number out of range");
+    }
+    if (result.ec != FBParseError::None || result.ptr != str.end()) {
+        throw std::invalid_argument("Invalid number");
+    }
+    return value;
+}
+
+#endif // FBSTRING_CONV_H
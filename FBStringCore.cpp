@@ -1,14 +1,119 @@
 #include <limits>
+#include <functional>
 #include "FBStringCore.h"
+#include "FBStringSimd.h"
+#include "FBStringHash.h"
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <stdlib.h>
+#endif
+
+// 当前线程最内层的分配计数器
+static thread_local FBStringAllocationCounter* currentAllocationCounter = nullptr;
+
+// 分配计数器构造函数
+FBStringAllocationCounter::FBStringAllocationCounter() : count_(0), previous_(currentAllocationCounter) {
+    currentAllocationCounter = this;
+}
+
+// 分配计数器析构函数
+FBStringAllocationCounter::~FBStringAllocationCounter() {
+    currentAllocationCounter = previous_;
+}
+
+// 返回分配次数
+size_t FBStringAllocationCounter::count() const {
+    return count_;
+}
+
+// 计入一次分配
+void FBStringAllocationCounter::record() {
+    if (currentAllocationCounter != nullptr) ++currentAllocationCounter->count_;
+}
+
+// 按字符类型选择编码：char 为 UTF-8，char16_t 为 UTF-16，char32_t 为 UTF-32
+static bool validateUnits(const char* data, size_t n) {
+    return FBStringSimd::validateUtf8(data, n);
+}
+
+static bool validateUnits(const char16_t* data, size_t n) {
+    return FBStringSimd::validateUtf16(data, n);
+}
+
+static bool validateUnits(const char32_t* data, size_t n) {
+    return FBStringSimd::validateUtf32(data, n);
+}
+
+// 按字符类型统计码点个数
+static size_t countUnits(const char* data, size_t n) {
+    return FBStringSimd::countCodePoints(data, n);
+}
+
+static size_t countUnits(const char16_t* data, size_t n) {
+    return FBStringSimd::countCodePoints(data, n);
+}
+
+static size_t countUnits(const char32_t*, size_t n) {
+    return n;
+}
+
+// 读取 8 个字节并按大端序解释，使整数的大小顺序就是字节的无符号顺序
+static inline uint64_t loadBigEndian64(const void* p) {
+    uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+#if !(defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+#if defined(_MSC_VER) && !defined(__clang__)
+    v = _byteswap_uint64(v);
+#else
+    v = __builtin_bswap64(v);
+#endif
+#endif
+    return v;
+}
+
+// 只保留大端序整数中最高的 k 个字节，即内存中的前 k 个字节
+static inline uint64_t keepLeadingBytes(uint64_t v, size_t k) {
+    return k >= 8 ? v : v & ~(~static_cast<uint64_t>(0) >> (8 * k));
+}
+
+// 在以 null 结尾的字符串中查找字符，char 直接使用 strchr
+static const char* findChar(const char* s, char c) {
+    return std::strchr(s, c);
+}
+
+template <typename Char>
+static const Char* findChar(const Char* s, Char c) {
+    for (;; ++s) {
+        if (*s == c) return s;
+        if (*s == Char()) return nullptr;
+    }
+}
+
+// 在以 null 结尾的字符串中查找子串，char 直接使用 strstr
+static const char* findString(const char* s, const char* needle) {
+    return std::strstr(s, needle);
+}
+
+template <typename Char>
+static const Char* findString(const Char* s, const Char* needle) {
+    for (;; ++s) {
+        size_t i = 0;
+        while (needle[i] != Char() && s[i] == needle[i]) ++i;
+        if (needle[i] == Char()) return s;
+        if (*s == Char()) return nullptr;
+    }
+}
 
 // 默认构造函数
-FBStringCore::FBStringCore() {
-    initSmall("", 0);
+template <typename Char>
+BasicFBStringCore<Char>::BasicFBStringCore() {
+    initEmpty();
 }
 
 // 用 C 风格字符串初始化
-FBStringCore::FBStringCore(const char* s) {
-    size_type len = std::strlen(s);
+template <typename Char>
+BasicFBStringCore<Char>::BasicFBStringCore(const Char* s) {
+    size_type len = traits_type::length(s);
     switch (determineType(len)) {
         case StorageType::Small:
             initSmall(s, len);
@@ -23,8 +128,9 @@ FBStringCore::FBStringCore(const char* s) {
 }
 
 // 用 n 个字符 c 初始化
-FBStringCore::FBStringCore(size_type n, char c) {
-    std::string temp(n, c);
+template <typename Char>
+BasicFBStringCore<Char>::BasicFBStringCore(size_type n, Char c) {
+    std::basic_string<Char> temp(n, c);
     switch (determineType(n)) {
         case StorageType::Small:
             initSmall(temp.c_str(), n);
@@ -39,7 +145,8 @@ FBStringCore::FBStringCore(size_type n, char c) {
 }
 
 // 使用 C 风格字符串和大小构造
-FBStringCore::FBStringCore(const char* str, size_type size) {
+template <typename Char>
+BasicFBStringCore<Char>::BasicFBStringCore(const Char* str, size_type size) {
     switch (determineType(size)) {
         case StorageType::Small:
             initSmall(str, size);
@@ -54,20 +161,23 @@ FBStringCore::FBStringCore(const char* str, size_type size) {
 }
 
 // 拷贝构造函数
-FBStringCore::FBStringCore(const FBStringCore& other) {
+template <typename Char>
+BasicFBStringCore<Char>::BasicFBStringCore(const BasicFBStringCore& other) {
     copyFrom(other);
 }
 
 // 移动构造函数
-FBStringCore::FBStringCore(FBStringCore&& other) noexcept {
+template <typename Char>
+BasicFBStringCore<Char>::BasicFBStringCore(BasicFBStringCore&& other) noexcept {
     storage_ = other.storage_;
     type_ = other.type_;
     other.type_ = StorageType::Small;
-    other.initSmall("", 0);
+    other.initEmpty();
 }
 
 // 拷贝赋值运算符
-FBStringCore& FBStringCore::operator=(const FBStringCore& other) {
+template <typename Char>
+BasicFBStringCore<Char>& BasicFBStringCore<Char>::operator=(const BasicFBStringCore& other) {
     if (this != &other) {
         destroy();
         copyFrom(other);
@@ -76,20 +186,22 @@ FBStringCore& FBStringCore::operator=(const FBStringCore& other) {
 }
 
 // 移动赋值运算符
-FBStringCore& FBStringCore::operator=(FBStringCore&& other) noexcept {
+template <typename Char>
+BasicFBStringCore<Char>& BasicFBStringCore<Char>::operator=(BasicFBStringCore&& other) noexcept {
     if (this != &other) {
         destroy();
         storage_ = other.storage_;
         type_ = other.type_;
         other.type_ = StorageType::Small;
-        other.initSmall("", 0);
+        other.initEmpty();
     }
     return *this;
 }
 
 // 从 C 字符串赋值
-FBStringCore& FBStringCore::operator=(const char* s) {
-    size_type len = std::strlen(s);
+template <typename Char>
+BasicFBStringCore<Char>& BasicFBStringCore<Char>::operator=(const Char* s) {
+    size_type len = traits_type::length(s);
     destroy();
     switch (determineType(len)) {
         case StorageType::Small:
@@ -106,139 +218,205 @@ FBStringCore& FBStringCore::operator=(const char* s) {
 }
 
 // 析构函数
-FBStringCore::~FBStringCore() {
+template <typename Char>
+BasicFBStringCore<Char>::~BasicFBStringCore() {
     destroy();
 }
 
 // 返回当前字符串中第 n 个字符的位置
-FBStringCore::reference FBStringCore::operator[](size_type n) {
-    return const_cast<reference>(static_cast<const FBStringCore&>(*this)[n]);
+template <typename Char>
+typename BasicFBStringCore<Char>::reference BasicFBStringCore<Char>::operator[](size_type n) {
+    return mutableData()[n];
 }
 
 // 返回当前字符串中第 n 个字符的位置
-FBStringCore::const_reference FBStringCore::operator[](size_type n) const {
+template <typename Char>
+typename BasicFBStringCore<Char>::const_reference BasicFBStringCore<Char>::operator[](size_type n) const {
     return type_ == StorageType::Small ? storage_.small_[n] : storage_.ml_.data_[n];
 }
 
 // 返回当前字符串中第 n 个字符的位置并进行范围检查
-FBStringCore::reference FBStringCore::at(size_type n) {
+template <typename Char>
+typename BasicFBStringCore<Char>::reference BasicFBStringCore<Char>::at(size_type n) {
     if (n >= size()) throw std::out_of_range("Index out of range");
     return (*this)[n];
 }
 
 // 返回当前字符串中第 n 个字符的位置并进行范围检查
-FBStringCore::const_reference FBStringCore::at(size_type n) const {
+template <typename Char>
+typename BasicFBStringCore<Char>::const_reference BasicFBStringCore<Char>::at(size_type n) const {
     if (n >= size()) throw std::out_of_range("Index out of range");
     return (*this)[n];
 }
 
 // 返回一个非 null 终止的 C 字符数组
-const char* FBStringCore::data() const {
+template <typename Char>
+const Char* BasicFBStringCore<Char>::data() const {
     return c_str();
 }
 
+// 返回可写的数据指针
+template <typename Char>
+Char* BasicFBStringCore<Char>::mutable_data() {
+    return mutableData();
+}
+
+// 判断存储是否与其他实例共享
+template <typename Char>
+bool BasicFBStringCore<Char>::is_shared() const {
+    return type_ != StorageType::Small && storage_.ml_.header_->refCount.load(std::memory_order_acquire) > 1;
+}
+
+// 判断内容是否保存在对象内部
+template <typename Char>
+bool BasicFBStringCore<Char>::is_inline() const {
+    return type_ == StorageType::Small;
+}
+
+// 按字符类型的编码校验内容，大型存储缓存校验结果
+template <typename Char>
+bool BasicFBStringCore<Char>::validate_encoding() const {
+    if (type_ != StorageType::Large) return validateUnits(data(), size());
+    SharedHeader* header = storage_.ml_.header_;
+    const unsigned flags = header->flags.load(std::memory_order_acquire);
+    if (flags & kEncodingChecked) return (flags & kEncodingValid) != 0;
+    // 共享同一缓冲区的副本可能同时校验，写入的结果相同
+    const bool valid = validateUnits(storage_.ml_.data_, storage_.ml_.size_);
+    header->flags.fetch_or(kEncodingChecked | (valid ? kEncodingValid : 0u), std::memory_order_release);
+    return valid;
+}
+
+// 统计码点个数
+template <typename Char>
+typename BasicFBStringCore<Char>::size_type BasicFBStringCore<Char>::count_code_points() const {
+    return countUnits(data(), size());
+}
+
+// 计算散列值，大型存储缓存计算结果
+template <typename Char>
+size_t BasicFBStringCore<Char>::hash() const {
+    if (type_ != StorageType::Large) return static_cast<size_t>(FBStringHash::hash(data(), size() * sizeof(Char)));
+    SharedHeader* header = storage_.ml_.header_;
+    if (header->flags.load(std::memory_order_acquire) & kHashCached) return header->hash.load(std::memory_order_relaxed);
+    // 共享同一缓冲区的副本可能同时计算，写入的结果相同
+    const size_t h = static_cast<size_t>(FBStringHash::hash(storage_.ml_.data_, storage_.ml_.size_ * sizeof(Char)));
+    header->hash.store(h, std::memory_order_relaxed);
+    header->flags.fetch_or(kHashCached, std::memory_order_release);
+    return h;
+}
+
 // 返回一个以 null 终止的 C 字符串
-const char* FBStringCore::c_str() const {
+template <typename Char>
+const Char* BasicFBStringCore<Char>::c_str() const {
     return type_ == StorageType::Small ? storage_.small_ : storage_.ml_.data_;
 }
 
 // 清空字符串
-void FBStringCore::clear() {
+template <typename Char>
+void BasicFBStringCore<Char>::clear() {
     destroy();
-    initSmall("", 0);
+    initEmpty();
 }
 
 // 预留存储空间
-void FBStringCore::reserve(size_type newCapacity) {
+template <typename Char>
+void BasicFBStringCore<Char>::reserve(size_type newCapacity) {
     if (newCapacity > capacity()) {
         realloc(newCapacity);
     }
 }
 
 // 调整字符串大小
-void FBStringCore::resize(size_type newSize) {
-    resize(newSize, '\0');
+template <typename Char>
+void BasicFBStringCore<Char>::resize(size_type newSize) {
+    resize(newSize, Char());
 }
 
 // 用字符 c 调整字符串大小
-void FBStringCore::resize(size_type newSize, char c) {
+template <typename Char>
+void BasicFBStringCore<Char>::resize(size_type newSize, Char c) {
     size_type currentSize = size();
     if (newSize > currentSize) {
-        reserve(newSize);
-        if (type_ == StorageType::Small) {
-            std::fill(storage_.small_ + currentSize, storage_.small_ + newSize, c);
-            setSmallSize(newSize);
-        } else {
-            std::fill(storage_.ml_.data_ + currentSize, storage_.ml_.data_ + newSize, c);
-            storage_.ml_.size_ = newSize;
-        }
+        Char* p = expand_noinit(newSize - currentSize);
+        std::fill(p, p + (newSize - currentSize), c);
     } else {
-        if (type_ == StorageType::Small) {
-            setSmallSize(newSize);
-        } else {
-            storage_.ml_.size_ = newSize;
-        }
+        mutableData();
+        setSize(newSize);
     }
 }
 
+// 在末尾扩展 delta 个未初始化的字符
+template <typename Char>
+Char* BasicFBStringCore<Char>::expand_noinit(size_type delta, bool expGrowth) {
+    size_type oldSize = size();
+    size_type newSize = oldSize + delta;
+    if (newSize > capacity()) {
+        realloc(expGrowth ? std::max(newSize, capacity() * 3 / 2) : newSize);
+    }
+    Char* p = mutableData();
+    setSize(newSize);
+    return p + oldSize;
+}
+
 // 追加字符串
-FBStringCore& FBStringCore::operator+=(const FBStringCore& s) {
+template <typename Char>
+BasicFBStringCore<Char>& BasicFBStringCore<Char>::operator+=(const BasicFBStringCore& s) {
     return append(s);
 }
 
 // 追加 C 风格字符串
-FBStringCore& FBStringCore::append(const char* s) {
-    return append(s, std::strlen(s));
+template <typename Char>
+BasicFBStringCore<Char>& BasicFBStringCore<Char>::append(const Char* s) {
+    return append(s, traits_type::length(s));
 }
 
 // 追加 C 风格字符串的前 n 个字符
-FBStringCore& FBStringCore::append(const char* s, size_type n) {
-    reserve(size() + n);
-    if (type_ == StorageType::Small) {
-        std::memcpy(storage_.small_ + smallSize(), s, n);
-        setSmallSize(smallSize() + n);
-    } else {
-        std::memcpy(storage_.ml_.data_ + storage_.ml_.size_, s, n);
-        storage_.ml_.size_ += n;
-    }
+template <typename Char>
+BasicFBStringCore<Char>& BasicFBStringCore<Char>::append(const Char* s, size_type n) {
+    // s 可能指向自身，扩容后需按偏移量重新定位
+    const Char* oldData = c_str();
+    bool aliased = std::less_equal<const Char*>()(oldData, s) && std::less<const Char*>()(s, oldData + size());
+    size_type offset = aliased ? static_cast<size_type>(s - oldData) : 0;
+    Char* dest = expand_noinit(n, true);
+    traits_type::copy(dest, aliased ? c_str() + offset : s, n);
     return *this;
 }
 
 // 追加 FBStringCore 对象
-FBStringCore& FBStringCore::append(const FBStringCore& s) {
+template <typename Char>
+BasicFBStringCore<Char>& BasicFBStringCore<Char>::append(const BasicFBStringCore& s) {
     return append(s.c_str(), s.size());
 }
 
 // 追加 FBStringCore 对象中的部分字符串
-FBStringCore& FBStringCore::append(const FBStringCore& s, size_type pos, size_type n) {
+template <typename Char>
+BasicFBStringCore<Char>& BasicFBStringCore<Char>::append(const BasicFBStringCore& s, size_type pos, size_type n) {
     return append(s.c_str() + pos, n);
 }
 
 // 追加 n 个字符 c
-FBStringCore& FBStringCore::append(size_type n, char c) {
-    reserve(size() + n);
-    if (type_ == StorageType::Small) {
-        std::fill(storage_.small_ + smallSize(), storage_.small_ + smallSize() + n, c);
-        setSmallSize(smallSize() + n);
-    } else {
-        std::fill(storage_.ml_.data_ + storage_.ml_.size_, storage_.ml_.data_ + storage_.ml_.size_ + n, c);
-        storage_.ml_.size_ += n;
-    }
+template <typename Char>
+BasicFBStringCore<Char>& BasicFBStringCore<Char>::append(size_type n, Char c) {
+    Char* dest = expand_noinit(n, true);
+    std::fill(dest, dest + n, c);
     return *this;
 }
 
 // 追加迭代器范围内的字符
-FBStringCore& FBStringCore::append(const_iterator first, const_iterator last) {
+template <typename Char>
+BasicFBStringCore<Char>& BasicFBStringCore<Char>::append(const_iterator first, const_iterator last) {
     return append(first, last - first);
 }
 
 // 用 C 风格字符串赋值
-FBStringCore& FBStringCore::assign(const char* s) {
-    return assign(s, std::strlen(s));
+template <typename Char>
+BasicFBStringCore<Char>& BasicFBStringCore<Char>::assign(const Char* s) {
+    return assign(s, traits_type::length(s));
 }
 
 // 用 C 风格字符串的前 n 个字符赋值
-FBStringCore& FBStringCore::assign(const char* s, size_type n) {
+template <typename Char>
+BasicFBStringCore<Char>& BasicFBStringCore<Char>::assign(const Char* s, size_type n) {
     destroy();
     switch (determineType(n)) {
         case StorageType::Small:
@@ -255,104 +433,116 @@ FBStringCore& FBStringCore::assign(const char* s, size_type n) {
 }
 
 // 用 FBStringCore 对象赋值
-FBStringCore& FBStringCore::assign(const FBStringCore& s) {
+template <typename Char>
+BasicFBStringCore<Char>& BasicFBStringCore<Char>::assign(const BasicFBStringCore& s) {
     return assign(s.c_str(), s.size());
 }
 
 // 用 n 个字符 c 赋值
-FBStringCore& FBStringCore::assign(size_type n, char c) {
-    std::string temp(n, c);
+template <typename Char>
+BasicFBStringCore<Char>& BasicFBStringCore<Char>::assign(size_type n, Char c) {
+    std::basic_string<Char> temp(n, c);
     return assign(temp.c_str(), n);
 }
 
 // 用 FBStringCore 对象中的部分字符串赋值
-FBStringCore& FBStringCore::assign(const FBStringCore& s, size_type start, size_type n) {
+template <typename Char>
+BasicFBStringCore<Char>& BasicFBStringCore<Char>::assign(const BasicFBStringCore& s, size_type start, size_type n) {
     return assign(s.c_str() + start, n);
 }
 
 // 用迭代器范围内的字符赋值
-FBStringCore& FBStringCore::assign(const_iterator first, const_iterator last) {
+template <typename Char>
+BasicFBStringCore<Char>& BasicFBStringCore<Char>::assign(const_iterator first, const_iterator last) {
     return assign(first, last - first);
 }
 
 // 在指定位置插入 C 风格字符串
-FBStringCore& FBStringCore::insert(size_type pos, const char* s) {
-    return insert(pos, s, std::strlen(s));
+template <typename Char>
+BasicFBStringCore<Char>& BasicFBStringCore<Char>::insert(size_type pos, const Char* s) {
+    return insert(pos, s, traits_type::length(s));
 }
 
 // 在指定位置插入 C 风格字符串的前 n 个字符
-FBStringCore& FBStringCore::insert(size_type pos, const char* s, size_type n) {
+template <typename Char>
+BasicFBStringCore<Char>& BasicFBStringCore<Char>::insert(size_type pos, const Char* s, size_type n) {
     if (pos > size()) return *this;
-    reserve(size() + n);
-    if (type_ == StorageType::Small) {
-        std::memmove(storage_.small_ + pos + n, storage_.small_ + pos, smallSize() - pos);
-        std::memcpy(storage_.small_ + pos, s, n);
-        setSmallSize(smallSize() + n);
-    } else {
-        std::memmove(storage_.ml_.data_ + pos + n, storage_.ml_.data_ + pos, storage_.ml_.size_ - pos);
-        std::memcpy(storage_.ml_.data_ + pos, s, n);
-        storage_.ml_.size_ += n;
+    const Char* oldData = c_str();
+    if (std::less_equal<const Char*>()(oldData, s) && std::less<const Char*>()(s, oldData + size())) {
+        // 插入自身的一部分：先拷贝出来，避免移动数据时覆盖源
+        BasicFBStringCore temp(s, n);
+        return insert(pos, temp.c_str(), n);
     }
+    size_type oldSize = size();
+    Char* p = expand_noinit(n, true) - oldSize;
+    traits_type::move(p + pos + n, p + pos, oldSize - pos);
+    traits_type::copy(p + pos, s, n);
     return *this;
 }
 
 // 在指定位置插入 FBStringCore 对象
-FBStringCore& FBStringCore::insert(size_type pos, const FBStringCore& s) {
+template <typename Char>
+BasicFBStringCore<Char>& BasicFBStringCore<Char>::insert(size_type pos, const BasicFBStringCore& s) {
     return insert(pos, s.c_str(), s.size());
 }
 
 // 在指定位置插入 FBStringCore 对象中的部分字符
-FBStringCore& FBStringCore::insert(size_type pos, const FBStringCore& s, size_type pos2, size_type n) {
+template <typename Char>
+BasicFBStringCore<Char>& BasicFBStringCore<Char>::insert(size_type pos, const BasicFBStringCore& s, size_type pos2, size_type n) {
     return insert(pos, s.c_str() + pos2, n);
 }
 
 // 在指定位置插入 n 个字符 c
-FBStringCore& FBStringCore::insert(size_type pos, size_type n, char c) {
-    std::string temp(n, c);
+template <typename Char>
+BasicFBStringCore<Char>& BasicFBStringCore<Char>::insert(size_type pos, size_type n, Char c) {
+    std::basic_string<Char> temp(n, c);
     return insert(pos, temp.c_str(), n);
 }
 
 // 在迭代器位置插入字符 c
-FBStringCore::iterator FBStringCore::insert(iterator it, char c) {
+template <typename Char>
+typename BasicFBStringCore<Char>::iterator BasicFBStringCore<Char>::insert(iterator it, Char c) {
     size_type pos = it - begin();
     insert(pos, 1, c);
     return begin() + pos;
 }
 
 // 在迭代器位置插入 n 个字符 c
-void FBStringCore::insert(iterator it, size_type n, char c) {
+template <typename Char>
+void BasicFBStringCore<Char>::insert(iterator it, size_type n, Char c) {
     size_type pos = it - begin();
     insert(pos, n, c);
 }
 
 // 在迭代器位置插入迭代器范围内的字符
-void FBStringCore::insert(iterator it, const_iterator first, const_iterator last) {
+template <typename Char>
+void BasicFBStringCore<Char>::insert(iterator it, const_iterator first, const_iterator last) {
     size_type pos = it - begin();
     insert(pos, first, last - first);
 }
 
 // 删除指定位置的 n 个字符
-FBStringCore& FBStringCore::erase(size_type pos, size_type n) {
-    if (pos + n > size()) return *this;
-    if (type_ == StorageType::Small) {
-        std::memmove(storage_.small_ + pos, storage_.small_ + pos + n, smallSize() - pos - n);
-        setSmallSize(smallSize() - n);
-    } else {
-        std::memmove(storage_.ml_.data_ + pos, storage_.ml_.data_ + pos + n, storage_.ml_.size_ - pos - n);
-        storage_.ml_.size_ -= n;
-    }
+template <typename Char>
+BasicFBStringCore<Char>& BasicFBStringCore<Char>::erase(size_type pos, size_type n) {
+    if (pos > size()) return *this;
+    n = std::min(n, size() - pos);
+    Char* p = mutableData();
+    traits_type::move(p + pos, p + pos + n, size() - pos - n);
+    setSize(size() - n);
     return *this;
 }
 
 // 删除迭代器位置的字符
-FBStringCore::iterator FBStringCore::erase(iterator pos) {
+template <typename Char>
+typename BasicFBStringCore<Char>::iterator BasicFBStringCore<Char>::erase(iterator pos) {
     size_type index = pos - begin();
     erase(index, 1);
     return begin() + index;
 }
 
 // 删除迭代器范围内的字符
-FBStringCore::iterator FBStringCore::erase(iterator first, iterator last) {
+template <typename Char>
+typename BasicFBStringCore<Char>::iterator BasicFBStringCore<Char>::erase(iterator first, iterator last) {
     size_type pos = first - begin();
     size_type n = last - first;
     erase(pos, n);
@@ -360,176 +550,230 @@ FBStringCore::iterator FBStringCore::erase(iterator first, iterator last) {
 }
 
 // 替换指定位置的 n 个字符为 C 风格字符串
-FBStringCore& FBStringCore::replace(size_type p0, size_type n0, const char* s) {
-    return replace(p0, n0, s, std::strlen(s));
+template <typename Char>
+BasicFBStringCore<Char>& BasicFBStringCore<Char>::replace(size_type p0, size_type n0, const Char* s) {
+    return replace(p0, n0, s, traits_type::length(s));
 }
 
 // 替换指定位置的 n0 个字符为 C 风格字符串的前 n 个字符
-FBStringCore& FBStringCore::replace(size_type p0, size_type n0, const char* s, size_type n) {
+template <typename Char>
+BasicFBStringCore<Char>& BasicFBStringCore<Char>::replace(size_type p0, size_type n0, const Char* s, size_type n) {
     erase(p0, n0);
     insert(p0, s, n);
     return *this;
 }
 
 // 替换指定位置的 n 个字符为 FBStringCore 对象
-FBStringCore& FBStringCore::replace(size_type p0, size_type n0, const FBStringCore& s) {
+template <typename Char>
+BasicFBStringCore<Char>& BasicFBStringCore<Char>::replace(size_type p0, size_type n0, const BasicFBStringCore& s) {
     return replace(p0, n0, s.c_str(), s.size());
 }
 
 // 替换指定位置的 n0 个字符为 FBStringCore 对象中的部分字符
-FBStringCore& FBStringCore::replace(size_type p0, size_type n0, const FBStringCore& s, size_type pos, size_type n) {
+template <typename Char>
+BasicFBStringCore<Char>& BasicFBStringCore<Char>::replace(size_type p0, size_type n0, const BasicFBStringCore& s, size_type pos, size_type n) {
     return replace(p0, n0, s.c_str() + pos, n);
 }
 
 // 替换指定位置的 n0 个字符为 n 个字符 c
-FBStringCore& FBStringCore::replace(size_type p0, size_type n0, size_type n, char c) {
-    std::string temp(n, c);
+template <typename Char>
+BasicFBStringCore<Char>& BasicFBStringCore<Char>::replace(size_type p0, size_type n0, size_type n, Char c) {
+    std::basic_string<Char> temp(n, c);
     return replace(p0, n0, temp.c_str(), n);
 }
 
 // 替换迭代器范围内的字符为 C 风格字符串
-FBStringCore& FBStringCore::replace(iterator first0, iterator last0, const char* s) {
+template <typename Char>
+BasicFBStringCore<Char>& BasicFBStringCore<Char>::replace(iterator first0, iterator last0, const Char* s) {
     size_type pos = first0 - begin();
     size_type n0 = last0 - first0;
     return replace(pos, n0, s);
 }
 
 // 替换迭代器范围内的字符为 C 风格字符串的前 n 个字符
-FBStringCore& FBStringCore::replace(iterator first0, iterator last0, const char* s, size_type n) {
+template <typename Char>
+BasicFBStringCore<Char>& BasicFBStringCore<Char>::replace(iterator first0, iterator last0, const Char* s, size_type n) {
     size_type pos = first0 - begin();
     size_type n0 = last0 - first0;
     return replace(pos, n0, s, n);
 }
 
 // 替换迭代器范围内的字符为 FBStringCore 对象
-FBStringCore& FBStringCore::replace(iterator first0, iterator last0, const FBStringCore& s) {
+template <typename Char>
+BasicFBStringCore<Char>& BasicFBStringCore<Char>::replace(iterator first0, iterator last0, const BasicFBStringCore& s) {
     size_type pos = first0 - begin();
     size_type n0 = last0 - first0;
     return replace(pos, n0, s.c_str(), s.size());
 }
 
 // 替换迭代器范围内的字符为 n 个字符 c
-FBStringCore& FBStringCore::replace(iterator first0, iterator last0, size_type n, char c) {
+template <typename Char>
+BasicFBStringCore<Char>& BasicFBStringCore<Char>::replace(iterator first0, iterator last0, size_type n, Char c) {
     size_type pos = first0 - begin();
     size_type n0 = last0 - first0;
     return replace(pos, n0, n, c);
 }
 
 // 替换迭代器范围内的字符为另一个迭代器范围内的字符
-FBStringCore& FBStringCore::replace(iterator first0, iterator last0, const_iterator first, const_iterator last) {
+template <typename Char>
+BasicFBStringCore<Char>& BasicFBStringCore<Char>::replace(iterator first0, iterator last0, const_iterator first, const_iterator last) {
     size_type pos = first0 - begin();
     size_type n0 = last0 - first0;
     return replace(pos, n0, first, last - first);
 }
 
 // 交换当前字符串与另一个字符串的值
-void FBStringCore::swap(FBStringCore& s2) {
+template <typename Char>
+void BasicFBStringCore<Char>::swap(BasicFBStringCore& s2) noexcept {
     std::swap(storage_, s2.storage_);
     std::swap(type_, s2.type_);
 }
 
 // 拷贝字符串中的字符到字符数组
-FBStringCore::size_type FBStringCore::copy(char* s, size_type n, size_type pos) const {
+template <typename Char>
+typename BasicFBStringCore<Char>::size_type BasicFBStringCore<Char>::copy(Char* s, size_type n, size_type pos) const {
     if (pos > size()) return 0;
     size_type len = std::min(n, size() - pos);
-    std::memcpy(s, c_str() + pos, len);
+    traits_type::copy(s, c_str() + pos, len);
     return len;
 }
 
 // 返回子字符串
-FBStringCore FBStringCore::substr(size_type pos, size_type n) const {
+template <typename Char>
+BasicFBStringCore<Char> BasicFBStringCore<Char>::substr(size_type pos, size_type n) const {
     if (pos > size()) throw std::out_of_range("Index out of range");
-    return FBStringCore(c_str() + pos, std::min(n, size() - pos));
+    return BasicFBStringCore(c_str() + pos, std::min(n, size() - pos));
+}
+
+// 原地截取子字符串
+template <typename Char>
+BasicFBStringCore<Char>& BasicFBStringCore<Char>::substr_inplace(size_type pos, size_type n) {
+    if (pos > size()) throw std::out_of_range("Index out of range");
+    n = std::min(n, size() - pos);
+    if (is_shared()) {
+        // 共享存储：先解除共享会复制整个字符串，这里只复制保留的部分
+        BasicFBStringCore kept(c_str() + pos, n);
+        swap(kept);
+        return *this;
+    }
+    Char* p = mutableData();
+    if (pos != 0) traits_type::move(p, p + pos, n);
+    setSize(n);
+    return *this;
 }
 
 // 比较两个字符串是否相等
-bool FBStringCore::operator==(const FBStringCore& other) const {
-    return size() == other.size() && std::memcmp(c_str(), other.c_str(), size()) == 0;
+template <typename Char>
+bool BasicFBStringCore<Char>::operator==(const BasicFBStringCore& other) const {
+    const size_type n = size();
+    if (n != other.size()) return false;
+    const Char* a = c_str();
+    const Char* b = other.c_str();
+    // 共享同一缓冲区的副本（以及与自身比较）大小相同时内容一定相同
+    if (a == b || n == 0) return true;
+    if (a[0] != b[0] || a[n - 1] != b[n - 1]) return false;
+    if (type_ == StorageType::Large && other.type_ == StorageType::Large && cachedHashesDiffer(other)) return false;
+    return FBStringSimd::equal(reinterpret_cast<const char*>(a), reinterpret_cast<const char*>(b), n * sizeof(Char));
 }
 
 // 比较两个字符串是否不相等
-bool FBStringCore::operator!=(const FBStringCore& other) const {
+template <typename Char>
+bool BasicFBStringCore<Char>::operator!=(const BasicFBStringCore& other) const {
     return !(*this == other);
 }
 
-// 比较两个字符串大小
-bool FBStringCore::operator<(const FBStringCore& other) const {
-    return std::lexicographical_compare(c_str(), c_str() + size(), other.c_str(), other.c_str() + other.size());
+// 比较两个字符串大小，与 compare() 一致
+template <typename Char>
+bool BasicFBStringCore<Char>::operator<(const BasicFBStringCore& other) const {
+    return compare(other) < 0;
 }
 
-bool FBStringCore::operator<=(const FBStringCore& other) const {
-    return !(other < *this);
+template <typename Char>
+bool BasicFBStringCore<Char>::operator<=(const BasicFBStringCore& other) const {
+    return compare(other) <= 0;
 }
 
-bool FBStringCore::operator>(const FBStringCore& other) const {
-    return other < *this;
+template <typename Char>
+bool BasicFBStringCore<Char>::operator>(const BasicFBStringCore& other) const {
+    return compare(other) > 0;
 }
 
-bool FBStringCore::operator>=(const FBStringCore& other) const {
-    return !(*this < other);
+template <typename Char>
+bool BasicFBStringCore<Char>::operator>=(const BasicFBStringCore& other) const {
+    return compare(other) >= 0;
 }
 
-// 比较当前字符串和另一个字符串的大小
-int FBStringCore::compare(const FBStringCore& s) const {
-    return compare(0, size(), s);
+// 比较当前字符串和另一个字符串的大小，两个小型存储的 char 字符串按字比较
+template <typename Char>
+int BasicFBStringCore<Char>::compare(const BasicFBStringCore& s) const {
+    if (sizeof(Char) == 1 && type_ == StorageType::Small && s.type_ == StorageType::Small) return compareSmall(s);
+    return compareChars(c_str(), size(), s.c_str(), s.size());
 }
 
 // 比较当前字符串的子串和另一个字符串的大小
-int FBStringCore::compare(size_type pos, size_type n, const FBStringCore& s) const {
-    return compare(pos, n, s.c_str(), s.size());
+template <typename Char>
+int BasicFBStringCore<Char>::compare(size_type pos, size_type n, const BasicFBStringCore& s) const {
+    if (pos > size()) throw std::out_of_range("Index out of range");
+    return compareChars(c_str() + pos, std::min(n, size() - pos), s.c_str(), s.size());
 }
 
 // 比较当前字符串的子串和另一个字符串的子串的大小
-int FBStringCore::compare(size_type pos, size_type n, const FBStringCore& s, size_type pos2, size_type n2) const {
-    return compare(pos, n, s.c_str() + pos2, n2);
+template <typename Char>
+int BasicFBStringCore<Char>::compare(size_type pos, size_type n, const BasicFBStringCore& s, size_type pos2, size_type n2) const {
+    if (pos > size() || pos2 > s.size()) throw std::out_of_range("Index out of range");
+    return compareChars(c_str() + pos, std::min(n, size() - pos), s.c_str() + pos2, std::min(n2, s.size() - pos2));
 }
 
 // 比较当前字符串和 C 风格字符串的大小
-int FBStringCore::compare(const char* s) const {
-    return compare(0, size(), s, std::strlen(s));
+template <typename Char>
+int BasicFBStringCore<Char>::compare(const Char* s) const {
+    return compareChars(c_str(), size(), s, traits_type::length(s));
 }
 
 // 比较当前字符串的子串和 C 风格字符串的大小
-int FBStringCore::compare(size_type pos, size_type n, const char* s) const {
-    return compare(pos, n, s, std::strlen(s));
+template <typename Char>
+int BasicFBStringCore<Char>::compare(size_type pos, size_type n, const Char* s) const {
+    return compare(pos, n, s, traits_type::length(s));
 }
 
 // 比较当前字符串的子串和 C 风格字符串前 pos2 个字符的大小
-int FBStringCore::compare(size_type pos, size_type n, const char* s, size_type pos2) const {
+template <typename Char>
+int BasicFBStringCore<Char>::compare(size_type pos, size_type n, const Char* s, size_type pos2) const {
     size_type len1 = std::min(n, size() - pos);
-    size_type len2 = std::min(pos2, std::strlen(s));
-    int cmp = std::memcmp(c_str() + pos, s, std::min(len1, len2));
-    if (cmp != 0) return cmp;
-    if (len1 < len2) return -1;
-    if (len1 > len2) return 1;
-    return 0;
+    size_type len2 = std::min(pos2, traits_type::length(s));
+    return compareChars(c_str() + pos, len1, s, len2);
 }
 
 // 查找字符在字符串中的位置
-FBStringCore::size_type FBStringCore::find(char c, size_type pos) const {
-    const char* result = std::strchr(c_str() + pos, c);
+template <typename Char>
+typename BasicFBStringCore<Char>::size_type BasicFBStringCore<Char>::find(Char c, size_type pos) const {
+    const Char* result = findChar(c_str() + pos, c);
     return result ? result - c_str() : npos;
 }
 
 // 查找 C 风格字符串在字符串中的位置
-FBStringCore::size_type FBStringCore::find(const char* s, size_type pos) const {
-    const char* result = std::strstr(c_str() + pos, s);
+template <typename Char>
+typename BasicFBStringCore<Char>::size_type BasicFBStringCore<Char>::find(const Char* s, size_type pos) const {
+    const Char* result = findString(c_str() + pos, s);
     return result ? result - c_str() : npos;
 }
 
 // 查找 C 风格字符串的前 n 个字符在字符串中的位置
-FBStringCore::size_type FBStringCore::find(const char* s, size_type pos, size_type n) const {
-    FBStringCore temp(s, n);
+template <typename Char>
+typename BasicFBStringCore<Char>::size_type BasicFBStringCore<Char>::find(const Char* s, size_type pos, size_type n) const {
+    BasicFBStringCore temp(s, n);
     return find(temp.c_str(), pos);
 }
 
 // 查找 FBStringCore 对象在字符串中的位置
-FBStringCore::size_type FBStringCore::find(const FBStringCore& s, size_type pos) const {
+template <typename Char>
+typename BasicFBStringCore<Char>::size_type BasicFBStringCore<Char>::find(const BasicFBStringCore& s, size_type pos) const {
     return find(s.c_str(), pos);
 }
 
 // 从后向前查找字符在字符串中的位置
-FBStringCore::size_type FBStringCore::rfind(char c, size_type pos) const {
+template <typename Char>
+typename BasicFBStringCore<Char>::size_type BasicFBStringCore<Char>::rfind(Char c, size_type pos) const {
     for (size_type i = std::min(pos, size()); i-- > 0;) {
         if ((*this)[i] == c) return i;
     }
@@ -537,52 +781,60 @@ FBStringCore::size_type FBStringCore::rfind(char c, size_type pos) const {
 }
 
 // 从后向前查找 C 风格字符串在字符串中的位置
-FBStringCore::size_type FBStringCore::rfind(const char* s, size_type pos) const {
-    size_type len = std::strlen(s);
+template <typename Char>
+typename BasicFBStringCore<Char>::size_type BasicFBStringCore<Char>::rfind(const Char* s, size_type pos) const {
+    size_type len = traits_type::length(s);
     if (len > size()) return npos;
     for (size_type i = std::min(pos, size() - len); i-- > 0;) {
-        if (std::memcmp(c_str() + i, s, len) == 0) return i;
+        if (traits_type::compare(c_str() + i, s, len) == 0) return i;
     }
     return npos;
 }
 
 // 从后向前查找 C 风格字符串的前 n 个字符在字符串中的位置
-FBStringCore::size_type FBStringCore::rfind(const char* s, size_type pos, size_type n) const {
-    FBStringCore temp(s, n);
+template <typename Char>
+typename BasicFBStringCore<Char>::size_type BasicFBStringCore<Char>::rfind(const Char* s, size_type pos, size_type n) const {
+    BasicFBStringCore temp(s, n);
     return rfind(temp.c_str(), pos);
 }
 
 // 从后向前查找 FBStringCore 对象在字符串中的位置
-FBStringCore::size_type FBStringCore::rfind(const FBStringCore& s, size_type pos) const {
+template <typename Char>
+typename BasicFBStringCore<Char>::size_type BasicFBStringCore<Char>::rfind(const BasicFBStringCore& s, size_type pos) const {
     return rfind(s.c_str(), pos);
 }
 
 // 查找字符串中第一个出现的字符
-FBStringCore::size_type FBStringCore::find_first_of(char c, size_type pos) const {
+template <typename Char>
+typename BasicFBStringCore<Char>::size_type BasicFBStringCore<Char>::find_first_of(Char c, size_type pos) const {
     return find(c, pos);
 }
 
 // 查找字符串中第一个出现的 C 风格字符串
-FBStringCore::size_type FBStringCore::find_first_of(const char* s, size_type pos) const {
+template <typename Char>
+typename BasicFBStringCore<Char>::size_type BasicFBStringCore<Char>::find_first_of(const Char* s, size_type pos) const {
     for (size_type i = pos; i < size(); ++i) {
-        if (std::strchr(s, (*this)[i])) return i;
+        if (findChar(s, (*this)[i])) return i;
     }
     return npos;
 }
 
 // 查找字符串中第一个出现的 C 风格字符串的前 n 个字符
-FBStringCore::size_type FBStringCore::find_first_of(const char* s, size_type pos, size_type n) const {
-    FBStringCore temp(s, n);
+template <typename Char>
+typename BasicFBStringCore<Char>::size_type BasicFBStringCore<Char>::find_first_of(const Char* s, size_type pos, size_type n) const {
+    BasicFBStringCore temp(s, n);
     return find_first_of(temp.c_str(), pos);
 }
 
 // 查找字符串中第一个出现的 FBStringCore 对象
-FBStringCore::size_type FBStringCore::find_first_of(const FBStringCore& s, size_type pos) const {
+template <typename Char>
+typename BasicFBStringCore<Char>::size_type BasicFBStringCore<Char>::find_first_of(const BasicFBStringCore& s, size_type pos) const {
     return find_first_of(s.c_str(), pos);
 }
 
 // 查找字符串中第一个不在指定字符集中的字符
-FBStringCore::size_type FBStringCore::find_first_not_of(char c, size_type pos) const {
+template <typename Char>
+typename BasicFBStringCore<Char>::size_type BasicFBStringCore<Char>::find_first_not_of(Char c, size_type pos) const {
     for (size_type i = pos; i < size(); ++i) {
         if ((*this)[i] != c) return i;
     }
@@ -590,50 +842,58 @@ FBStringCore::size_type FBStringCore::find_first_not_of(char c, size_type pos) c
 }
 
 // 查找字符串中第一个不在指定 C 风格字符串中的字符
-FBStringCore::size_type FBStringCore::find_first_not_of(const char* s, size_type pos) const {
+template <typename Char>
+typename BasicFBStringCore<Char>::size_type BasicFBStringCore<Char>::find_first_not_of(const Char* s, size_type pos) const {
     for (size_type i = pos; i < size(); ++i) {
-        if (!std::strchr(s, (*this)[i])) return i;
+        if (!findChar(s, (*this)[i])) return i;
     }
     return npos;
 }
 
 // 查找字符串中第一个不在指定 C 风格字符串的前 n 个字符中的字符
-FBStringCore::size_type FBStringCore::find_first_not_of(const char* s, size_type pos, size_type n) const {
-    FBStringCore temp(s, n);
+template <typename Char>
+typename BasicFBStringCore<Char>::size_type BasicFBStringCore<Char>::find_first_not_of(const Char* s, size_type pos, size_type n) const {
+    BasicFBStringCore temp(s, n);
     return find_first_not_of(temp.c_str(), pos);
 }
 
 // 查找字符串中第一个不在指定 FBStringCore 对象中的字符
-FBStringCore::size_type FBStringCore::find_first_not_of(const FBStringCore& s, size_type pos) const {
+template <typename Char>
+typename BasicFBStringCore<Char>::size_type BasicFBStringCore<Char>::find_first_not_of(const BasicFBStringCore& s, size_type pos) const {
     return find_first_not_of(s.c_str(), pos);
 }
 
 // 从后向前查找字符串中最后一个出现的字符
-FBStringCore::size_type FBStringCore::find_last_of(char c, size_type pos) const {
+template <typename Char>
+typename BasicFBStringCore<Char>::size_type BasicFBStringCore<Char>::find_last_of(Char c, size_type pos) const {
     return rfind(c, pos);
 }
 
 // 从后向前查找字符串中最后一个出现的 C 风格字符串
-FBStringCore::size_type FBStringCore::find_last_of(const char* s, size_type pos) const {
+template <typename Char>
+typename BasicFBStringCore<Char>::size_type BasicFBStringCore<Char>::find_last_of(const Char* s, size_type pos) const {
     for (size_type i = std::min(pos, size()); i-- > 0;) {
-        if (std::strchr(s, (*this)[i])) return i;
+        if (findChar(s, (*this)[i])) return i;
     }
     return npos;
 }
 
 // 从后向前查找字符串中最后一个出现的 C 风格字符串的前 n 个字符
-FBStringCore::size_type FBStringCore::find_last_of(const char* s, size_type pos, size_type n) const {
-    FBStringCore temp(s, n);
+template <typename Char>
+typename BasicFBStringCore<Char>::size_type BasicFBStringCore<Char>::find_last_of(const Char* s, size_type pos, size_type n) const {
+    BasicFBStringCore temp(s, n);
     return find_last_of(temp.c_str(), pos);
 }
 
 // 从后向前查找字符串中最后一个出现的 FBStringCore 对象
-FBStringCore::size_type FBStringCore::find_last_of(const FBStringCore& s, size_type pos) const {
+template <typename Char>
+typename BasicFBStringCore<Char>::size_type BasicFBStringCore<Char>::find_last_of(const BasicFBStringCore& s, size_type pos) const {
     return find_last_of(s.c_str(), pos);
 }
 
 // 从后向前查找字符串中最后一个不在指定字符集中的字符
-FBStringCore::size_type FBStringCore::find_last_not_of(char c, size_type pos) const {
+template <typename Char>
+typename BasicFBStringCore<Char>::size_type BasicFBStringCore<Char>::find_last_not_of(Char c, size_type pos) const {
     for (size_type i = std::min(pos, size()); i-- > 0;) {
         if ((*this)[i] != c) return i;
     }
@@ -641,143 +901,149 @@ FBStringCore::size_type FBStringCore::find_last_not_of(char c, size_type pos) co
 }
 
 // 从后向前查找字符串中最后一个不在指定 C 风格字符串中的字符
-FBStringCore::size_type FBStringCore::find_last_not_of(const char* s, size_type pos) const {
+template <typename Char>
+typename BasicFBStringCore<Char>::size_type BasicFBStringCore<Char>::find_last_not_of(const Char* s, size_type pos) const {
     for (size_type i = std::min(pos, size()); i-- > 0;) {
-        if (!std::strchr(s, (*this)[i])) return i;
+        if (!findChar(s, (*this)[i])) return i;
     }
     return npos;
 }
 
 // 从后向前查找字符串中最后一个不在指定 C 风格字符串的前 n 个字符中的字符
-FBStringCore::size_type FBStringCore::find_last_not_of(const char* s, size_type pos, size_type n) const {
-    FBStringCore temp(s, n);
+template <typename Char>
+typename BasicFBStringCore<Char>::size_type BasicFBStringCore<Char>::find_last_not_of(const Char* s, size_type pos, size_type n) const {
+    BasicFBStringCore temp(s, n);
     return find_last_not_of(temp.c_str(), pos);
 }
 
 // 从后向前查找字符串中最后一个不在指定 FBStringCore 对象中的字符
-FBStringCore::size_type FBStringCore::find_last_not_of(const FBStringCore& s, size_type pos) const {
+template <typename Char>
+typename BasicFBStringCore<Char>::size_type BasicFBStringCore<Char>::find_last_not_of(const BasicFBStringCore& s, size_type pos) const {
     return find_last_not_of(s.c_str(), pos);
 }
 
 // 返回字符串的大小
-FBStringCore::size_type FBStringCore::size() const {
+template <typename Char>
+typename BasicFBStringCore<Char>::size_type BasicFBStringCore<Char>::size() const {
     return type_ == StorageType::Small ? smallSize() : storage_.ml_.size_;
 }
 
 // 返回字符串的长度
-FBStringCore::size_type FBStringCore::length() const {
+template <typename Char>
+typename BasicFBStringCore<Char>::size_type BasicFBStringCore<Char>::length() const {
     return size();
 }
 
 // 判断字符串是否为空
-bool FBStringCore::empty() const {
+template <typename Char>
+bool BasicFBStringCore<Char>::empty() const {
     return size() == 0;
 }
 
 // 返回当前容量
-FBStringCore::size_type FBStringCore::capacity() const {
-    return type_ == StorageType::Small ? 22 : storage_.ml_.capacity_;
+template <typename Char>
+typename BasicFBStringCore<Char>::size_type BasicFBStringCore<Char>::capacity() const {
+    return type_ == StorageType::Small ? kMaxSmallSize : storage_.ml_.capacity_;
 }
 
 // 返回可存放的最大字符串长度
-FBStringCore::size_type FBStringCore::max_size() const {
+template <typename Char>
+typename BasicFBStringCore<Char>::size_type BasicFBStringCore<Char>::max_size() const {
     return std::numeric_limits<size_type>::max();
 }
 
 // 返回字符串的起始位置迭代器
-FBStringCore::iterator FBStringCore::begin() {
-    return type_ == StorageType::Small ? storage_.small_ : storage_.ml_.data_;
+template <typename Char>
+typename BasicFBStringCore<Char>::iterator BasicFBStringCore<Char>::begin() {
+    return mutableData();
 }
 
 // 返回字符串的起始位置常量迭代器
-FBStringCore::const_iterator FBStringCore::begin() const {
+template <typename Char>
+typename BasicFBStringCore<Char>::const_iterator BasicFBStringCore<Char>::begin() const {
     return type_ == StorageType::Small ? storage_.small_ : storage_.ml_.data_;
 }
 
 // 返回字符串的结束位置迭代器
-FBStringCore::iterator FBStringCore::end() {
+template <typename Char>
+typename BasicFBStringCore<Char>::iterator BasicFBStringCore<Char>::end() {
     return begin() + size();
 }
 
 // 返回字符串的结束位置常量迭代器
-FBStringCore::const_iterator FBStringCore::end() const {
+template <typename Char>
+typename BasicFBStringCore<Char>::const_iterator BasicFBStringCore<Char>::end() const {
     return begin() + size();
 }
 
 // 返回字符串的最后一个字符位置的反向迭代器
-FBStringCore::reverse_iterator FBStringCore::rbegin() {
+template <typename Char>
+typename BasicFBStringCore<Char>::reverse_iterator BasicFBStringCore<Char>::rbegin() {
     return reverse_iterator(end());
 }
 
 // 返回字符串的最后一个字符位置的常量反向迭代器
-FBStringCore::const_reverse_iterator FBStringCore::rbegin() const {
+template <typename Char>
+typename BasicFBStringCore<Char>::const_reverse_iterator BasicFBStringCore<Char>::rbegin() const {
     return const_reverse_iterator(end());
 }
 
 // 返回字符串第一个字符位置的前面的反向迭代器
-FBStringCore::reverse_iterator FBStringCore::rend() {
+template <typename Char>
+typename BasicFBStringCore<Char>::reverse_iterator BasicFBStringCore<Char>::rend() {
     return reverse_iterator(begin());
 }
 
 // 返回字符串第一个字符位置的前面的常量反向迭代器
-FBStringCore::const_reverse_iterator FBStringCore::rend() const {
+template <typename Char>
+typename BasicFBStringCore<Char>::const_reverse_iterator BasicFBStringCore<Char>::rend() const {
     return const_reverse_iterator(begin());
 }
 
-// 输入操作符重载
-std::istream& operator>>(std::istream& in, FBStringCore& s) {
-    std::string temp;
-    in >> temp;
-    s = temp.c_str();
-    return in;
-}
-
-// 输出操作符重载
-std::ostream& operator<<(std::ostream& out, const FBStringCore& s) {
-    out << s.c_str();
-    return out;
-}
-
-// 从输入流中读取字符串
-std::istream& getline(std::istream& in, FBStringCore& s, char delim) {
-    std::string temp;
-    std::getline(in, temp, delim);
-    s = temp.c_str();
-    return in;
+// 初始化为空字符串
+template <typename Char>
+void BasicFBStringCore<Char>::initEmpty() {
+    setSmallSize(0);
+    storage_.small_[0] = Char();
+    type_ = StorageType::Small;
 }
 
 // 初始化小型存储
-void FBStringCore::initSmall(const char* str, size_type size) {
-    std::memcpy(storage_.small_, str, size);
+template <typename Char>
+void BasicFBStringCore<Char>::initSmall(const Char* str, size_type size) {
+    traits_type::copy(storage_.small_, str, size);
     setSmallSize(size);
-    storage_.small_[size] = '\0';
+    storage_.small_[size] = Char();
     type_ = StorageType::Small;
 }
 
 // 初始化中型存储
-void FBStringCore::initMedium(const char* str, size_type size) {
+template <typename Char>
+void BasicFBStringCore<Char>::initMedium(const Char* str, size_type size) {
     storage_.ml_.data_ = allocate(size + 1);
-    std::memcpy(storage_.ml_.data_, str, size);
-    storage_.ml_.data_[size] = '\0';
+    traits_type::copy(storage_.ml_.data_, str, size);
+    storage_.ml_.data_[size] = Char();
     storage_.ml_.size_ = size;
     storage_.ml_.capacity_ = size;
-    storage_.ml_.refCount_ = new std::atomic<size_type>(1);
+    storage_.ml_.header_ = newHeader();
     type_ = StorageType::Medium;
 }
 
 // 初始化大型存储
-void FBStringCore::initLarge(const char* str, size_type size) {
+template <typename Char>
+void BasicFBStringCore<Char>::initLarge(const Char* str, size_type size) {
     storage_.ml_.data_ = allocate(size + 1);
-    std::memcpy(storage_.ml_.data_, str, size);
-    storage_.ml_.data_[size] = '\0';
+    traits_type::copy(storage_.ml_.data_, str, size);
+    storage_.ml_.data_[size] = Char();
     storage_.ml_.size_ = size;
     storage_.ml_.capacity_ = size;
-    storage_.ml_.refCount_ = new std::atomic<size_type>(1);
+    storage_.ml_.header_ = newHeader();
     type_ = StorageType::Large;
 }
 
 // 从另一个实例复制
-void FBStringCore::copyFrom(const FBStringCore& other) {
+template <typename Char>
+void BasicFBStringCore<Char>::copyFrom(const BasicFBStringCore& other) {
     switch (other.type_) {
         case StorageType::Small:
             initSmall(other.c_str(), other.size());
@@ -786,44 +1052,79 @@ void FBStringCore::copyFrom(const FBStringCore& other) {
         case StorageType::Large:
             storage_ = other.storage_;
             type_ = other.type_;
-            storage_.ml_.refCount_->fetch_add(1, std::memory_order_relaxed);
+            storage_.ml_.header_->refCount.fetch_add(1, std::memory_order_relaxed);
             break;
     }
 }
 
 // 销毁当前存储
-void FBStringCore::destroy() {
+template <typename Char>
+void BasicFBStringCore<Char>::destroy() {
     if (type_ == StorageType::Medium || type_ == StorageType::Large) {
-        if (storage_.ml_.refCount_->fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        if (storage_.ml_.header_->refCount.fetch_sub(1, std::memory_order_acq_rel) == 1) {
             deallocate(storage_.ml_.data_);
-            delete storage_.ml_.refCount_;
+            delete storage_.ml_.header_;
         }
     }
 }
 
 // 解除共享
-void FBStringCore::unshare() {
-    if (type_ == StorageType::Large && storage_.ml_.refCount_->load(std::memory_order_acquire) > 1) {
+template <typename Char>
+void BasicFBStringCore<Char>::unshare() {
+    if (is_shared()) {
         size_type newCapacity = storage_.ml_.capacity_;
-        char* newData = allocate(newCapacity + 1);
-        std::memcpy(newData, storage_.ml_.data_, storage_.ml_.size_ + 1);
-        storage_.ml_.refCount_->fetch_sub(1, std::memory_order_acq_rel);
+        Char* newData = allocate(newCapacity + 1);
+        traits_type::copy(newData, storage_.ml_.data_, storage_.ml_.size_);
+        newData[storage_.ml_.size_] = Char();
+        destroy();
         storage_.ml_.data_ = newData;
-        storage_.ml_.refCount_ = new std::atomic<size_type>(1);
+        storage_.ml_.header_ = newHeader();
+    }
+}
+
+// 返回可写的数据指针
+template <typename Char>
+Char* BasicFBStringCore<Char>::mutableData() {
+    if (type_ == StorageType::Small) return storage_.small_;
+    unshare();
+    // 调用方拿到可写指针后内容可能改变，缓存的结果不再可信
+    storage_.ml_.header_->flags.store(0, std::memory_order_relaxed);
+    return storage_.ml_.data_;
+}
+
+// 设置字符串大小并写入结尾的 null 字符
+template <typename Char>
+void BasicFBStringCore<Char>::setSize(size_type newSize) {
+    if (type_ == StorageType::Small) {
+        setSmallSize(newSize);
+        storage_.small_[newSize] = Char();
+    } else {
+        storage_.ml_.size_ = newSize;
+        storage_.ml_.data_[newSize] = Char();
     }
 }
 
 // 分配内存
-char* FBStringCore::allocate(size_type size) {
+template <typename Char>
+Char* BasicFBStringCore<Char>::allocate(size_type size) {
+    FBStringAllocationCounter::record();
 #ifdef USE_JEMALLOC
-    return static_cast<char*>(je_malloc(size));
+    return static_cast<Char*>(je_malloc(size * sizeof(Char)));
 #else
-    return static_cast<char*>(std::malloc(size));
+    return static_cast<Char*>(std::malloc(size * sizeof(Char)));
 #endif
 }
 
+// 分配新的共享头部
+template <typename Char>
+typename BasicFBStringCore<Char>::SharedHeader* BasicFBStringCore<Char>::newHeader() {
+    FBStringAllocationCounter::record();
+    return new SharedHeader();
+}
+
 // 释放内存
-void FBStringCore::deallocate(char* ptr) {
+template <typename Char>
+void BasicFBStringCore<Char>::deallocate(Char* ptr) {
 #ifdef USE_JEMALLOC
     je_free(ptr);
 #else
@@ -832,8 +1133,9 @@ void FBStringCore::deallocate(char* ptr) {
 }
 
 // 确定存储类型
-FBStringCore::StorageType FBStringCore::determineType(size_type size) const {
-    if (size <= 22) {
+template <typename Char>
+typename BasicFBStringCore<Char>::StorageType BasicFBStringCore<Char>::determineType(size_type size) const {
+    if (size <= kMaxSmallSize) {
         return StorageType::Small;
     } else if (size <= 255) {
         return StorageType::Medium;
@@ -843,49 +1145,94 @@ FBStringCore::StorageType FBStringCore::determineType(size_type size) const {
 }
 
 // 设置小型存储的大小
-void FBStringCore::setSmallSize(size_type s) {
-    storage_.small_[23] = static_cast<char>(22 - s);
+template <typename Char>
+void BasicFBStringCore<Char>::setSmallSize(size_type s) {
+    storage_.small_[kMaxSmallSize + 1] = static_cast<Char>(kMaxSmallSize - s);
 }
 
 // 返回小型存储的大小
-FBStringCore::size_type FBStringCore::smallSize() const {
-    return 22 - static_cast<size_type>(storage_.small_[23]);
+template <typename Char>
+typename BasicFBStringCore<Char>::size_type BasicFBStringCore<Char>::smallSize() const {
+    return kMaxSmallSize - static_cast<size_type>(storage_.small_[kMaxSmallSize + 1]);
+}
+
+// 两边的散列值都已缓存时比较散列值，不会为此计算散列值
+template <typename Char>
+bool BasicFBStringCore<Char>::cachedHashesDiffer(const BasicFBStringCore& other) const {
+    const SharedHeader* h1 = storage_.ml_.header_;
+    const SharedHeader* h2 = other.storage_.ml_.header_;
+    if (!(h1->flags.load(std::memory_order_acquire) & kHashCached)) return false;
+    if (!(h2->flags.load(std::memory_order_acquire) & kHashCached)) return false;
+    return h1->hash.load(std::memory_order_relaxed) != h2->hash.load(std::memory_order_relaxed);
+}
+
+// 比较两段字符序列：char_traits<char>::compare 按 unsigned char 比较，与 memcmp 一致；char16_t、char32_t 本身无符号
+template <typename Char>
+int BasicFBStringCore<Char>::compareChars(const Char* a, size_type n1, const Char* b, size_type n2) {
+    const int cmp = traits_type::compare(a, b, std::min(n1, n2));
+    if (cmp != 0) return cmp;
+    return n1 < n2 ? -1 : (n1 > n2 ? 1 : 0);
+}
+
+// 比较两个小型存储的 char 字符串：整个数组都可读，按大端序的字（最多 4 个）比较公共长度内的字节，
+// 公共部分相同时较短的字符串较小
+template <typename Char>
+int BasicFBStringCore<Char>::compareSmall(const BasicFBStringCore& other) const {
+    const size_type n1 = smallSize(), n2 = other.smallSize();
+    const size_type n = std::min(n1, n2);
+    const unsigned char* a = reinterpret_cast<const unsigned char*>(storage_.small_);
+    const unsigned char* b = reinterpret_cast<const unsigned char*>(other.storage_.small_);
+    for (size_type offset = 0; offset < n; offset += 8) {
+        const uint64_t x = keepLeadingBytes(loadBigEndian64(a + offset), n - offset);
+        const uint64_t y = keepLeadingBytes(loadBigEndian64(b + offset), n - offset);
+        if (x != y) return x < y ? -1 : 1;
+    }
+    return n1 < n2 ? -1 : (n1 > n2 ? 1 : 0);
 }
 
 // 返回容量
-FBStringCore::size_type FBStringCore::capacityImpl() const {
-    return type_ == StorageType::Small ? 22 : storage_.ml_.capacity_;
+template <typename Char>
+typename BasicFBStringCore<Char>::size_type BasicFBStringCore<Char>::capacityImpl() const {
+    return type_ == StorageType::Small ? kMaxSmallSize : storage_.ml_.capacity_;
 }
 
 // 重新分配内存
-void FBStringCore::realloc(size_type newCapacity) {
-    if (type_ == StorageType::Small) {
-        char* newData = allocate(newCapacity + 1);
-        std::memcpy(newData, storage_.small_, smallSize() + 1);
-        initMedium(newData, smallSize());
-        deallocate(newData);
-    } else {
-        char* newData = allocate(newCapacity + 1);
-        std::memcpy(newData, storage_.ml_.data_, storage_.ml_.size_ + 1);
+template <typename Char>
+void BasicFBStringCore<Char>::realloc(size_type newCapacity) {
+    size_type currentSize = size();
+    Char* newData = allocate(newCapacity + 1);
+    traits_type::copy(newData, c_str(), currentSize);
+    newData[currentSize] = Char();
+    if (type_ != StorageType::Small && storage_.ml_.header_->refCount.load(std::memory_order_acquire) == 1) {
+        // 独占缓冲区：沿用原有引用计数
         deallocate(storage_.ml_.data_);
-        storage_.ml_.data_ = newData;
-        storage_.ml_.capacity_ = newCapacity;
+    } else {
+        // 小型存储或共享缓冲区：释放旧引用，不能修改其他实例仍在使用的数据
+        destroy();
+        storage_.ml_.header_ = newHeader();
     }
+    storage_.ml_.data_ = newData;
+    storage_.ml_.size_ = currentSize;
+    storage_.ml_.capacity_ = newCapacity;
+    type_ = determineType(newCapacity) == StorageType::Large ? StorageType::Large : StorageType::Medium;
 }
 
 // 判断是否为小端
-bool FBStringCore::isLittleEndian() {
+template <typename Char>
+bool BasicFBStringCore<Char>::isLittleEndian() {
     int num = 1;
     return *reinterpret_cast<char*>(&num) == 1;
 }
 
 // 对齐大小
-FBStringCore::size_type FBStringCore::alignSize(size_type size) {
+template <typename Char>
+typename BasicFBStringCore<Char>::size_type BasicFBStringCore<Char>::alignSize(size_type size) {
     return (size + 7) & ~7;
 }
 
 // 假设不可达
-void FBStringCore::assumeUnreachable() {
+template <typename Char>
+void BasicFBStringCore<Char>::assumeUnreachable() {
 #if defined(__GNUC__)
     __builtin_unreachable();
 #elif defined(_MSC_VER)
@@ -894,3 +1241,30 @@ void FBStringCore::assumeUnreachable() {
     std::abort();
 #endif
 }
+
+// 显式实例化：成员函数都定义在本文件中，只支持以下字符类型
+template class BasicFBStringCore<char>;
+template class BasicFBStringCore<char16_t>;
+template class BasicFBStringCore<char32_t>;
+
+// 输入操作符重载
+std::istream& operator>>(std::istream& in, FBStringCore& s) {
+    std::string temp;
+    in >> temp;
+    s = temp.c_str();
+    return in;
+}
+
+// 输出操作符重载
+std::ostream& operator<<(std::ostream& out, const FBStringCore& s) {
+    out << s.c_str();
+    return out;
+}
+
+// 从输入流中读取字符串
+std::istream& getline(std::istream& in, FBStringCore& s, char delim) {
+    std::string temp;
+    std::getline(in, temp, delim);
+    s = temp.c_str();
+    return in;
+}
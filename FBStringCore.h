@@ -7,20 +7,57 @@
 #include <iostream>
 #include <cassert>
 #include <algorithm>
+#include <functional>
 #include <stdexcept>
+#include <string>
 
 #ifdef USE_JEMALLOC
 #include <jemalloc.h>
 #endif
 
-class FBStringCore {
+/**
+ * 堆分配计数器
+ * 存在期间统计当前线程中所有 FBStringCore 的数据缓冲区和共享头部的分配次数，不影响其他线程和其他分配。
+ * 计数器可以嵌套，分配只计入最内层的计数器。
+ */
+class FBStringAllocationCounter {
+public:
+    FBStringAllocationCounter();
+    ~FBStringAllocationCounter();
+
+    FBStringAllocationCounter(const FBStringAllocationCounter&) = delete;
+    FBStringAllocationCounter& operator=(const FBStringAllocationCounter&) = delete;
+
+    /**
+     * 返回计数器存在期间的分配次数
+     * @return 分配次数
+     */
+    size_t count() const;
+
+    /** 当前线程有计数器时计入一次分配 */
+    static void record();
+
+private:
+    size_t count_;                        /**< 分配次数 */
+    FBStringAllocationCounter* previous_; /**< 外层的计数器 */
+};
+
+/**
+ * 字符串核心存储，按字符类型参数化
+ * 支持 char、char16_t、char32_t，成员函数定义在 FBStringCore.cpp 中并显式实例化。
+ * 小型存储使用整个存储联合体（64 位平台上 32 字节，32 位平台上 24 字节），
+ * 能容纳的字符数随字符宽度缩小（64 位平台上 char 为 30，char16_t 为 14，char32_t 为 6）。
+ */
+template <typename Char>
+class BasicFBStringCore {
 public:
     // 类型定义
-    typedef char value_type;
-    typedef char &reference;
-    typedef const char &const_reference;
-    typedef char *iterator;
-    typedef const char *const_iterator;
+    typedef Char value_type;
+    typedef std::char_traits<Char> traits_type;
+    typedef Char &reference;
+    typedef const Char &const_reference;
+    typedef Char *iterator;
+    typedef const Char *const_iterator;
     typedef std::reverse_iterator<iterator> reverse_iterator;
     typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
     typedef size_t size_type;
@@ -30,69 +67,70 @@ public:
      * 默认构造函数
      * 初始化一个空的字符串对象。
      */
-    FBStringCore();
+    BasicFBStringCore();
 
     /**
      * 用 C 风格字符串初始化
      * @param s 指向字符数组的指针
      */
-    FBStringCore(const char *s);
+    BasicFBStringCore(const Char *s);
 
     /**
      * 用 n 个字符 c 初始化
      * @param n 字符个数
      * @param c 初始化字符
      */
-    FBStringCore(size_type n, char c);
+    BasicFBStringCore(size_type n, Char c);
 
     /**
      * 使用 C 风格字符串和大小构造
      * @param str 指向字符数组的指针
      * @param size 字符串的长度
      */
-    FBStringCore(const char *str, size_type size);
+    BasicFBStringCore(const Char *str, size_type size);
 
     /**
      * 拷贝构造函数
      * @param other 要复制的 FBStringCore 对象
      */
-    FBStringCore(const FBStringCore &other);
+    BasicFBStringCore(const BasicFBStringCore &other);
 
     /**
      * 拷贝赋值运算符
      * @param other 要复制的 FBStringCore 对象
      * @return 当前对象的引用
      */
-    FBStringCore &operator=(const FBStringCore &other);
+    BasicFBStringCore &operator=(const BasicFBStringCore &other);
 
     /**
      * 移动构造函数
      * @param other 要移动的 FBStringCore 对象
      */
-    FBStringCore(FBStringCore&& other) noexcept;
+    BasicFBStringCore(BasicFBStringCore&& other) noexcept;
 
     /**
      * 移动赋值运算符
      * @param other 要移动的 FBStringCore 对象
      * @return 当前对象的引用
      */
-    FBStringCore& operator=(FBStringCore&& other) noexcept;
+    BasicFBStringCore& operator=(BasicFBStringCore&& other) noexcept;
 
     /**
      * 从 C 字符串赋值
      * @param s 要赋值的 C 字符串
      * @return 当前对象的引用
      */
-    FBStringCore &operator=(const char *s);
+    BasicFBStringCore &operator=(const Char *s);
 
     /**
      * 析构函数
      * 释放所有分配的资源。
      */
-    ~FBStringCore();
+    ~BasicFBStringCore();
 
     /**
      * 返回当前字符串中第 n 个字符的位置
+     * 返回可写的引用，存储被共享时先解除共享。
      * @param n 要访问的字符位置
      * @return 当前字符串中第 n 个字符的引用
      */
@@ -125,13 +163,56 @@ public:
      * 返回一个非 null 终止的 C 字符数组
      * @return 指向内部字符数组的指针
      */
-    const char *data() const;
+    const Char *data() const;
+
+    /**
+     * 返回可写的数据指针
+     * 存储被共享时先解除共享，此后通过该指针的写入不会影响其他实例。
+     * 同时清除 validate_encoding() 等缓存的结果；之后再通过该指针修改内容，需要重新取得指针才能使缓存失效。
+     * @return 指向字符数组的指针
+     */
+    Char *mutable_data();
+
+    /**
+     * 判断存储是否与其他实例共享
+     * @return 共享时返回 true；小型存储从不共享
+     */
+    bool is_shared() const;
+
+    /**
+     * 判断内容是否保存在对象内部（小型存储）
+     * 为 true 时 data() 指向对象内部的数组，从 data() 起至少 24 个字节可读（64 位平台上 32 个），即使超出 size()。
+     * 构造和赋值时长度不超过小型存储容量（64 位平台上 32 / sizeof(Char) - 2 个字符）的内容总是保存在对象内部。
+     * @return 保存在对象内部时返回 true
+     */
+    bool is_inline() const;
+
+    /**
+     * 校验内容是否为合法的 Unicode 编码：char 按 UTF-8，char16_t 按 UTF-16，char32_t 按 UTF-32
+     * 大型存储的结果缓存在共享头部中，共享同一缓冲区的副本无需重复校验；内容被修改时缓存失效。
+     * @return 合法返回 true
+     */
+    bool validate_encoding() const;
+
+    /**
+     * 统计码点个数
+     * 不做校验，内容不是合法的编码时结果没有意义。
+     * @return 码点个数
+     */
+    size_type count_code_points() const;
+
+    /**
+     * 计算内容的散列值，等于 FBStringHash::hash(data(), size() * sizeof(Char)) 截断为 size_t
+     * 大型存储的结果缓存在共享头部中，共享同一缓冲区的副本只计算一次；内容被修改时缓存失效。
+     * @return 散列值
+     */
+    size_t hash() const;
 
     /**
      * 返回一个以 null 终止的 C 字符串
      * @return 指向内部字符数组的指针
      */
-    const char *c_str() const;
+    const Char *c_str() const;
 
     /**
      * 清空字符串
@@ -156,21 +237,40 @@ public:
      * @param newSize 新的字符串大小
      * @param c 用于填充的字符
      */
-    void resize(size_type newSize, char c);
+    void resize(size_type newSize, Char c);
+
+    /**
+     * 调整字符串大小，并由 op 直接写入存储
+     * 新增部分不做初始化，op(p, n) 负责写入内容并返回最终长度（不得超过 n），
+     * 适合 read()、解压等直接产出字节的场景。
+     * @param n 可写入的最大长度
+     * @param op 写入操作，签名为 size_type op(Char* p, size_type n)
+     */
+    template <typename Operation>
+    void resize_and_overwrite(size_type n, Operation op);
+
+    /**
+     * 在末尾扩展 delta 个未初始化的字符
+     * 调用方必须写满返回的区域；必要时会解除共享。
+     * @param delta 要扩展的字符数
+     * @param expGrowth 是否按 1.5 倍几何增长容量（连续追加时避免反复重新分配）
+     * @return 指向新增区域起始位置的指针
+     */
+    Char *expand_noinit(size_type delta, bool expGrowth = false);
 
     /**
      * 追加字符串
      * @param s 要追加的字符串
      * @return 当前对象的引用
      */
-    FBStringCore &operator+=(const FBStringCore &s);
+    BasicFBStringCore &operator+=(const BasicFBStringCore &s);
 
     /**
      * 追加 C 风格字符串
      * @param s 要追加的 C 字符串
      * @return 当前对象的引用
      */
-    FBStringCore &append(const char *s);
+    BasicFBStringCore &append(const Char *s);
 
     /**
      * 追加 C 风格字符串的前 n 个字符
@@ -178,14 +278,14 @@ public:
      * @param n 要追加的字符数
      * @return 当前对象的引用
      */
-    FBStringCore &append(const char *s, size_type n);
+    BasicFBStringCore &append(const Char *s, size_type n);
 
     /**
      * 追加 FBStringCore 对象
      * @param s 要追加的 FBStringCore 对象
      * @return 当前对象的引用
      */
-    FBStringCore &append(const FBStringCore &s);
+    BasicFBStringCore &append(const BasicFBStringCore &s);
 
     /**
      * 追加 FBStringCore 对象中的部分字符串
@@ -194,7 +294,7 @@ public:
      * @param n 要追加的字符数
      * @return 当前对象的引用
      */
-    FBStringCore &append(const FBStringCore &s, size_type pos, size_type n);
+    BasicFBStringCore &append(const BasicFBStringCore &s, size_type pos, size_type n);
 
     /**
      * 追加 n 个字符 c
@@ -202,7 +302,7 @@ public:
      * @param c 要追加的字符
      * @return 当前对象的引用
      */
-    FBStringCore &append(size_type n, char c);
+    BasicFBStringCore &append(size_type n, Char c);
 
     /**
      * 追加迭代器范围内的字符
@@ -210,14 +310,14 @@ public:
      * @param last 结束迭代器
      * @return 当前对象的引用
      */
-    FBStringCore &append(const_iterator first, const_iterator last);
+    BasicFBStringCore &append(const_iterator first, const_iterator last);
 
     /**
      * 用 C 风格字符串赋值
      * @param s 要赋值的 C 字符串
      * @return 当前对象的引用
      */
-    FBStringCore &assign(const char *s);
+    BasicFBStringCore &assign(const Char *s);
 
     /**
      * 用 C 风格字符串的前 n 个字符赋值
@@ -225,14 +325,14 @@ public:
      * @param n 要赋值的字符数
      * @return 当前对象的引用
      */
-    FBStringCore &assign(const char *s, size_type n);
+    BasicFBStringCore &assign(const Char *s, size_type n);
 
     /**
      * 用 FBStringCore 对象赋值
      * @param s 要赋值的 FBStringCore 对象
      * @return 当前对象的引用
      */
-    FBStringCore &assign(const FBStringCore &s);
+    BasicFBStringCore &assign(const BasicFBStringCore &s);
 
     /**
      * 用 n 个字符 c 赋值
@@ -240,7 +340,7 @@ public:
      * @param c 要赋值的字符
      * @return 当前对象的引用
      */
-    FBStringCore &assign(size_type n, char c);
+    BasicFBStringCore &assign(size_type n, Char c);
 
     /**
      * 用 FBStringCore 对象中的部分字符串赋值
@@ -249,7 +349,7 @@ public:
      * @param n 要赋值的字符数
      * @return 当前对象的引用
      */
-    FBStringCore &assign(const FBStringCore &s, size_type start, size_type n);
+    BasicFBStringCore &assign(const BasicFBStringCore &s, size_type start, size_type n);
 
     /**
      * 用迭代器范围内的字符赋值
@@ -257,7 +357,7 @@ public:
      * @param last 结束迭代器
      * @return 当前对象的引用
      */
-    FBStringCore &assign(const_iterator first, const_iterator last);
+    BasicFBStringCore &assign(const_iterator first, const_iterator last);
 
     /**
      * 在指定位置插入 C 风格字符串
@@ -265,7 +365,7 @@ public:
      * @param s 要插入的 C 字符串
      * @return 当前对象的引用
      */
-    FBStringCore &insert(size_type pos, const char *s);
+    BasicFBStringCore &insert(size_type pos, const Char *s);
 
     /**
      * 在指定位置插入 C 风格字符串的前 n 个字符
@@ -274,7 +374,7 @@ public:
      * @param n 要插入的字符数
      * @return 当前对象的引用
      */
-    FBStringCore &insert(size_type pos, const char *s, size_type n);
+    BasicFBStringCore &insert(size_type pos, const Char *s, size_type n);
 
     /**
      * 在指定位置插入 FBStringCore 对象
@@ -282,7 +382,7 @@ public:
      * @param s 要插入的 FBStringCore 对象
      * @return 当前对象的引用
      */
-    FBStringCore &insert(size_type pos, const FBStringCore &s);
+    BasicFBStringCore &insert(size_type pos, const BasicFBStringCore &s);
 
     /**
      * 在指定位置插入 FBStringCore 对象中的部分字符
@@ -292,7 +392,7 @@ public:
      * @param n 要插入的字符数
      * @return 当前对象的引用
      */
-    FBStringCore &insert(size_type pos, const FBStringCore &s, size_type pos2, size_type n);
+    BasicFBStringCore &insert(size_type pos, const BasicFBStringCore &s, size_type pos2, size_type n);
 
     /**
      * 在指定位置插入 n 个字符 c
@@ -301,7 +401,7 @@ public:
      * @param c 要插入的字符
      * @return 当前对象的引用
      */
-    FBStringCore &insert(size_type pos, size_type n, char c);
+    BasicFBStringCore &insert(size_type pos, size_type n, Char c);
 
     /**
      * 在迭代器位置插入字符 c
@@ -309,7 +409,7 @@ public:
      * @param c 要插入的字符
      * @return 插入后的位置迭代器
      */
-    iterator insert(iterator it, char c);
+    iterator insert(iterator it, Char c);
 
     /**
      * 在迭代器位置插入 n 个字符 c
@@ -317,7 +417,7 @@ public:
      * @param n 要插入的字符数
      * @param c 要插入的字符
      */
-    void insert(iterator it, size_type n, char c);
+    void insert(iterator it, size_type n, Char c);
 
     /**
      * 在迭代器位置插入迭代器范围内的字符
@@ -333,7 +433,7 @@ public:
      * @param n 要删除的字符数
      * @return 当前对象的引用
      */
-    FBStringCore &erase(size_type pos = 0, size_type n = npos);
+    BasicFBStringCore &erase(size_type pos = 0, size_type n = npos);
 
     /**
      * 删除迭代器位置的字符
@@ -357,7 +457,7 @@ public:
      * @param s 替换为的 C 字符串
      * @return 当前对象的引用
      */
-    FBStringCore &replace(size_type p0, size_type n0, const char *s);
+    BasicFBStringCore &replace(size_type p0, size_type n0, const Char *s);
 
     /**
      * 替换指定位置的 n0 个字符为 C 风格字符串的前 n 个字符
@@ -367,7 +467,7 @@ public:
      * @param n 替换为的字符数
      * @return 当前对象的引用
      */
-    FBStringCore &replace(size_type p0, size_type n0, const char *s, size_type n);
+    BasicFBStringCore &replace(size_type p0, size_type n0, const Char *s, size_type n);
 
     /**
      * 替换指定位置的 n 个字符为 FBStringCore 对象
@@ -376,7 +476,7 @@ public:
      * @param s 替换为的 FBStringCore 对象
      * @return 当前对象的引用
      */
-    FBStringCore &replace(size_type p0, size_type n0, const FBStringCore &s);
+    BasicFBStringCore &replace(size_type p0, size_type n0, const BasicFBStringCore &s);
 
     /**
      * 替换指定位置的 n0 个字符为 FBStringCore 对象中的部分字符
@@ -387,7 +487,7 @@ public:
      * @param n 替换为的字符数
      * @return 当前对象的引用
      */
-    FBStringCore &replace(size_type p0, size_type n0, const FBStringCore &s, size_type pos, size_type n);
+    BasicFBStringCore &replace(size_type p0, size_type n0, const BasicFBStringCore &s, size_type pos, size_type n);
 
     /**
      * 替换指定位置的 n0 个字符为 n 个字符 c
@@ -397,7 +497,7 @@ public:
      * @param c 替换为的字符
      * @return 当前对象的引用
      */
-    FBStringCore &replace(size_type p0, size_type n0, size_type n, char c);
+    BasicFBStringCore &replace(size_type p0, size_type n0, size_type n, Char c);
 
     /**
      * 替换迭代器范围内的字符为 C 风格字符串
@@ -406,7 +506,7 @@ public:
      * @param s 替换为的 C 字符串
      * @return 当前对象的引用
      */
-    FBStringCore &replace(iterator first0, iterator last0, const char *s);
+    BasicFBStringCore &replace(iterator first0, iterator last0, const Char *s);
 
     /**
      * 替换迭代器范围内的字符为 C 风格字符串的前 n 个字符
@@ -416,7 +516,7 @@ public:
      * @param n 替换为的字符数
      * @return 当前对象的引用
      */
-    FBStringCore &replace(iterator first0, iterator last0, const char *s, size_type n);
+    BasicFBStringCore &replace(iterator first0, iterator last0, const Char *s, size_type n);
 
     /**
      * 替换迭代器范围内的字符为 FBStringCore 对象
@@ -425,7 +525,7 @@ public:
      * @param s 替换为的 FBStringCore 对象
      * @return 当前对象的引用
      */
-    FBStringCore &replace(iterator first0, iterator last0, const FBStringCore &s);
+    BasicFBStringCore &replace(iterator first0, iterator last0, const BasicFBStringCore &s);
 
     /**
      * 替换迭代器范围内的字符为 n 个字符 c
@@ -435,7 +535,7 @@ public:
      * @param c 替换为的字符
      * @return 当前对象的引用
      */
-    FBStringCore &replace(iterator first0, iterator last0, size_type n, char c);
+    BasicFBStringCore &replace(iterator first0, iterator last0, size_type n, Char c);
 
     /**
      * 替换迭代器范围内的字符为另一个迭代器范围内的字符
@@ -445,13 +545,13 @@ public:
      * @param last 替换为的结束迭代器
      * @return 当前对象的引用
      */
-    FBStringCore &replace(iterator first0, iterator last0, const_iterator first, const_iterator last);
+    BasicFBStringCore &replace(iterator first0, iterator last0, const_iterator first, const_iterator last);
 
     /**
      * 交换当前字符串与另一个字符串的值
      * @param s2 要交换的字符串
      */
-    void swap(FBStringCore &s2);
+    void swap(BasicFBStringCore &s2) noexcept;
 
     /**
      * 拷贝字符串中的字符到字符数组
@@ -460,7 +560,7 @@ public:
      * @param pos 开始拷贝的位置
      * @return 实际拷贝的字符数
      */
-    size_type copy(char *s, size_type n, size_type pos = 0) const;
+    size_type copy(Char *s, size_type n, size_type pos = 0) const;
 
     /**
      * 返回子字符串
@@ -468,38 +568,52 @@ public:
      * @param n 子字符串的长度
      * @return 子字符串对象
      */
-    FBStringCore substr(size_type pos = 0, size_type n = npos) const;
+    BasicFBStringCore substr(size_type pos = 0, size_type n = npos) const;
+
+    /**
+     * 原地截取子字符串，只保留 [pos, pos + n) 的内容
+     * 独占存储时只移动保留的部分并调整大小，不分配内存；共享存储时只复制保留的部分。
+     * @param pos 子字符串的起始位置
+     * @param n 子字符串的长度，超出部分截断
+     * @return 当前对象的引用
+     * @throws out_of_range 如果 pos 大于字符串长度
+     */
+    BasicFBStringCore& substr_inplace(size_type pos, size_type n = npos);
 
     /**
      * 比较两个字符串是否相等
+     * 依次排除：大小不同、首尾字符不同、两边缓存的散列值不同（大型存储）；
+     * 共享同一缓冲区的副本不读取内容直接判定相等，其余情况用 SIMD 比较全部内容。
      * @param other 要比较的 FBStringCore 对象
      * @return 是否相等
      */
-    bool operator==(const FBStringCore& other) const;
+    bool operator==(const BasicFBStringCore& other) const;
 
     /**
      * 比较两个字符串是否不相等
      * @param other 要比较的 FBStringCore 对象
      * @return 是否不相等
      */
-    bool operator!=(const FBStringCore& other) const;
+    bool operator!=(const BasicFBStringCore& other) const;
 
     /**
      * 比较两个字符串大小
+     * 与 compare() 的顺序一致：按字符的无符号值做字典序比较，char 即 memcmp 的顺序。
      * @param other 要比较的 FBStringCore 对象
      * @return 比较结果
      */
-    bool operator<(const FBStringCore& other) const;
-    bool operator<=(const FBStringCore& other) const;
-    bool operator>(const FBStringCore& other) const;
-    bool operator>=(const FBStringCore& other) const;
+    bool operator<(const BasicFBStringCore& other) const;
+    bool operator<=(const BasicFBStringCore& other) const;
+    bool operator>(const BasicFBStringCore& other) const;
+    bool operator>=(const BasicFBStringCore& other) const;
 
     /**
      * 比较当前字符串和另一个字符串的大小
+     * 按字符的无符号值做字典序比较，char 即 memcmp 的顺序；两个 char 字符串都是小型存储时按最多 4 个大端序 64 位字比较。
      * @param s 要比较的字符串
-     * @return 比较结果
+     * @return 小于、等于、大于时分别返回负数、零、正数
      */
-    int compare(const FBStringCore& s) const;
+    int compare(const BasicFBStringCore& s) const;
 
     /**
      * 比较当前字符串的子串和另一个字符串的大小
@@ -509,7 +623,7 @@ public:
      * @param pos2 另一个子串的起始位置
      * @return 比较结果
      */
-    int compare(size_type pos, size_type n, const char *s, size_type pos2) const;
+    int compare(size_type pos, size_type n, const Char *s, size_type pos2) const;
 
     /**
      * 比较当前字符串的子串和另一个字符串的大小
@@ -517,8 +631,9 @@ public:
      * @param n 子串的长度
      * @param s 要比较的字符串
      * @return 比较结果
+     * @throws out_of_range 如果 pos 超出范围
      */
-    int compare(size_type pos, size_type n, const FBStringCore& s) const;
+    int compare(size_type pos, size_type n, const BasicFBStringCore& s) const;
 
     /**
      * 比较当前字符串的子串和另一个字符串的子串的大小
@@ -528,15 +643,16 @@ public:
      * @param pos2 另一个子串的起始位置
      * @param n2 另一个子串的长度
      * @return 比较结果
+     * @throws out_of_range 如果 pos 或 pos2 超出范围
      */
-    int compare(size_type pos, size_type n, const FBStringCore& s, size_type pos2, size_type n2) const;
+    int compare(size_type pos, size_type n, const BasicFBStringCore& s, size_type pos2, size_type n2) const;
 
     /**
      * 比较当前字符串和 C 风格字符串的大小
      * @param s 要比较的 C 字符串
      * @return 比较结果
      */
-    int compare(const char* s) const;
+    int compare(const Char* s) const;
 
     /**
      * 比较当前字符串的子串和 C 风格字符串的大小
@@ -545,7 +661,7 @@ public:
      * @param s 要比较的 C 字符串
      * @return 比较结果
      */
-    int compare(size_type pos, size_type n, const char* s) const;
+    int compare(size_type pos, size_type n, const Char* s) const;
 
     /**
      * 查找字符在字符串中的位置
@@ -553,7 +669,7 @@ public:
      * @param pos 开始查找的位置
      * @return 字符的位置或 npos
      */
-    size_type find(char c, size_type pos = 0) const;
+    size_type find(Char c, size_type pos = 0) const;
 
     /**
      * 查找 C 风格字符串在字符串中的位置
@@ -561,7 +677,7 @@ public:
      * @param pos 开始查找的位置
      * @return 字符串的位置或 npos
      */
-    size_type find(const char* s, size_type pos = 0) const;
+    size_type find(const Char* s, size_type pos = 0) const;
 
     /**
      * 查找 C 风格字符串的前 n 个字符在字符串中的位置
@@ -570,7 +686,7 @@ public:
      * @param n 要查找的字符数
      * @return 字符串的位置或 npos
      */
-    size_type find(const char* s, size_type pos, size_type n) const;
+    size_type find(const Char* s, size_type pos, size_type n) const;
 
     /**
      * 查找 FBStringCore 对象在字符串中的位置
@@ -578,7 +694,7 @@ public:
      * @param pos 开始查找的位置
      * @return 字符串的位置或 npos
      */
-    size_type find(const FBStringCore& s, size_type pos = 0) const;
+    size_type find(const BasicFBStringCore& s, size_type pos = 0) const;
 
     /**
      * 从后向前查找字符在字符串中的位置
@@ -586,7 +702,7 @@ public:
      * @param pos 开始查找的位置
      * @return 字符的位置或 npos
      */
-    size_type rfind(char c, size_type pos = npos) const;
+    size_type rfind(Char c, size_type pos = npos) const;
 
     /**
      * 从后向前查找 C 风格字符串在字符串中的位置
@@ -594,7 +710,7 @@ public:
      * @param pos 开始查找的位置
      * @return 字符串的位置或 npos
      */
-    size_type rfind(const char* s, size_type pos = npos) const;
+    size_type rfind(const Char* s, size_type pos = npos) const;
 
     /**
      * 从后向前查找 C 风格字符串的前 n 个字符在字符串中的位置
@@ -603,7 +719,7 @@ public:
      * @param n 要查找的字符数
      * @return 字符串的位置或 npos
      */
-    size_type rfind(const char* s, size_type pos, size_type n) const;
+    size_type rfind(const Char* s, size_type pos, size_type n) const;
 
     /**
      * 从后向前查找 FBStringCore 对象在字符串中的位置
@@ -611,7 +727,7 @@ public:
      * @param pos 开始查找的位置
      * @return 字符串的位置或 npos
      */
-    size_type rfind(const FBStringCore& s, size_type pos = npos) const;
+    size_type rfind(const BasicFBStringCore& s, size_type pos = npos) const;
 
     /**
      * 查找字符串中第一个出现的字符
@@ -619,7 +735,7 @@ public:
      * @param pos 开始查找的位置
      * @return 字符的位置或 npos
      */
-    size_type find_first_of(char c, size_type pos = 0) const;
+    size_type find_first_of(Char c, size_type pos = 0) const;
 
     /**
      * 查找字符串中第一个出现的 C 风格字符串
@@ -627,7 +743,7 @@ public:
      * @param pos 开始查找的位置
      * @return 字符串的位置或 npos
      */
-    size_type find_first_of(const char* s, size_type pos = 0) const;
+    size_type find_first_of(const Char* s, size_type pos = 0) const;
 
     /**
      * 查找字符串中第一个出现的 C 风格字符串的前 n 个字符
@@ -636,7 +752,7 @@ public:
      * @param n 要查找的字符数
      * @return 字符串的位置或 npos
      */
-    size_type find_first_of(const char* s, size_type pos, size_type n) const;
+    size_type find_first_of(const Char* s, size_type pos, size_type n) const;
 
     /**
      * 查找字符串中第一个出现的 FBStringCore 对象
@@ -644,7 +760,7 @@ public:
      * @param pos 开始查找的位置
      * @return 字符串的位置或 npos
      */
-    size_type find_first_of(const FBStringCore& s, size_type pos = 0) const;
+    size_type find_first_of(const BasicFBStringCore& s, size_type pos = 0) const;
 
     /**
      * 查找字符串中第一个不在指定字符集中的字符
@@ -652,7 +768,7 @@ public:
      * @param pos 开始查找的位置
      * @return 字符的位置或 npos
      */
-    size_type find_first_not_of(char c, size_type pos = 0) const;
+    size_type find_first_not_of(Char c, size_type pos = 0) const;
 
     /**
      * 查找字符串中第一个不在指定 C 风格字符串中的字符
@@ -660,7 +776,7 @@ public:
      * @param pos 开始查找的位置
      * @return 字符的位置或 npos
      */
-    size_type find_first_not_of(const char* s, size_type pos = 0) const;
+    size_type find_first_not_of(const Char* s, size_type pos = 0) const;
 
     /**
      * 查找字符串中第一个不在指定 C 风格字符串的前 n 个字符中的字符
@@ -669,7 +785,7 @@ public:
      * @param n 要排除的字符数
      * @return 字符的位置或 npos
      */
-    size_type find_first_not_of(const char* s, size_type pos, size_type n) const;
+    size_type find_first_not_of(const Char* s, size_type pos, size_type n) const;
 
     /**
      * 查找字符串中第一个不在指定 FBStringCore 对象中的字符
@@ -677,7 +793,7 @@ public:
      * @param pos 开始查找的位置
      * @return 字符的位置或 npos
      */
-    size_type find_first_not_of(const FBStringCore& s, size_type pos = 0) const;
+    size_type find_first_not_of(const BasicFBStringCore& s, size_type pos = 0) const;
 
     /**
      * 从后向前查找字符串中最后一个出现的字符
@@ -685,7 +801,7 @@ public:
      * @param pos 开始查找的位置
      * @return 字符的位置或 npos
      */
-    size_type find_last_of(char c, size_type pos = npos) const;
+    size_type find_last_of(Char c, size_type pos = npos) const;
 
     /**
      * 从后向前查找字符串中最后一个出现的 C 风格字符串
@@ -693,7 +809,7 @@ public:
      * @param pos 开始查找的位置
      * @return 字符串的位置或 npos
      */
-    size_type find_last_of(const char* s, size_type pos = npos) const;
+    size_type find_last_of(const Char* s, size_type pos = npos) const;
 
     /**
      * 从后向前查找字符串中最后一个出现的 C 风格字符串的前 n 个字符
@@ -702,7 +818,7 @@ public:
      * @param n 要查找的字符数
      * @return 字符串的位置或 npos
      */
-    size_type find_last_of(const char* s, size_type pos, size_type n) const;
+    size_type find_last_of(const Char* s, size_type pos, size_type n) const;
 
     /**
      * 从后向前查找字符串中最后一个出现的 FBStringCore 对象
@@ -710,7 +826,7 @@ public:
      * @param pos 开始查找的位置
      * @return 字符串的位置或 npos
      */
-    size_type find_last_of(const FBStringCore& s, size_type pos = npos) const;
+    size_type find_last_of(const BasicFBStringCore& s, size_type pos = npos) const;
 
     /**
      * 从后向前查找字符串中最后一个不在指定字符集中的字符
@@ -718,7 +834,7 @@ public:
      * @param pos 开始查找的位置
      * @return 字符的位置或 npos
      */
-    size_type find_last_not_of(char c, size_type pos = npos) const;
+    size_type find_last_not_of(Char c, size_type pos = npos) const;
 
     /**
      * 从后向前查找字符串中最后一个不在指定 C 风格字符串中的字符
@@ -726,7 +842,7 @@ public:
      * @param pos 开始查找的位置
      * @return 字符的位置或 npos
      */
-    size_type find_last_not_of(const char* s, size_type pos = npos) const;
+    size_type find_last_not_of(const Char* s, size_type pos = npos) const;
 
     /**
      * 从后向前查找字符串中最后一个不在指定 C 风格字符串的前 n 个字符中的字符
@@ -735,7 +851,7 @@ public:
      * @param n 要排除的字符数
      * @return 字符的位置或 npos
      */
-    size_type find_last_not_of(const char* s, size_type pos, size_type n) const;
+    size_type find_last_not_of(const Char* s, size_type pos, size_type n) const;
 
     /**
      * 从后向前查找字符串中最后一个不在指定 FBStringCore 对象中的字符
@@ -743,7 +859,7 @@ public:
      * @param pos 开始查找的位置
      * @return 字符的位置或 npos
      */
-    size_type find_last_not_of(const FBStringCore& s, size_type pos = npos) const;
+    size_type find_last_not_of(const BasicFBStringCore& s, size_type pos = npos) const;
 
     /**
      * 返回字符串的大小
@@ -777,6 +893,7 @@ public:
 
     /**
      * 返回字符串的起始位置迭代器
+     * 返回可写的迭代器，存储被共享时先解除共享；end()、rbegin()、rend() 同理。
      * @return 起始位置迭代器
      */
     iterator begin();
@@ -823,31 +940,6 @@ public:
      */
     const_reverse_iterator rend() const;
 
-    /**
-     * 输入操作符重载
-     * @param in 输入流
-     * @param s 字符串对象
-     * @return 输入流
-     */
-    friend std::istream& operator>>(std::istream& in, FBStringCore& s);
-
-    /**
-     * 输出操作符重载
-     * @param out 输出流
-     * @param s 字符串对象
-     * @return 输出流
-     */
-    friend std::ostream& operator<<(std::ostream& out, const FBStringCore& s);
-
-    /**
-     * 从输入流中读取字符串
-     * @param in 输入流
-     * @param s 字符串对象
-     * @param delim 分隔符
-     * @return 输入流
-     */
-    friend std::istream& getline(std::istream& in, FBStringCore& s, char delim);
-
 private:
     /** 存储字符串类型枚举 */
     enum class StorageType {
@@ -856,12 +948,26 @@ private:
         Large
     };
 
+    /** 中大型存储的共享头部，由共享同一缓冲区的所有实例共用 */
+    struct SharedHeader {
+        std::atomic<size_type> refCount; /**< 引用计数 */
+        std::atomic<unsigned> flags;     /**< 只读缓存的状态标志，内容可能被修改时清零 */
+        std::atomic<size_t> hash;        /**< 缓存的散列值，flags 含 kHashCached 时有效 */
+
+        SharedHeader() : refCount(1), flags(0), hash(0) {}
+    };
+
+    /** 缓存标志 */
+    static const unsigned kEncodingChecked = 1u << 0; /**< 已检查过编码合法性 */
+    static const unsigned kEncodingValid = 1u << 1;   /**< 内容是合法的编码 */
+    static const unsigned kHashCached = 1u << 2;      /**< 已缓存散列值 */
+
     /** 中大型存储结构 */
     struct MediumLarge {
-        char* data_;
+        Char* data_;
         size_type size_;
         size_type capacity_;
-        std::atomic<size_type>* refCount_;
+        SharedHeader* header_;
 
         /** 返回容量 */
         size_type capacity() const;
@@ -870,26 +976,36 @@ private:
         void setCapacity(size_type cap, StorageType type);
     };
 
+    /**
+     * 小型存储：数组的最后一个字符保存剩余容量，之前的位置存放内容和结尾的 null 字符
+     * 数组占满整个存储联合体，即 MediumLarge 的大小（64 位平台上 32 字节），至少 24 字节。
+     */
+    static const size_type kSmallArraySize = (sizeof(MediumLarge) > 24 ? sizeof(MediumLarge) : 24) / sizeof(Char);
+    static const size_type kMaxSmallSize = kSmallArraySize - 2;
+
     /** 存储联合体 */
     union Storage {
-        char small_[24];
+        Char small_[kSmallArraySize];
         MediumLarge ml_;
     };
 
     Storage storage_; /**< 存储联合体实例 */
     StorageType type_; /**< 当前存储类型 */
 
+    /** 初始化为空字符串 */
+    void initEmpty();
+
     /** 初始化小型存储 */
-    void initSmall(const char* str, size_type size);
+    void initSmall(const Char* str, size_type size);
 
     /** 初始化中型存储 */
-    void initMedium(const char* str, size_type size);
+    void initMedium(const Char* str, size_type size);
 
     /** 初始化大型存储 */
-    void initLarge(const char* str, size_type size);
+    void initLarge(const Char* str, size_type size);
 
     /** 从另一个实例复制 */
-    void copyFrom(const FBStringCore& other);
+    void copyFrom(const BasicFBStringCore& other);
 
     /** 销毁当前存储 */
     void destroy();
@@ -897,11 +1013,20 @@ private:
     /** 解除共享 */
     void unshare();
 
+    /** 返回可写的数据指针（必要时先解除共享，并清除只读缓存） */
+    Char* mutableData();
+
+    /** 设置字符串大小并写入结尾的 null 字符（要求当前对象独占存储） */
+    void setSize(size_type newSize);
+
     /** 分配内存 */
-    char* allocate(size_type size);
+    Char* allocate(size_type size);
+
+    /** 分配新的共享头部，引用计数为 1 */
+    static SharedHeader* newHeader();
 
     /** 释放内存 */
-    void deallocate(char* ptr);
+    void deallocate(Char* ptr);
 
     /** 确定存储类型 */
     StorageType determineType(size_type size) const;
@@ -912,6 +1037,15 @@ private:
     /** 返回小型存储的大小 */
     size_type smallSize() const;
 
+    /** 两个大型存储都缓存了散列值且不同时返回 true，此时内容一定不同 */
+    bool cachedHashesDiffer(const BasicFBStringCore& other) const;
+
+    /** 按字符的无符号值比较两段字符序列，返回负数、零或正数 */
+    static int compareChars(const Char* a, size_type n1, const Char* b, size_type n2);
+
+    /** 比较两个小型存储的 char 字符串：每次读取一个 64 位字，按大端序比较公共长度内的字节，最多 4 个字 */
+    int compareSmall(const BasicFBStringCore& other) const;
+
     /** 返回容量 */
     size_type capacityImpl() const;
 
@@ -930,4 +1064,54 @@ private:
 
 };
 
+// 调整大小，并由 op 直接写入存储
+template <typename Char>
+template <typename Operation>
+void BasicFBStringCore<Char>::resize_and_overwrite(size_type n, Operation op) {
+    reserve(n);
+    Char* p = mutableData();
+    size_type newSize = static_cast<size_type>(op(p, n));
+    assert(newSize <= n);
+    setSize(newSize);
+}
+
+typedef BasicFBStringCore<char> FBStringCore;
+typedef BasicFBStringCore<char16_t> FBStringCore16;
+typedef BasicFBStringCore<char32_t> FBStringCore32;
+
+/**
+ * 输入操作符重载
+ * @param in 输入流
+ * @param s 字符串对象
+ * @return 输入流
+ */
+std::istream& operator>>(std::istream& in, FBStringCore& s);
+
+/**
+ * 输出操作符重载
+ * @param out 输出流
+ * @param s 字符串对象
+ * @return 输出流
+ */
+std::ostream& operator<<(std::ostream& out, const FBStringCore& s);
+
+/**
+ * 从输入流中读取字符串
+ * @param in 输入流
+ * @param s 字符串对象
+ * @param delim 分隔符
+ * @return 输入流
+ */
+std::istream& getline(std::istream& in, FBStringCore& s, char delim);
+
+namespace std {
+// 使 FBStringCore 可以直接作为无序容器的键
+template <typename Char>
+struct hash<BasicFBStringCore<Char>> {
+    size_t operator()(const BasicFBStringCore<Char>& s) const {
+        return s.hash();
+    }
+};
+} // namespace std
+
 #endif // FBSTRING_CORE_H
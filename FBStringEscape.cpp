@@ -0,0 +1,367 @@
+#include "FBStringEscape.h"
+#include "FBStringSimd.h"
+#include <cstring>
+#include <functional>
+
+static const char kHexUpper[] = "0123456789ABCDEF";
+static const char kHexLower[] = "0123456789abcdef";
+static const ptrdiff_t kDenseWindow = 16; // 找到需要转义的字节后逐字节处理的长度
+
+// 各格式的扫描集合以及每个字节转义后的长度
+struct FBEscapeTables {
+    FBByteSet json;          /**< JSON 中需要转义的字节 */
+    FBByteSet html;          /**< HTML 中需要转义的字节 */
+    FBByteSet urlUnreserved; /**< 百分号编码中不需要编码的字节；它比需要编码的集合小得多，查表是精确的 */
+    unsigned char length[3][256];
+
+    FBEscapeTables()
+        : json(jsonChars()),
+          html("&<>\"'"),
+          urlUnreserved("ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-._~") {
+        for (int c = 0; c < 256; ++c) {
+            const char ch = static_cast<char>(c);
+            length[0][c] = static_cast<unsigned char>(json.contains(ch) ? (c < 0x20 && !shortJsonEscape(ch) ? 6 : 2) : 1);
+            length[1][c] = 1;
+            length[2][c] = static_cast<unsigned char>(urlUnreserved.contains(ch) ? 1 : 3);
+        }
+        length[1][static_cast<unsigned char>('&')] = 5;  // &amp;
+        length[1][static_cast<unsigned char>('<')] = 4;  // &lt;
+        length[1][static_cast<unsigned char>('>')] = 4;  // &gt;
+        length[1][static_cast<unsigned char>('"')] = 6;  // &quot;
+        length[1][static_cast<unsigned char>('\'')] = 5; // &#39;
+    }
+
+    // 控制字符 0x00 ~ 0x1F 以及 " 和 '\'
+    static FBStringView jsonChars() {
+        static const char chars[] = "\x01\x02\x03\x04\x05\x06\x07\x08\x09\x0A\x0B\x0C\x0D\x0E\x0F"
+                                    "\x10\x11\x12\x13\x14\x15\x16\x17\x18\x19\x1A\x1B\x1C\x1D\x1E\x1F\"\\";
+        // 末尾的 '\0' 也属于集合
+        return FBStringView(chars, sizeof(chars));
+    }
+
+    // 有两字符简写形式的 JSON 转义
+    static char shortJsonEscape(char c) {
+        switch (c) {
+            case '"': return '"';
+            case '\\': return '\\';
+            case '\b': return 'b';
+            case '\f': return 'f';
+            case '\n': return 'n';
+            case '\r': return 'r';
+            case '\t': return 't';
+            default: return 0;
+        }
+    }
+};
+
+// 扫描表只在第一次使用时构造
+static const FBEscapeTables& escapeTables() {
+    static const FBEscapeTables tables;
+    return tables;
+}
+
+// 查找下一个需要转义的字节
+static inline const char* nextSpecial(const char* first, const char* last, FBEscapeFormat format, const FBEscapeTables& tables) {
+    switch (format) {
+        case FBEscapeFormat::Json: return FBStringSimd::findAny(first, last, tables.json);
+        case FBEscapeFormat::Html: return FBStringSimd::findAny(first, last, tables.html);
+        default: return FBStringSimd::skipLeading(first, last, tables.urlUnreserved);
+    }
+}
+
+// 写入一个字节的转义形式，返回写入后的位置
+static inline char* writeEscape(char* out, char c, FBEscapeFormat format) {
+    const unsigned char u = static_cast<unsigned char>(c);
+    if (format == FBEscapeFormat::Json) {
+        const char shortForm = FBEscapeTables::shortJsonEscape(c);
+        *out++ = '\\';
+        if (shortForm != 0) {
+            *out++ = shortForm;
+        } else {
+            std::memcpy(out, "u00", 3);
+            out[3] = kHexLower[u >> 4];
+            out[4] = kHexLower[u & 0xF];
+            out += 5;
+        }
+        return out;
+    }
+    if (format == FBEscapeFormat::Url) {
+        out[0] = '%';
+        out[1] = kHexUpper[u >> 4];
+        out[2] = kHexUpper[u & 0xF];
+        return out + 3;
+    }
+    const char* entity;
+    size_t length;
+    switch (c) {
+        case '&': entity = "&amp;"; length = 5; break;
+        case '<': entity = "&lt;"; length = 4; break;
+        case '>': entity = "&gt;"; length = 4; break;
+        case '"': entity = "&quot;"; length = 6; break;
+        default: entity = "&#39;"; length = 5; break;
+    }
+    std::memcpy(out, entity, length);
+    return out + length;
+}
+
+// 十六进制数字的值，不是十六进制数字返回 -1
+static inline int hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// 解析 4 个十六进制数字，不合法返回 false
+static inline bool parseHex4(const char* p, char32_t& value) {
+    value = 0;
+    for (int i = 0; i < 4; ++i) {
+        const int d = hexValue(p[i]);
+        if (d < 0) return false;
+        value = (value << 4) | static_cast<char32_t>(d);
+    }
+    return true;
+}
+
+// 写入一个码点的 UTF-8 编码，返回写入后的位置
+static inline char* encodeUtf8(char* out, char32_t cp) {
+    if (cp < 0x80) {
+        *out++ = static_cast<char>(cp);
+    } else if (cp < 0x800) {
+        *out++ = static_cast<char>(0xC0 | (cp >> 6));
+        *out++ = static_cast<char>(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        *out++ = static_cast<char>(0xE0 | (cp >> 12));
+        *out++ = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        *out++ = static_cast<char>(0x80 | (cp & 0x3F));
+    } else {
+        *out++ = static_cast<char>(0xF0 | (cp >> 18));
+        *out++ = static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+        *out++ = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        *out++ = static_cast<char>(0x80 | (cp & 0x3F));
+    }
+    return out;
+}
+
+// 解码 p 处（指向 '\'）的 JSON 转义序列，返回序列之后的位置，不合法返回 nullptr
+static const char* unescapeJson(const char* p, const char* last, char*& out) {
+    if (last - p < 2) return nullptr;
+    switch (p[1]) {
+        case '"': *out++ = '"'; return p + 2;
+        case '\\': *out++ = '\\'; return p + 2;
+        case '/': *out++ = '/'; return p + 2;
+        case 'b': *out++ = '\b'; return p + 2;
+        case 'f': *out++ = '\f'; return p + 2;
+        case 'n': *out++ = '\n'; return p + 2;
+        case 'r': *out++ = '\r'; return p + 2;
+        case 't': *out++ = '\t'; return p + 2;
+        case 'u': break;
+        default: return nullptr;
+    }
+    char32_t cp;
+    if (last - p < 6 || !parseHex4(p + 2, cp)) return nullptr;
+    p += 6;
+    if (cp >= 0xDC00 && cp <= 0xDFFF) return nullptr;
+    if (cp >= 0xD800 && cp <= 0xDBFF) {
+        // 高代理项后面必须紧跟 \u 形式的低代理项
+        char32_t low;
+        if (last - p < 6 || p[0] != '\\' || p[1] != 'u' || !parseHex4(p + 2, low) || low < 0xDC00 || low > 0xDFFF) {
+            return nullptr;
+        }
+        cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+        p += 6;
+    }
+    out = encodeUtf8(out, cp);
+    return p;
+}
+
+// 解码 p 处（指向 '&'）的 HTML 字符引用，返回引用之后的位置；无法识别时原样写出 '&'
+static const char* unescapeHtml(const char* p, const char* last, char*& out) {
+    // 最长的可识别引用是 &#x10FFFF; 和 &#1114111;，只在这个范围内找 ';'
+    const char* limit = last - p > 11 ? p + 11 : last;
+    const char* semicolon = static_cast<const char*>(std::memchr(p + 1, ';', limit - (p + 1)));
+    if (semicolon != nullptr) {
+        const char* name = p + 1;
+        const size_t length = static_cast<size_t>(semicolon - name);
+        struct Entity { const char* name; size_t length; char value; };
+        static const Entity entities[] = {{"amp", 3, '&'}, {"lt", 2, '<'}, {"gt", 2, '>'}, {"quot", 4, '"'}, {"apos", 4, '\''}};
+        for (size_t i = 0; i < sizeof(entities) / sizeof(entities[0]); ++i) {
+            if (length == entities[i].length && std::memcmp(name, entities[i].name, length) == 0) {
+                *out++ = entities[i].value;
+                return semicolon + 1;
+            }
+        }
+        if (length >= 2 && name[0] == '#') {
+            const bool hex = name[1] == 'x' || name[1] == 'X';
+            const char* digits = name + (hex ? 2 : 1);
+            char32_t cp = 0;
+            bool valid = digits < semicolon;
+            for (const char* d = digits; valid && d < semicolon; ++d) {
+                const int v = hex ? hexValue(*d) : (*d >= '0' && *d <= '9' ? *d - '0' : -1);
+                valid = v >= 0;
+                cp = cp * (hex ? 16 : 10) + static_cast<char32_t>(v);
+                valid = valid && cp <= 0x10FFFF;
+            }
+            if (valid && cp != 0 && !(cp >= 0xD800 && cp <= 0xDFFF)) {
+                out = encodeUtf8(out, cp);
+                return semicolon + 1;
+            }
+        }
+    }
+    *out++ = '&';
+    return p + 1;
+}
+
+// 计算转义后的长度
+size_t FBStringEscape::escapedLength(const char* data, size_t n, FBEscapeFormat format) {
+    const FBEscapeTables& tables = escapeTables();
+    const unsigned char* lengths = tables.length[static_cast<int>(format)];
+    const char* last = data + n;
+    size_t total = n;
+    const char* p = nextSpecial(data, last, format, tables);
+    while (p != last) {
+        // 需要转义的字节往往成片出现：找到一个之后，对其后的一小段直接查表累加，再回到 SIMD 扫描
+        const char* windowEnd = last - p > kDenseWindow ? p + kDenseWindow : last;
+        for (; p != windowEnd; ++p) {
+            total += lengths[static_cast<unsigned char>(*p)] - 1;
+        }
+        p = nextSpecial(p, last, format, tables);
+    }
+    return total;
+}
+
+// 转义
+char* FBStringEscape::escape(char* out, const char* data, size_t n, FBEscapeFormat format) {
+    const FBEscapeTables& tables = escapeTables();
+    const unsigned char* lengths = tables.length[static_cast<int>(format)];
+    const char* p = data;
+    const char* last = data + n;
+    while (p != last) {
+        const char* special = nextSpecial(p, last, format, tables);
+        std::memcpy(out, p, special - p);
+        out += special - p;
+        p = special;
+        const char* windowEnd = last - p > kDenseWindow ? p + kDenseWindow : last;
+        if (format == FBEscapeFormat::Url) {
+            // 每个字节都写出 3 个字节，再按实际长度前进，不做分支；
+            // 后面至少还有两个输入字节时，多写的两个字节仍在输出范围内，之后会被覆盖
+            for (; p != windowEnd && last - p > 2; ++p) {
+                const unsigned char c = static_cast<unsigned char>(*p);
+                out[0] = lengths[c] == 1 ? static_cast<char>(c) : '%';
+                out[1] = kHexUpper[c >> 4];
+                out[2] = kHexUpper[c & 0xF];
+                out += lengths[c];
+            }
+        }
+        for (; p != windowEnd; ++p) {
+            if (lengths[static_cast<unsigned char>(*p)] == 1) {
+                *out++ = *p;
+            } else {
+                out = writeEscape(out, *p, format);
+            }
+        }
+    }
+    return out;
+}
+
+// 反转义
+char* FBStringEscape::unescape(char* out, const char* data, size_t n, FBEscapeFormat format) {
+    const char marker = format == FBEscapeFormat::Json ? '\\' : format == FBEscapeFormat::Html ? '&' : '%';
+    const char* p = data;
+    const char* last = data + n;
+    while (true) {
+        const char* special = FBStringSimd::find(p, last, marker);
+        std::memmove(out, p, special - p);
+        out += special - p;
+        if (special == last) return out;
+        if (format == FBEscapeFormat::Json) {
+            p = unescapeJson(special, last, out);
+            if (p == nullptr) return nullptr;
+        } else if (format == FBEscapeFormat::Html) {
+            p = unescapeHtml(special, last, out);
+        } else {
+            const int hi = last - special >= 3 ? hexValue(special[1]) : -1;
+            const int lo = hi >= 0 ? hexValue(special[2]) : -1;
+            if (lo < 0) return nullptr;
+            *out++ = static_cast<char>((hi << 4) | lo);
+            p = special + 3;
+        }
+    }
+}
+
+// 扩展 out 的存储；data 可能指向 out 自身，扩容后需按偏移量重新定位
+static char* expandFor(FBString& out, size_t delta, const char*& data, size_t n) {
+    const char* oldData = out.c_str();
+    const bool aliased = std::less_equal<const char*>()(oldData, data) && std::less<const char*>()(data, oldData + out.size()) && n > 0;
+    const size_t offset = aliased ? static_cast<size_t>(data - oldData) : 0;
+    char* p = out.expand_noinit(delta);
+    if (aliased) data = out.c_str() + offset;
+    return p;
+}
+
+// 转义并追加
+void append_escaped(FBString& out, FBStringView data, FBEscapeFormat format) {
+    const size_t length = FBStringEscape::escapedLength(data.data(), data.size(), format);
+    const char* in = data.data();
+    char* p = expandFor(out, length, in, data.size());
+    if (length == data.size()) {
+        std::memcpy(p, in, length);
+    } else {
+        FBStringEscape::escape(p, in, data.size(), format);
+    }
+}
+
+// 反转义并追加；结果不会比输入长，先按输入长度扩展，结束后截去多余部分
+void append_unescaped(FBString& out, FBStringView data, FBEscapeFormat format) {
+    const size_t oldSize = out.size();
+    const char* in = data.data();
+    char* begin = expandFor(out, data.size(), in, data.size());
+    char* end = FBStringEscape::unescape(begin, in, data.size(), format);
+    if (end == nullptr) {
+        out.resize(oldSize);
+        throw std::invalid_argument(format == FBEscapeFormat::Json ? "Invalid JSON escape" : "Invalid percent-encoding");
+    }
+    out.resize(oldSize + (end - begin));
+}
+
+// JSON 转义
+FBString json_escape(FBStringView data) {
+    FBString result;
+    append_escaped(result, data, FBEscapeFormat::Json);
+    return result;
+}
+
+// JSON 反转义
+FBString json_unescape(FBStringView data) {
+    FBString result;
+    append_unescaped(result, data, FBEscapeFormat::Json);
+    return result;
+}
+
+// HTML 转义
+FBString html_escape(FBStringView data) {
+    FBString result;
+    append_escaped(result, data, FBEscapeFormat::Html);
+    return result;
+}
+
+// HTML 反转义
+FBString html_unescape(FBStringView data) {
+    FBString result;
+    append_unescaped(result, data, FBEscapeFormat::Html);
+    return result;
+}
+
+// 百分号编码
+FBString url_encode(FBStringView data) {
+    FBString result;
+    append_escaped(result, data, FBEscapeFormat::Url);
+    return result;
+}
+
+// 百分号解码
+FBString url_decode(FBStringView data) {
+    FBString result;
+    append_unescaped(result, data, FBEscapeFormat::Url);
+    return result;
+}
@@ -0,0 +1,94 @@
+#ifndef FBSTRING_ESCAPE_H
+#define FBSTRING_ESCAPE_H
+
+#include "FBString.h"
+#include "FBStringView.h"
+#include <stdexcept>
+
+// 转义格式
+enum class FBEscapeFormat {
+    Json, /**< JSON 字符串：转义 "、\ 和控制字符，其余字节（包括 UTF-8 多字节序列）原样保留 */
+    Html, /**< HTML 文本与属性值：转义 &、<、>、"、' */
+    Url   /**< 百分号编码（RFC 3986）：A-Z a-z 0-9 - . _ ~ 以外的字节都编码为 %XX */
+};
+
+// FBStringEscape 提供转义与反转义内核：用 SIMD 扫描找到下一个需要处理的字节，中间不需要处理的部分整段复制
+class FBStringEscape {
+public:
+    /**
+     * 计算转义后的长度
+     * @param data 输入
+     * @param n 输入字节数
+     * @param format 转义格式
+     * @return 转义后的字节数
+     */
+    static size_t escapedLength(const char* data, size_t n, FBEscapeFormat format);
+
+    /**
+     * 转义
+     * @param out 输出位置，至少有 escapedLength(data, n, format) 个字节可写
+     * @param data 输入
+     * @param n 输入字节数
+     * @param format 转义格式
+     * @return 写入结束的位置
+     */
+    static char* escape(char* out, const char* data, size_t n, FBEscapeFormat format);
+
+    /**
+     * 反转义，结果不会比输入长
+     * JSON 的 \uXXXX（包括代理项对）解码为 UTF-8；HTML 识别 &amp; &lt; &gt; &quot; &apos; 和数字字符引用，
+     * 无法识别的实体原样保留。
+     * @param out 输出位置，至少有 n 个字节可写；可以与 data 相同，即原地反转义
+     * @param data 输入
+     * @param n 输入字节数
+     * @param format 转义格式
+     * @return 写入结束的位置；输入不合法时返回 nullptr，此时输出内容未定义
+     */
+    static char* unescape(char* out, const char* data, size_t n, FBEscapeFormat format);
+};
+
+/**
+ * 转义并追加到 out 末尾
+ * 先扫描一遍算出精确长度，一次扩展 out 的存储后再写入；没有需要转义的字节时直接整段追加。
+ * @param out 目标字符串
+ * @param data 要转义的数据，可以指向 out 自身
+ * @param format 转义格式
+ */
+void append_escaped(FBString& out, FBStringView data, FBEscapeFormat format);
+
+/**
+ * 反转义并追加到 out 末尾
+ * @param out 目标字符串；抛出异常时保持不变
+ * @param data 要反转义的数据，可以指向 out 自身
+ * @param format 转义格式
+ * @throws invalid_argument 如果 JSON 转义序列或百分号编码不合法
+ */
+void append_unescaped(FBString& out, FBStringView data, FBEscapeFormat format);
+
+/**
+ * JSON 字符串转义与反转义（不含两端的引号）
+ * @param data 输入
+ * @return 结果
+ * @throws invalid_argument 反转义时，如果转义序列不合法或包含不成对的代理项
+ */
+FBString json_escape(FBStringView data);
+FBString json_unescape(FBStringView data);
+
+/**
+ * HTML 转义与反转义
+ * @param data 输入
+ * @return 结果
+ */
+FBString html_escape(FBStringView data);
+FBString html_unescape(FBStringView data);
+
+/**
+ * 百分号编码与解码；'+' 不视为空格
+ * @param data 输入
+ * @return 结果
+ * @throws invalid_argument 解码时，如果 % 后面不是两个十六进制数字
+ */
+FBString url_encode(FBStringView data);
+FBString url_decode(FBStringView data);
+
+#endif // FBSTRING_ESCAPE_H
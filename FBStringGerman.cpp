@@ -0,0 +1,167 @@
+#include "FBStringGerman.h"
+#include "FBStringSimd.h"
+#include <cstring>
+#include <stdexcept>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <stdlib.h>
+#endif
+
+static_assert(sizeof(FBGermanString) == 16, "FBGermanString must be 16 bytes");
+
+const size_t FBGermanString::kInlineSize;
+const size_t FBGermanString::kPrefixSize;
+
+// 按大端序读取 4、8 个字节，使整数的大小顺序就是字节的无符号顺序
+static inline uint32_t loadBigEndian32(const void* p) {
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+#if !(defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+#if defined(_MSC_VER) && !defined(__clang__)
+    v = _byteswap_ulong(v);
+#else
+    v = __builtin_bswap32(v);
+#endif
+#endif
+    return v;
+}
+
+static inline uint64_t loadBigEndian64(const void* p) {
+    uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+#if !(defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+#if defined(_MSC_VER) && !defined(__clang__)
+    v = _byteswap_uint64(v);
+#else
+    v = __builtin_bswap64(v);
+#endif
+#endif
+    return v;
+}
+
+// 默认构造函数
+FBGermanString::FBGermanString() : size_(0) {
+    std::memset(chars_, 0, sizeof(chars_));
+}
+
+// 短内容整个复制到对象内部，长内容复制前缀并保存指针
+FBGermanString::FBGermanString(FBStringView str) {
+    if (static_cast<uint64_t>(str.size()) > UINT32_MAX) {
+        throw std::length_error("String too long for FBGermanString");
+    }
+    size_ = static_cast<uint32_t>(str.size());
+    std::memset(chars_, 0, sizeof(chars_));
+    if (size_ <= kInlineSize) {
+        if (size_ != 0) std::memcpy(chars_, str.data(), size_);
+    } else {
+        const char* data = str.data();
+        std::memcpy(chars_, data, kPrefixSize);
+        std::memcpy(chars_ + kPrefixSize, &data, sizeof(data));
+    }
+}
+
+// 读取指针
+const char* FBGermanString::pointer() const {
+    const char* data;
+    std::memcpy(&data, chars_ + kPrefixSize, sizeof(data));
+    return data;
+}
+
+// 返回数据指针
+const char* FBGermanString::data() const {
+    return size_ <= kInlineSize ? chars_ : pointer();
+}
+
+// 返回大小
+size_t FBGermanString::size() const {
+    return size_;
+}
+
+// 是否为空
+bool FBGermanString::empty() const {
+    return size_ == 0;
+}
+
+// 是否保存在对象内部
+bool FBGermanString::is_inline() const {
+    return size_ <= kInlineSize;
+}
+
+// 前缀：不足 4 个字节的部分是 0
+uint32_t FBGermanString::prefix() const {
+    return loadBigEndian32(chars_);
+}
+
+// 视图
+FBStringView FBGermanString::view() const {
+    return FBStringView(data(), size_);
+}
+
+FBGermanString::operator FBStringView() const {
+    return view();
+}
+
+// 复制为 FBString
+FBString FBGermanString::str() const {
+    return FBString(data(), size_);
+}
+
+// 比较：未使用的字节是 0，不小于任何实际的字节，所以补零后按字比较的结果与逐字节比较再比较长度一致
+int FBGermanString::compare(const FBGermanString& other) const {
+    const uint32_t a = prefix();
+    const uint32_t b = other.prefix();
+    if (a != b) return a < b ? -1 : 1;
+    const size_t n = size_ < other.size_ ? size_ : other.size_;
+    if (n > kPrefixSize) {
+        if (size_ <= kInlineSize && other.size_ <= kInlineSize) {
+            const uint64_t x = loadBigEndian64(chars_ + kPrefixSize);
+            const uint64_t y = loadBigEndian64(other.chars_ + kPrefixSize);
+            if (x != y) return x < y ? -1 : 1;
+        } else {
+            const int result = std::memcmp(data() + kPrefixSize, other.data() + kPrefixSize, n - kPrefixSize);
+            if (result != 0) return result;
+        }
+    }
+    return size_ < other.size_ ? -1 : (size_ > other.size_ ? 1 : 0);
+}
+
+// 散列值
+size_t FBGermanString::hash() const {
+    return static_cast<size_t>(FBStringHash::hash(data(), size_));
+}
+
+// 相等比较：第一个字是长度和前缀；短字符串的第二个字就是其余内容，长字符串比较前缀之后的部分
+bool operator==(const FBGermanString& lhs, const FBGermanString& rhs) {
+    uint64_t a, b;
+    std::memcpy(&a, &lhs, sizeof(a));
+    std::memcpy(&b, &rhs, sizeof(b));
+    if (a != b) return false;
+    if (lhs.size_ <= FBGermanString::kInlineSize) {
+        std::memcpy(&a, lhs.chars_ + FBGermanString::kPrefixSize, sizeof(a));
+        std::memcpy(&b, rhs.chars_ + FBGermanString::kPrefixSize, sizeof(b));
+        return a == b;
+    }
+    const char* x = lhs.pointer();
+    const char* y = rhs.pointer();
+    return x == y || FBStringSimd::equal(x + FBGermanString::kPrefixSize, y + FBGermanString::kPrefixSize, lhs.size_ - FBGermanString::kPrefixSize);
+}
+
+bool operator!=(const FBGermanString& lhs, const FBGermanString& rhs) {
+    return !(lhs == rhs);
+}
+
+bool operator<(const FBGermanString& lhs, const FBGermanString& rhs) {
+    return lhs.compare(rhs) < 0;
+}
+
+bool operator<=(const FBGermanString& lhs, const FBGermanString& rhs) {
+    return lhs.compare(rhs) <= 0;
+}
+
+bool operator>(const FBGermanString& lhs, const FBGermanString& rhs) {
+    return lhs.compare(rhs) > 0;
+}
+
+bool operator>=(const FBGermanString& lhs, const FBGermanString& rhs) {
+    return lhs.compare(rhs) >= 0;
+}
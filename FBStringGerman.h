@@ -0,0 +1,135 @@
+#ifndef FBSTRING_GERMAN_H
+#define FBSTRING_GERMAN_H
+
+#include "FBString.h"
+#include "FBStringView.h"
+#include "FBStringHash.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+// FBGermanString 是 16 字节的紧凑字符串句柄（Umbra / DuckDB 的 "German string" 布局），适合列式存储中大量字符串的比较和排序
+// 前 4 个字节是长度，接着 4 个字节是内容的前缀；不超过 12 个字符的内容整个保存在对象内部（前缀之后的 8 个字节），
+// 更长的内容在后 8 个字节保存指向完整内容的指针。对象内部未使用的字节都是 0。
+// 大多数比较只看长度和前缀就能得出结果，不需要解引用指针；短字符串的比较和相等判断完全不访问外部内存。
+// 长字符串不拥有内容：指向的存储（例如 FBStringTable、FBString 或列缓冲区）必须比句柄活得更久且不被修改。
+class FBGermanString {
+public:
+    static const size_t kInlineSize = 12; /**< 保存在对象内部的最大字符数 */
+    static const size_t kPrefixSize = 4;  /**< 前缀的字节数 */
+
+    /**
+     * 默认构造函数
+     * 构造空字符串。
+     */
+    FBGermanString();
+
+    /**
+     * 引用一段内容
+     * 不超过 kInlineSize 个字符时复制到对象内部，否则只复制前缀并保存指针。
+     * FBString 可以直接传入；长字符串指向它的缓冲区，小型存储的内容在 FBString 对象内部，这时 FBString 本身也不能移动。
+     * @param str 内容
+     * @throws std::length_error 如果长度不小于 2^32
+     */
+    explicit FBGermanString(FBStringView str);
+
+    /**
+     * 返回数据指针，不保证以 null 结尾
+     * @return 指向第一个字符的指针
+     */
+    const char* data() const;
+
+    /**
+     * 返回字符串大小
+     * @return 字符个数
+     */
+    size_t size() const;
+
+    /**
+     * 判断是否为空字符串
+     * @return 为空返回 true
+     */
+    bool empty() const;
+
+    /**
+     * 判断内容是否保存在对象内部
+     * @return 不超过 kInlineSize 个字符时返回 true
+     */
+    bool is_inline() const;
+
+    /**
+     * 返回前 4 个字节按大端序组成的整数，不足 4 个字节时低位补 0
+     * 整数的大小顺序与内容前缀的无符号字节顺序一致，可以直接作为排序或分桶的键。
+     * @return 前缀
+     */
+    uint32_t prefix() const;
+
+    /**
+     * 返回内容的视图
+     * @return 视图
+     */
+    FBStringView view() const;
+
+    /**
+     * 转换为视图
+     */
+    operator FBStringView() const;
+
+    /**
+     * 复制为 FBString
+     * @return 字符串
+     */
+    FBString str() const;
+
+    /**
+     * 按无符号字节的字典序比较，与 FBString 和 FBStringView 的比较一致
+     * 前缀不同时只比较前缀；两个都保存在对象内部时比较对象内的两个字，不调用 memcmp。
+     * @param other 要比较的字符串
+     * @return 小于、等于、大于时分别返回负数、0、正数
+     */
+    int compare(const FBGermanString& other) const;
+
+    /**
+     * 计算散列值，与内容相同的 FBString、FBStringView 一致
+     * @return 散列值
+     */
+    size_t hash() const;
+
+private:
+    uint32_t size_;          /**< 字符个数 */
+    char chars_[kInlineSize]; /**< 前 4 个字节是前缀；短字符串接着保存其余内容，长字符串接着保存指针；未使用的字节为 0 */
+
+    /**
+     * 读取长字符串的指针
+     * @return 指向完整内容的指针
+     */
+    const char* pointer() const;
+
+    friend bool operator==(const FBGermanString& lhs, const FBGermanString& rhs);
+};
+
+/**
+ * 比较运算符
+ * 相等比较先比较长度和前缀组成的第一个字，短字符串再比较第二个字，长字符串指针相同时不比较内容。
+ * @param lhs 左操作数
+ * @param rhs 右操作数
+ * @return 比较结果
+ */
+bool operator==(const FBGermanString& lhs, const FBGermanString& rhs);
+bool operator!=(const FBGermanString& lhs, const FBGermanString& rhs);
+bool operator<(const FBGermanString& lhs, const FBGermanString& rhs);
+bool operator<=(const FBGermanString& lhs, const FBGermanString& rhs);
+bool operator>(const FBGermanString& lhs, const FBGermanString& rhs);
+bool operator>=(const FBGermanString& lhs, const FBGermanString& rhs);
+
+namespace std {
+// 与 FBString::hash() 结果一致
+template <>
+struct hash<FBGermanString> {
+    size_t operator()(const FBGermanString& str) const {
+        return str.hash();
+    }
+};
+} // namespace std
+
+#endif // FBSTRING_GERMAN_H
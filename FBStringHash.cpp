@@ -0,0 +1,139 @@
+#include "FBStringHash.h"
+#include "FBStringSimd.h"
+#include <cstring>
+
+#if defined(FBSTRING_HAS_AESNI)
+#include <wmmintrin.h>
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+// wyhash 的默认密钥
+static const uint64_t kSecret[4] = {0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull, 0x4b33a62ed433d4a3ull, 0x4d5a2da51de1aa47ull};
+
+// 64 位乘法的 128 位结果，低 64 位写回 a，高 64 位写回 b
+static inline void multiply128(uint64_t& a, uint64_t& b) {
+#if defined(__SIZEOF_INT128__)
+    const unsigned __int128 r = static_cast<unsigned __int128>(a) * b;
+    a = static_cast<uint64_t>(r);
+    b = static_cast<uint64_t>(r >> 64);
+#elif defined(_MSC_VER) && !defined(__clang__) && defined(_M_X64)
+    a = _umul128(a, b, &b);
+#else
+    const uint64_t ha = a >> 32, hb = b >> 32, la = static_cast<uint32_t>(a), lb = static_cast<uint32_t>(b);
+    const uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+    const uint64_t t = rl + (rm0 << 32);
+    uint64_t carry = t < rl;
+    const uint64_t lo = t + (rm1 << 32);
+    carry += lo < t;
+    a = lo;
+    b = rh + (rm0 >> 32) + (rm1 >> 32) + carry;
+#endif
+}
+
+// 乘法后把高低两半异或
+static inline uint64_t mix(uint64_t a, uint64_t b) {
+    multiply128(a, b);
+    return a ^ b;
+}
+
+// 按小端序读取 8、4 个字节
+static inline uint64_t read64(const unsigned char* p) {
+    uint64_t v;
+    std::memcpy(&v, p, 8);
+    return v;
+}
+
+static inline uint64_t read32(const unsigned char* p) {
+    uint32_t v;
+    std::memcpy(&v, p, 4);
+    return v;
+}
+
+// 1 ~ 3 个字节拼成一个整数
+static inline uint64_t read3(const unsigned char* p, size_t n) {
+    return (static_cast<uint64_t>(p[0]) << 16) | (static_cast<uint64_t>(p[n >> 1]) << 8) | p[n - 1];
+}
+
+// wyhash final4
+static uint64_t wyhash(const unsigned char* p, size_t n, uint64_t seed) {
+    seed ^= mix(seed ^ kSecret[0], kSecret[1]);
+    uint64_t a, b;
+    if (n <= 16) {
+        if (n >= 4) {
+            a = (read32(p) << 32) | read32(p + ((n >> 3) << 2));
+            b = (read32(p + n - 4) << 32) | read32(p + n - 4 - ((n >> 3) << 2));
+        } else if (n > 0) {
+            a = read3(p, n);
+            b = 0;
+        } else {
+            a = b = 0;
+        }
+    } else {
+        size_t i = n;
+        if (i >= 48) {
+            uint64_t see1 = seed, see2 = seed;
+            do {
+                seed = mix(read64(p) ^ kSecret[1], read64(p + 8) ^ seed);
+                see1 = mix(read64(p + 16) ^ kSecret[2], read64(p + 24) ^ see1);
+                see2 = mix(read64(p + 32) ^ kSecret[3], read64(p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+            } while (i >= 48);
+            seed ^= see1 ^ see2;
+        }
+        while (i > 16) {
+            seed = mix(read64(p) ^ kSecret[1], read64(p + 8) ^ seed);
+            i -= 16;
+            p += 16;
+        }
+        a = read64(p + i - 16);
+        b = read64(p + i - 8);
+    }
+    a ^= kSecret[1];
+    b ^= seed;
+    multiply128(a, b);
+    return mix(a ^ kSecret[0] ^ n, b ^ kSecret[1]);
+}
+
+#if defined(FBSTRING_HAS_AESNI)
+// 长输入：4 路状态各自用 aesenc 吸收 16 字节，最后一块与前面重叠读取，再多轮合并
+static uint64_t aesHash(const unsigned char* p, size_t n, uint64_t seed) {
+    const __m128i key = _mm_set_epi64x(static_cast<long long>(seed ^ kSecret[0]), static_cast<long long>(n ^ kSecret[1]));
+    const __m128i key2 = _mm_set_epi64x(static_cast<long long>(kSecret[2]), static_cast<long long>(kSecret[3]));
+    __m128i s0 = key;
+    __m128i s1 = _mm_xor_si128(key, key2);
+    __m128i s2 = _mm_aesenc_si128(key, key2);
+    __m128i s3 = _mm_aesenc_si128(s1, key);
+    const unsigned char* last = p + n - 64;
+    for (; p < last; p += 64) {
+        s0 = _mm_aesenc_si128(s0, _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+        s1 = _mm_aesenc_si128(s1, _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16)));
+        s2 = _mm_aesenc_si128(s2, _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 32)));
+        s3 = _mm_aesenc_si128(s3, _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 48)));
+    }
+    s0 = _mm_aesenc_si128(s0, _mm_loadu_si128(reinterpret_cast<const __m128i*>(last)));
+    s1 = _mm_aesenc_si128(s1, _mm_loadu_si128(reinterpret_cast<const __m128i*>(last + 16)));
+    s2 = _mm_aesenc_si128(s2, _mm_loadu_si128(reinterpret_cast<const __m128i*>(last + 32)));
+    s3 = _mm_aesenc_si128(s3, _mm_loadu_si128(reinterpret_cast<const __m128i*>(last + 48)));
+    // 合并 4 路状态，每路至少再经过两轮才进入结果
+    s0 = _mm_aesenc_si128(_mm_aesenc_si128(s0, s1), key);
+    s2 = _mm_aesenc_si128(_mm_aesenc_si128(s2, s3), key2);
+    __m128i h = _mm_aesenc_si128(_mm_aesenc_si128(s0, s2), key);
+    h = _mm_aesenclast_si128(_mm_aesenc_si128(h, key2), key);
+    uint64_t parts[2];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(parts), h);
+    return parts[0] ^ parts[1];
+}
+#endif
+
+// 计算字节序列的散列值
+uint64_t FBStringHash::hash(const void* data, size_t n, uint64_t seed) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+#if defined(FBSTRING_HAS_AESNI)
+    if (n > 64) return aesHash(p, n, seed);
+#endif
+    return wyhash(p, n, seed);
+}
@@ -0,0 +1,22 @@
+#ifndef FBSTRING_HASH_H
+#define FBSTRING_HASH_H
+
+#include <cstddef>
+#include <cstdint>
+
+// FBStringHash 提供字符串使用的 64 位散列函数
+// 短输入使用 wyhash（final4 版本），支持 AES-NI 的目标上长输入改用 4 路 aesenc 压缩。
+// 结果只保证同一构建内稳定，不同编译选项或平台之间可能不同，不要持久化。
+class FBStringHash {
+public:
+    /**
+     * 计算字节序列的散列值
+     * @param data 起始位置
+     * @param n 字节数
+     * @param seed 种子，相同的种子和内容得到相同的结果
+     * @return 64 位散列值
+     */
+    static uint64_t hash(const void* data, size_t n, uint64_t seed = 0);
+};
+
+#endif // FBSTRING_HASH_H
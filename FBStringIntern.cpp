@@ -0,0 +1,282 @@
+#include "FBStringIntern.h"
+#include "FBStringHash.h"
+
+// 默认构造的句柄和所有驻留池中的空字符串都指向它
+static const FBString& emptyString() {
+    static const FBString empty;
+    return empty;
+}
+
+// 默认构造函数
+FBInternedString::FBInternedString() : str_(&emptyString()) {}
+
+// 指向规范字符串的构造函数
+FBInternedString::FBInternedString(const FBString* str) : str_(str) {}
+
+// 返回规范字符串
+const FBString& FBInternedString::str() const {
+    return *str_;
+}
+
+// 返回 C 风格字符串
+const char* FBInternedString::c_str() const {
+    return str_->c_str();
+}
+
+// 返回字符串大小
+size_t FBInternedString::size() const {
+    return str_->size();
+}
+
+// 判断是否为空字符串
+bool FBInternedString::empty() const {
+    return str_->size() == 0;
+}
+
+// 返回内容的视图
+FBStringView FBInternedString::view() const {
+    return FBStringView(str_->c_str(), str_->size());
+}
+
+// 比较运算符
+bool FBInternedString::operator==(const FBInternedString& other) const {
+    return str_ == other.str_;
+}
+
+bool FBInternedString::operator!=(const FBInternedString& other) const {
+    return str_ != other.str_;
+}
+
+// 返回节省的字节数
+size_t FBStringInternPool::Stats::savedBytes() const {
+    return requestedBytes - storedBytes;
+}
+
+// 散列表使用散列值的低位，分片使用高位，两者互不相关
+size_t FBStringInternPool::KeyHash::operator()(const Key& key) const {
+    return static_cast<size_t>(key.hash);
+}
+
+// 先比较散列值，再比较内容
+bool FBStringInternPool::KeyEqual::operator()(const Key& lhs, const Key& rhs) const {
+    return lhs.hash == rhs.hash && lhs.view == rhs.view;
+}
+
+// 构造函数
+FBStringInternPool::FBStringInternPool(size_t shardCount) {
+    size_t count = 1;
+    while (count < shardCount) count <<= 1;
+    shards_.reset(new Shard[count]);
+    shardMask_ = count - 1;
+}
+
+// 驻留字符串
+FBInternedString FBStringInternPool::intern(FBStringView str) {
+    return internImpl(str, nullptr);
+}
+
+FBInternedString FBStringInternPool::intern(const char* str) {
+    return internImpl(FBStringView(str), nullptr);
+}
+
+FBInternedString FBStringInternPool::intern(const FBString& str) {
+    return internImpl(FBStringView(str.c_str(), str.size()), &str);
+}
+
+// 查找或插入
+FBInternedString FBStringInternPool::internImpl(FBStringView str, const FBString* owner) {
+    if (str.size() == 0) return FBInternedString();
+    // 散列在加锁之前计算，锁内只做查表
+    const uint64_t hash = FBStringHash::hash(str.data(), str.size());
+    Shard& shard = shards_[static_cast<size_t>(hash >> 40) & shardMask_];
+    const Key probe = {str, hash};
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    ++shard.requests;
+    shard.requestedBytes += str.size();
+    auto it = shard.index.find(probe);
+    if (it != shard.index.end()) return FBInternedString(it->second);
+    if (owner != nullptr) {
+        shard.strings.push_back(*owner);
+    } else {
+        shard.strings.push_back(FBString(str.data(), str.size()));
+    }
+    const FBString* canonical = &shard.strings.back();
+    const Key key = {FBStringView(canonical->c_str(), canonical->size()), hash};
+    shard.index.emplace(key, canonical);
+    shard.storedBytes += str.size();
+    return FBInternedString(canonical);
+}
+
+// 返回不同字符串的个数
+size_t FBStringInternPool::size() const {
+    size_t total = 0;
+    for (size_t i = 0; i <= shardMask_; ++i) {
+        std::lock_guard<std::mutex> lock(shards_[i].mutex);
+        total += shards_[i].index.size();
+    }
+    return total;
+}
+
+// 返回统计信息
+FBStringInternPool::Stats FBStringInternPool::stats() const {
+    Stats result = {0, 0, 0, 0};
+    for (size_t i = 0; i <= shardMask_; ++i) {
+        std::lock_guard<std::mutex> lock(shards_[i].mutex);
+        result.distinct += shards_[i].index.size();
+        result.requests += shards_[i].requests;
+        result.storedBytes += shards_[i].storedBytes;
+        result.requestedBytes += shards_[i].requestedBytes;
+    }
+    return result;
+}
+
+FBConcurrentInternSet::Entry FBConcurrentInternSet::movedMarker_ = {0, FBString()};
+
+// 构造指定槽位数的空表
+FBConcurrentInternSet::Table::Table(size_t capacity) : mask(capacity - 1), slots(new std::atomic<Entry*>[capacity]) {
+    for (size_t i = 0; i < capacity; ++i) {
+        slots[i].store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+// 返回已迁移标记
+FBConcurrentInternSet::Entry* FBConcurrentInternSet::moved() {
+    return &movedMarker_;
+}
+
+// 构造函数
+FBConcurrentInternSet::FBConcurrentInternSet(size_t initialCapacity) : size_(0) {
+    size_t capacity = 16;
+    while (capacity < initialCapacity) capacity <<= 1;
+    table_.store(new Table(capacity), std::memory_order_release);
+}
+
+// 析构函数：当前表包含全部条目，旧表只保存条目指针的副本
+FBConcurrentInternSet::~FBConcurrentInternSet() {
+    Table* table = table_.load(std::memory_order_acquire);
+    for (size_t i = 0; i <= table->mask; ++i) {
+        delete table->slots[i].load(std::memory_order_relaxed);
+    }
+    delete table;
+    for (size_t i = 0; i < retired_.size(); ++i) {
+        delete retired_[i];
+    }
+}
+
+// 从 start 开始线性探测
+size_t FBConcurrentInternSet::probe(const Table* table, FBStringView str, uint64_t hash, size_t start, Entry*& entry) {
+    size_t i = start;
+    for (size_t n = 0; n <= table->mask; ++n, i = (i + 1) & table->mask) {
+        Entry* e = table->slots[i].load(std::memory_order_acquire);
+        if (e == nullptr || e == moved() ||
+            (e->hash == hash && FBStringView(e->str.c_str(), e->str.size()) == str)) {
+            entry = e;
+            return i;
+        }
+    }
+    entry = moved();
+    return i;
+}
+
+// 驻留字符串
+FBInternedString FBConcurrentInternSet::intern(FBStringView str) {
+    return internImpl(str, nullptr);
+}
+
+FBInternedString FBConcurrentInternSet::intern(const char* str) {
+    return internImpl(FBStringView(str), nullptr);
+}
+
+FBInternedString FBConcurrentInternSet::intern(const FBString& str) {
+    return internImpl(FBStringView(str.c_str(), str.size()), &str);
+}
+
+// 查找或插入
+FBInternedString FBConcurrentInternSet::internImpl(FBStringView str, const FBString* owner) {
+    if (str.size() == 0) return FBInternedString();
+    const uint64_t hash = FBStringHash::hash(str.data(), str.size());
+    Table* table = table_.load(std::memory_order_acquire);
+    Entry* created = nullptr;
+    size_t i = static_cast<size_t>(hash) & table->mask;
+    while (true) {
+        Entry* e;
+        i = probe(table, str, hash, i, e);
+        if (e == nullptr) {
+            if (created == nullptr) {
+                created = new Entry{hash, owner != nullptr ? *owner : FBString(str.data(), str.size())};
+            }
+            if (table->slots[i].compare_exchange_strong(e, created, std::memory_order_acq_rel, std::memory_order_acquire)) {
+                if (size_.fetch_add(1, std::memory_order_relaxed) + 1 > (table->mask + 1) / 2) grow(table);
+                return FBInternedString(&created->str);
+            }
+            // 其他线程抢先占据了该槽位，从这个槽位重新探测
+            continue;
+        }
+        if (e != moved()) {
+            // 同一个值被其他线程抢先插入时，丢弃自己创建的条目
+            delete created;
+            return FBInternedString(&e->str);
+        }
+        // 正在扩容或表已满：等待或完成扩容后在新表中重试
+        grow(table);
+        table = table_.load(std::memory_order_acquire);
+        i = static_cast<size_t>(hash) & table->mask;
+    }
+}
+
+// 查找字符串，不插入
+bool FBConcurrentInternSet::find(FBStringView str, FBInternedString& result) const {
+    if (str.size() == 0) {
+        result = FBInternedString();
+        return true;
+    }
+    const uint64_t hash = FBStringHash::hash(str.data(), str.size());
+    Table* table = table_.load(std::memory_order_acquire);
+    while (true) {
+        Entry* e;
+        probe(table, str, hash, static_cast<size_t>(hash) & table->mask, e);
+        if (e == nullptr) return false;
+        if (e != moved()) {
+            result = FBInternedString(&e->str);
+            return true;
+        }
+        // 已迁移标记只替换空槽，说明该键不在这张表中；扩容期间新表尚未发布，不会有插入在其中完成，
+        // 因此当前表没有变化时直接返回未找到，已被替换时到新表中继续查找，全程不加锁
+        Table* next = table_.load(std::memory_order_acquire);
+        if (next == table) return false;
+        table = next;
+    }
+}
+
+// 返回不同字符串的个数
+size_t FBConcurrentInternSet::size() const {
+    return size_.load(std::memory_order_relaxed);
+}
+
+// 释放退役的旧表
+void FBConcurrentInternSet::reclaim() {
+    std::lock_guard<std::mutex> lock(growMutex_);
+    for (size_t i = 0; i < retired_.size(); ++i) {
+        delete retired_[i];
+    }
+    retired_.clear();
+}
+
+// 扩容
+void FBConcurrentInternSet::grow(Table* old) {
+    std::lock_guard<std::mutex> lock(growMutex_);
+    if (table_.load(std::memory_order_acquire) != old) return;
+    size_t capacity = (old->mask + 1) * 2;
+    while (size_.load(std::memory_order_relaxed) * 2 >= capacity) capacity <<= 1;
+    Table* next = new Table(capacity);
+    for (size_t i = 0; i <= old->mask; ++i) {
+        // 空槽标记为已迁移，之后不会再有插入落在旧表；已有条目复制指针到新表
+        Entry* e = nullptr;
+        if (old->slots[i].compare_exchange_strong(e, moved(), std::memory_order_acq_rel, std::memory_order_acquire)) continue;
+        size_t j = static_cast<size_t>(e->hash) & next->mask;
+        while (next->slots[j].load(std::memory_order_relaxed) != nullptr) j = (j + 1) & next->mask;
+        next->slots[j].store(e, std::memory_order_relaxed);
+    }
+    table_.store(next, std::memory_order_release);
+    retired_.push_back(old);
+}
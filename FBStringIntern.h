@@ -0,0 +1,302 @@
+#ifndef FBSTRING_INTERN_H
+#define FBSTRING_INTERN_H
+
+#include "FBString.h"
+#include "FBStringView.h"
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * 驻留字符串的句柄
+ * 指向驻留池中唯一的规范字符串，同一个池返回的句柄内容相同当且仅当指针相同，比较只需比较指针。
+ * 句柄在所属的驻留池销毁之前有效。
+ */
+class FBInternedString {
+public:
+    /**
+     * 默认构造函数
+     * 构造空字符串的句柄，与任何驻留池中驻留的空字符串相等。
+     */
+    FBInternedString();
+
+    /**
+     * 返回驻留池中的规范字符串
+     * 复制它得到的 FBString 与池中的字符串共享同一缓冲区（中型和大型存储）。
+     * @return 规范字符串
+     */
+    const FBString& str() const;
+
+    /**
+     * 返回 C 风格字符串
+     * @return 指向内容的指针，以 null 结尾
+     */
+    const char* c_str() const;
+
+    /**
+     * 返回字符串大小
+     * @return 字符个数
+     */
+    size_t size() const;
+
+    /**
+     * 判断是否为空字符串
+     * @return 为空返回 true
+     */
+    bool empty() const;
+
+    /**
+     * 返回内容的视图
+     * @return 视图
+     */
+    FBStringView view() const;
+
+    /**
+     * 比较运算符，只比较指针；不同驻留池的句柄之间比较没有意义
+     * @param other 要比较的句柄
+     * @return 比较结果
+     */
+    bool operator==(const FBInternedString& other) const;
+    bool operator!=(const FBInternedString& other) const;
+
+private:
+    friend class FBStringInternPool;
+    friend class FBConcurrentInternSet;
+
+    /**
+     * 指向规范字符串的构造函数
+     * @param str 规范字符串
+     */
+    explicit FBInternedString(const FBString* str);
+
+    const FBString* str_; /**< 规范字符串 */
+};
+
+namespace std {
+// 句柄按指针散列，不读取内容
+template <>
+struct hash<FBInternedString> {
+    size_t operator()(const FBInternedString& s) const {
+        return std::hash<const FBString*>()(&s.str());
+    }
+};
+} // namespace std
+
+/**
+ * 字符串驻留池
+ * 每个不同的值只保存一份，中型和大型字符串由引用计数的缓冲区共享。
+ * 池按散列值分为多个分片，每个分片有自己的锁，不同分片上的并发插入互不阻塞。
+ * 驻留的字符串在池销毁前不会被释放。
+ */
+class FBStringInternPool {
+public:
+    /** 统计信息 */
+    struct Stats {
+        size_t distinct;       /**< 不同字符串的个数 */
+        size_t requests;       /**< intern 调用次数 */
+        size_t storedBytes;    /**< 不同字符串的内容总字节数 */
+        size_t requestedBytes; /**< 所有 intern 调用的内容总字节数 */
+
+        /**
+         * 返回驻留节省的内容字节数，即重复的字符串如果各自保存一份时多占用的字节
+         * @return 节省的字节数
+         */
+        size_t savedBytes() const;
+    };
+
+    /**
+     * 构造函数
+     * @param shardCount 分片数，向上取整为 2 的幂，至少为 1
+     */
+    explicit FBStringInternPool(size_t shardCount = 64);
+
+    FBStringInternPool(const FBStringInternPool&) = delete;
+    FBStringInternPool& operator=(const FBStringInternPool&) = delete;
+
+    /**
+     * 驻留字符串
+     * 值已存在时直接返回已有的句柄；否则复制内容加入池中。
+     * @param str 要驻留的内容
+     * @return 句柄
+     */
+    FBInternedString intern(FBStringView str);
+    FBInternedString intern(const char* str);
+
+    /**
+     * 驻留字符串
+     * 值不存在时池直接共享 str 的缓冲区（中型和大型存储），不复制内容。
+     * @param str 要驻留的字符串
+     * @return 句柄
+     */
+    FBInternedString intern(const FBString& str);
+
+    /**
+     * 返回不同字符串的个数
+     * @return 个数
+     */
+    size_t size() const;
+
+    /**
+     * 返回统计信息
+     * 逐个分片加锁汇总，并发插入时结果是近似值。
+     * @return 统计信息
+     */
+    Stats stats() const;
+
+private:
+    /** 散列表的键：内容视图及预先算好的散列值，指向池中规范字符串自己的存储 */
+    struct Key {
+        FBStringView view;
+        uint64_t hash;
+    };
+
+    struct KeyHash {
+        size_t operator()(const Key& key) const;
+    };
+
+    struct KeyEqual {
+        bool operator()(const Key& lhs, const Key& rhs) const;
+    };
+
+    /** 分片：deque 追加元素时不移动已有元素，键中的视图和返回的句柄始终有效 */
+    struct Shard {
+        mutable std::mutex mutex;
+        std::deque<FBString> strings;
+        std::unordered_map<Key, const FBString*, KeyHash, KeyEqual> index;
+        size_t requests;
+        size_t storedBytes;
+        size_t requestedBytes;
+
+        Shard() : requests(0), storedBytes(0), requestedBytes(0) {}
+    };
+
+    /**
+     * 查找或插入
+     * @param str 要驻留的内容
+     * @param owner 内容所属的 FBString，可以为 nullptr；插入时复制它以共享缓冲区
+     * @return 句柄
+     */
+    FBInternedString internImpl(FBStringView str, const FBString* owner);
+
+    std::unique_ptr<Shard[]> shards_; /**< 分片数组 */
+    size_t shardMask_;                /**< 分片数减一 */
+};
+
+/**
+ * 无锁的字符串驻留集合
+ * 开放寻址的散列表，每个槽位是指向条目的原子指针，插入用 CAS 占据空槽。
+ * 查找已存在的键只做原子读取，是无等待的，不写任何共享的缓存行。
+ * 负载超过一半时扩容：扩容线程持有互斥锁，把旧表的空槽标记为已迁移并复制条目指针，完成后发布新表；
+ * 期间遇到已迁移标记的插入会等待扩容结束；查找从不加锁，遇到已迁移标记时若当前表已被替换则到新表中继续查找。
+ * 旧表可能仍被并发的读者访问，退役后保留到 reclaim() 或集合销毁时释放，总大小不超过当前表。
+ */
+class FBConcurrentInternSet {
+public:
+    /**
+     * 构造函数
+     * @param initialCapacity 初始槽位数，向上取整为 2 的幂，至少为 16
+     */
+    explicit FBConcurrentInternSet(size_t initialCapacity = 1024);
+
+    ~FBConcurrentInternSet();
+
+    FBConcurrentInternSet(const FBConcurrentInternSet&) = delete;
+    FBConcurrentInternSet& operator=(const FBConcurrentInternSet&) = delete;
+
+    /**
+     * 驻留字符串
+     * 值已存在时直接返回已有的句柄；否则复制内容并尝试插入，与其他线程竞争失败时返回胜者的句柄。
+     * @param str 要驻留的内容
+     * @return 句柄
+     */
+    FBInternedString intern(FBStringView str);
+    FBInternedString intern(const char* str);
+
+    /**
+     * 驻留字符串
+     * 值不存在时集合直接共享 str 的缓冲区（中型和大型存储），不复制内容。
+     * @param str 要驻留的字符串
+     * @return 句柄
+     */
+    FBInternedString intern(const FBString& str);
+
+    /**
+     * 查找字符串，不插入；不加锁，扩容期间也不等待
+     * @param str 要查找的内容
+     * @param result 输出参数，找到时写入句柄
+     * @return 找到返回 true
+     */
+    bool find(FBStringView str, FBInternedString& result) const;
+
+    /**
+     * 返回不同字符串的个数
+     * @return 个数
+     */
+    size_t size() const;
+
+    /**
+     * 释放扩容后退役的旧表
+     * 调用方必须保证此时没有其他线程在访问集合。
+     */
+    void reclaim();
+
+private:
+    /** 条目：创建后不再修改，直到集合销毁 */
+    struct Entry {
+        uint64_t hash;
+        FBString str;
+    };
+
+    /** 散列表 */
+    struct Table {
+        size_t mask;
+        std::unique_ptr<std::atomic<Entry*>[]> slots;
+
+        explicit Table(size_t capacity);
+    };
+
+    /**
+     * 返回已迁移标记，只用于比较地址
+     * @return 标记
+     */
+    static Entry* moved();
+
+    /**
+     * 从 start 开始线性探测
+     * @param table 表
+     * @param str 要查找的内容
+     * @param hash 内容的散列值
+     * @param start 起始槽位
+     * @param entry 输出参数：找到时为条目，遇到空槽时为 nullptr，遇到已迁移标记或探测完整张表时为已迁移标记
+     * @return 结束探测的槽位下标
+     */
+    static size_t probe(const Table* table, FBStringView str, uint64_t hash, size_t start, Entry*& entry);
+
+    /**
+     * 查找或插入
+     * @param str 要驻留的内容
+     * @param owner 内容所属的 FBString，可以为 nullptr；插入时复制它以共享缓冲区
+     * @return 句柄
+     */
+    FBInternedString internImpl(FBStringView str, const FBString* owner);
+
+    /**
+     * 扩容；其他线程已经完成扩容时直接返回
+     * @param old 调用方看到的当前表
+     */
+    void grow(Table* old);
+
+    std::atomic<Table*> table_;   /**< 当前表 */
+    std::atomic<size_t> size_;    /**< 条目数，只在插入新值时修改 */
+    std::mutex growMutex_;        /**< 扩容锁，扩容期间一直持有 */
+    std::vector<Table*> retired_; /**< 退役的旧表，受 growMutex_ 保护 */
+
+    static Entry movedMarker_;    /**< 已迁移标记 */
+};
+
+#endif // FBSTRING_INTERN_H
@@ -0,0 +1,846 @@
+#ifndef FBSTRING_MAP_H
+#define FBSTRING_MAP_H
+
+#include "FBString.h"
+#include "FBStringView.h"
+#include "FBStringHash.h"
+#include "FBStringSimd.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#if defined(FBSTRING_HAS_SSE2)
+#include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+/**
+ * 以 FBString 为键的开放寻址散列表
+ * 键值对直接存放在槽位数组中，插入不分配节点；另有一个控制字节数组，每个槽位一个字节，
+ * 保存键散列值的低 7 位作为标签，空槽和删除标记的最高位为 1。查找时一次比较 16 个控制字节，只有标签相同的槽位才比较键。
+ * 查找和删除接受 FBStringView，const char*、FBString、std::string 都可以直接传入，不需要先构造 FBString。
+ * 不超过 16 字节的键总是保存在 FBString 对象内部（见 FBString::is_inline()），比较时直接读取两个 64 位字，
+ * 与预先补零的查找键按长度掩码后比较，不调用 memcmp。
+ * 插入可能扩容，使所有迭代器和引用失效；删除只使被删除元素的迭代器失效。
+ * @tparam V 值类型
+ */
+template <typename V>
+class FBStringMap {
+public:
+    typedef FBString key_type;
+    typedef V mapped_type;
+    typedef std::pair<const FBString, V> value_type;
+    typedef size_t size_type;
+
+    /**
+     * 前向迭代器，按槽位顺序遍历
+     * @tparam Value value_type 或 const value_type
+     */
+    template <typename Value>
+    class IteratorBase {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef typename std::remove_const<Value>::type value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef Value* pointer;
+        typedef Value& reference;
+
+        IteratorBase() : ctrl_(nullptr), slot_(nullptr), end_(nullptr) {}
+
+        /** 可写迭代器到只读迭代器的转换 */
+        template <typename Other>
+        IteratorBase(const IteratorBase<Other>& other) : ctrl_(other.ctrl_), slot_(other.slot_), end_(other.end_) {}
+
+        reference operator*() const { return *slot_; }
+        pointer operator->() const { return slot_; }
+
+        IteratorBase& operator++() {
+            ++ctrl_;
+            ++slot_;
+            skipFree();
+            return *this;
+        }
+
+        IteratorBase operator++(int) {
+            IteratorBase old = *this;
+            ++*this;
+            return old;
+        }
+
+        bool operator==(const IteratorBase& other) const { return slot_ == other.slot_; }
+        bool operator!=(const IteratorBase& other) const { return slot_ != other.slot_; }
+
+    private:
+        friend class FBStringMap;
+        template <typename> friend class IteratorBase;
+
+        IteratorBase(const int8_t* ctrl, Value* slot, const int8_t* end) : ctrl_(ctrl), slot_(slot), end_(end) {}
+
+        /** 跳过空槽和删除标记 */
+        void skipFree() {
+            while (ctrl_ != end_ && *ctrl_ < 0) {
+                ++ctrl_;
+                ++slot_;
+            }
+        }
+
+        const int8_t* ctrl_; /**< 当前槽位的控制字节 */
+        Value* slot_;        /**< 当前槽位 */
+        const int8_t* end_;  /**< 控制字节数组的末尾（不含复制的部分） */
+    };
+
+    typedef IteratorBase<value_type> iterator;
+    typedef IteratorBase<const value_type> const_iterator;
+
+    /**
+     * 默认构造函数
+     * 不分配内存，第一次插入时才分配。
+     */
+    FBStringMap();
+
+    /**
+     * 预留容量的构造函数
+     * @param expected 预计的元素个数，插入这么多元素之前不会扩容
+     */
+    explicit FBStringMap(size_t expected);
+
+    FBStringMap(const FBStringMap& other);
+    FBStringMap(FBStringMap&& other) noexcept;
+    FBStringMap& operator=(const FBStringMap& other);
+    FBStringMap& operator=(FBStringMap&& other) noexcept;
+    ~FBStringMap();
+
+    /**
+     * 交换两个散列表的内容，不移动元素
+     * @param other 要交换的散列表
+     */
+    void swap(FBStringMap& other) noexcept;
+
+    iterator begin();
+    iterator end();
+    const_iterator begin() const;
+    const_iterator end() const;
+
+    /**
+     * 返回元素个数
+     * @return 元素个数
+     */
+    size_t size() const;
+
+    /**
+     * 判断是否为空
+     * @return 为空返回 true
+     */
+    bool empty() const;
+
+    /**
+     * 返回槽位数
+     * @return 0 或不小于 16 的 2 的幂
+     */
+    size_t capacity() const;
+
+    /**
+     * 预留容量，使插入 expected 个元素之前不会扩容
+     * @param expected 预计的元素个数
+     */
+    void reserve(size_t expected);
+
+    /**
+     * 删除所有元素，保留已分配的槽位
+     */
+    void clear();
+
+    /**
+     * 查找键
+     * @param key 要查找的键
+     * @return 找到时为指向该元素的迭代器，否则为 end()
+     */
+    iterator find(FBStringView key);
+    const_iterator find(FBStringView key) const;
+
+    /**
+     * 返回键出现的次数
+     * @param key 要查找的键
+     * @return 0 或 1
+     */
+    size_t count(FBStringView key) const;
+
+    /**
+     * 判断键是否存在
+     * @param key 要查找的键
+     * @return 存在返回 true
+     */
+    bool contains(FBStringView key) const;
+
+    /**
+     * 访问键对应的值
+     * @param key 要查找的键
+     * @return 值的引用
+     * @throws out_of_range 如果键不存在
+     */
+    V& at(FBStringView key);
+    const V& at(FBStringView key) const;
+
+    /**
+     * 访问键对应的值，键不存在时插入值初始化的值
+     * @param key 键
+     * @return 值的引用
+     */
+    V& operator[](FBStringView key);
+
+    /**
+     * 插入键值对，键已存在时不做修改
+     * 键是中型或大型字符串时与 value.first 共享缓冲区，不复制内容。
+     * @param value 键值对
+     * @return 指向键所在元素的迭代器，以及是否插入了新元素
+     */
+    std::pair<iterator, bool> insert(const value_type& value);
+    std::pair<iterator, bool> insert(value_type&& value);
+
+    /**
+     * 键不存在时用 args 构造值并插入，键已存在时不做修改，也不构造值
+     * @param key 键
+     * @param args 值的构造参数
+     * @return 指向键所在元素的迭代器，以及是否插入了新元素
+     */
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace(FBStringView key, Args&&... args);
+
+    /**
+     * 键不存在时插入，已存在时赋值
+     * @param key 键
+     * @param value 值
+     * @return 指向键所在元素的迭代器，以及是否插入了新元素
+     */
+    template <typename M>
+    std::pair<iterator, bool> insert_or_assign(FBStringView key, M&& value);
+
+    /**
+     * 删除键
+     * @param key 要删除的键
+     * @return 删除的元素个数，0 或 1
+     */
+    size_t erase(FBStringView key);
+
+    /**
+     * 删除迭代器指向的元素
+     * @param pos 指向元素的迭代器
+     * @return 指向下一个元素的迭代器
+     */
+    iterator erase(const_iterator pos);
+
+private:
+    /** 控制字节：空槽、删除标记；占用的槽位保存 0 ~ 127 的标签 */
+    static const int8_t kEmpty = -128;
+    static const int8_t kDeleted = -2;
+
+    /** 一次比较的控制字节数 */
+    static const size_t kGroupWidth = 16;
+
+    /** 在对象内部按字比较的键的最大长度 */
+    static const size_t kInlineKeySize = 16;
+
+    /** 预处理过的查找键：散列值，以及短键补零后的两个字和对应的长度掩码 */
+    struct Lookup {
+        const char* data;
+        size_t size;
+        uint64_t hash;
+        uint64_t words[2];
+        uint64_t masks[2];
+    };
+
+    /**
+     * 预处理查找键
+     * @param key 键
+     * @param hash 键的散列值
+     * @return 查找键
+     */
+    static Lookup makeLookup(FBStringView key, uint64_t hash);
+    static Lookup makeLookup(FBStringView key);
+    static Lookup makeLookup(const FBString& key);
+
+    /**
+     * 返回 FBString 键的 64 位散列值，与 FBStringHash::hash 的结果相同
+     * size_t 为 64 位时使用字符串缓存的散列值，否则缓存的值被截断，需要重新计算。
+     * @param key 键
+     * @return 散列值
+     */
+    static uint64_t keyHash(const FBString& key);
+
+    /**
+     * 比较表中的键与查找键
+     * @param key 表中的键
+     * @param lookup 查找键
+     * @return 相等返回 true
+     */
+    static bool keyEquals(const FBString& key, const Lookup& lookup);
+
+    /**
+     * 生成要保存到表中的键，保证不超过 kInlineKeySize 的键保存在对象内部
+     * @param key 键的内容，或者共享其缓冲区的 FBString
+     * @return 键
+     */
+    static FBString makeKey(FBStringView key);
+    static FBString makeKey(const FBString& key);
+
+    /**
+     * 返回一组 16 个控制字节中等于 tag 的位掩码
+     * @param group 控制字节
+     * @param tag 要匹配的值
+     * @return 第 i 位对应 group[i]
+     */
+    static uint32_t matchTag(const int8_t* group, int8_t tag);
+
+    /**
+     * 返回一组 16 个控制字节中空槽和删除标记的位掩码
+     * @param group 控制字节
+     * @return 第 i 位对应 group[i]
+     */
+    static uint32_t matchFree(const int8_t* group);
+
+    /**
+     * 返回最低位 1 的下标
+     * @param mask 非零的位掩码
+     * @return 下标
+     */
+    static unsigned lowestBit(uint32_t mask);
+
+    /**
+     * 计算容纳 expected 个元素需要的槽位数
+     * @param expected 元素个数
+     * @return 不小于 16 的 2 的幂
+     */
+    static size_t capacityFor(size_t expected);
+
+    /**
+     * 返回给定槽位数下最多能占用的槽位数（负载因子 7/8）
+     * @param capacity 槽位数
+     * @return 最多占用的槽位数
+     */
+    static size_t maxLoad(size_t capacity);
+
+    /**
+     * 查找键所在的槽位
+     * @param lookup 查找键
+     * @return 槽位下标，未找到时为 capacity_
+     */
+    size_t findIndex(const Lookup& lookup) const;
+
+    /**
+     * 沿探测序列找第一个空槽或删除标记
+     * @param hash 键的散列值
+     * @return 槽位下标
+     */
+    size_t findFree(uint64_t hash) const;
+
+    /**
+     * 设置控制字节，开头的 kGroupWidth - 1 个同时写入末尾的副本
+     * @param index 槽位下标
+     * @param tag 控制字节
+     */
+    void setCtrl(size_t index, int8_t tag);
+
+    /**
+     * 查找键，不存在时构造键和值并插入
+     * @param lookup 查找键
+     * @param key 键的内容，或者共享其缓冲区的 FBString
+     * @param args 值的构造参数
+     * @return 指向键所在元素的迭代器，以及是否插入了新元素
+     */
+    template <typename K, typename... Args>
+    std::pair<iterator, bool> emplaceImpl(const Lookup& lookup, const K& key, Args&&... args);
+
+    /**
+     * 重新分配槽位并重新插入所有元素，同时清除删除标记
+     * @param newCapacity 新的槽位数
+     */
+    void rehash(size_t newCapacity);
+
+    /**
+     * 析构所有元素并释放槽位
+     */
+    void destroy();
+
+    /**
+     * 构造指向槽位的迭代器
+     * @param index 槽位下标
+     * @return 迭代器
+     */
+    iterator iteratorAt(size_t index);
+    const_iterator iteratorAt(size_t index) const;
+
+    int8_t* ctrl_;      /**< 控制字节，capacity_ + kGroupWidth - 1 个，末尾复制开头的 kGroupWidth - 1 个以便跨越结尾成组读取 */
+    value_type* slots_; /**< 槽位 */
+    size_t capacity_;   /**< 槽位数，0 或不小于 kGroupWidth 的 2 的幂 */
+    size_t size_;       /**< 元素个数 */
+    size_t growthLeft_; /**< 不扩容还能占用的空槽数；删除只留下删除标记，不归还空槽 */
+};
+
+// 默认构造函数
+template <typename V>
+FBStringMap<V>::FBStringMap() : ctrl_(nullptr), slots_(nullptr), capacity_(0), size_(0), growthLeft_(0) {}
+
+// 预留容量的构造函数
+template <typename V>
+FBStringMap<V>::FBStringMap(size_t expected) : FBStringMap() {
+    reserve(expected);
+}
+
+// 拷贝构造函数：按相同的槽位数逐个插入，中型和大型的键共享缓冲区
+template <typename V>
+FBStringMap<V>::FBStringMap(const FBStringMap& other) : FBStringMap() {
+    reserve(other.size_);
+    for (const_iterator it = other.begin(); it != other.end(); ++it) {
+        insert(*it);
+    }
+}
+
+// 移动构造函数
+template <typename V>
+FBStringMap<V>::FBStringMap(FBStringMap&& other) noexcept : FBStringMap() {
+    swap(other);
+}
+
+// 拷贝赋值运算符
+template <typename V>
+FBStringMap<V>& FBStringMap<V>::operator=(const FBStringMap& other) {
+    if (this != &other) {
+        FBStringMap copy(other);
+        swap(copy);
+    }
+    return *this;
+}
+
+// 移动赋值运算符
+template <typename V>
+FBStringMap<V>& FBStringMap<V>::operator=(FBStringMap&& other) noexcept {
+    if (this != &other) {
+        destroy();
+        swap(other);
+    }
+    return *this;
+}
+
+// 析构函数
+template <typename V>
+FBStringMap<V>::~FBStringMap() {
+    destroy();
+}
+
+// 交换两个散列表的内容
+template <typename V>
+void FBStringMap<V>::swap(FBStringMap& other) noexcept {
+    std::swap(ctrl_, other.ctrl_);
+    std::swap(slots_, other.slots_);
+    std::swap(capacity_, other.capacity_);
+    std::swap(size_, other.size_);
+    std::swap(growthLeft_, other.growthLeft_);
+}
+
+// 迭代器
+template <typename V>
+typename FBStringMap<V>::iterator FBStringMap<V>::begin() {
+    iterator it(ctrl_, slots_, ctrl_ + capacity_);
+    it.skipFree();
+    return it;
+}
+
+template <typename V>
+typename FBStringMap<V>::iterator FBStringMap<V>::end() {
+    return iteratorAt(capacity_);
+}
+
+template <typename V>
+typename FBStringMap<V>::const_iterator FBStringMap<V>::begin() const {
+    const_iterator it(ctrl_, slots_, ctrl_ + capacity_);
+    it.skipFree();
+    return it;
+}
+
+template <typename V>
+typename FBStringMap<V>::const_iterator FBStringMap<V>::end() const {
+    return iteratorAt(capacity_);
+}
+
+// 返回元素个数
+template <typename V>
+size_t FBStringMap<V>::size() const {
+    return size_;
+}
+
+// 判断是否为空
+template <typename V>
+bool FBStringMap<V>::empty() const {
+    return size_ == 0;
+}
+
+// 返回槽位数
+template <typename V>
+size_t FBStringMap<V>::capacity() const {
+    return capacity_;
+}
+
+// 预留容量
+template <typename V>
+void FBStringMap<V>::reserve(size_t expected) {
+    const size_t needed = capacityFor(expected);
+    if (needed > capacity_) rehash(needed);
+}
+
+// 删除所有元素，保留槽位
+template <typename V>
+void FBStringMap<V>::clear() {
+    for (size_t i = 0; i < capacity_; ++i) {
+        if (ctrl_[i] >= 0) slots_[i].~value_type();
+    }
+    if (capacity_ != 0) std::memset(ctrl_, static_cast<unsigned char>(kEmpty), capacity_ + kGroupWidth - 1);
+    size_ = 0;
+    growthLeft_ = maxLoad(capacity_);
+}
+
+// 查找键
+template <typename V>
+typename FBStringMap<V>::iterator FBStringMap<V>::find(FBStringView key) {
+    return iteratorAt(findIndex(makeLookup(key)));
+}
+
+template <typename V>
+typename FBStringMap<V>::const_iterator FBStringMap<V>::find(FBStringView key) const {
+    return iteratorAt(findIndex(makeLookup(key)));
+}
+
+// 返回键出现的次数
+template <typename V>
+size_t FBStringMap<V>::count(FBStringView key) const {
+    return findIndex(makeLookup(key)) != capacity_ ? 1 : 0;
+}
+
+// 判断键是否存在
+template <typename V>
+bool FBStringMap<V>::contains(FBStringView key) const {
+    return findIndex(makeLookup(key)) != capacity_;
+}
+
+// 访问键对应的值，不存在时抛出异常
+template <typename V>
+V& FBStringMap<V>::at(FBStringView key) {
+    const size_t index = findIndex(makeLookup(key));
+    if (index == capacity_) throw std::out_of_range("Key not found");
+    return slots_[index].second;
+}
+
+template <typename V>
+const V& FBStringMap<V>::at(FBStringView key) const {
+    const size_t index = findIndex(makeLookup(key));
+    if (index == capacity_) throw std::out_of_range("Key not found");
+    return slots_[index].second;
+}
+
+// 访问键对应的值，不存在时插入
+template <typename V>
+V& FBStringMap<V>::operator[](FBStringView key) {
+    return emplaceImpl(makeLookup(key), key).first->second;
+}
+
+// 插入键值对，键共享 value.first 的缓冲区
+template <typename V>
+std::pair<typename FBStringMap<V>::iterator, bool> FBStringMap<V>::insert(const value_type& value) {
+    return emplaceImpl(makeLookup(value.first), value.first, value.second);
+}
+
+template <typename V>
+std::pair<typename FBStringMap<V>::iterator, bool> FBStringMap<V>::insert(value_type&& value) {
+    return emplaceImpl(makeLookup(value.first), value.first, std::move(value.second));
+}
+
+// 键不存在时构造值并插入
+template <typename V>
+template <typename... Args>
+std::pair<typename FBStringMap<V>::iterator, bool> FBStringMap<V>::try_emplace(FBStringView key, Args&&... args) {
+    return emplaceImpl(makeLookup(key), key, std::forward<Args>(args)...);
+}
+
+// 插入或赋值
+template <typename V>
+template <typename M>
+std::pair<typename FBStringMap<V>::iterator, bool> FBStringMap<V>::insert_or_assign(FBStringView key, M&& value) {
+    const Lookup lookup = makeLookup(key);
+    const size_t index = findIndex(lookup);
+    if (index != capacity_) {
+        slots_[index].second = std::forward<M>(value);
+        return std::make_pair(iteratorAt(index), false);
+    }
+    return emplaceImpl(lookup, key, std::forward<M>(value));
+}
+
+// 删除键
+template <typename V>
+size_t FBStringMap<V>::erase(FBStringView key) {
+    const size_t index = findIndex(makeLookup(key));
+    if (index == capacity_) return 0;
+    erase(iteratorAt(index));
+    return 1;
+}
+
+// 删除迭代器指向的元素，槽位留下删除标记以免截断其他键的探测序列
+template <typename V>
+typename FBStringMap<V>::iterator FBStringMap<V>::erase(const_iterator pos) {
+    const size_t index = static_cast<size_t>(pos.slot_ - slots_);
+    slots_[index].~value_type();
+    setCtrl(index, kDeleted);
+    --size_;
+    iterator next = iteratorAt(index);
+    ++next;
+    return next;
+}
+
+// 预处理查找键：不超过 kInlineKeySize 的键复制到补零的两个字中，并生成长度掩码
+template <typename V>
+typename FBStringMap<V>::Lookup FBStringMap<V>::makeLookup(FBStringView key, uint64_t hash) {
+    Lookup lookup;
+    lookup.data = key.data();
+    lookup.size = key.size();
+    lookup.hash = hash;
+    if (lookup.size <= kInlineKeySize) {
+        unsigned char bytes[kInlineKeySize] = {};
+        unsigned char masks[kInlineKeySize] = {};
+        if (lookup.size != 0) std::memcpy(bytes, lookup.data, lookup.size);
+        std::memset(masks, 0xFF, lookup.size);
+        std::memcpy(lookup.words, bytes, sizeof(bytes));
+        std::memcpy(lookup.masks, masks, sizeof(masks));
+    }
+    return lookup;
+}
+
+template <typename V>
+typename FBStringMap<V>::Lookup FBStringMap<V>::makeLookup(FBStringView key) {
+    return makeLookup(key, FBStringHash::hash(key.data(), key.size()));
+}
+
+// FBString 的键使用它缓存的散列值
+template <typename V>
+typename FBStringMap<V>::Lookup FBStringMap<V>::makeLookup(const FBString& key) {
+    return makeLookup(FBStringView(key.c_str(), key.size()), keyHash(key));
+}
+
+// 所有查找都从同一个 64 位散列值得到 H1 和 H2，size_t 为 32 位时不能使用截断的缓存值
+template <typename V>
+uint64_t FBStringMap<V>::keyHash(const FBString& key) {
+    if (sizeof(size_t) >= sizeof(uint64_t)) return key.hash();
+    return FBStringHash::hash(key.c_str(), key.size());
+}
+
+// 比较表中的键与查找键：短键在对象内部，直接读两个字按长度掩码比较
+template <typename V>
+bool FBStringMap<V>::keyEquals(const FBString& key, const Lookup& lookup) {
+    if (key.size() != lookup.size) return false;
+    if (lookup.size <= kInlineKeySize) {
+        // makeKey 保证这样的键保存在对象内部，从 c_str() 起至少 24 个字节可读
+        uint64_t words[2];
+        std::memcpy(words, key.c_str(), sizeof(words));
+        return (((words[0] ^ lookup.words[0]) & lookup.masks[0]) | ((words[1] ^ lookup.words[1]) & lookup.masks[1])) == 0;
+    }
+    return std::memcmp(key.c_str(), lookup.data, lookup.size) == 0;
+}
+
+// 从内容生成键：用 (data, size) 构造，短键一定保存在对象内部
+template <typename V>
+FBString FBStringMap<V>::makeKey(FBStringView key) {
+    return FBString(key.data(), key.size());
+}
+
+// 复制 FBString 作为键以共享缓冲区；缩短过的中型字符串可能很短却不在对象内部，这时重新构造
+template <typename V>
+FBString FBStringMap<V>::makeKey(const FBString& key) {
+    if (key.size() <= kInlineKeySize && !key.is_inline()) return FBString(key.c_str(), key.size());
+    return key;
+}
+
+// 匹配标签
+template <typename V>
+uint32_t FBStringMap<V>::matchTag(const int8_t* group, int8_t tag) {
+#if defined(FBSTRING_HAS_SSE2)
+    const __m128i ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+    return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(tag))));
+#else
+    uint32_t mask = 0;
+    for (size_t i = 0; i < kGroupWidth; ++i) {
+        mask |= static_cast<uint32_t>(group[i] == tag) << i;
+    }
+    return mask;
+#endif
+}
+
+// 匹配空槽和删除标记，即最高位为 1 的控制字节
+template <typename V>
+uint32_t FBStringMap<V>::matchFree(const int8_t* group) {
+#if defined(FBSTRING_HAS_SSE2)
+    return static_cast<uint32_t>(_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(group))));
+#else
+    uint32_t mask = 0;
+    for (size_t i = 0; i < kGroupWidth; ++i) {
+        mask |= static_cast<uint32_t>(group[i] < 0) << i;
+    }
+    return mask;
+#endif
+}
+
+// 返回最低位 1 的下标
+template <typename V>
+unsigned FBStringMap<V>::lowestBit(uint32_t mask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+}
+
+// 计算需要的槽位数
+template <typename V>
+size_t FBStringMap<V>::capacityFor(size_t expected) {
+    size_t capacity = kGroupWidth;
+    while (maxLoad(capacity) < expected) capacity <<= 1;
+    return capacity;
+}
+
+// 负载因子上限 7/8：保证任何探测序列都能遇到空槽
+template <typename V>
+size_t FBStringMap<V>::maxLoad(size_t capacity) {
+    return capacity - capacity / 8;
+}
+
+// 按组探测：起点由散列值的高位决定，组间步长依次为 16、32、48……，槽位数是 2 的幂时能遍历所有组
+template <typename V>
+size_t FBStringMap<V>::findIndex(const Lookup& lookup) const {
+    if (capacity_ == 0) return capacity_;
+    const size_t mask = capacity_ - 1;
+    const int8_t tag = static_cast<int8_t>(lookup.hash & 0x7F);
+    size_t pos = static_cast<size_t>(lookup.hash >> 7) & mask;
+    size_t stride = 0;
+    for (;;) {
+        const int8_t* group = ctrl_ + pos;
+        for (uint32_t match = matchTag(group, tag); match != 0; match &= match - 1) {
+            const size_t index = (pos + lowestBit(match)) & mask;
+            if (keyEquals(slots_[index].first, lookup)) return index;
+        }
+        if (matchTag(group, kEmpty) != 0) return capacity_;
+        stride += kGroupWidth;
+        pos = (pos + stride) & mask;
+    }
+}
+
+// 沿探测序列找第一个可用的槽位
+template <typename V>
+size_t FBStringMap<V>::findFree(uint64_t hash) const {
+    const size_t mask = capacity_ - 1;
+    size_t pos = static_cast<size_t>(hash >> 7) & mask;
+    size_t stride = 0;
+    for (;;) {
+        const uint32_t match = matchFree(ctrl_ + pos);
+        if (match != 0) return (pos + lowestBit(match)) & mask;
+        stride += kGroupWidth;
+        pos = (pos + stride) & mask;
+    }
+}
+
+// 设置控制字节
+template <typename V>
+void FBStringMap<V>::setCtrl(size_t index, int8_t tag) {
+    ctrl_[index] = tag;
+    if (index < kGroupWidth - 1) ctrl_[capacity_ + index] = tag;
+}
+
+// 查找或插入：没有空余时扩容；删除标记较多时按原槽位数重建
+template <typename V>
+template <typename K, typename... Args>
+std::pair<typename FBStringMap<V>::iterator, bool> FBStringMap<V>::emplaceImpl(const Lookup& lookup, const K& key, Args&&... args) {
+    size_t index = findIndex(lookup);
+    if (index != capacity_) return std::make_pair(iteratorAt(index), false);
+    index = capacity_ == 0 ? 0 : findFree(lookup.hash);
+    if (capacity_ == 0 || (growthLeft_ == 0 && ctrl_[index] == kEmpty)) {
+        // 扩容会移动已有元素，而键和参数可能引用表中的元素，所以先构造新元素再扩容
+        value_type element(std::piecewise_construct, std::forward_as_tuple(makeKey(key)), std::forward_as_tuple(std::forward<Args>(args)...));
+        rehash(capacity_ == 0 ? kGroupWidth : size_ + 1 <= maxLoad(capacity_) / 2 ? capacity_ : capacity_ * 2);
+        index = findFree(lookup.hash);
+        new (slots_ + index) value_type(std::move(element));
+    } else {
+        // 先构造元素再写控制字节，构造抛出异常时表保持不变
+        new (slots_ + index) value_type(std::piecewise_construct, std::forward_as_tuple(makeKey(key)), std::forward_as_tuple(std::forward<Args>(args)...));
+    }
+    if (ctrl_[index] == kEmpty) --growthLeft_;
+    setCtrl(index, static_cast<int8_t>(lookup.hash & 0x7F));
+    ++size_;
+    return std::make_pair(iteratorAt(index), true);
+}
+
+// 重新分配并重新插入：键的散列值重新计算（大型字符串使用缓存），键本身复制时共享缓冲区
+template <typename V>
+void FBStringMap<V>::rehash(size_t newCapacity) {
+    int8_t* newCtrl = new int8_t[newCapacity + kGroupWidth - 1];
+    value_type* newSlots;
+    try {
+        newSlots = static_cast<value_type*>(::operator new(newCapacity * sizeof(value_type)));
+    } catch (...) {
+        delete[] newCtrl;
+        throw;
+    }
+    std::memset(newCtrl, static_cast<unsigned char>(kEmpty), newCapacity + kGroupWidth - 1);
+
+    int8_t* oldCtrl = ctrl_;
+    value_type* oldSlots = slots_;
+    const size_t oldCapacity = capacity_;
+    ctrl_ = newCtrl;
+    slots_ = newSlots;
+    capacity_ = newCapacity;
+    growthLeft_ = maxLoad(newCapacity) - size_;
+
+    for (size_t i = 0; i < oldCapacity; ++i) {
+        if (oldCtrl[i] < 0) continue;
+        const uint64_t hash = keyHash(oldSlots[i].first);
+        const size_t index = findFree(hash);
+        new (slots_ + index) value_type(std::move(oldSlots[i]));
+        setCtrl(index, static_cast<int8_t>(hash & 0x7F));
+        oldSlots[i].~value_type();
+    }
+    delete[] oldCtrl;
+    ::operator delete(oldSlots);
+}
+
+// 析构所有元素并释放槽位
+template <typename V>
+void FBStringMap<V>::destroy() {
+    for (size_t i = 0; i < capacity_; ++i) {
+        if (ctrl_[i] >= 0) slots_[i].~value_type();
+    }
+    delete[] ctrl_;
+    ::operator delete(slots_);
+    ctrl_ = nullptr;
+    slots_ = nullptr;
+    capacity_ = 0;
+    size_ = 0;
+    growthLeft_ = 0;
+}
+
+// 构造指向槽位的迭代器
+template <typename V>
+typename FBStringMap<V>::iterator FBStringMap<V>::iteratorAt(size_t index) {
+    return iterator(ctrl_ + index, slots_ + index, ctrl_ + capacity_);
+}
+
+template <typename V>
+typename FBStringMap<V>::const_iterator FBStringMap<V>::iteratorAt(size_t index) const {
+    return const_iterator(ctrl_ + index, slots_ + index, ctrl_ + capacity_);
+}
+
+#endif // FBSTRING_MAP_H
@@ -0,0 +1,1226 @@
+#ifndef FBSTRING_RADIX_TREE_H
+#define FBSTRING_RADIX_TREE_H
+
+#include "FBString.h"
+#include "FBStringView.h"
+#include "FBStringSimd.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+
+#if defined(FBSTRING_HAS_SSE2)
+#include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+/**
+ * 以 FBString 为键的自适应基数树（Adaptive Radix Tree）
+ * 每个内部节点按一个字节分支，子节点数决定节点大小：4、16 个子节点的节点保存有序的键字节数组，
+ * 48 个子节点的节点用 256 项的字节索引，256 个子节点的节点直接按字节下标。子节点增减时在这四种节点之间转换。
+ * 只有一个子节点的路径被压缩为节点的前缀，前缀只保存前 8 个字节，更长的部分需要时从子树中任一叶子的键读取。
+ * 叶子保存完整的键和值；键恰好在某个内部节点处结束时，叶子挂在该节点的 terminal 上，所以一个键可以是另一个键的前缀。
+ * 键可以包含任意字节（包括 '\0'），遍历按字节的无符号值排序，与 FBString 的比较运算符一致。
+ * 除了精确查找，还支持最长前缀匹配（例如 URL 路由）和按前缀遍历。
+ * 叶子插入后不再移动，元素的指针在删除该元素或树销毁之前一直有效。
+ * @tparam V 值类型
+ */
+template <typename V>
+class FBStringRadixTree {
+public:
+    typedef FBString key_type;
+    typedef V mapped_type;
+    typedef std::pair<const FBString, V> value_type;
+    typedef size_t size_type;
+
+    /**
+     * 默认构造函数
+     */
+    FBStringRadixTree();
+
+    FBStringRadixTree(const FBStringRadixTree& other);
+    FBStringRadixTree(FBStringRadixTree&& other) noexcept;
+    FBStringRadixTree& operator=(const FBStringRadixTree& other);
+    FBStringRadixTree& operator=(FBStringRadixTree&& other) noexcept;
+    ~FBStringRadixTree();
+
+    /**
+     * 交换两棵树的内容
+     * @param other 要交换的树
+     */
+    void swap(FBStringRadixTree& other) noexcept;
+
+    /**
+     * 返回元素个数
+     * @return 元素个数
+     */
+    size_t size() const;
+
+    /**
+     * 判断是否为空
+     * @return 为空返回 true
+     */
+    bool empty() const;
+
+    /**
+     * 删除所有元素
+     */
+    void clear();
+
+    /**
+     * 查找键
+     * @param key 要查找的键
+     * @return 找到时为指向该元素的指针，否则为 nullptr
+     */
+    value_type* find(FBStringView key);
+    const value_type* find(FBStringView key) const;
+
+    /**
+     * 返回键出现的次数
+     * @param key 要查找的键
+     * @return 0 或 1
+     */
+    size_t count(FBStringView key) const;
+
+    /**
+     * 判断键是否存在
+     * @param key 要查找的键
+     * @return 存在返回 true
+     */
+    bool contains(FBStringView key) const;
+
+    /**
+     * 访问键对应的值
+     * @param key 要查找的键
+     * @return 值的引用
+     * @throws out_of_range 如果键不存在
+     */
+    V& at(FBStringView key);
+    const V& at(FBStringView key) const;
+
+    /**
+     * 访问键对应的值，键不存在时插入值初始化的值
+     * @param key 键
+     * @return 值的引用
+     * @throws length_error 如果键的长度不小于 2^32
+     */
+    V& operator[](FBStringView key);
+
+    /**
+     * 插入键值对，键已存在时不做修改
+     * 键是中型或大型字符串时与 value.first 共享缓冲区，不复制内容。
+     * @param value 键值对
+     * @return 指向键所在元素的指针，以及是否插入了新元素
+     * @throws length_error 如果键的长度不小于 2^32
+     */
+    std::pair<value_type*, bool> insert(const value_type& value);
+    std::pair<value_type*, bool> insert(value_type&& value);
+
+    /**
+     * 键不存在时用 args 构造值并插入，键已存在时不做修改，也不构造值
+     * @param key 键
+     * @param args 值的构造参数
+     * @return 指向键所在元素的指针，以及是否插入了新元素
+     * @throws length_error 如果键的长度不小于 2^32
+     */
+    template <typename... Args>
+    std::pair<value_type*, bool> try_emplace(FBStringView key, Args&&... args);
+
+    /**
+     * 键不存在时插入，已存在时赋值
+     * @param key 键
+     * @param value 值
+     * @return 指向键所在元素的指针，以及是否插入了新元素
+     * @throws length_error 如果键的长度不小于 2^32
+     */
+    template <typename M>
+    std::pair<value_type*, bool> insert_or_assign(FBStringView key, M&& value);
+
+    /**
+     * 删除键，必要时把节点换成更小的类型或与唯一的子节点合并
+     * @param key 要删除的键
+     * @return 删除的元素个数，0 或 1
+     */
+    size_t erase(FBStringView key);
+
+    /**
+     * 最长前缀匹配：在所有是 key 的前缀的键（包括 key 本身）中找最长的一个
+     * @param key 要匹配的字符串，例如请求的 URL 路径
+     * @return 找到时为指向该元素的指针，否则为 nullptr
+     */
+    value_type* longest_prefix(FBStringView key);
+    const value_type* longest_prefix(FBStringView key) const;
+
+    /**
+     * 按键的顺序遍历所有元素
+     * @param f 对每个元素调用 f(const value_type&)
+     */
+    template <typename F>
+    void for_each(F f) const;
+
+    /**
+     * 按键的顺序遍历以 prefix 开头的所有元素，只访问对应的子树
+     * @param prefix 前缀
+     * @param f 对每个元素调用 f(const value_type&)
+     */
+    template <typename F>
+    void for_each_prefix(FBStringView prefix, F f) const;
+
+    /**
+     * 返回树结构占用的内存字节数，包括所有节点、叶子和树对象本身，不包括键自己的堆缓冲区
+     * @return 字节数
+     */
+    size_t memory_usage() const;
+
+private:
+    /** 节点类型 */
+    enum : uint8_t { kLeaf, kNode4, kNode16, kNode48, kNode256 };
+
+    /** 节点中保存的前缀的最大字节数 */
+    static const size_t kMaxPrefixLength = 8;
+
+    /** 节点的公共头部 */
+    struct Node {
+        uint8_t type;
+
+        explicit Node(uint8_t t) : type(t) {}
+    };
+
+    /** 叶子：完整的键和值 */
+    struct Leaf : Node {
+        value_type entry;
+
+        template <typename... Args>
+        explicit Leaf(FBString&& key, Args&&... args)
+            : Node(kLeaf), entry(std::piecewise_construct, std::forward_as_tuple(std::move(key)), std::forward_as_tuple(std::forward<Args>(args)...)) {}
+    };
+
+    /** 内部节点的公共部分：子节点数、压缩的前缀，以及恰好在前缀之后结束的键 */
+    struct Inner : Node {
+        uint16_t numChildren;
+        uint32_t prefixLength;                  /**< 前缀的完整长度 */
+        Leaf* terminal;
+        unsigned char prefix[kMaxPrefixLength]; /**< 前缀的前 min(prefixLength, kMaxPrefixLength) 个字节 */
+
+        explicit Inner(uint8_t t) : Node(t), numChildren(0), prefixLength(0), terminal(nullptr) {}
+    };
+
+    /** 最多 4 个子节点，keys 有序 */
+    struct Node4 : Inner {
+        unsigned char keys[4];
+        Node* children[4];
+
+        Node4() : Inner(kNode4) {}
+    };
+
+    /** 最多 16 个子节点，keys 有序，查找时一次比较 16 个字节 */
+    struct Node16 : Inner {
+        unsigned char keys[16];
+        Node* children[16];
+
+        Node16() : Inner(kNode16) {}
+    };
+
+    /** 最多 48 个子节点，index[b] 为 0 表示没有字节 b 的子节点，否则是 children 的下标加一 */
+    struct Node48 : Inner {
+        unsigned char index[256];
+        Node* children[48];
+
+        Node48() : Inner(kNode48) {
+            std::memset(index, 0, sizeof(index));
+            for (size_t i = 0; i < 48; ++i) children[i] = nullptr;
+        }
+    };
+
+    /** 每个字节一个子节点 */
+    struct Node256 : Inner {
+        Node* children[256];
+
+        Node256() : Inner(kNode256) {
+            for (size_t i = 0; i < 256; ++i) children[i] = nullptr;
+        }
+    };
+
+    /**
+     * 生成要保存到叶子中的键
+     * @param key 键的内容，或者共享其缓冲区的 FBString
+     * @return 键
+     */
+    static FBString makeKey(FBStringView key);
+    static FBString makeKey(const FBString& key);
+
+    /**
+     * 返回叶子的键
+     * @param leaf 叶子
+     * @return 键的视图
+     */
+    static FBStringView leafKey(const Leaf* leaf);
+
+    /**
+     * 返回子树中任意一个叶子，用于读取超出 kMaxPrefixLength 的前缀
+     * @param node 非空的子树
+     * @return 叶子
+     */
+    static const Leaf* anyLeaf(const Node* node);
+
+    /**
+     * 比较节点的前缀与 key 从 depth 开始的部分，超出保存长度的部分从子树的叶子读取
+     * @param inner 节点
+     * @param key 键
+     * @param depth 前缀在键中的起始位置
+     * @return 相同的字节数，不超过前缀长度和 key 的剩余长度
+     */
+    static size_t matchPrefix(const Inner* inner, FBStringView key, size_t depth);
+
+    /**
+     * 只比较节点中保存的前缀字节，超出部分留到叶子处比较键时验证
+     * @param inner 节点
+     * @param key 键
+     * @param depth 前缀在键中的起始位置
+     * @return key 剩余部分不短于前缀且保存的字节都相同返回 true
+     */
+    static bool matchStoredPrefix(const Inner* inner, FBStringView key, size_t depth);
+
+    /**
+     * 设置节点的前缀
+     * @param inner 节点
+     * @param data 前缀内容
+     * @param length 前缀长度
+     */
+    static void setPrefix(Inner* inner, const char* data, size_t length);
+
+    /**
+     * 查找字节 b 对应的子节点槽位
+     * @param inner 节点
+     * @param b 字节
+     * @return 槽位，没有这个子节点时为 nullptr
+     */
+    static Node** findChild(Inner* inner, unsigned char b);
+    static Node* const* findChild(const Inner* inner, unsigned char b);
+
+    /**
+     * 添加字节 b 对应的子节点，节点已满时换成更大的类型并更新 ref
+     * 新节点分配成功之前不修改树，分配失败时抛出异常，树保持不变。
+     * @param ref 指向节点的槽位
+     * @param b 字节，节点中还没有这个子节点
+     * @param child 子节点
+     */
+    static void addChild(Node** ref, unsigned char b, Node* child);
+
+    /**
+     * 删除字节 b 对应的子节点
+     * @param inner 节点
+     * @param b 字节，节点中有这个子节点
+     */
+    static void removeChild(Inner* inner, unsigned char b);
+
+    /**
+     * 删除之后整理节点：没有子节点时换成 terminal，只有一个子节点时与子节点合并，子节点变少时换成更小的类型
+     * 换成更小的类型时分配失败就保留原节点，不抛出异常。
+     * @param ref 指向节点的槽位
+     */
+    static void compact(Node** ref);
+
+    /**
+     * 把内部节点的公共部分复制到新节点
+     * @param dst 新节点
+     * @param src 原节点
+     */
+    static void copyHeader(Inner* dst, const Inner* src);
+
+    /**
+     * 按类型释放单个节点，不释放子节点
+     * @param node 节点
+     */
+    static void freeNode(Node* node);
+
+    /**
+     * 释放子树
+     * @param node 子树，可以为 nullptr
+     */
+    static void destroy(Node* node);
+
+    /**
+     * 按键的顺序遍历子树
+     * @param node 非空的子树
+     * @param f 回调
+     */
+    template <typename F>
+    static void visit(const Node* node, F& f);
+
+    /**
+     * 统计子树占用的内存
+     * @param node 子树，可以为 nullptr
+     * @return 字节数
+     */
+    static size_t subtreeMemory(const Node* node);
+
+    /**
+     * 查找键，不存在时构造键和值并插入
+     * @param key 键
+     * @param source 键的内容，或者共享其缓冲区的 FBString
+     * @param args 值的构造参数
+     * @return 指向键所在元素的指针，以及是否插入了新元素
+     */
+    template <typename K, typename... Args>
+    std::pair<value_type*, bool> emplaceImpl(FBStringView key, const K& source, Args&&... args);
+
+    /**
+     * 删除子树中的键
+     * @param ref 指向子树的槽位
+     * @param key 键
+     * @param depth 子树在键中的起始位置
+     * @return 删除了返回 true
+     */
+    static bool eraseImpl(Node** ref, FBStringView key, size_t depth);
+
+    Node* root_;  /**< 根节点 */
+    size_t size_; /**< 元素个数 */
+};
+
+// 默认构造函数
+template <typename V>
+FBStringRadixTree<V>::FBStringRadixTree() : root_(nullptr), size_(0) {}
+
+// 拷贝构造函数：按顺序逐个插入，中型和大型的键共享缓冲区
+template <typename V>
+FBStringRadixTree<V>::FBStringRadixTree(const FBStringRadixTree& other) : FBStringRadixTree() {
+    other.for_each([this](const value_type& value) { insert(value); });
+}
+
+// 移动构造函数
+template <typename V>
+FBStringRadixTree<V>::FBStringRadixTree(FBStringRadixTree&& other) noexcept : FBStringRadixTree() {
+    swap(other);
+}
+
+// 拷贝赋值运算符
+template <typename V>
+FBStringRadixTree<V>& FBStringRadixTree<V>::operator=(const FBStringRadixTree& other) {
+    if (this != &other) {
+        FBStringRadixTree copy(other);
+        swap(copy);
+    }
+    return *this;
+}
+
+// 移动赋值运算符
+template <typename V>
+FBStringRadixTree<V>& FBStringRadixTree<V>::operator=(FBStringRadixTree&& other) noexcept {
+    if (this != &other) {
+        clear();
+        swap(other);
+    }
+    return *this;
+}
+
+// 析构函数
+template <typename V>
+FBStringRadixTree<V>::~FBStringRadixTree() {
+    destroy(root_);
+}
+
+// 交换两棵树的内容
+template <typename V>
+void FBStringRadixTree<V>::swap(FBStringRadixTree& other) noexcept {
+    std::swap(root_, other.root_);
+    std::swap(size_, other.size_);
+}
+
+template <typename V>
+size_t FBStringRadixTree<V>::size() const {
+    return size_;
+}
+
+template <typename V>
+bool FBStringRadixTree<V>::empty() const {
+    return size_ == 0;
+}
+
+// 删除所有元素
+template <typename V>
+void FBStringRadixTree<V>::clear() {
+    destroy(root_);
+    root_ = nullptr;
+    size_ = 0;
+}
+
+// 查找键：沿途只比较节点中保存的前缀字节，最后比较叶子的完整键
+template <typename V>
+typename FBStringRadixTree<V>::value_type* FBStringRadixTree<V>::find(FBStringView key) {
+    return const_cast<value_type*>(static_cast<const FBStringRadixTree*>(this)->find(key));
+}
+
+template <typename V>
+const typename FBStringRadixTree<V>::value_type* FBStringRadixTree<V>::find(FBStringView key) const {
+    const Node* node = root_;
+    size_t depth = 0;
+    while (node != nullptr) {
+        if (node->type == kLeaf) {
+            const Leaf* leaf = static_cast<const Leaf*>(node);
+            return leafKey(leaf) == key ? &leaf->entry : nullptr;
+        }
+        const Inner* inner = static_cast<const Inner*>(node);
+        if (inner->prefixLength != 0) {
+            if (!matchStoredPrefix(inner, key, depth)) return nullptr;
+            depth += inner->prefixLength;
+        }
+        if (depth == key.size()) {
+            const Leaf* leaf = inner->terminal;
+            return leaf != nullptr && leafKey(leaf) == key ? &leaf->entry : nullptr;
+        }
+        Node* const* child = findChild(inner, static_cast<unsigned char>(key[depth]));
+        node = child != nullptr ? *child : nullptr;
+        ++depth;
+    }
+    return nullptr;
+}
+
+template <typename V>
+size_t FBStringRadixTree<V>::count(FBStringView key) const {
+    return find(key) != nullptr ? 1 : 0;
+}
+
+template <typename V>
+bool FBStringRadixTree<V>::contains(FBStringView key) const {
+    return find(key) != nullptr;
+}
+
+// 访问键对应的值，不存在时抛出异常
+template <typename V>
+V& FBStringRadixTree<V>::at(FBStringView key) {
+    value_type* entry = find(key);
+    if (entry == nullptr) throw std::out_of_range("Key not found");
+    return entry->second;
+}
+
+template <typename V>
+const V& FBStringRadixTree<V>::at(FBStringView key) const {
+    const value_type* entry = find(key);
+    if (entry == nullptr) throw std::out_of_range("Key not found");
+    return entry->second;
+}
+
+// 访问键对应的值，不存在时插入
+template <typename V>
+V& FBStringRadixTree<V>::operator[](FBStringView key) {
+    return emplaceImpl(key, key).first->second;
+}
+
+// 插入键值对，键共享 value.first 的缓冲区
+template <typename V>
+std::pair<typename FBStringRadixTree<V>::value_type*, bool> FBStringRadixTree<V>::insert(const value_type& value) {
+    return emplaceImpl(FBStringView(value.first), value.first, value.second);
+}
+
+template <typename V>
+std::pair<typename FBStringRadixTree<V>::value_type*, bool> FBStringRadixTree<V>::insert(value_type&& value) {
+    return emplaceImpl(FBStringView(value.first), value.first, std::move(value.second));
+}
+
+// 键不存在时构造值并插入
+template <typename V>
+template <typename... Args>
+std::pair<typename FBStringRadixTree<V>::value_type*, bool> FBStringRadixTree<V>::try_emplace(FBStringView key, Args&&... args) {
+    return emplaceImpl(key, key, std::forward<Args>(args)...);
+}
+
+// 插入或赋值
+template <typename V>
+template <typename M>
+std::pair<typename FBStringRadixTree<V>::value_type*, bool> FBStringRadixTree<V>::insert_or_assign(FBStringView key, M&& value) {
+    value_type* entry = find(key);
+    if (entry != nullptr) {
+        entry->second = std::forward<M>(value);
+        return std::make_pair(entry, false);
+    }
+    return emplaceImpl(key, key, std::forward<M>(value));
+}
+
+// 删除键
+template <typename V>
+size_t FBStringRadixTree<V>::erase(FBStringView key) {
+    if (!eraseImpl(&root_, key, 0)) return 0;
+    --size_;
+    return 1;
+}
+
+// 最长前缀匹配：沿 key 向下走，记录经过的最后一个 terminal；前缀完整比较，所以记录的键一定是 key 的前缀
+template <typename V>
+typename FBStringRadixTree<V>::value_type* FBStringRadixTree<V>::longest_prefix(FBStringView key) {
+    return const_cast<value_type*>(static_cast<const FBStringRadixTree*>(this)->longest_prefix(key));
+}
+
+template <typename V>
+const typename FBStringRadixTree<V>::value_type* FBStringRadixTree<V>::longest_prefix(FBStringView key) const {
+    const Node* node = root_;
+    const Leaf* best = nullptr;
+    size_t depth = 0;
+    while (node != nullptr) {
+        if (node->type == kLeaf) {
+            // depth 之前的字节已经比较过
+            const Leaf* leaf = static_cast<const Leaf*>(node);
+            const FBStringView candidate = leafKey(leaf);
+            if (candidate.size() <= key.size() && std::memcmp(candidate.data() + depth, key.data() + depth, candidate.size() - depth) == 0) {
+                best = leaf;
+            }
+            break;
+        }
+        const Inner* inner = static_cast<const Inner*>(node);
+        if (inner->prefixLength != 0) {
+            if (matchPrefix(inner, key, depth) != inner->prefixLength) break;
+            depth += inner->prefixLength;
+        }
+        if (inner->terminal != nullptr) best = inner->terminal;
+        if (depth == key.size()) break;
+        Node* const* child = findChild(inner, static_cast<unsigned char>(key[depth]));
+        node = child != nullptr ? *child : nullptr;
+        ++depth;
+    }
+    return best != nullptr ? &best->entry : nullptr;
+}
+
+// 按键的顺序遍历
+template <typename V>
+template <typename F>
+void FBStringRadixTree<V>::for_each(F f) const {
+    if (root_ != nullptr) visit(root_, f);
+}
+
+// 按前缀遍历：找到 prefix 结束处的子树后整棵遍历
+template <typename V>
+template <typename F>
+void FBStringRadixTree<V>::for_each_prefix(FBStringView prefix, F f) const {
+    const Node* node = root_;
+    size_t depth = 0;
+    while (node != nullptr) {
+        if (node->type == kLeaf) {
+            if (leafKey(static_cast<const Leaf*>(node)).starts_with(prefix)) visit(node, f);
+            return;
+        }
+        const Inner* inner = static_cast<const Inner*>(node);
+        if (inner->prefixLength != 0) {
+            const size_t matched = matchPrefix(inner, prefix, depth);
+            // prefix 在节点的前缀中间结束时，整棵子树都以 prefix 开头
+            if (matched == prefix.size() - depth) {
+                visit(node, f);
+                return;
+            }
+            if (matched != inner->prefixLength) return;
+            depth += inner->prefixLength;
+        }
+        if (depth == prefix.size()) {
+            visit(node, f);
+            return;
+        }
+        Node* const* child = findChild(inner, static_cast<unsigned char>(prefix[depth]));
+        node = child != nullptr ? *child : nullptr;
+        ++depth;
+    }
+}
+
+// 树结构占用的内存
+template <typename V>
+size_t FBStringRadixTree<V>::memory_usage() const {
+    return sizeof(*this) + subtreeMemory(root_);
+}
+
+// 从内容生成键
+template <typename V>
+FBString FBStringRadixTree<V>::makeKey(FBStringView key) {
+    return FBString(key.data(), key.size());
+}
+
+// 复制 FBString 作为键以共享缓冲区
+template <typename V>
+FBString FBStringRadixTree<V>::makeKey(const FBString& key) {
+    return key;
+}
+
+template <typename V>
+FBStringView FBStringRadixTree<V>::leafKey(const Leaf* leaf) {
+    return FBStringView(leaf->entry.first.c_str(), leaf->entry.first.size());
+}
+
+// 子树中任意一个叶子：优先取 terminal，否则沿第一个子节点向下
+template <typename V>
+const typename FBStringRadixTree<V>::Leaf* FBStringRadixTree<V>::anyLeaf(const Node* node) {
+    for (;;) {
+        switch (node->type) {
+        case kLeaf:
+            return static_cast<const Leaf*>(node);
+        case kNode4:
+        case kNode16:
+        case kNode48:
+        case kNode256: {
+            const Inner* inner = static_cast<const Inner*>(node);
+            if (inner->terminal != nullptr) return inner->terminal;
+            if (node->type == kNode4) {
+                node = static_cast<const Node4*>(node)->children[0];
+            } else if (node->type == kNode16) {
+                node = static_cast<const Node16*>(node)->children[0];
+            } else {
+                Node* const* children = node->type == kNode48 ? static_cast<const Node48*>(node)->children : static_cast<const Node256*>(node)->children;
+                size_t i = 0;
+                while (children[i] == nullptr) ++i;
+                node = children[i];
+            }
+            break;
+        }
+        }
+    }
+}
+
+// 完整比较前缀
+template <typename V>
+size_t FBStringRadixTree<V>::matchPrefix(const Inner* inner, FBStringView key, size_t depth) {
+    const size_t remaining = key.size() - depth;
+    const size_t limit = inner->prefixLength < remaining ? inner->prefixLength : remaining;
+    const size_t stored = limit < kMaxPrefixLength ? limit : kMaxPrefixLength;
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(key.data()) + depth;
+    for (size_t i = 0; i < stored; ++i) {
+        if (inner->prefix[i] != p[i]) return i;
+    }
+    if (limit > kMaxPrefixLength) {
+        // 子树中所有键在这段前缀上都相同，任取一个叶子的键比较
+        const unsigned char* full = reinterpret_cast<const unsigned char*>(leafKey(anyLeaf(inner)).data()) + depth;
+        for (size_t i = kMaxPrefixLength; i < limit; ++i) {
+            if (full[i] != p[i]) return i;
+        }
+    }
+    return limit;
+}
+
+// 只比较保存的前缀字节
+template <typename V>
+bool FBStringRadixTree<V>::matchStoredPrefix(const Inner* inner, FBStringView key, size_t depth) {
+    if (key.size() - depth < inner->prefixLength) return false;
+    const size_t stored = inner->prefixLength < kMaxPrefixLength ? inner->prefixLength : kMaxPrefixLength;
+    return std::memcmp(inner->prefix, key.data() + depth, stored) == 0;
+}
+
+// 设置前缀，只保存前 kMaxPrefixLength 个字节
+template <typename V>
+void FBStringRadixTree<V>::setPrefix(Inner* inner, const char* data, size_t length) {
+    inner->prefixLength = static_cast<uint32_t>(length);
+    std::memcpy(inner->prefix, data, length < kMaxPrefixLength ? length : kMaxPrefixLength);
+}
+
+// 查找子节点
+template <typename V>
+typename FBStringRadixTree<V>::Node** FBStringRadixTree<V>::findChild(Inner* inner, unsigned char b) {
+    return const_cast<Node**>(findChild(static_cast<const Inner*>(inner), b));
+}
+
+template <typename V>
+typename FBStringRadixTree<V>::Node* const* FBStringRadixTree<V>::findChild(const Inner* inner, unsigned char b) {
+    switch (inner->type) {
+    case kNode4: {
+        const Node4* node = static_cast<const Node4*>(inner);
+        for (size_t i = 0; i < node->numChildren; ++i) {
+            if (node->keys[i] == b) return &node->children[i];
+        }
+        return nullptr;
+    }
+    case kNode16: {
+        const Node16* node = static_cast<const Node16*>(inner);
+#if defined(FBSTRING_HAS_SSE2)
+        const __m128i keys = _mm_loadu_si128(reinterpret_cast<const __m128i*>(node->keys));
+        const uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(keys, _mm_set1_epi8(static_cast<char>(b))))) &
+                              ((1u << node->numChildren) - 1);
+        if (mask == 0) return nullptr;
+#if defined(_MSC_VER) && !defined(__clang__)
+        unsigned long index;
+        _BitScanForward(&index, mask);
+        return &node->children[index];
+#else
+        return &node->children[__builtin_ctz(mask)];
+#endif
+#else
+        for (size_t i = 0; i < node->numChildren; ++i) {
+            if (node->keys[i] == b) return &node->children[i];
+        }
+        return nullptr;
+#endif
+    }
+    case kNode48: {
+        const Node48* node = static_cast<const Node48*>(inner);
+        const unsigned char index = node->index[b];
+        return index != 0 ? &node->children[index - 1] : nullptr;
+    }
+    default: {
+        const Node256* node = static_cast<const Node256*>(inner);
+        return node->children[b] != nullptr ? &node->children[b] : nullptr;
+    }
+    }
+}
+
+// 添加子节点，节点已满时换成更大的类型
+template <typename V>
+void FBStringRadixTree<V>::addChild(Node** ref, unsigned char b, Node* child) {
+    Inner* inner = static_cast<Inner*>(*ref);
+    switch (inner->type) {
+    case kNode4: {
+        Node4* node = static_cast<Node4*>(inner);
+        if (node->numChildren < 4) {
+            size_t i = node->numChildren;
+            for (; i > 0 && node->keys[i - 1] > b; --i) {
+                node->keys[i] = node->keys[i - 1];
+                node->children[i] = node->children[i - 1];
+            }
+            node->keys[i] = b;
+            node->children[i] = child;
+            ++node->numChildren;
+            return;
+        }
+        Node16* bigger = new Node16();
+        copyHeader(bigger, node);
+        std::memcpy(bigger->keys, node->keys, sizeof(node->keys));
+        std::memcpy(bigger->children, node->children, sizeof(node->children));
+        *ref = bigger;
+        delete node;
+        addChild(ref, b, child);
+        return;
+    }
+    case kNode16: {
+        Node16* node = static_cast<Node16*>(inner);
+        if (node->numChildren < 16) {
+            size_t i = node->numChildren;
+            for (; i > 0 && node->keys[i - 1] > b; --i) {
+                node->keys[i] = node->keys[i - 1];
+                node->children[i] = node->children[i - 1];
+            }
+            node->keys[i] = b;
+            node->children[i] = child;
+            ++node->numChildren;
+            return;
+        }
+        Node48* bigger = new Node48();
+        copyHeader(bigger, node);
+        for (size_t i = 0; i < 16; ++i) {
+            bigger->index[node->keys[i]] = static_cast<unsigned char>(i + 1);
+            bigger->children[i] = node->children[i];
+        }
+        *ref = bigger;
+        delete node;
+        addChild(ref, b, child);
+        return;
+    }
+    case kNode48: {
+        Node48* node = static_cast<Node48*>(inner);
+        if (node->numChildren < 48) {
+            size_t slot = 0;
+            while (node->children[slot] != nullptr) ++slot;
+            node->children[slot] = child;
+            node->index[b] = static_cast<unsigned char>(slot + 1);
+            ++node->numChildren;
+            return;
+        }
+        Node256* bigger = new Node256();
+        copyHeader(bigger, node);
+        for (size_t c = 0; c < 256; ++c) {
+            if (node->index[c] != 0) bigger->children[c] = node->children[node->index[c] - 1];
+        }
+        *ref = bigger;
+        delete node;
+        addChild(ref, b, child);
+        return;
+    }
+    default: {
+        Node256* node = static_cast<Node256*>(inner);
+        node->children[b] = child;
+        ++node->numChildren;
+        return;
+    }
+    }
+}
+
+// 删除子节点
+template <typename V>
+void FBStringRadixTree<V>::removeChild(Inner* inner, unsigned char b) {
+    switch (inner->type) {
+    case kNode4:
+    case kNode16: {
+        unsigned char* keys = inner->type == kNode4 ? static_cast<Node4*>(inner)->keys : static_cast<Node16*>(inner)->keys;
+        Node** children = inner->type == kNode4 ? static_cast<Node4*>(inner)->children : static_cast<Node16*>(inner)->children;
+        size_t i = 0;
+        while (keys[i] != b) ++i;
+        for (; i + 1 < inner->numChildren; ++i) {
+            keys[i] = keys[i + 1];
+            children[i] = children[i + 1];
+        }
+        break;
+    }
+    case kNode48: {
+        Node48* node = static_cast<Node48*>(inner);
+        node->children[node->index[b] - 1] = nullptr;
+        node->index[b] = 0;
+        break;
+    }
+    default:
+        static_cast<Node256*>(inner)->children[b] = nullptr;
+        break;
+    }
+    --inner->numChildren;
+}
+
+// 删除之后整理节点
+template <typename V>
+void FBStringRadixTree<V>::compact(Node** ref) {
+    Inner* inner = static_cast<Inner*>(*ref);
+    if (inner->numChildren == 0) {
+        // 叶子保存完整的键，可以直接放在任何位置
+        *ref = inner->terminal;
+        freeNode(inner);
+        return;
+    }
+    if (inner->numChildren == 1 && inner->terminal == nullptr) {
+        unsigned char b = 0;
+        Node* child = nullptr;
+        for (unsigned c = 0; c < 256 && child == nullptr; ++c) {
+            Node* const* slot = findChild(static_cast<const Inner*>(inner), static_cast<unsigned char>(c));
+            if (slot != nullptr) {
+                b = static_cast<unsigned char>(c);
+                child = *slot;
+            }
+        }
+        if (child->type != kLeaf) {
+            // 把本节点的前缀、分支字节和子节点的前缀合并为子节点的前缀
+            Inner* next = static_cast<Inner*>(child);
+            unsigned char prefix[kMaxPrefixLength];
+            size_t n = inner->prefixLength < kMaxPrefixLength ? inner->prefixLength : kMaxPrefixLength;
+            std::memcpy(prefix, inner->prefix, n);
+            if (n < kMaxPrefixLength) prefix[n++] = b;
+            const size_t rest = next->prefixLength < kMaxPrefixLength - n ? next->prefixLength : kMaxPrefixLength - n;
+            std::memcpy(prefix + n, next->prefix, rest);
+            std::memcpy(next->prefix, prefix, n + rest);
+            next->prefixLength += inner->prefixLength + 1;
+        }
+        *ref = child;
+        freeNode(inner);
+        return;
+    }
+    // 子节点变少时换成更小的类型，阈值比扩大时低一些，避免在边界上反复转换
+    switch (inner->type) {
+    case kNode16: {
+        if (inner->numChildren > 3) return;
+        Node16* node = static_cast<Node16*>(inner);
+        Node4* smaller = new (std::nothrow) Node4();
+        if (smaller == nullptr) return;
+        copyHeader(smaller, node);
+        std::memcpy(smaller->keys, node->keys, node->numChildren);
+        std::memcpy(smaller->children, node->children, node->numChildren * sizeof(Node*));
+        *ref = smaller;
+        delete node;
+        return;
+    }
+    case kNode48: {
+        if (inner->numChildren > 12) return;
+        Node48* node = static_cast<Node48*>(inner);
+        Node16* smaller = new (std::nothrow) Node16();
+        if (smaller == nullptr) return;
+        copyHeader(smaller, node);
+        size_t i = 0;
+        for (size_t c = 0; c < 256; ++c) {
+            if (node->index[c] != 0) {
+                smaller->keys[i] = static_cast<unsigned char>(c);
+                smaller->children[i] = node->children[node->index[c] - 1];
+                ++i;
+            }
+        }
+        *ref = smaller;
+        delete node;
+        return;
+    }
+    case kNode256: {
+        if (inner->numChildren > 37) return;
+        Node256* node = static_cast<Node256*>(inner);
+        Node48* smaller = new (std::nothrow) Node48();
+        if (smaller == nullptr) return;
+        copyHeader(smaller, node);
+        size_t i = 0;
+        for (size_t c = 0; c < 256; ++c) {
+            if (node->children[c] != nullptr) {
+                smaller->index[c] = static_cast<unsigned char>(i + 1);
+                smaller->children[i] = node->children[c];
+                ++i;
+            }
+        }
+        *ref = smaller;
+        delete node;
+        return;
+    }
+    default:
+        return;
+    }
+}
+
+// 复制内部节点的公共部分
+template <typename V>
+void FBStringRadixTree<V>::copyHeader(Inner* dst, const Inner* src) {
+    dst->numChildren = src->numChildren;
+    dst->prefixLength = src->prefixLength;
+    dst->terminal = src->terminal;
+    std::memcpy(dst->prefix, src->prefix, kMaxPrefixLength);
+}
+
+// 按类型释放单个节点
+template <typename V>
+void FBStringRadixTree<V>::freeNode(Node* node) {
+    switch (node->type) {
+    case kLeaf:
+        delete static_cast<Leaf*>(node);
+        break;
+    case kNode4:
+        delete static_cast<Node4*>(node);
+        break;
+    case kNode16:
+        delete static_cast<Node16*>(node);
+        break;
+    case kNode48:
+        delete static_cast<Node48*>(node);
+        break;
+    default:
+        delete static_cast<Node256*>(node);
+        break;
+    }
+}
+
+// 释放子树
+template <typename V>
+void FBStringRadixTree<V>::destroy(Node* node) {
+    if (node == nullptr) return;
+    switch (node->type) {
+    case kLeaf:
+        break;
+    case kNode4:
+    case kNode16: {
+        const Inner* inner = static_cast<const Inner*>(node);
+        Node* const* children = node->type == kNode4 ? static_cast<const Node4*>(node)->children : static_cast<const Node16*>(node)->children;
+        destroy(inner->terminal);
+        for (size_t i = 0; i < inner->numChildren; ++i) destroy(children[i]);
+        break;
+    }
+    case kNode48: {
+        const Node48* inner = static_cast<const Node48*>(node);
+        destroy(inner->terminal);
+        for (size_t i = 0; i < 48; ++i) destroy(inner->children[i]);
+        break;
+    }
+    default: {
+        const Node256* inner = static_cast<const Node256*>(node);
+        destroy(inner->terminal);
+        for (size_t c = 0; c < 256; ++c) destroy(inner->children[c]);
+        break;
+    }
+    }
+    freeNode(node);
+}
+
+// 按键的顺序遍历子树：terminal 的键比所有子节点中的键都短，排在最前
+template <typename V>
+template <typename F>
+void FBStringRadixTree<V>::visit(const Node* node, F& f) {
+    switch (node->type) {
+    case kLeaf:
+        f(static_cast<const Leaf*>(node)->entry);
+        return;
+    case kNode4:
+    case kNode16: {
+        const Inner* inner = static_cast<const Inner*>(node);
+        if (inner->terminal != nullptr) f(inner->terminal->entry);
+        Node* const* children = node->type == kNode4 ? static_cast<const Node4*>(node)->children : static_cast<const Node16*>(node)->children;
+        for (size_t i = 0; i < inner->numChildren; ++i) visit(children[i], f);
+        return;
+    }
+    case kNode48: {
+        const Node48* inner = static_cast<const Node48*>(node);
+        if (inner->terminal != nullptr) f(inner->terminal->entry);
+        for (size_t c = 0; c < 256; ++c) {
+            if (inner->index[c] != 0) visit(inner->children[inner->index[c] - 1], f);
+        }
+        return;
+    }
+    default: {
+        const Node256* inner = static_cast<const Node256*>(node);
+        if (inner->terminal != nullptr) f(inner->terminal->entry);
+        for (size_t c = 0; c < 256; ++c) {
+            if (inner->children[c] != nullptr) visit(inner->children[c], f);
+        }
+        return;
+    }
+    }
+}
+
+// 统计子树占用的内存
+template <typename V>
+size_t FBStringRadixTree<V>::subtreeMemory(const Node* node) {
+    if (node == nullptr) return 0;
+    switch (node->type) {
+    case kLeaf:
+        return sizeof(Leaf);
+    case kNode4:
+    case kNode16: {
+        const Inner* inner = static_cast<const Inner*>(node);
+        Node* const* children = node->type == kNode4 ? static_cast<const Node4*>(node)->children : static_cast<const Node16*>(node)->children;
+        size_t total = (node->type == kNode4 ? sizeof(Node4) : sizeof(Node16)) + subtreeMemory(inner->terminal);
+        for (size_t i = 0; i < inner->numChildren; ++i) total += subtreeMemory(children[i]);
+        return total;
+    }
+    case kNode48: {
+        const Node48* inner = static_cast<const Node48*>(node);
+        size_t total = sizeof(Node48) + subtreeMemory(inner->terminal);
+        for (size_t i = 0; i < 48; ++i) total += subtreeMemory(inner->children[i]);
+        return total;
+    }
+    default: {
+        const Node256* inner = static_cast<const Node256*>(node);
+        size_t total = sizeof(Node256) + subtreeMemory(inner->terminal);
+        for (size_t c = 0; c < 256; ++c) total += subtreeMemory(inner->children[c]);
+        return total;
+    }
+    }
+}
+
+// 查找键，不存在时插入；先分配叶子和新节点，全部成功后才修改树
+template <typename V>
+template <typename K, typename... Args>
+std::pair<typename FBStringRadixTree<V>::value_type*, bool> FBStringRadixTree<V>::emplaceImpl(FBStringView key, const K& source, Args&&... args) {
+    if (static_cast<uint64_t>(key.size()) > UINT32_MAX) throw std::length_error("Key too long");
+    Node** ref = &root_;
+    size_t depth = 0;
+    for (;;) {
+        Node* node = *ref;
+        if (node == nullptr) {
+            Leaf* leaf = new Leaf(makeKey(source), std::forward<Args>(args)...);
+            *ref = leaf;
+            ++size_;
+            return std::make_pair(&leaf->entry, true);
+        }
+
+        if (node->type == kLeaf) {
+            Leaf* existing = static_cast<Leaf*>(node);
+            const FBStringView existingKey = leafKey(existing);
+            if (existingKey == key) return std::make_pair(&existing->entry, false);
+            // 两个键从 depth 起的公共部分成为新节点的前缀，在第一个不同的字节处分支
+            size_t common = 0;
+            const size_t limit = existingKey.size() < key.size() ? existingKey.size() : key.size();
+            while (depth + common < limit && existingKey[depth + common] == key[depth + common]) ++common;
+            std::unique_ptr<Leaf> leaf(new Leaf(makeKey(source), std::forward<Args>(args)...));
+            Node4* split = new Node4();
+            setPrefix(split, key.data() + depth, common);
+            const size_t at = depth + common;
+            // 至多一个键在分支处结束；结束的一个挂在 terminal 上
+            if (existingKey.size() == at) {
+                split->terminal = existing;
+            } else {
+                split->keys[0] = static_cast<unsigned char>(existingKey[at]);
+                split->children[0] = existing;
+                split->numChildren = 1;
+            }
+            if (key.size() == at) {
+                split->terminal = leaf.get();
+            } else {
+                // split 最多已有一个子节点，addChild 不会扩大它
+                Node* splitNode = split;
+                addChild(&splitNode, static_cast<unsigned char>(key[at]), leaf.get());
+            }
+            *ref = split;
+            ++size_;
+            return std::make_pair(&leaf.release()->entry, true);
+        }
+
+        Inner* inner = static_cast<Inner*>(node);
+        if (inner->prefixLength != 0) {
+            const size_t matched = matchPrefix(inner, key, depth);
+            if (matched != inner->prefixLength) {
+                // 在前缀中间分裂：新节点保存相同的部分，原节点保留不同字节之后的部分
+                std::unique_ptr<Leaf> leaf(new Leaf(makeKey(source), std::forward<Args>(args)...));
+                Node4* split = new Node4();
+                setPrefix(split, key.data() + depth, matched);
+                const size_t rest = inner->prefixLength - matched - 1;
+                unsigned char b;
+                if (inner->prefixLength <= kMaxPrefixLength) {
+                    b = inner->prefix[matched];
+                    std::memmove(inner->prefix, inner->prefix + matched + 1, rest);
+                } else {
+                    const char* full = leafKey(anyLeaf(inner)).data() + depth;
+                    b = static_cast<unsigned char>(full[matched]);
+                    std::memcpy(inner->prefix, full + matched + 1, rest < kMaxPrefixLength ? rest : kMaxPrefixLength);
+                }
+                inner->prefixLength = static_cast<uint32_t>(rest);
+                split->keys[0] = b;
+                split->children[0] = inner;
+                split->numChildren = 1;
+                if (key.size() == depth + matched) {
+                    split->terminal = leaf.get();
+                } else {
+                    Node* splitNode = split;
+                    addChild(&splitNode, static_cast<unsigned char>(key[depth + matched]), leaf.get());
+                }
+                *ref = split;
+                ++size_;
+                return std::make_pair(&leaf.release()->entry, true);
+            }
+            depth += inner->prefixLength;
+        }
+
+        if (depth == key.size()) {
+            // 前缀已完整比较，terminal 的键就是 key
+            if (inner->terminal != nullptr) return std::make_pair(&inner->terminal->entry, false);
+            inner->terminal = new Leaf(makeKey(source), std::forward<Args>(args)...);
+            ++size_;
+            return std::make_pair(&inner->terminal->entry, true);
+        }
+
+        const unsigned char b = static_cast<unsigned char>(key[depth]);
+        Node** child = findChild(inner, b);
+        if (child == nullptr) {
+            std::unique_ptr<Leaf> leaf(new Leaf(makeKey(source), std::forward<Args>(args)...));
+            addChild(ref, b, leaf.get());
+            ++size_;
+            return std::make_pair(&leaf.release()->entry, true);
+        }
+        ref = child;
+        ++depth;
+    }
+}
+
+// 删除子树中的键，返回后由调用方整理父节点
+template <typename V>
+bool FBStringRadixTree<V>::eraseImpl(Node** ref, FBStringView key, size_t depth) {
+    Node* node = *ref;
+    if (node == nullptr) return false;
+    if (node->type == kLeaf) {
+        if (leafKey(static_cast<Leaf*>(node)) != key) return false;
+        freeNode(node);
+        *ref = nullptr;
+        return true;
+    }
+    Inner* inner = static_cast<Inner*>(node);
+    if (inner->prefixLength != 0) {
+        if (!matchStoredPrefix(inner, key, depth)) return false;
+        depth += inner->prefixLength;
+    }
+    if (depth == key.size()) {
+        if (inner->terminal == nullptr || leafKey(inner->terminal) != key) return false;
+        freeNode(inner->terminal);
+        inner->terminal = nullptr;
+    } else {
+        const unsigned char b = static_cast<unsigned char>(key[depth]);
+        Node** child = findChild(inner, b);
+        if (child == nullptr || !eraseImpl(child, key, depth + 1)) return false;
+        if (*child == nullptr) removeChild(inner, b);
+    }
+    compact(ref);
+    return true;
+}
+
+#endif // FBSTRING_RADIX_TREE_H
@@ -0,0 +1,787 @@
+#include "FBStringSimd.h"
+#include <cstring>
+
+#if defined(FBSTRING_HAS_AVX2)
+#include <immintrin.h>
+#elif defined(FBSTRING_HAS_SSSE3)
+#include <tmmintrin.h>
+#elif defined(FBSTRING_HAS_SSE2)
+#include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+// 最低的非零位的位置，mask 不能为 0
+static inline unsigned countTrailingZeros(uint32_t mask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+}
+
+#if defined(FBSTRING_HAS_SSSE3)
+// 最高的非零位的位置，mask 不能为 0
+static inline unsigned highestSetBit(uint32_t mask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanReverse(&index, mask);
+    return static_cast<unsigned>(index);
+#else
+    return 31u - static_cast<unsigned>(__builtin_clz(mask));
+#endif
+}
+
+// 用位图复核查表得到的成员掩码，去掉误报的位置
+static uint32_t refineMask(const char* p, uint32_t mask, const FBByteSet& set) {
+    for (uint32_t rest = mask; rest != 0; rest &= rest - 1) {
+        const unsigned index = countTrailingZeros(rest);
+        if (!set.contains(p[index])) mask &= ~(uint32_t(1) << index);
+    }
+    return mask;
+}
+#endif
+
+// 默认构造函数
+FBByteSet::FBByteSet() : exact_(true) {
+    std::memset(bits_, 0, sizeof(bits_));
+    std::memset(lowNibbleTable_, 0, sizeof(lowNibbleTable_));
+    std::memset(highNibbleTable_, 0, sizeof(highNibbleTable_));
+}
+
+// 使用集合中的全部字节构造
+FBByteSet::FBByteSet(FBStringView chars) : FBByteSet() {
+    // 高半字节 h 与 h ^ 8 共用第 (h & 7) 个分组；两者同时出现时查表会有误报，需要用位图复核
+    for (size_t i = 0; i < chars.size(); ++i) {
+        const unsigned char c = static_cast<unsigned char>(chars[i]);
+        const unsigned char bucket = static_cast<unsigned char>(1u << ((c >> 4) & 7));
+        bits_[c >> 6] |= uint64_t(1) << (c & 63);
+        lowNibbleTable_[c & 0xF] |= bucket;
+        highNibbleTable_[c >> 4] = bucket;
+    }
+    for (unsigned h = 0; h < 8; ++h) {
+        if (highNibbleTable_[h] != 0 && highNibbleTable_[h + 8] != 0) exact_ = false;
+    }
+}
+
+// 判断字节是否属于集合
+bool FBByteSet::contains(char c) const {
+    const unsigned char u = static_cast<unsigned char>(c);
+    return (bits_[u >> 6] >> (u & 63)) & 1;
+}
+
+// 查找字节第一次出现的位置
+const char* FBStringSimd::find(const char* first, const char* last, char c) {
+    const char* p = first;
+#if defined(FBSTRING_HAS_AVX2)
+    const __m256i target = _mm256_set1_epi8(c);
+    for (; last - p >= 32; p += 32) {
+        const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        const uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, target)));
+        if (mask != 0) return p + countTrailingZeros(mask);
+    }
+#endif
+#if defined(FBSTRING_HAS_SSE2)
+    const __m128i target16 = _mm_set1_epi8(c);
+    for (; last - p >= 16; p += 16) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        const uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, target16)));
+        if (mask != 0) return p + countTrailingZeros(mask);
+    }
+#endif
+    if (p == last) return last;
+    const void* found = std::memchr(p, c, last - p);
+    return found ? static_cast<const char*>(found) : last;
+}
+
+#if defined(FBSTRING_HAS_AVX2)
+// 32 个字节中属于集合的位置（查表结果，可能有误报）
+static inline uint32_t memberMask32(const char* p, __m256i lowTable, __m256i highTable) {
+    const __m256i nibbleMask = _mm256_set1_epi8(0x0F);
+    const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    const __m256i low = _mm256_shuffle_epi8(lowTable, _mm256_and_si256(chunk, nibbleMask));
+    const __m256i high = _mm256_shuffle_epi8(highTable, _mm256_and_si256(_mm256_srli_epi16(chunk, 4), nibbleMask));
+    return ~static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_and_si256(low, high), _mm256_setzero_si256())));
+}
+#endif
+
+#if defined(FBSTRING_HAS_SSSE3)
+// 16 个字节中属于集合的位置（查表结果，可能有误报）
+static inline uint32_t memberMask16(const char* p, __m128i lowTable, __m128i highTable) {
+    const __m128i nibbleMask = _mm_set1_epi8(0x0F);
+    const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    const __m128i low = _mm_shuffle_epi8(lowTable, _mm_and_si128(chunk, nibbleMask));
+    const __m128i high = _mm_shuffle_epi8(highTable, _mm_and_si128(_mm_srli_epi16(chunk, 4), nibbleMask));
+    return ~static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(low, high), _mm_setzero_si128()))) & 0xFFFF;
+}
+#endif
+
+// 查找集合中任一字节第一次出现的位置
+const char* FBStringSimd::findAny(const char* first, const char* last, const FBByteSet& set) {
+    const char* p = first;
+#if defined(FBSTRING_HAS_AVX2)
+    {
+        const __m256i lowTable = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(set.lowNibbleTable_)));
+        const __m256i highTable = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(set.highNibbleTable_)));
+        for (; last - p >= 32; p += 32) {
+            uint32_t mask = memberMask32(p, lowTable, highTable);
+            for (; mask != 0; mask &= mask - 1) {
+                const char* candidate = p + countTrailingZeros(mask);
+                if (set.exact_ || set.contains(*candidate)) return candidate;
+            }
+        }
+    }
+#endif
+#if defined(FBSTRING_HAS_SSSE3)
+    {
+        const __m128i lowTable = _mm_loadu_si128(reinterpret_cast<const __m128i*>(set.lowNibbleTable_));
+        const __m128i highTable = _mm_loadu_si128(reinterpret_cast<const __m128i*>(set.highNibbleTable_));
+        for (; last - p >= 16; p += 16) {
+            uint32_t mask = memberMask16(p, lowTable, highTable);
+            for (; mask != 0; mask &= mask - 1) {
+                const char* candidate = p + countTrailingZeros(mask);
+                if (set.exact_ || set.contains(*candidate)) return candidate;
+            }
+        }
+    }
+#endif
+    for (; p < last; ++p) {
+        if (set.contains(*p)) return p;
+    }
+    return last;
+}
+
+// 查找子串第一次出现的位置
+const char* FBStringSimd::findSubstring(const char* first, const char* last, const char* needle, size_t n) {
+    if (static_cast<size_t>(last - first) < n) return last;
+    if (n == 1) return find(first, last, needle[0]);
+
+    const char* p = first;
+    const char* lastStart = last - n; // 子串可能开始的最后位置
+#if defined(FBSTRING_HAS_AVX2)
+    {
+        const __m256i firstByte = _mm256_set1_epi8(needle[0]);
+        const __m256i lastByte = _mm256_set1_epi8(needle[n - 1]);
+        for (; lastStart - p >= 31; p += 32) {
+            const __m256i head = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+            const __m256i tail = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + n - 1));
+            uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(
+                _mm256_and_si256(_mm256_cmpeq_epi8(head, firstByte), _mm256_cmpeq_epi8(tail, lastByte))));
+            for (; mask != 0; mask &= mask - 1) {
+                const char* candidate = p + countTrailingZeros(mask);
+                if (std::memcmp(candidate + 1, needle + 1, n - 2) == 0) return candidate;
+            }
+        }
+    }
+#endif
+#if defined(FBSTRING_HAS_SSE2)
+    {
+        const __m128i firstByte = _mm_set1_epi8(needle[0]);
+        const __m128i lastByte = _mm_set1_epi8(needle[n - 1]);
+        for (; lastStart - p >= 15; p += 16) {
+            const __m128i head = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            const __m128i tail = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + n - 1));
+            uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(
+                _mm_and_si128(_mm_cmpeq_epi8(head, firstByte), _mm_cmpeq_epi8(tail, lastByte))));
+            for (; mask != 0; mask &= mask - 1) {
+                const char* candidate = p + countTrailingZeros(mask);
+                if (std::memcmp(candidate + 1, needle + 1, n - 2) == 0) return candidate;
+            }
+        }
+    }
+#endif
+    for (; p <= lastStart; ++p) {
+        if (p[0] == needle[0] && p[n - 1] == needle[n - 1] && std::memcmp(p + 1, needle + 1, n - 2) == 0) return p;
+    }
+    return last;
+}
+
+// 跳过开头属于集合的字节
+const char* FBStringSimd::skipLeading(const char* first, const char* last, const FBByteSet& set) {
+    const char* p = first;
+    // 大多数字符串开头没有或只有很少的空白，先逐个检查几个字节
+    for (int i = 0; i < 4; ++i, ++p) {
+        if (p == last || !set.contains(*p)) return p;
+    }
+#if defined(FBSTRING_HAS_AVX2)
+    {
+        const __m256i lowTable = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(set.lowNibbleTable_)));
+        const __m256i highTable = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(set.highNibbleTable_)));
+        for (; last - p >= 32; p += 32) {
+            uint32_t members = memberMask32(p, lowTable, highTable);
+            if (!set.exact_) members = refineMask(p, members, set);
+            if (~members != 0) return p + countTrailingZeros(~members);
+        }
+    }
+#endif
+#if defined(FBSTRING_HAS_SSSE3)
+    {
+        const __m128i lowTable = _mm_loadu_si128(reinterpret_cast<const __m128i*>(set.lowNibbleTable_));
+        const __m128i highTable = _mm_loadu_si128(reinterpret_cast<const __m128i*>(set.highNibbleTable_));
+        for (; last - p >= 16; p += 16) {
+            uint32_t members = memberMask16(p, lowTable, highTable);
+            if (!set.exact_) members = refineMask(p, members, set);
+            const uint32_t others = ~members & 0xFFFF;
+            if (others != 0) return p + countTrailingZeros(others);
+        }
+    }
+#endif
+    while (p < last && set.contains(*p)) ++p;
+    return p;
+}
+
+// 跳过末尾属于集合的字节
+const char* FBStringSimd::skipTrailing(const char* first, const char* last, const FBByteSet& set) {
+    const char* end = last;
+    for (int i = 0; i < 4; ++i, --end) {
+        if (end == first || !set.contains(end[-1])) return end;
+    }
+#if defined(FBSTRING_HAS_AVX2)
+    {
+        const __m256i lowTable = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(set.lowNibbleTable_)));
+        const __m256i highTable = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(set.highNibbleTable_)));
+        for (; end - first >= 32; end -= 32) {
+            uint32_t members = memberMask32(end - 32, lowTable, highTable);
+            if (!set.exact_) members = refineMask(end - 32, members, set);
+            if (~members != 0) return end - 32 + highestSetBit(~members) + 1;
+        }
+    }
+#endif
+#if defined(FBSTRING_HAS_SSSE3)
+    {
+        const __m128i lowTable = _mm_loadu_si128(reinterpret_cast<const __m128i*>(set.lowNibbleTable_));
+        const __m128i highTable = _mm_loadu_si128(reinterpret_cast<const __m128i*>(set.highNibbleTable_));
+        for (; end - first >= 16; end -= 16) {
+            uint32_t members = memberMask16(end - 16, lowTable, highTable);
+            if (!set.exact_) members = refineMask(end - 16, members, set);
+            const uint32_t others = ~members & 0xFFFF;
+            if (others != 0) return end - 16 + highestSetBit(others) + 1;
+        }
+    }
+#endif
+    while (end > first && set.contains(end[-1])) --end;
+    return end;
+}
+
+// 查找第一个落在 [lo, hi] 范围内的字节
+const char* FBStringSimd::findInRange(const char* first, const char* last, char lo, char hi) {
+    const unsigned char width = static_cast<unsigned char>(hi - lo);
+    const char* p = first;
+#if defined(FBSTRING_HAS_AVX2)
+    {
+        const __m256i low = _mm256_set1_epi8(lo);
+        const __m256i span = _mm256_set1_epi8(static_cast<char>(width));
+        for (; last - p >= 32; p += 32) {
+            // c - lo 按无符号比较不超过 hi - lo 即在范围内
+            const __m256i offset = _mm256_sub_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)), low);
+            const uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_min_epu8(offset, span), offset)));
+            if (mask != 0) return p + countTrailingZeros(mask);
+        }
+    }
+#endif
+#if defined(FBSTRING_HAS_SSE2)
+    {
+        const __m128i low = _mm_set1_epi8(lo);
+        const __m128i span = _mm_set1_epi8(static_cast<char>(width));
+        for (; last - p >= 16; p += 16) {
+            const __m128i offset = _mm_sub_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)), low);
+            const uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_min_epu8(offset, span), offset)));
+            if (mask != 0) return p + countTrailingZeros(mask);
+        }
+    }
+#endif
+    for (; p < last; ++p) {
+        if (static_cast<unsigned char>(*p - lo) <= width) return p;
+    }
+    return last;
+}
+
+// 复制 n 个字节，并翻转其中落在 [lo, hi] 范围内的字节的 0x20 位
+void FBStringSimd::toggleCaseInRange(char* out, const char* in, size_t n, char lo, char hi) {
+    const unsigned char width = static_cast<unsigned char>(hi - lo);
+    size_t i = 0;
+#if defined(FBSTRING_HAS_AVX2)
+    {
+        const __m256i low = _mm256_set1_epi8(lo);
+        const __m256i span = _mm256_set1_epi8(static_cast<char>(width));
+        const __m256i caseBit = _mm256_set1_epi8(0x20);
+        for (; n - i >= 32; i += 32) {
+            const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+            const __m256i offset = _mm256_sub_epi8(chunk, low);
+            const __m256i inRange = _mm256_cmpeq_epi8(_mm256_min_epu8(offset, span), offset);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_xor_si256(chunk, _mm256_and_si256(inRange, caseBit)));
+        }
+    }
+#endif
+#if defined(FBSTRING_HAS_SSE2)
+    {
+        const __m128i low = _mm_set1_epi8(lo);
+        const __m128i span = _mm_set1_epi8(static_cast<char>(width));
+        const __m128i caseBit = _mm_set1_epi8(0x20);
+        for (; n - i >= 16; i += 16) {
+            const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+            const __m128i offset = _mm_sub_epi8(chunk, low);
+            const __m128i inRange = _mm_cmpeq_epi8(_mm_min_epu8(offset, span), offset);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_xor_si128(chunk, _mm_and_si128(inRange, caseBit)));
+        }
+    }
+#endif
+    for (; i < n; ++i) {
+        const char c = in[i];
+        out[i] = static_cast<unsigned char>(c - lo) <= width ? static_cast<char>(c ^ 0x20) : c;
+    }
+}
+
+// 读取 8、4 个字节，只用于判断相等，不关心字节序
+static inline uint64_t loadWord(const char* p) {
+    uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline uint32_t loadHalfWord(const char* p) {
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+// 判断两段字节是否相等：每轮比较两块，只在一轮结束时检查一次，最后一块与前面重叠读取
+bool FBStringSimd::equal(const char* a, const char* b, size_t n) {
+#if defined(FBSTRING_HAS_AVX2)
+    if (n >= 32) {
+        for (size_t i = 0; n - i >= 64; i += 64) {
+            const __m256i x0 = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)),
+                                                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i)));
+            const __m256i x1 = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i + 32)),
+                                                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i + 32)));
+            const __m256i diff = _mm256_or_si256(x0, x1);
+            if (!_mm256_testz_si256(diff, diff)) return false;
+        }
+        // 剩余不足 64 字节：比较最后 64 个字节（不足 64 时为全部），与已比较的部分重叠
+        const size_t j = n >= 64 ? n - 64 : 0;
+        const __m256i x0 = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + j)),
+                                            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + j)));
+        const __m256i x1 = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + n - 32)),
+                                            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + n - 32)));
+        const __m256i diff = _mm256_or_si256(x0, x1);
+        return _mm256_testz_si256(diff, diff) != 0;
+    }
+#endif
+#if defined(FBSTRING_HAS_SSE2)
+    if (n >= 16) {
+        for (size_t i = 0; n - i >= 32; i += 32) {
+            const __m128i e0 = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)),
+                                              _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i)));
+            const __m128i e1 = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i + 16)),
+                                              _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i + 16)));
+            if (_mm_movemask_epi8(_mm_and_si128(e0, e1)) != 0xFFFF) return false;
+        }
+        const size_t j = n >= 32 ? n - 32 : 0;
+        const __m128i e0 = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + j)),
+                                          _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + j)));
+        const __m128i e1 = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + n - 16)),
+                                          _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + n - 16)));
+        return _mm_movemask_epi8(_mm_and_si128(e0, e1)) == 0xFFFF;
+    }
+#endif
+    if (n >= 8) {
+        for (size_t i = 0; n - i > 8; i += 8) {
+            if (loadWord(a + i) != loadWord(b + i)) return false;
+        }
+        return loadWord(a + n - 8) == loadWord(b + n - 8);
+    }
+    if (n >= 4) {
+        return ((loadHalfWord(a) ^ loadHalfWord(b)) | (loadHalfWord(a + n - 4) ^ loadHalfWord(b + n - 4))) == 0;
+    }
+    for (size_t i = 0; i < n; ++i) {
+        if (a[i] != b[i]) return false;
+    }
+    return true;
+}
+
+// ASCII 空白字符集合
+const FBByteSet& FBStringSimd::whitespace() {
+    static const FBByteSet set(FBStringView(" \t\n\v\f\r"));
+    return set;
+}
+
+#if defined(FBSTRING_HAS_SSE2)
+// 非零位的个数
+static inline unsigned popCount(uint32_t mask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    return static_cast<unsigned>(__popcnt(mask));
+#else
+    return static_cast<unsigned>(__builtin_popcount(mask));
+#endif
+}
+#endif
+
+#if !defined(FBSTRING_HAS_SSSE3)
+// 逐字节校验 UTF-8（Unicode 标准表 3-7），连续 8 个 ASCII 字节整体跳过
+static bool validateUtf8Scalar(const unsigned char* p, const unsigned char* end) {
+    while (p < end) {
+        if (end - p >= 8) {
+            uint64_t word;
+            std::memcpy(&word, p, sizeof(word));
+            if ((word & 0x8080808080808080ULL) == 0) {
+                p += 8;
+                continue;
+            }
+        }
+        const unsigned char c = *p;
+        if (c < 0x80) {
+            ++p;
+            continue;
+        }
+        // 第二个字节的合法范围因首字节而异，用来排除超长编码、代理项和超过 U+10FFFF 的码点
+        ptrdiff_t length;
+        unsigned char low = 0x80, high = 0xBF;
+        if (c >= 0xC2 && c <= 0xDF) {
+            length = 2;
+        } else if (c >= 0xE0 && c <= 0xEF) {
+            length = 3;
+            if (c == 0xE0) low = 0xA0;
+            else if (c == 0xED) high = 0x9F;
+        } else if (c >= 0xF0 && c <= 0xF4) {
+            length = 4;
+            if (c == 0xF0) low = 0x90;
+            else if (c == 0xF4) high = 0x8F;
+        } else {
+            return false;
+        }
+        if (end - p < length) return false;
+        if (p[1] < low || p[1] > high) return false;
+        for (ptrdiff_t i = 2; i < length; ++i) {
+            if ((p[i] & 0xC0) != 0x80) return false;
+        }
+        p += length;
+    }
+    return true;
+}
+#endif
+
+#if defined(FBSTRING_HAS_SSSE3)
+// 相邻两个字节组合可能出现的错误类别（Keiser & Lemire, "Validating UTF-8 In Less Than One Instruction Per Byte"）
+static const unsigned char kTooShort = 1 << 0;     // 多字节序列的首字节后面不是续字节
+static const unsigned char kTooLong = 1 << 1;      // ASCII 字节后面出现续字节
+static const unsigned char kOverlong3 = 1 << 2;    // E0 80..9F
+static const unsigned char kTooLarge = 1 << 3;     // F4 90..BF
+static const unsigned char kSurrogate = 1 << 4;    // ED A0..BF
+static const unsigned char kOverlong2 = 1 << 5;    // C0..C1 续字节
+static const unsigned char kTooLarge1000 = 1 << 6; // F5..FF 续字节
+static const unsigned char kOverlong4 = 1 << 6;    // F0 80..8F
+static const unsigned char kTwoConts = 1 << 7;     // 两个续字节相邻，需结合前两三个字节判断
+static const unsigned char kCarry = kTooShort | kTooLong | kTwoConts;
+
+// 按前一字节的高半字节查表
+static const unsigned char kUtf8Byte1High[16] = {
+    kTooLong, kTooLong, kTooLong, kTooLong, kTooLong, kTooLong, kTooLong, kTooLong,
+    kTwoConts, kTwoConts, kTwoConts, kTwoConts,
+    kTooShort | kOverlong2,
+    kTooShort,
+    kTooShort | kOverlong3 | kSurrogate,
+    kTooShort | kTooLarge | kTooLarge1000 | kOverlong4
+};
+
+// 按前一字节的低半字节查表
+static const unsigned char kUtf8Byte1Low[16] = {
+    kCarry | kOverlong3 | kOverlong2 | kOverlong4,
+    kCarry | kOverlong2,
+    kCarry,
+    kCarry,
+    kCarry | kTooLarge,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000 | kSurrogate,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000
+};
+
+// 按当前字节的高半字节查表
+static const unsigned char kUtf8Byte2High[16] = {
+    kTooShort, kTooShort, kTooShort, kTooShort, kTooShort, kTooShort, kTooShort, kTooShort,
+    kTooLong | kOverlong2 | kTwoConts | kOverlong3 | kTooLarge1000 | kOverlong4,
+    kTooLong | kOverlong2 | kTwoConts | kOverlong3 | kTooLarge,
+    kTooLong | kOverlong2 | kTwoConts | kSurrogate | kTooLarge,
+    kTooLong | kOverlong2 | kTwoConts | kSurrogate | kTooLarge,
+    kTooShort, kTooShort, kTooShort, kTooShort
+};
+
+// 块末尾各位置上“后面还缺续字节”的阈值：倒数第 3、2、1 个字节分别不能 ≥ F0、E0、C0
+static const unsigned char kUtf8IncompleteMax[32] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xEF, 0xDF, 0xBF
+};
+#endif
+
+#if defined(FBSTRING_HAS_AVX2)
+// UTF-8 校验的跨块状态（32 字节一块）
+struct Utf8State32 {
+    __m256i error;          // 累积的错误位
+    __m256i prevInput;      // 上一块
+    __m256i prevIncomplete; // 上一块末尾未完成的多字节序列
+};
+
+// 校验一个 32 字节块
+static inline void checkUtf8Block(__m256i input, Utf8State32& state) {
+    if (_mm256_movemask_epi8(input) == 0) {
+        // 全是 ASCII：只需确认上一块没有以未完成的序列结尾
+        state.error = _mm256_or_si256(state.error, state.prevIncomplete);
+        state.prevInput = input;
+        state.prevIncomplete = _mm256_setzero_si256();
+        return;
+    }
+    const __m256i nibble = _mm256_set1_epi8(0x0F);
+    const __m256i byte1HighTable = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(kUtf8Byte1High)));
+    const __m256i byte1LowTable = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(kUtf8Byte1Low)));
+    const __m256i byte2HighTable = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(kUtf8Byte2High)));
+
+    // prevN 的第 i 个字节是 input 第 i 个字节之前第 N 个字节，跨 128 位通道时取自上一块
+    const __m256i carried = _mm256_permute2x128_si256(state.prevInput, input, 0x21);
+    const __m256i prev1 = _mm256_alignr_epi8(input, carried, 15);
+    const __m256i prev2 = _mm256_alignr_epi8(input, carried, 14);
+    const __m256i prev3 = _mm256_alignr_epi8(input, carried, 13);
+
+    const __m256i byte1High = _mm256_shuffle_epi8(byte1HighTable, _mm256_and_si256(_mm256_srli_epi16(prev1, 4), nibble));
+    const __m256i byte1Low = _mm256_shuffle_epi8(byte1LowTable, _mm256_and_si256(prev1, nibble));
+    const __m256i byte2High = _mm256_shuffle_epi8(byte2HighTable, _mm256_and_si256(_mm256_srli_epi16(input, 4), nibble));
+    const __m256i special = _mm256_and_si256(_mm256_and_si256(byte1High, byte1Low), byte2High);
+
+    // 前两个字节是 3 字节首字节或前三个字节是 4 字节首字节的位置必须是续字节，且只有这些位置可以出现两个相邻的续字节
+    const __m256i third = _mm256_subs_epu8(prev2, _mm256_set1_epi8(static_cast<char>(0xE0 - 0x80)));
+    const __m256i fourth = _mm256_subs_epu8(prev3, _mm256_set1_epi8(static_cast<char>(0xF0 - 0x80)));
+    const __m256i must23 = _mm256_and_si256(_mm256_or_si256(third, fourth), _mm256_set1_epi8(static_cast<char>(0x80)));
+    state.error = _mm256_or_si256(state.error, _mm256_xor_si256(must23, special));
+
+    state.prevIncomplete = _mm256_subs_epu8(input, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(kUtf8IncompleteMax)));
+    state.prevInput = input;
+}
+#elif defined(FBSTRING_HAS_SSSE3)
+// UTF-8 校验的跨块状态（16 字节一块）
+struct Utf8State16 {
+    __m128i error;          // 累积的错误位
+    __m128i prevInput;      // 上一块
+    __m128i prevIncomplete; // 上一块末尾未完成的多字节序列
+};
+
+// 校验一个 16 字节块
+static inline void checkUtf8Block(__m128i input, Utf8State16& state) {
+    if (_mm_movemask_epi8(input) == 0) {
+        // 全是 ASCII：只需确认上一块没有以未完成的序列结尾
+        state.error = _mm_or_si128(state.error, state.prevIncomplete);
+        state.prevInput = input;
+        state.prevIncomplete = _mm_setzero_si128();
+        return;
+    }
+    const __m128i nibble = _mm_set1_epi8(0x0F);
+    const __m128i byte1HighTable = _mm_loadu_si128(reinterpret_cast<const __m128i*>(kUtf8Byte1High));
+    const __m128i byte1LowTable = _mm_loadu_si128(reinterpret_cast<const __m128i*>(kUtf8Byte1Low));
+    const __m128i byte2HighTable = _mm_loadu_si128(reinterpret_cast<const __m128i*>(kUtf8Byte2High));
+
+    // prevN 的第 i 个字节是 input 第 i 个字节之前第 N 个字节，不足时取自上一块
+    const __m128i prev1 = _mm_alignr_epi8(input, state.prevInput, 15);
+    const __m128i prev2 = _mm_alignr_epi8(input, state.prevInput, 14);
+    const __m128i prev3 = _mm_alignr_epi8(input, state.prevInput, 13);
+
+    const __m128i byte1High = _mm_shuffle_epi8(byte1HighTable, _mm_and_si128(_mm_srli_epi16(prev1, 4), nibble));
+    const __m128i byte1Low = _mm_shuffle_epi8(byte1LowTable, _mm_and_si128(prev1, nibble));
+    const __m128i byte2High = _mm_shuffle_epi8(byte2HighTable, _mm_and_si128(_mm_srli_epi16(input, 4), nibble));
+    const __m128i special = _mm_and_si128(_mm_and_si128(byte1High, byte1Low), byte2High);
+
+    // 前两个字节是 3 字节首字节或前三个字节是 4 字节首字节的位置必须是续字节，且只有这些位置可以出现两个相邻的续字节
+    const __m128i third = _mm_subs_epu8(prev2, _mm_set1_epi8(static_cast<char>(0xE0 - 0x80)));
+    const __m128i fourth = _mm_subs_epu8(prev3, _mm_set1_epi8(static_cast<char>(0xF0 - 0x80)));
+    const __m128i must23 = _mm_and_si128(_mm_or_si128(third, fourth), _mm_set1_epi8(static_cast<char>(0x80)));
+    state.error = _mm_or_si128(state.error, _mm_xor_si128(must23, special));
+
+    state.prevIncomplete = _mm_subs_epu8(input, _mm_loadu_si128(reinterpret_cast<const __m128i*>(kUtf8IncompleteMax + 16)));
+    state.prevInput = input;
+}
+#endif
+
+// 校验是否为合法的 UTF-8
+bool FBStringSimd::validateUtf8(const char* data, size_t n) {
+#if defined(FBSTRING_HAS_AVX2)
+    Utf8State32 state;
+    state.error = state.prevInput = state.prevIncomplete = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; n - i >= 32; i += 32) {
+        checkUtf8Block(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)), state);
+    }
+    if (i < n) {
+        // 不足一块的尾部补 0 后按整块处理，补上的 0 会暴露末尾未完成的序列
+        char tail[32] = {0};
+        std::memcpy(tail, data + i, n - i);
+        checkUtf8Block(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(tail)), state);
+    }
+    const __m256i error = _mm256_or_si256(state.error, state.prevIncomplete);
+    return _mm256_testz_si256(error, error) != 0;
+#elif defined(FBSTRING_HAS_SSSE3)
+    Utf8State16 state;
+    state.error = state.prevInput = state.prevIncomplete = _mm_setzero_si128();
+    size_t i = 0;
+    for (; n - i >= 16; i += 16) {
+        checkUtf8Block(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)), state);
+    }
+    if (i < n) {
+        // 不足一块的尾部补 0 后按整块处理，补上的 0 会暴露末尾未完成的序列
+        char tail[16] = {0};
+        std::memcpy(tail, data + i, n - i);
+        checkUtf8Block(_mm_loadu_si128(reinterpret_cast<const __m128i*>(tail)), state);
+    }
+    const __m128i error = _mm_or_si128(state.error, state.prevIncomplete);
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(error, _mm_setzero_si128())) == 0xFFFF;
+#else
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(data);
+    return validateUtf8Scalar(p, p + n);
+#endif
+}
+
+// 统计 UTF-8 码点个数：续字节（0x80 ~ 0xBF，按有符号比较小于 -64）以外的字节各开始一个码点
+size_t FBStringSimd::countCodePoints(const char* data, size_t n) {
+    size_t count = 0;
+    size_t i = 0;
+#if defined(FBSTRING_HAS_AVX2)
+    {
+        const __m256i threshold = _mm256_set1_epi8(-65);
+        for (; n - i >= 32; i += 32) {
+            const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+            count += popCount(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpgt_epi8(chunk, threshold))));
+        }
+    }
+#endif
+#if defined(FBSTRING_HAS_SSE2)
+    {
+        const __m128i threshold = _mm_set1_epi8(-65);
+        for (; n - i >= 16; i += 16) {
+            const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+            count += popCount(static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpgt_epi8(chunk, threshold))));
+        }
+    }
+#endif
+    for (; i < n; ++i) {
+        if (static_cast<signed char>(data[i]) > -65) ++count;
+    }
+    return count;
+}
+
+// 查找第一个代理项（0xD800 ~ 0xDFFF），未找到返回 last
+static const char16_t* findSurrogate(const char16_t* first, const char16_t* last) {
+    const char16_t* p = first;
+#if defined(FBSTRING_HAS_AVX2)
+    {
+        const __m256i mask = _mm256_set1_epi16(static_cast<short>(0xF800));
+        const __m256i surrogate = _mm256_set1_epi16(static_cast<short>(0xD800));
+        for (; last - p >= 16; p += 16) {
+            const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+            const uint32_t hits = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi16(_mm256_and_si256(chunk, mask), surrogate)));
+            if (hits != 0) return p + countTrailingZeros(hits) / 2;
+        }
+    }
+#endif
+#if defined(FBSTRING_HAS_SSE2)
+    {
+        const __m128i mask = _mm_set1_epi16(static_cast<short>(0xF800));
+        const __m128i surrogate = _mm_set1_epi16(static_cast<short>(0xD800));
+        for (; last - p >= 8; p += 8) {
+            const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            const uint32_t hits = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(chunk, mask), surrogate)));
+            if (hits != 0) return p + countTrailingZeros(hits) / 2;
+        }
+    }
+#endif
+    for (; p != last; ++p) {
+        if ((*p & 0xF800) == 0xD800) return p;
+    }
+    return last;
+}
+
+// 校验是否为合法的 UTF-16
+bool FBStringSimd::validateUtf16(const char16_t* data, size_t n) {
+    const char16_t* last = data + n;
+    for (const char16_t* p = findSurrogate(data, last); p != last; p = findSurrogate(p, last)) {
+        // 高代理项后面必须紧跟低代理项
+        if (*p > 0xDBFF || last - p < 2 || (p[1] & 0xFC00) != 0xDC00) return false;
+        p += 2;
+    }
+    return true;
+}
+
+// 校验是否为合法的 UTF-32
+bool FBStringSimd::validateUtf32(const char32_t* data, size_t n) {
+    size_t i = 0;
+#if defined(FBSTRING_HAS_AVX2)
+    {
+        // 高 16 位大于 0x10 即超过 U+10FFFF；移位后的值非负，可以用有符号比较
+        const __m256i maxPlane = _mm256_set1_epi32(0x10);
+        const __m256i mask = _mm256_set1_epi32(static_cast<int>(0xFFFFF800));
+        const __m256i surrogate = _mm256_set1_epi32(0xD800);
+        __m256i error = _mm256_setzero_si256();
+        for (; n - i >= 8; i += 8) {
+            const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+            error = _mm256_or_si256(error, _mm256_cmpgt_epi32(_mm256_srli_epi32(chunk, 16), maxPlane));
+            error = _mm256_or_si256(error, _mm256_cmpeq_epi32(_mm256_and_si256(chunk, mask), surrogate));
+        }
+        if (!_mm256_testz_si256(error, error)) return false;
+    }
+#endif
+#if defined(FBSTRING_HAS_SSE2)
+    {
+        const __m128i maxPlane = _mm_set1_epi32(0x10);
+        const __m128i mask = _mm_set1_epi32(static_cast<int>(0xFFFFF800));
+        const __m128i surrogate = _mm_set1_epi32(0xD800);
+        __m128i error = _mm_setzero_si128();
+        for (; n - i >= 4; i += 4) {
+            const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+            error = _mm_or_si128(error, _mm_cmpgt_epi32(_mm_srli_epi32(chunk, 16), maxPlane));
+            error = _mm_or_si128(error, _mm_cmpeq_epi32(_mm_and_si128(chunk, mask), surrogate));
+        }
+        if (_mm_movemask_epi8(error) != 0) return false;
+    }
+#endif
+    for (; i < n; ++i) {
+        const char32_t c = data[i];
+        if (c > 0x10FFFF || (c & 0xFFFFF800) == 0xD800) return false;
+    }
+    return true;
+}
+
+// 统计 UTF-16 码点个数：低代理项（0xDC00 ~ 0xDFFF）以外的单元各开始一个码点
+size_t FBStringSimd::countCodePoints(const char16_t* data, size_t n) {
+    size_t lowSurrogates = 0;
+    size_t i = 0;
+#if defined(FBSTRING_HAS_AVX2)
+    {
+        const __m256i mask = _mm256_set1_epi16(static_cast<short>(0xFC00));
+        const __m256i low = _mm256_set1_epi16(static_cast<short>(0xDC00));
+        for (; n - i >= 16; i += 16) {
+            const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+            lowSurrogates += popCount(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi16(_mm256_and_si256(chunk, mask), low)))) / 2;
+        }
+    }
+#endif
+#if defined(FBSTRING_HAS_SSE2)
+    {
+        const __m128i mask = _mm_set1_epi16(static_cast<short>(0xFC00));
+        const __m128i low = _mm_set1_epi16(static_cast<short>(0xDC00));
+        for (; n - i >= 8; i += 8) {
+            const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+            lowSurrogates += popCount(static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(chunk, mask), low)))) / 2;
+        }
+    }
+#endif
+    for (; i < n; ++i) {
+        if ((data[i] & 0xFC00) == 0xDC00) ++lowSurrogates;
+    }
+    return n - lowSurrogates;
+}
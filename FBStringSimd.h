@@ -0,0 +1,189 @@
+#ifndef FBSTRING_SIMD_H
+#define FBSTRING_SIMD_H
+
+#include <cstddef>
+#include <cstdint>
+#include "FBStringView.h"
+
+// 编译目标支持的指令集；未定义时相应的 SIMD 路径不参与编译，使用标量实现
+#if defined(__AVX2__)
+#define FBSTRING_HAS_AVX2 1
+#endif
+#if defined(__SSSE3__) || defined(__AVX2__)
+#define FBSTRING_HAS_SSSE3 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FBSTRING_HAS_SSE2 1
+#endif
+#if defined(__AES__) && defined(FBSTRING_HAS_SSE2)
+#define FBSTRING_HAS_AESNI 1
+#endif
+
+/**
+ * 字节集合
+ * 除了 256 位的位图外，还预先计算了按高低半字节查表（shufti）所需的两张 16 项表，
+ * 使 SIMD 路径每次能同时判断 16 或 32 个字节是否属于集合。
+ */
+class FBByteSet {
+public:
+    /**
+     * 默认构造函数
+     * 构造一个空集合。
+     */
+    FBByteSet();
+
+    /**
+     * 使用集合中的全部字节构造
+     * @param chars 集合中的字节，重复的字节会被忽略
+     */
+    explicit FBByteSet(FBStringView chars);
+
+    /**
+     * 判断字节是否属于集合
+     * @param c 要判断的字节
+     * @return 属于集合返回 true
+     */
+    bool contains(char c) const;
+
+private:
+    friend class FBStringSimd;
+
+    uint64_t bits_[4];                  /**< 位图 */
+    unsigned char lowNibbleTable_[16];  /**< 低半字节 → 出现过的高半字节分组 */
+    unsigned char highNibbleTable_[16]; /**< 高半字节 → 所在分组 */
+    bool exact_;                        /**< 查表结果是否精确；不精确时需要用位图复核候选位置 */
+};
+
+// FBStringSimd 提供按指令集分派的字节扫描内核：AVX2、SSE2/SSSE3，以及标量回退
+class FBStringSimd {
+public:
+    /**
+     * 查找字节第一次出现的位置
+     * @param first 起始位置
+     * @param last 结束位置
+     * @param c 要查找的字节
+     * @return 找到的位置，未找到返回 last
+     */
+    static const char* find(const char* first, const char* last, char c);
+
+    /**
+     * 查找集合中任一字节第一次出现的位置
+     * @param first 起始位置
+     * @param last 结束位置
+     * @param set 字节集合
+     * @return 找到的位置，未找到返回 last
+     */
+    static const char* findAny(const char* first, const char* last, const FBByteSet& set);
+
+    /**
+     * 查找子串第一次出现的位置
+     * 同时比较子串的首尾字节来筛选候选位置，只对候选位置做完整比较。
+     * @param first 起始位置
+     * @param last 结束位置
+     * @param needle 子串
+     * @param n 子串长度，不能为 0
+     * @return 找到的位置，未找到返回 last
+     */
+    static const char* findSubstring(const char* first, const char* last, const char* needle, size_t n);
+
+    /**
+     * 跳过开头属于集合的字节
+     * @param first 起始位置
+     * @param last 结束位置
+     * @param set 字节集合
+     * @return 第一个不属于集合的字节的位置，全部属于集合时返回 last
+     */
+    static const char* skipLeading(const char* first, const char* last, const FBByteSet& set);
+
+    /**
+     * 跳过末尾属于集合的字节
+     * @param first 起始位置
+     * @param last 结束位置
+     * @param set 字节集合
+     * @return 最后一个不属于集合的字节之后的位置，全部属于集合时返回 first
+     */
+    static const char* skipTrailing(const char* first, const char* last, const FBByteSet& set);
+
+    /**
+     * 查找第一个落在 [lo, hi] 范围内的字节
+     * @param first 起始位置
+     * @param last 结束位置
+     * @param lo 范围下界（按无符号字节比较）
+     * @param hi 范围上界
+     * @return 找到的位置，未找到返回 last
+     */
+    static const char* findInRange(const char* first, const char* last, char lo, char hi);
+
+    /**
+     * 复制 n 个字节，并翻转其中落在 [lo, hi] 范围内的字节的 0x20 位
+     * 以 'a' ~ 'z' 为范围即转换为大写，以 'A' ~ 'Z' 为范围即转换为小写。
+     * @param out 输出位置，可以与 in 相同
+     * @param in 输入位置
+     * @param n 字节数
+     * @param lo 范围下界（按无符号字节比较）
+     * @param hi 范围上界
+     */
+    static void toggleCaseInRange(char* out, const char* in, size_t n, char lo, char hi);
+
+    /**
+     * 校验是否为合法的 UTF-8
+     * 拒绝超长编码、代理项（U+D800 ~ U+DFFF）、超过 U+10FFFF 的码点以及被截断的序列。
+     * SIMD 路径按 Keiser–Lemire 算法一次查表判断相邻字节的组合，纯 ASCII 块只做一次比较。
+     * @param data 起始位置
+     * @param n 字节数
+     * @return 合法返回 true
+     */
+    static bool validateUtf8(const char* data, size_t n);
+
+    /**
+     * 统计 UTF-8 码点个数
+     * 只数续字节以外的字节，不做校验；对非法输入的结果没有意义。
+     * @param data 起始位置
+     * @param n 字节数
+     * @return 码点个数
+     */
+    static size_t countCodePoints(const char* data, size_t n);
+
+    /**
+     * 校验是否为合法的 UTF-16：高代理项后面必须紧跟低代理项，低代理项不能单独出现
+     * @param data 起始位置
+     * @param n 单元数
+     * @return 合法返回 true
+     */
+    static bool validateUtf16(const char16_t* data, size_t n);
+
+    /**
+     * 校验是否为合法的 UTF-32：不超过 U+10FFFF 且不是代理项
+     * @param data 起始位置
+     * @param n 单元数
+     * @return 合法返回 true
+     */
+    static bool validateUtf32(const char32_t* data, size_t n);
+
+    /**
+     * 统计 UTF-16 码点个数
+     * 只数低代理项以外的单元，不做校验。
+     * @param data 起始位置
+     * @param n 单元数
+     * @return 码点个数
+     */
+    static size_t countCodePoints(const char16_t* data, size_t n);
+
+    /**
+     * 判断两段字节是否相等
+     * 只判断是否相等，不区分大小，可以比 memcmp 少做找出第一个不同字节的工作；结尾不足一块时与前面重叠读取。
+     * @param a 第一段的起始位置
+     * @param b 第二段的起始位置
+     * @param n 字节数
+     * @return 相等返回 true
+     */
+    static bool equal(const char* a, const char* b, size_t n);
+
+    /**
+     * ASCII 空白字符集合：空格、\t、\n、\v、\f、\r
+     * @return 空白字符集合
+     */
+    static const FBByteSet& whitespace();
+};
+
+#endif // FBSTRING_SIMD_H
@@ -0,0 +1,362 @@
+#include "FBStringSort.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <utility>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#include <stdlib.h>
+#endif
+
+// 元素不超过这个数时改用插入排序
+static const size_t kInsertionThreshold = 16;
+
+// 元素不少于这个数时按单个字节做基数排序的分桶，否则用多关键字快速排序
+static const size_t kRadixThreshold = 1024;
+
+// 元素少于这个数时 parallelSort 直接单线程排序
+static const size_t kParallelThreshold = 1 << 16;
+
+// 划分出的部分至少有这么多元素时才考虑交给新线程
+static const size_t kParallelGrain = 1 << 14;
+
+// 排序项：从当前深度起的 8 个字节按大端序拼成的整数，使整数的大小顺序就是字节的无符号顺序
+struct FBSortItem {
+    uint64_t key;
+    const char* data;
+    size_t size;
+    FBString* str;
+};
+
+// 多线程排序的共享状态：还可以启动的线程数
+struct FBSortContext {
+    std::atomic<int> idle;
+
+    explicit FBSortContext(int threads) : idle(threads) {}
+
+    // 占用一个线程名额，没有名额时返回 false
+    bool tryAcquire() {
+        int n = idle.load(std::memory_order_relaxed);
+        while (n > 0) {
+            if (idle.compare_exchange_weak(n, n - 1, std::memory_order_relaxed)) return true;
+        }
+        return false;
+    }
+
+    void release() {
+        idle.fetch_add(1, std::memory_order_relaxed);
+    }
+};
+
+// 读取从 p 开始的至多 8 个字节，不足的部分补零，按大端序拼成整数
+static inline uint64_t loadPrefix(const char* p, size_t n) {
+    uint64_t v = 0;
+    std::memcpy(&v, p, n < 8 ? n : 8);
+#if !(defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+#if defined(_MSC_VER) && !defined(__clang__)
+    v = _byteswap_uint64(v);
+#else
+    v = __builtin_bswap64(v);
+#endif
+#endif
+    return v;
+}
+
+// 最高位起连续为零的字节数，diff 不能为零
+static inline size_t leadingZeroBytes(uint64_t diff) {
+#if defined(_MSC_VER) && !defined(__clang__) && defined(_M_X64)
+    unsigned long index;
+    _BitScanReverse64(&index, diff);
+    return (63 - index) / 8;
+#elif defined(_MSC_VER) && !defined(__clang__)
+    size_t n = 0;
+    while ((diff >> 56) == 0) {
+        diff <<= 8;
+        ++n;
+    }
+    return n;
+#else
+    return static_cast<size_t>(__builtin_clzll(diff)) / 8;
+#endif
+}
+
+// 缓存的整数中有效的字节数：字符串在这 8 个字节内结束时小于 8，用来区分结尾和补上的零
+static inline size_t tailLength(const FBSortItem& item, size_t depth) {
+    return std::min<size_t>(item.size - depth, 8);
+}
+
+// 按缓存的整数和有效字节数比较项与枢轴
+static inline int compareToPivot(const FBSortItem& item, uint64_t key, size_t tail, size_t depth) {
+    if (item.key != key) return item.key < key ? -1 : 1;
+    const size_t t = tailLength(item, depth);
+    return t == tail ? 0 : (t < tail ? -1 : 1);
+}
+
+// 比较从 depth 开始的完整内容，用于插入排序
+static inline bool lessFrom(const FBSortItem& a, const FBSortItem& b, size_t depth) {
+    if (a.key != b.key) return a.key < b.key;
+    const size_t from = depth + 8;
+    if (a.size <= from || b.size <= from) return a.size < b.size;
+    const int c = std::memcmp(a.data + from, b.data + from, std::min(a.size, b.size) - from);
+    return c != 0 ? c < 0 : a.size < b.size;
+}
+
+// 插入排序
+static void insertionSort(FBSortItem* items, size_t n, size_t depth) {
+    for (size_t i = 1; i < n; ++i) {
+        FBSortItem item = items[i];
+        size_t j = i;
+        for (; j > 0 && lessFrom(item, items[j - 1], depth); --j) {
+            items[j] = items[j - 1];
+        }
+        items[j] = item;
+    }
+}
+
+// 三数取中，返回枢轴的下标
+static size_t medianOfThree(const FBSortItem* items, size_t a, size_t b, size_t c, size_t depth) {
+    const uint64_t ka = items[a].key, kb = items[b].key, kc = items[c].key;
+    const size_t ta = tailLength(items[a], depth), tb = tailLength(items[b], depth), tc = tailLength(items[c], depth);
+    const bool ab = ka < kb || (ka == kb && ta < tb);
+    const bool bc = kb < kc || (kb == kc && tb < tc);
+    const bool ac = ka < kc || (ka == kc && ta < tc);
+    if (ab == bc) return b;
+    return ab == ac ? c : a;
+}
+
+// 排序中需要的位置信息：项数组和同样大小的临时数组，基数排序分桶时借用临时数组中对应的区间
+struct FBSortBuffers {
+    FBSortItem* items;
+    FBSortItem* scratch;
+};
+
+static void sortRange(FBSortItem* items, size_t n, size_t depth, size_t byteIndex, const FBSortBuffers& buffers, FBSortContext* context);
+
+// 排序划分出的一部分：多线程时较大的部分尽量交给新线程
+static void sortPart(FBSortItem* items, size_t n, size_t depth, size_t byteIndex, const FBSortBuffers& buffers, FBSortContext* context,
+                     std::vector<std::thread>& spawned) {
+    if (n <= 1) return;
+    if (context != nullptr && n >= kParallelGrain && context->tryAcquire()) {
+        const FBSortBuffers copy = buffers;
+        spawned.push_back(std::thread([items, n, depth, byteIndex, copy, context]() {
+            sortRange(items, n, depth, byteIndex, copy, context);
+            context->release();
+        }));
+        return;
+    }
+    sortRange(items, n, depth, byteIndex, buffers, context);
+}
+
+// 等待启动的线程结束
+static void joinAll(std::vector<std::thread>& spawned) {
+    for (size_t i = 0; i < spawned.size(); ++i) {
+        spawned[i].join();
+    }
+}
+
+// 多关键字快速排序：按缓存的 8 个字节三路划分，等于枢轴的部分读取下一段后继续排序
+static void multikeySort(FBSortItem* items, size_t n, size_t depth, const FBSortBuffers& buffers, FBSortContext* context) {
+    std::vector<std::thread> spawned;
+    while (n > kInsertionThreshold) {
+        const FBSortItem& pivot = items[medianOfThree(items, 0, n / 2, n - 1, depth)];
+        const uint64_t pivotKey = pivot.key;
+        const size_t pivotTail = tailLength(pivot, depth);
+
+        // [0, lt) 小于枢轴，[lt, i) 等于，[gt, n) 大于
+        size_t lt = 0, i = 0, gt = n;
+        while (i < gt) {
+            const int c = compareToPivot(items[i], pivotKey, pivotTail, depth);
+            if (c < 0) {
+                std::swap(items[lt++], items[i++]);
+            } else if (c > 0) {
+                std::swap(items[i], items[--gt]);
+            } else {
+                ++i;
+            }
+        }
+
+        // 等于枢轴的部分 8 个字节都相同；字符串都还没结束时读取下一段，否则这些字符串完全相等
+        if (pivotTail == 8 && gt - lt > 1) {
+            const size_t next = depth + 8;
+            for (size_t k = lt; k < gt; ++k) {
+                items[k].key = loadPrefix(items[k].data + next, items[k].size - next);
+            }
+            // 全部等于枢轴时（共享很长的前缀）原地进入下一段，不增加递归深度
+            if (lt == 0 && gt == n) {
+                depth = next;
+                continue;
+            }
+            sortPart(items + lt, gt - lt, next, 0, buffers, context, spawned);
+        }
+
+        // 较小的一侧递归，较大的一侧继续循环，递归深度不超过 log n
+        const size_t less = lt, greater = n - gt;
+        if (less < greater) {
+            sortPart(items, less, depth, 0, buffers, context, spawned);
+            items += gt;
+            n = greater;
+        } else {
+            sortPart(items + gt, greater, depth, 0, buffers, context, spawned);
+            n = less;
+        }
+    }
+    insertionSort(items, n, depth);
+    joinAll(spawned);
+}
+
+// MSD 基数排序的一趟：按缓存整数中第 byteIndex 个字节分为 257 个桶，0 号桶是在这个字节之前已经结束的字符串
+// 同一个桶的项前面的字节都相同，继续按下一个字节排序；8 个字节用完后读取下一段
+static void radixSort(FBSortItem* items, size_t n, size_t depth, size_t byteIndex, const FBSortBuffers& buffers, FBSortContext* context) {
+    // 先跳过所有项共同的前缀：共享前缀的键不必逐个字节分桶，也不增加递归深度
+    for (;;) {
+        const uint64_t first = items[0].key;
+        uint64_t diff = 0;
+        size_t minSize = items[0].size;
+        for (size_t i = 1; i < n; ++i) {
+            diff |= items[i].key ^ first;
+            minSize = std::min(minSize, items[i].size);
+        }
+        const size_t common = std::min(diff == 0 ? 8 : leadingZeroBytes(diff), minSize - depth);
+        if (common < 8) {
+            byteIndex = std::max(byteIndex, common);
+            break;
+        }
+        depth += 8;
+        byteIndex = 0;
+        for (size_t k = 0; k < n; ++k) {
+            items[k].key = loadPrefix(items[k].data + depth, items[k].size - depth);
+        }
+    }
+
+    const size_t position = depth + byteIndex;
+    const unsigned shift = static_cast<unsigned>(56 - 8 * byteIndex);
+    size_t counts[257] = {};
+    for (size_t i = 0; i < n; ++i) {
+        const size_t bucket = items[i].size > position ? 1 + static_cast<size_t>((items[i].key >> shift) & 0xFF) : 0;
+        ++counts[bucket];
+    }
+    // 都已经结束时完全相等
+    if (counts[0] == n) return;
+    size_t offsets[257];
+    size_t sum = 0;
+    for (size_t b = 0; b < 257; ++b) {
+        offsets[b] = sum;
+        sum += counts[b];
+    }
+    FBSortItem* scratch = buffers.scratch + (items - buffers.items);
+    for (size_t i = 0; i < n; ++i) {
+        const size_t bucket = items[i].size > position ? 1 + static_cast<size_t>((items[i].key >> shift) & 0xFF) : 0;
+        scratch[offsets[bucket]++] = items[i];
+    }
+    std::memcpy(items, scratch, n * sizeof(FBSortItem));
+
+    // 0 号桶的字符串完全相等，不需要再排序
+    std::vector<std::thread> spawned;
+    size_t begin = counts[0];
+    for (size_t b = 1; b < 257; ++b) {
+        const size_t count = counts[b];
+        if (count > 1) {
+            if (byteIndex == 7) {
+                const size_t next = depth + 8;
+                for (size_t k = begin; k < begin + count; ++k) {
+                    items[k].key = loadPrefix(items[k].data + next, items[k].size - next);
+                }
+                sortPart(items + begin, count, next, 0, buffers, context, spawned);
+            } else {
+                sortPart(items + begin, count, depth, byteIndex + 1, buffers, context, spawned);
+            }
+        }
+        begin += count;
+    }
+    joinAll(spawned);
+}
+
+// 排序一段项：它们从 depth 起的前 byteIndex 个字节都相同，缓存的整数是从 depth 起的 8 个字节
+static void sortRange(FBSortItem* items, size_t n, size_t depth, size_t byteIndex, const FBSortBuffers& buffers, FBSortContext* context) {
+    if (n >= kRadixThreshold) {
+        radixSort(items, n, depth, byteIndex, buffers, context);
+    } else {
+        multikeySort(items, n, depth, buffers, context);
+    }
+}
+
+// 把 [0, n) 分成 threads 块并行执行 f(begin, end)
+template <typename Function>
+static void forEachChunk(size_t n, unsigned threads, Function f) {
+    if (threads <= 1) {
+        f(static_cast<size_t>(0), n);
+        return;
+    }
+    std::vector<std::thread> workers;
+    const size_t chunk = (n + threads - 1) / threads;
+    for (size_t begin = chunk; begin < n; begin += chunk) {
+        workers.push_back(std::thread(f, begin, std::min(n, begin + chunk)));
+    }
+    f(static_cast<size_t>(0), std::min(n, chunk));
+    for (size_t i = 0; i < workers.size(); ++i) {
+        workers[i].join();
+    }
+}
+
+// 生成排序项、排序，再按排好的顺序移动字符串
+static void sortStrings(FBString* first, FBString* last, unsigned threads) {
+    const size_t n = static_cast<size_t>(last - first);
+    if (n < 2) return;
+    std::unique_ptr<FBSortItem[]> items(new FBSortItem[n]);
+    forEachChunk(n, threads, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            FBSortItem& item = items[i];
+            item.data = first[i].c_str();
+            item.size = first[i].size();
+            item.key = loadPrefix(item.data, item.size);
+            item.str = first + i;
+        }
+    });
+
+    std::unique_ptr<FBSortItem[]> scratch(new FBSortItem[n]);
+    const FBSortBuffers buffers = {items.get(), scratch.get()};
+    if (threads <= 1) {
+        sortRange(items.get(), n, 0, 0, buffers, nullptr);
+    } else {
+        FBSortContext context(static_cast<int>(threads) - 1);
+        sortRange(items.get(), n, 0, 0, buffers, &context);
+    }
+    scratch.reset();
+
+    // 按排好的顺序移动字符串，移动不复制内容
+    std::unique_ptr<FBString[]> sorted(new FBString[n]);
+    forEachChunk(n, threads, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            sorted[i] = std::move(*items[i].str);
+        }
+    });
+    forEachChunk(n, threads, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            first[i] = std::move(sorted[i]);
+        }
+    });
+}
+
+// 排序
+void FBStringSort::sort(FBString* first, FBString* last) {
+    sortStrings(first, last, 1);
+}
+
+void FBStringSort::sort(std::vector<FBString>& strings) {
+    if (!strings.empty()) sort(&strings[0], &strings[0] + strings.size());
+}
+
+// 多线程排序
+void FBStringSort::parallelSort(FBString* first, FBString* last, unsigned threads) {
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    if (static_cast<size_t>(last - first) < kParallelThreshold) threads = 1;
+    sortStrings(first, last, threads);
+}
+
+void FBStringSort::parallelSort(std::vector<FBString>& strings, unsigned threads) {
+    if (!strings.empty()) parallelSort(&strings[0], &strings[0] + strings.size(), threads);
+}
@@ -0,0 +1,36 @@
+#ifndef FBSTRING_SORT_H
+#define FBSTRING_SORT_H
+
+#include "FBString.h"
+#include <cstddef>
+#include <vector>
+
+// FBStringSort 提供专门针对字符串的排序：MSD 基数排序与多关键字快速排序（multikey quicksort）结合
+// 每个字符串在排序数组中对应一项，缓存当前深度起的 8 个字节（按大端序拼成 64 位整数）和长度，
+// 分桶和划分时只读取缓存的整数，不访问字符串的存储；前缀相同的一组再一起向后读取下一个 8 字节。
+// 较大的部分按单个字节分桶，较小的部分用三路划分的快速排序。
+// 排好项的顺序后再按顺序移动 FBString，移动不复制内容。
+// 结果按字节的无符号值排序，与 memcmp 以及 FBString 的比较运算符一致；相等的字符串之间顺序不确定（不稳定排序）。
+class FBStringSort {
+public:
+    /**
+     * 排序
+     * @param first 起始位置
+     * @param last 结束位置
+     */
+    static void sort(FBString* first, FBString* last);
+    static void sort(std::vector<FBString>& strings);
+
+    /**
+     * 多线程排序
+     * 生成缓存项和最后的移动按线程分块进行；划分后足够大的部分交给新线程排序，同时运行的线程数不超过 threads。
+     * 元素较少时退化为单线程的 sort。
+     * @param first 起始位置
+     * @param last 结束位置
+     * @param threads 最多使用的线程数，0 表示使用硬件线程数
+     */
+    static void parallelSort(FBString* first, FBString* last, unsigned threads = 0);
+    static void parallelSort(std::vector<FBString>& strings, unsigned threads = 0);
+};
+
+#endif // FBSTRING_SORT_H
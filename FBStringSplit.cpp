@@ -0,0 +1,106 @@
+#include "FBStringSplit.h"
+#include <stdexcept>
+
+// 默认构造函数
+FBSplitRange::iterator::iterator() : range_(nullptr), field_(), done_(true) {}
+
+// 从 fieldBegin 开始定位一个字段
+FBSplitRange::iterator::iterator(const FBSplitRange* range, const char* fieldBegin) : range_(range), done_(false) {
+    field_ = FBStringView(fieldBegin, range_->findDelimiter(fieldBegin) - fieldBegin);
+}
+
+// 访问当前字段
+FBSplitRange::iterator::reference FBSplitRange::iterator::operator*() const {
+    return field_;
+}
+
+FBSplitRange::iterator::pointer FBSplitRange::iterator::operator->() const {
+    return &field_;
+}
+
+// 前进到下一个字段：当前字段之后紧跟分隔符时从分隔符之后继续，否则已到达末尾
+FBSplitRange::iterator& FBSplitRange::iterator::operator++() {
+    const char* fieldEnd = field_.end();
+    if (fieldEnd == range_->str_.end()) {
+        done_ = true;
+        field_ = FBStringView();
+        return *this;
+    }
+    const char* next = fieldEnd + range_->delimiterSize_;
+    field_ = FBStringView(next, range_->findDelimiter(next) - next);
+    return *this;
+}
+
+FBSplitRange::iterator FBSplitRange::iterator::operator++(int) {
+    iterator old = *this;
+    ++*this;
+    return old;
+}
+
+// 比较运算符
+bool FBSplitRange::iterator::operator==(const iterator& other) const {
+    if (done_ || other.done_) return done_ == other.done_;
+    return field_.data() == other.field_.data();
+}
+
+bool FBSplitRange::iterator::operator!=(const iterator& other) const {
+    return !(*this == other);
+}
+
+// 按单个字符切分
+FBSplitRange::FBSplitRange(FBStringView str, char delimiter)
+    : str_(str), kind_(Kind::Char), delimiter_(delimiter), substring_(), set_(), delimiterSize_(1) {}
+
+// 按子串切分
+FBSplitRange::FBSplitRange(FBStringView str, FBStringView delimiter)
+    : str_(str), kind_(Kind::Substring), delimiter_(0), substring_(delimiter), set_(), delimiterSize_(delimiter.size()) {
+    if (delimiter.empty()) throw std::invalid_argument("Empty delimiter");
+}
+
+// 按字节集合切分
+FBSplitRange::FBSplitRange(FBStringView str, const FBByteSet& delimiters)
+    : str_(str), kind_(Kind::ByteSet), delimiter_(0), substring_(), set_(delimiters), delimiterSize_(1) {}
+
+// 迭代器
+FBSplitRange::iterator FBSplitRange::begin() const {
+    return iterator(this, str_.begin());
+}
+
+FBSplitRange::iterator FBSplitRange::end() const {
+    return iterator();
+}
+
+// 把字段依次写入预先分配的数组
+size_t FBSplitRange::into(FBStringView* out, size_t capacity) const {
+    size_t count = 0;
+    for (iterator it = begin(), last = end(); it != last && count < capacity; ++it) {
+        out[count++] = *it;
+    }
+    return count;
+}
+
+// 从 p 开始查找下一个分隔符，未找到返回字符串末尾
+const char* FBSplitRange::findDelimiter(const char* p) const {
+    switch (kind_) {
+        case Kind::Char:
+            return FBStringSimd::find(p, str_.end(), delimiter_);
+        case Kind::Substring:
+            return FBStringSimd::findSubstring(p, str_.end(), substring_.data(), substring_.size());
+        case Kind::ByteSet:
+            return FBStringSimd::findAny(p, str_.end(), set_);
+    }
+    return str_.end();
+}
+
+// 惰性切分字符串视图
+FBSplitRange split(FBStringView str, char delimiter) {
+    return FBSplitRange(str, delimiter);
+}
+
+FBSplitRange split(FBStringView str, FBStringView delimiter) {
+    return FBSplitRange(str, delimiter);
+}
+
+FBSplitRange split(FBStringView str, const FBByteSet& delimiters) {
+    return FBSplitRange(str, delimiters);
+}
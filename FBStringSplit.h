@@ -0,0 +1,153 @@
+#ifndef FBSTRING_SPLIT_H
+#define FBSTRING_SPLIT_H
+
+#include "FBStringView.h"
+#include "FBStringSimd.h"
+#include <iterator>
+
+/**
+ * 按分隔符惰性切分字符串
+ * 每次迭代才查找下一个分隔符，产出的字段是指向原字符串的视图，整个过程不分配内存。
+ * 与 Python 的 str.split(sep) 一致：空字符串产出一个空字段，相邻的分隔符之间产出空字段。
+ * 被切分的字符串和子串分隔符都只保存视图，必须在迭代期间保持有效且不被修改。
+ */
+class FBSplitRange {
+public:
+    // 字段迭代器（前向迭代器）
+    class iterator {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef FBStringView value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const FBStringView* pointer;
+        typedef const FBStringView& reference;
+
+        /**
+         * 默认构造函数
+         * 构造一个结束迭代器。
+         */
+        iterator();
+
+        /**
+         * 访问当前字段
+         * @return 当前字段的视图
+         */
+        reference operator*() const;
+        pointer operator->() const;
+
+        /**
+         * 前进到下一个字段
+         * @return 前进后的迭代器
+         */
+        iterator& operator++();
+        iterator operator++(int);
+
+        /**
+         * 比较运算符
+         * @param other 要比较的迭代器
+         * @return 比较结果
+         */
+        bool operator==(const iterator& other) const;
+        bool operator!=(const iterator& other) const;
+
+    private:
+        friend class FBSplitRange;
+
+        /** 从 fieldBegin 开始定位一个字段 */
+        iterator(const FBSplitRange* range, const char* fieldBegin);
+
+        const FBSplitRange* range_; /**< 所属的切分范围 */
+        FBStringView field_;        /**< 当前字段 */
+        bool done_;                 /**< 是否已越过最后一个字段 */
+    };
+
+    typedef iterator const_iterator;
+
+    /**
+     * 按单个字符切分
+     * @param str 要切分的字符串
+     * @param delimiter 分隔符
+     */
+    FBSplitRange(FBStringView str, char delimiter);
+
+    /**
+     * 按子串切分
+     * @param str 要切分的字符串
+     * @param delimiter 分隔子串
+     * @throws invalid_argument 如果分隔子串为空
+     */
+    FBSplitRange(FBStringView str, FBStringView delimiter);
+
+    /**
+     * 按字节集合切分，集合中的任一字节都是分隔符
+     * @param str 要切分的字符串
+     * @param delimiters 分隔字节集合
+     */
+    FBSplitRange(FBStringView str, const FBByteSet& delimiters);
+
+    /**
+     * 迭代器
+     * @return 第一个字段或结束位置
+     */
+    iterator begin() const;
+    iterator end() const;
+
+    /**
+     * 把全部字段追加到容器末尾
+     * 容器的元素需要能由 (const char*, size_t) 构造，例如 FBStringView、FBString、std::string；
+     * 元素为 FBStringView 且容器已预留空间时不会分配内存。
+     * @param out 目标容器，已有元素保持不变
+     * @return 追加的字段数
+     */
+    template <typename Container>
+    size_t into(Container& out) const;
+
+    /**
+     * 把字段依次写入预先分配的数组
+     * @param out 目标数组
+     * @param capacity 数组容量，字段数超过容量时只写入前 capacity 个
+     * @return 写入的字段数
+     */
+    size_t into(FBStringView* out, size_t capacity) const;
+
+private:
+    /** 分隔符类别 */
+    enum class Kind {
+        Char,
+        Substring,
+        ByteSet
+    };
+
+    /** 从 p 开始查找下一个分隔符，未找到返回字符串末尾 */
+    const char* findDelimiter(const char* p) const;
+
+    FBStringView str_;       /**< 被切分的字符串 */
+    Kind kind_;              /**< 分隔符类别 */
+    char delimiter_;         /**< 单字符分隔符 */
+    FBStringView substring_; /**< 子串分隔符 */
+    FBByteSet set_;          /**< 分隔字节集合 */
+    size_t delimiterSize_;   /**< 分隔符长度 */
+};
+
+/**
+ * 惰性切分字符串视图
+ * FBString 提供同名的成员函数。
+ * @param str 要切分的字符串
+ * @param delimiter 单字符分隔符、分隔子串或分隔字节集合
+ * @return 产出字段视图的范围
+ */
+FBSplitRange split(FBStringView str, char delimiter);
+FBSplitRange split(FBStringView str, FBStringView delimiter);
+FBSplitRange split(FBStringView str, const FBByteSet& delimiters);
+
+// 把全部字段追加到容器末尾
+template <typename Container>
+size_t FBSplitRange::into(Container& out) const {
+    size_t count = 0;
+    for (iterator it = begin(), last = end(); it != last; ++it, ++count) {
+        out.emplace_back(it->data(), it->size());
+    }
+    return count;
+}
+
+#endif // FBSTRING_SPLIT_H
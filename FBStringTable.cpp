@@ -0,0 +1,228 @@
+#include "FBStringTable.h"
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+// 结束位置中 slab 内偏移占的位数，其余高位是 slab 编号
+static const unsigned kOffsetBits = 40;
+static const uint64_t kOffsetMask = (static_cast<uint64_t>(1) << kOffsetBits) - 1;
+static const uint64_t kMaxSlabs = static_cast<uint64_t>(1) << (64 - kOffsetBits);
+
+const size_t FBStringTable::kDefaultSlabSize;
+
+// 迭代器默认构造函数
+FBStringTable::const_iterator::const_iterator() : table_(nullptr), index_(0) {}
+
+// 迭代器构造函数
+FBStringTable::const_iterator::const_iterator(const FBStringTable* table, size_t index) : table_(table), index_(index) {}
+
+// 解引用
+FBStringView FBStringTable::const_iterator::operator*() const {
+    return (*table_)[index_];
+}
+
+// 前置递增
+FBStringTable::const_iterator& FBStringTable::const_iterator::operator++() {
+    ++index_;
+    return *this;
+}
+
+// 后置递增
+FBStringTable::const_iterator FBStringTable::const_iterator::operator++(int) {
+    const_iterator old = *this;
+    ++index_;
+    return old;
+}
+
+// 迭代器比较
+bool FBStringTable::const_iterator::operator==(const const_iterator& other) const {
+    return index_ == other.index_ && table_ == other.table_;
+}
+
+bool FBStringTable::const_iterator::operator!=(const const_iterator& other) const {
+    return !(*this == other);
+}
+
+// 构造函数
+FBStringTable::FBStringTable(size_t slabSize) : bytes_(0), slabSize_(slabSize) {
+    if (slabSize == 0 || static_cast<uint64_t>(slabSize) > kOffsetMask) {
+        throw std::invalid_argument("Invalid slab size");
+    }
+}
+
+// 移动构造函数
+FBStringTable::FBStringTable(FBStringTable&& other) noexcept
+    : ends_(std::move(other.ends_)), slabs_(std::move(other.slabs_)), bytes_(other.bytes_), slabSize_(other.slabSize_) {
+    other.ends_.clear();
+    other.slabs_.clear();
+    other.bytes_ = 0;
+}
+
+// 移动赋值运算符
+FBStringTable& FBStringTable::operator=(FBStringTable&& other) noexcept {
+    if (this != &other) {
+        ends_ = std::move(other.ends_);
+        slabs_ = std::move(other.slabs_);
+        bytes_ = other.bytes_;
+        slabSize_ = other.slabSize_;
+        other.ends_.clear();
+        other.slabs_.clear();
+        other.bytes_ = 0;
+    }
+    return *this;
+}
+
+// 开始新的 slab
+void FBStringTable::addSlab(size_t n) {
+    if (slabs_.size() >= kMaxSlabs) {
+        throw std::length_error("FBStringTable has too many slabs");
+    }
+    Slab slab;
+    slab.capacity = n > slabSize_ ? n : slabSize_;
+    slab.data.reset(new char[slab.capacity]);
+    slab.used = 0;
+    slabs_.push_back(std::move(slab));
+}
+
+// 追加字符串
+size_t FBStringTable::push_back(FBStringView str) {
+    const size_t n = str.size();
+    if (static_cast<uint64_t>(n) > kOffsetMask) {
+        throw std::length_error("String too long for FBStringTable");
+    }
+    if (slabs_.empty() || slabs_.back().capacity - slabs_.back().used < n) {
+        addSlab(n);
+    }
+    // 先记录结束位置再复制内容：push_back 抛出异常时表保持不变（最多多出一块空的 slab）
+    Slab& slab = slabs_.back();
+    const uint64_t slabIndex = slabs_.size() - 1;
+    ends_.push_back((slabIndex << kOffsetBits) | (slab.used + n));
+    // 旧的 slab 不会移动，str 指向表中已有元素时仍然有效，且与写入的区域不重叠
+    if (n != 0) {
+        std::memcpy(slab.data.get() + slab.used, str.data(), n);
+    }
+    slab.used += n;
+    bytes_ += n;
+    return ends_.size() - 1;
+}
+
+// 下标访问：起始位置是前一个元素在同一 slab 中的结束位置，前一个元素在别的 slab 中时为 0
+FBStringView FBStringTable::operator[](size_t i) const {
+    const uint64_t end = ends_[i];
+    const uint64_t slab = end >> kOffsetBits;
+    size_t begin = 0;
+    if (i != 0 && (ends_[i - 1] >> kOffsetBits) == slab) {
+        begin = static_cast<size_t>(ends_[i - 1] & kOffsetMask);
+    }
+    return FBStringView(slabs_[static_cast<size_t>(slab)].data.get() + begin, static_cast<size_t>(end & kOffsetMask) - begin);
+}
+
+// 带检查的下标访问
+FBStringView FBStringTable::at(size_t i) const {
+    if (i >= ends_.size()) {
+        throw std::out_of_range("Index out of range");
+    }
+    return (*this)[i];
+}
+
+// 复制为 FBString
+FBString FBStringTable::str(size_t i) const {
+    const FBStringView view = at(i);
+    return FBString(view.data(), view.size());
+}
+
+// 元素个数
+size_t FBStringTable::size() const {
+    return ends_.size();
+}
+
+// 是否为空
+bool FBStringTable::empty() const {
+    return ends_.empty();
+}
+
+// 内容总字节数
+size_t FBStringTable::bytes() const {
+    return bytes_;
+}
+
+// 占用的内存
+size_t FBStringTable::memory_usage() const {
+    size_t total = sizeof(*this) + ends_.capacity() * sizeof(uint64_t) + slabs_.capacity() * sizeof(Slab);
+    for (size_t i = 0; i < slabs_.size(); ++i) {
+        total += slabs_[i].capacity;
+    }
+    return total;
+}
+
+// 预留结束位置的空间
+void FBStringTable::reserve(size_t count) {
+    ends_.reserve(count);
+}
+
+// 释放未使用的容量
+void FBStringTable::shrink_to_fit() {
+    if (!slabs_.empty()) {
+        Slab& last = slabs_.back();
+        if (last.used < last.capacity) {
+            std::unique_ptr<char[]> data(new char[last.used]);
+            if (last.used != 0) {
+                std::memcpy(data.get(), last.data.get(), last.used);
+            }
+            last.data = std::move(data);
+            last.capacity = last.used;
+        }
+    }
+    ends_.shrink_to_fit();
+    slabs_.shrink_to_fit();
+}
+
+// 合并为一块连续内存
+void FBStringTable::freeze() {
+    if (slabs_.size() <= 1) {
+        shrink_to_fit();
+        return;
+    }
+    if (static_cast<uint64_t>(bytes_) > kOffsetMask) {
+        throw std::length_error("FBStringTable too large to freeze");
+    }
+    // 元素按下标顺序依次存放在各 slab 中，按顺序拼接各 slab 已使用的部分即得到所有元素首尾相接的内容
+    Slab merged;
+    merged.data.reset(new char[bytes_]);
+    merged.capacity = bytes_;
+    merged.used = 0;
+    std::vector<size_t> bases(slabs_.size());
+    for (size_t s = 0; s < slabs_.size(); ++s) {
+        bases[s] = merged.used;
+        if (slabs_[s].used != 0) {
+            std::memcpy(merged.data.get() + merged.used, slabs_[s].data.get(), slabs_[s].used);
+        }
+        merged.used += slabs_[s].used;
+    }
+    std::vector<uint64_t> ends;
+    ends.reserve(ends_.size());
+    for (size_t i = 0; i < ends_.size(); ++i) {
+        ends.push_back(bases[static_cast<size_t>(ends_[i] >> kOffsetBits)] + (ends_[i] & kOffsetMask));
+    }
+    std::vector<Slab> slabs;
+    slabs.reserve(1);
+    slabs.push_back(std::move(merged));
+    ends_.swap(ends);
+    slabs_.swap(slabs);
+}
+
+// 清空
+void FBStringTable::clear() {
+    std::vector<uint64_t>().swap(ends_);
+    std::vector<Slab>().swap(slabs_);
+    bytes_ = 0;
+}
+
+// 迭代器
+FBStringTable::const_iterator FBStringTable::begin() const {
+    return const_iterator(this, 0);
+}
+
+FBStringTable::const_iterator FBStringTable::end() const {
+    return const_iterator(this, ends_.size());
+}
@@ -0,0 +1,183 @@
+#ifndef FBSTRING_TABLE_H
+#define FBSTRING_TABLE_H
+
+#include "FBString.h"
+#include "FBStringView.h"
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+/**
+ * 只追加的字符串表，用于保存大量不再修改的字符串
+ * 所有字符串的内容依次复制到大块的连续内存（slab）中，每个字符串只额外占用 8 字节的结束位置；
+ * 不像 std::vector<FBString> 那样每个对象占 32 字节，中型和大型字符串还各有自己的缓冲区和引用计数块。
+ * 结束位置的高位是 slab 编号、低位是 slab 内的偏移，起始位置就是前一个字符串在同一 slab 中的结束位置，访问任意元素都是常数时间。
+ * 追加不移动已有的内容，返回的视图在 shrink_to_fit()、freeze()、clear() 或表销毁之前一直有效。
+ * 字符串不跨 slab 存放：当前 slab 剩余空间不够时开始新的 slab，超过 slab 大小的字符串单独占用一块恰好大小的 slab。
+ */
+class FBStringTable {
+public:
+    static const size_t kDefaultSlabSize = 1 << 20; /**< 默认的 slab 大小（字节） */
+
+    /** 顺序遍历的迭代器，解引用得到元素的视图 */
+    class const_iterator {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef FBStringView value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const FBStringView* pointer;
+        typedef FBStringView reference;
+
+        const_iterator();
+
+        FBStringView operator*() const;
+        const_iterator& operator++();
+        const_iterator operator++(int);
+        bool operator==(const const_iterator& other) const;
+        bool operator!=(const const_iterator& other) const;
+
+    private:
+        friend class FBStringTable;
+
+        const_iterator(const FBStringTable* table, size_t index);
+
+        const FBStringTable* table_; /**< 所属的表 */
+        size_t index_;               /**< 元素下标 */
+    };
+
+    typedef const_iterator iterator;
+
+    /**
+     * 构造函数
+     * @param slabSize 每块 slab 的字节数
+     * @throws std::invalid_argument 如果 slabSize 为 0 或超过单个 slab 能表示的偏移
+     */
+    explicit FBStringTable(size_t slabSize = kDefaultSlabSize);
+
+    FBStringTable(const FBStringTable&) = delete;
+    FBStringTable& operator=(const FBStringTable&) = delete;
+
+    /**
+     * 移动构造函数，被移动的表变为空表
+     * @param other 要移动的表
+     */
+    FBStringTable(FBStringTable&& other) noexcept;
+
+    /**
+     * 移动赋值运算符，被移动的表变为空表
+     * @param other 要移动的表
+     * @return 当前表的引用
+     */
+    FBStringTable& operator=(FBStringTable&& other) noexcept;
+
+    /**
+     * 在末尾追加一个字符串，复制其内容
+     * str 可以是表中已有元素的视图。
+     * @param str 要追加的内容
+     * @return 新元素的下标
+     * @throws std::length_error 如果 slab 个数或单个字符串的长度超过结束位置能表示的范围
+     */
+    size_t push_back(FBStringView str);
+
+    /**
+     * 返回第 i 个元素的视图，不检查下标
+     * @param i 下标
+     * @return 视图
+     */
+    FBStringView operator[](size_t i) const;
+
+    /**
+     * 返回第 i 个元素的视图
+     * @param i 下标
+     * @return 视图
+     * @throws std::out_of_range 如果下标越界
+     */
+    FBStringView at(size_t i) const;
+
+    /**
+     * 把第 i 个元素复制为 FBString；不超过小型存储容量的内容不分配内存
+     * @param i 下标
+     * @return 字符串
+     * @throws std::out_of_range 如果下标越界
+     */
+    FBString str(size_t i) const;
+
+    /**
+     * 返回元素个数
+     * @return 个数
+     */
+    size_t size() const;
+
+    /**
+     * 判断表是否为空
+     * @return 为空返回 true
+     */
+    bool empty() const;
+
+    /**
+     * 返回所有元素内容的总字节数
+     * @return 字节数
+     */
+    size_t bytes() const;
+
+    /**
+     * 返回表占用的内存字节数，包括 slab 的全部容量、结束位置数组的容量和表对象本身
+     * @return 字节数
+     */
+    size_t memory_usage() const;
+
+    /**
+     * 为 count 个元素的结束位置预留空间
+     * @param count 元素个数
+     */
+    void reserve(size_t count);
+
+    /**
+     * 释放最后一块 slab 和结束位置数组中未使用的容量
+     * 最后一块 slab 的内容会被移动，指向它的视图失效。之后仍可追加，追加时开始新的 slab。
+     */
+    void shrink_to_fit();
+
+    /**
+     * 构建完成后压缩：把所有 slab 的内容合并到一块恰好大小的连续内存，并释放多余的容量
+     * 合并后所有元素首尾相接，顺序遍历只访问一块内存。所有视图失效。之后仍可追加，追加时开始新的 slab。
+     * @throws std::length_error 如果总字节数超过单个 slab 能表示的偏移
+     */
+    void freeze();
+
+    /**
+     * 清空表并释放所有内存
+     */
+    void clear();
+
+    /**
+     * 返回迭代器，按下标顺序遍历
+     * @return 迭代器
+     */
+    const_iterator begin() const;
+    const_iterator end() const;
+
+private:
+    /** 一块连续内存，used 之前的部分依次存放字符串内容 */
+    struct Slab {
+        std::unique_ptr<char[]> data;
+        size_t capacity;
+        size_t used;
+    };
+
+    /**
+     * 开始一块能容纳至少 n 字节的新 slab
+     * @param n 需要的字节数
+     * @throws std::length_error 如果 slab 个数超过结束位置能表示的范围
+     */
+    void addSlab(size_t n);
+
+    std::vector<uint64_t> ends_; /**< 每个元素的结束位置：高位为 slab 编号，低位为 slab 内的偏移 */
+    std::vector<Slab> slabs_;    /**< slab 数组，只在最后一块中追加 */
+    size_t bytes_;               /**< 内容总字节数 */
+    size_t slabSize_;            /**< 新 slab 的默认大小 */
+};
+
+#endif // FBSTRING_TABLE_H
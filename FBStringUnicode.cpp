@@ -0,0 +1,346 @@
+#include "FBStringUnicode.h"
+#include "FBStringSimd.h"
+
+#if defined(FBSTRING_HAS_AVX2)
+#include <immintrin.h>
+#elif defined(FBSTRING_HAS_SSE2)
+#include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+#if defined(FBSTRING_HAS_SSE2)
+// 非零位的个数
+static inline unsigned popCount(uint32_t mask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    return static_cast<unsigned>(__popcnt(mask));
+#else
+    return static_cast<unsigned>(__builtin_popcount(mask));
+#endif
+}
+#endif
+
+// 解码一个 UTF-8 码点（输入必须合法），返回下一个码点的位置
+static inline const unsigned char* decodeUtf8(const unsigned char* p, char32_t& cp) {
+    const unsigned char c = p[0];
+    if (c < 0x80) {
+        cp = c;
+        return p + 1;
+    }
+    if (c < 0xE0) {
+        cp = (static_cast<char32_t>(c & 0x1F) << 6) | (p[1] & 0x3F);
+        return p + 2;
+    }
+    if (c < 0xF0) {
+        cp = (static_cast<char32_t>(c & 0x0F) << 12) | (static_cast<char32_t>(p[1] & 0x3F) << 6) | (p[2] & 0x3F);
+        return p + 3;
+    }
+    cp = (static_cast<char32_t>(c & 0x07) << 18) | (static_cast<char32_t>(p[1] & 0x3F) << 12) |
+         (static_cast<char32_t>(p[2] & 0x3F) << 6) | (p[3] & 0x3F);
+    return p + 4;
+}
+
+// 解码一个 UTF-16 码点（输入必须合法），返回下一个码点的位置
+static inline const char16_t* decodeUtf16(const char16_t* p, char32_t& cp) {
+    const char16_t u = p[0];
+    if ((u & 0xFC00) != 0xD800) {
+        cp = u;
+        return p + 1;
+    }
+    cp = 0x10000 + ((static_cast<char32_t>(u) - 0xD800) << 10) + (static_cast<char32_t>(p[1]) - 0xDC00);
+    return p + 2;
+}
+
+// 写入一个码点的 UTF-16 编码，返回写入后的位置
+static inline char16_t* encodeUtf16(char16_t* out, char32_t cp) {
+    if (cp < 0x10000) {
+        *out++ = static_cast<char16_t>(cp);
+    } else {
+        cp -= 0x10000;
+        *out++ = static_cast<char16_t>(0xD800 + (cp >> 10));
+        *out++ = static_cast<char16_t>(0xDC00 + (cp & 0x3FF));
+    }
+    return out;
+}
+
+// 写入一个码点的 UTF-8 编码，返回写入后的位置
+static inline char* encodeUtf8(char* out, char32_t cp) {
+    if (cp < 0x80) {
+        *out++ = static_cast<char>(cp);
+    } else if (cp < 0x800) {
+        *out++ = static_cast<char>(0xC0 | (cp >> 6));
+        *out++ = static_cast<char>(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        *out++ = static_cast<char>(0xE0 | (cp >> 12));
+        *out++ = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        *out++ = static_cast<char>(0x80 | (cp & 0x3F));
+    } else {
+        *out++ = static_cast<char>(0xF0 | (cp >> 18));
+        *out++ = static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+        *out++ = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        *out++ = static_cast<char>(0x80 | (cp & 0x3F));
+    }
+    return out;
+}
+
+// 计算 UTF-8 转换为 UTF-16 后的单元数：续字节以外的字节各占一个单元，4 字节序列的首字节再多占一个
+size_t FBStringUnicode::utf16Length(const char* utf8, size_t n) {
+    size_t length = 0;
+    size_t i = 0;
+#if defined(FBSTRING_HAS_SSE2)
+    {
+        const __m128i continuation = _mm_set1_epi8(-65);
+        const __m128i fourByteLead = _mm_set1_epi8(static_cast<char>(0xF0));
+        for (; n - i >= 16; i += 16) {
+            const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(utf8 + i));
+            const uint32_t leads = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpgt_epi8(chunk, continuation)));
+            const uint32_t fours = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(chunk, fourByteLead), chunk)));
+            length += popCount(leads) + popCount(fours);
+        }
+    }
+#endif
+    for (; i < n; ++i) {
+        const unsigned char c = static_cast<unsigned char>(utf8[i]);
+        length += ((c & 0xC0) != 0x80) + (c >= 0xF0);
+    }
+    return length;
+}
+
+// 计算 UTF-16 转换为 UTF-8 后的字节数：每个单元 1 ~ 3 字节，代理项每个单元 2 字节
+size_t FBStringUnicode::utf8Length(const char16_t* data, size_t n) {
+    size_t length = 0;
+    size_t i = 0;
+#if defined(FBSTRING_HAS_SSE2)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i above7F = _mm_set1_epi16(static_cast<short>(0xFF80));
+        const __m128i above7FF = _mm_set1_epi16(static_cast<short>(0xF800));
+        const __m128i surrogate = _mm_set1_epi16(static_cast<short>(0xD800));
+        for (; n - i >= 8; i += 8) {
+            const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+            const __m128i high = _mm_and_si128(chunk, above7FF);
+            // 掩码的每个单元占 2 位
+            const uint32_t ascii = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(chunk, above7F), zero)));
+            const uint32_t twoBytes = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi16(high, zero)));
+            const uint32_t surrogates = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi16(high, surrogate)));
+            length += 24 - (popCount(ascii) + popCount(twoBytes) + popCount(surrogates)) / 2;
+        }
+    }
+#endif
+    for (; i < n; ++i) {
+        const char16_t u = data[i];
+        length += 1 + (u >= 0x80) + (u >= 0x800 && (u & 0xF800) != 0xD800);
+    }
+    return length;
+}
+
+// 计算 UTF-32 转换为 UTF-8 后的字节数
+size_t FBStringUnicode::utf8Length(const char32_t* data, size_t n) {
+    size_t length = 0;
+    size_t i = 0;
+#if defined(FBSTRING_HAS_SSE2)
+    {
+        // 合法的码点不超过 U+10FFFF，可以用有符号比较
+        const __m128i limit1 = _mm_set1_epi32(0x7F);
+        const __m128i limit2 = _mm_set1_epi32(0x7FF);
+        const __m128i limit3 = _mm_set1_epi32(0xFFFF);
+        for (; n - i >= 4; i += 4) {
+            const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+            // 掩码的每个单元占 4 位
+            const uint32_t extra = popCount(static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpgt_epi32(chunk, limit1)))) +
+                                   popCount(static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpgt_epi32(chunk, limit2)))) +
+                                   popCount(static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpgt_epi32(chunk, limit3))));
+            length += 4 + extra / 4;
+        }
+    }
+#endif
+    for (; i < n; ++i) {
+        const char32_t c = data[i];
+        length += 1 + (c >= 0x80) + (c >= 0x800) + (c >= 0x10000);
+    }
+    return length;
+}
+
+// UTF-8 转换为 UTF-16
+void FBStringUnicode::utf8ToUtf16(char16_t* out, const char* utf8, size_t n) {
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(utf8);
+    const unsigned char* last = p + n;
+    while (p < last) {
+        const unsigned char* blockEnd = last;
+#if defined(FBSTRING_HAS_SSE2)
+        if (last - p >= 16) {
+            const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            if (_mm_movemask_epi8(chunk) == 0) {
+                // 16 个 ASCII 字节零扩展为 16 个单元
+#if defined(FBSTRING_HAS_AVX2)
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), _mm256_cvtepu8_epi16(chunk));
+#else
+                const __m128i zero = _mm_setzero_si128();
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_unpacklo_epi8(chunk, zero));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 8), _mm_unpackhi_epi8(chunk, zero));
+#endif
+                p += 16;
+                out += 16;
+                continue;
+            }
+            blockEnd = p + 16;
+        }
+#endif
+        // 含非 ASCII 字节的块逐个码点解码，最后一个码点可能越过块的末尾
+        while (p < blockEnd) {
+            char32_t cp;
+            p = decodeUtf8(p, cp);
+            out = encodeUtf16(out, cp);
+        }
+    }
+}
+
+// UTF-8 转换为 UTF-32
+void FBStringUnicode::utf8ToUtf32(char32_t* out, const char* utf8, size_t n) {
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(utf8);
+    const unsigned char* last = p + n;
+    while (p < last) {
+        const unsigned char* blockEnd = last;
+#if defined(FBSTRING_HAS_SSE2)
+        if (last - p >= 16) {
+            const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            if (_mm_movemask_epi8(chunk) == 0) {
+                // 16 个 ASCII 字节零扩展为 16 个单元
+#if defined(FBSTRING_HAS_AVX2)
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), _mm256_cvtepu8_epi32(chunk));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 8), _mm256_cvtepu8_epi32(_mm_srli_si128(chunk, 8)));
+#else
+                const __m128i zero = _mm_setzero_si128();
+                const __m128i low = _mm_unpacklo_epi8(chunk, zero);
+                const __m128i high = _mm_unpackhi_epi8(chunk, zero);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_unpacklo_epi16(low, zero));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 4), _mm_unpackhi_epi16(low, zero));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 8), _mm_unpacklo_epi16(high, zero));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 12), _mm_unpackhi_epi16(high, zero));
+#endif
+                p += 16;
+                out += 16;
+                continue;
+            }
+            blockEnd = p + 16;
+        }
+#endif
+        // 含非 ASCII 字节的块逐个码点解码，最后一个码点可能越过块的末尾
+        while (p < blockEnd) {
+            char32_t cp;
+            p = decodeUtf8(p, cp);
+            *out++ = cp;
+        }
+    }
+}
+
+// UTF-16 转换为 UTF-8
+void FBStringUnicode::utf16ToUtf8(char* out, const char16_t* data, size_t n) {
+    const char16_t* p = data;
+    const char16_t* last = data + n;
+    while (p < last) {
+        const char16_t* blockEnd = last;
+#if defined(FBSTRING_HAS_SSE2)
+        if (last - p >= 8) {
+            const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            const __m128i nonAscii = _mm_and_si128(chunk, _mm_set1_epi16(static_cast<short>(0xFF80)));
+            if (_mm_movemask_epi8(_mm_cmpeq_epi16(nonAscii, _mm_setzero_si128())) == 0xFFFF) {
+                // 8 个 ASCII 单元收窄为 8 个字节
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(out), _mm_packus_epi16(chunk, chunk));
+                p += 8;
+                out += 8;
+                continue;
+            }
+            blockEnd = p + 8;
+        }
+#endif
+        // 含非 ASCII 单元的块逐个码点编码，最后一对代理项可能越过块的末尾
+        while (p < blockEnd) {
+            char32_t cp;
+            p = decodeUtf16(p, cp);
+            out = encodeUtf8(out, cp);
+        }
+    }
+}
+
+// UTF-32 转换为 UTF-8
+void FBStringUnicode::utf32ToUtf8(char* out, const char32_t* data, size_t n) {
+    const char32_t* p = data;
+    const char32_t* last = data + n;
+    while (p < last) {
+        const char32_t* blockEnd = last;
+#if defined(FBSTRING_HAS_SSE2)
+        if (last - p >= 8) {
+            const __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            const __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 4));
+            const __m128i nonAscii = _mm_and_si128(_mm_or_si128(low, high), _mm_set1_epi32(~0x7F));
+            if (_mm_movemask_epi8(_mm_cmpeq_epi32(nonAscii, _mm_setzero_si128())) == 0xFFFF) {
+                // 8 个 ASCII 单元收窄为 8 个字节
+                const __m128i words = _mm_packs_epi32(low, high);
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(out), _mm_packus_epi16(words, words));
+                p += 8;
+                out += 8;
+                continue;
+            }
+            blockEnd = p + 8;
+        }
+#endif
+        while (p < blockEnd) {
+            out = encodeUtf8(out, *p++);
+        }
+    }
+}
+
+// UTF-8 转换为 UTF-16
+FBStringCore16 utf8_to_utf16(FBStringView utf8) {
+    if (!FBStringSimd::validateUtf8(utf8.data(), utf8.size())) throw std::invalid_argument("Invalid UTF-8");
+    FBStringCore16 result;
+    result.resize_and_overwrite(FBStringUnicode::utf16Length(utf8.data(), utf8.size()), [&](char16_t* out, size_t n) -> size_t {
+        FBStringUnicode::utf8ToUtf16(out, utf8.data(), utf8.size());
+        return n;
+    });
+    return result;
+}
+
+// UTF-8 转换为 UTF-32
+FBStringCore32 utf8_to_utf32(FBStringView utf8) {
+    if (!FBStringSimd::validateUtf8(utf8.data(), utf8.size())) throw std::invalid_argument("Invalid UTF-8");
+    FBStringCore32 result;
+    result.resize_and_overwrite(FBStringSimd::countCodePoints(utf8.data(), utf8.size()), [&](char32_t* out, size_t n) -> size_t {
+        FBStringUnicode::utf8ToUtf32(out, utf8.data(), utf8.size());
+        return n;
+    });
+    return result;
+}
+
+// UTF-16 转换为 UTF-8
+FBString utf16_to_utf8(const char16_t* data, size_t n) {
+    if (!FBStringSimd::validateUtf16(data, n)) throw std::invalid_argument("Invalid UTF-16");
+    FBString result;
+    result.resize_and_overwrite(FBStringUnicode::utf8Length(data, n), [&](char* out, size_t length) -> size_t {
+        FBStringUnicode::utf16ToUtf8(out, data, n);
+        return length;
+    });
+    return result;
+}
+
+FBString utf16_to_utf8(const FBStringCore16& utf16) {
+    return utf16_to_utf8(utf16.data(), utf16.size());
+}
+
+// UTF-32 转换为 UTF-8
+FBString utf32_to_utf8(const char32_t* data, size_t n) {
+    if (!FBStringSimd::validateUtf32(data, n)) throw std::invalid_argument("Invalid UTF-32");
+    FBString result;
+    result.resize_and_overwrite(FBStringUnicode::utf8Length(data, n), [&](char* out, size_t length) -> size_t {
+        FBStringUnicode::utf32ToUtf8(out, data, n);
+        return length;
+    });
+    return result;
+}
+
+FBString utf32_to_utf8(const FBStringCore32& utf32) {
+    return utf32_to_utf8(utf32.data(), utf32.size());
+}
@@ -0,0 +1,80 @@
+#ifndef FBSTRING_UNICODE_H
+#define FBSTRING_UNICODE_H
+
+#include "FBString.h"
+#include "FBStringCore.h"
+#include "FBStringView.h"
+#include <stdexcept>
+
+// FBStringUnicode 提供 UTF-8 与 UTF-16/UTF-32 之间的转码内核：先算出结果的精确长度，再直接写入目标存储
+class FBStringUnicode {
+public:
+    /**
+     * 计算 UTF-8 转换为 UTF-16 后的单元数
+     * 4 字节序列对应一对代理项，其余序列各对应一个单元。
+     * @param utf8 输入，必须是合法的 UTF-8
+     * @param n 字节数
+     * @return UTF-16 单元数
+     */
+    static size_t utf16Length(const char* utf8, size_t n);
+
+    /**
+     * 计算 UTF-16 或 UTF-32 转换为 UTF-8 后的字节数
+     * @param data 输入，必须是合法的 UTF-16 或 UTF-32
+     * @param n 单元数
+     * @return UTF-8 字节数
+     */
+    static size_t utf8Length(const char16_t* data, size_t n);
+    static size_t utf8Length(const char32_t* data, size_t n);
+
+    /**
+     * UTF-8 转换为 UTF-16
+     * 连续的 ASCII 字节按 16 或 32 字节一块直接零扩展写出，其余部分逐个码点解码。
+     * @param out 输出位置，至少有 utf16Length(utf8, n) 个单元可写
+     * @param utf8 输入，必须是合法的 UTF-8
+     * @param n 字节数
+     */
+    static void utf8ToUtf16(char16_t* out, const char* utf8, size_t n);
+
+    /**
+     * UTF-8 转换为 UTF-32
+     * @param out 输出位置，至少有 FBStringSimd::countCodePoints(utf8, n) 个单元可写
+     * @param utf8 输入，必须是合法的 UTF-8
+     * @param n 字节数
+     */
+    static void utf8ToUtf32(char32_t* out, const char* utf8, size_t n);
+
+    /**
+     * UTF-16 或 UTF-32 转换为 UTF-8
+     * 连续的 ASCII 单元整块收窄写出，其余部分逐个码点编码。
+     * @param out 输出位置，至少有 utf8Length(data, n) 个字节可写
+     * @param data 输入，必须是合法的 UTF-16 或 UTF-32
+     * @param n 单元数
+     */
+    static void utf16ToUtf8(char* out, const char16_t* data, size_t n);
+    static void utf32ToUtf8(char* out, const char32_t* data, size_t n);
+};
+
+/**
+ * UTF-8 转换为 UTF-16 或 UTF-32
+ * 先用 SIMD 校验输入并计算精确长度，结果一次写入目标字符串的存储。
+ * @param utf8 要转换的 UTF-8 字符串
+ * @return 转换后的字符串
+ * @throws invalid_argument 如果输入不是合法的 UTF-8
+ */
+FBStringCore16 utf8_to_utf16(FBStringView utf8);
+FBStringCore32 utf8_to_utf32(FBStringView utf8);
+
+/**
+ * UTF-16 或 UTF-32 转换为 UTF-8
+ * @param data 要转换的字符串
+ * @param n 单元数
+ * @return 转换后的字符串
+ * @throws invalid_argument 如果输入包含不成对的代理项或不合法的码点
+ */
+FBString utf16_to_utf8(const char16_t* data, size_t n);
+FBString utf16_to_utf8(const FBStringCore16& utf16);
+FBString utf32_to_utf8(const char32_t* data, size_t n);
+FBString utf32_to_utf8(const FBStringCore32& utf32);
+
+#endif // FBSTRING_UNICODE_H
@@ -0,0 +1,171 @@
+#include "FBStringView.h"
+#include "FBStringSimd.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+// 默认构造函数
+FBStringView::FBStringView() : data_(""), size_(0) {}
+
+// 引用 C 风格字符串
+FBStringView::FBStringView(const char* str) : data_(str), size_(std::strlen(str)) {}
+
+// 引用指定长度的字符序列
+FBStringView::FBStringView(const char* data, size_type size) : data_(data), size_(size) {}
+
+// 返回数据指针
+const char* FBStringView::data() const {
+    return data_;
+}
+
+// 返回视图长度
+FBStringView::size_type FBStringView::size() const {
+    return size_;
+}
+
+// 判断视图是否为空
+bool FBStringView::empty() const {
+    return size_ == 0;
+}
+
+// 迭代器
+FBStringView::const_iterator FBStringView::begin() const {
+    return data_;
+}
+
+FBStringView::const_iterator FBStringView::end() const {
+    return data_ + size_;
+}
+
+// 访问指定位置的字符（不检查边界）
+FBStringView::const_reference FBStringView::operator[](size_type n) const {
+    return data_[n];
+}
+
+// 访问指定位置的字符
+FBStringView::const_reference FBStringView::at(size_type n) const {
+    if (n >= size_) throw std::out_of_range("Index out of range");
+    return data_[n];
+}
+
+// 取子视图
+FBStringView FBStringView::substr(size_type pos, size_type n) const {
+    if (pos > size_) throw std::out_of_range("Index out of range");
+    return FBStringView(data_ + pos, std::min(n, size_ - pos));
+}
+
+// 去掉开头的 n 个字符
+void FBStringView::remove_prefix(size_type n) {
+    data_ += n;
+    size_ -= n;
+}
+
+// 去掉末尾的 n 个字符
+void FBStringView::remove_suffix(size_type n) {
+    size_ -= n;
+}
+
+// 查找字符
+FBStringView::size_type FBStringView::find(char c, size_type pos) const {
+    if (pos >= size_) return npos;
+    const void* found = std::memchr(data_ + pos, c, size_ - pos);
+    return found ? static_cast<const char*>(found) - data_ : npos;
+}
+
+// 查找子串：先用 memchr 定位首字符，再比较剩余部分
+FBStringView::size_type FBStringView::find(FBStringView str, size_type pos) const {
+    if (pos > size_ || str.size_ > size_ - pos) return npos;
+    if (str.size_ == 0) return pos;
+    const char* p = data_ + pos;
+    const char* last = data_ + size_ - str.size_ + 1; // 子串可能开始的最后位置之后
+    while (p < last) {
+        p = static_cast<const char*>(std::memchr(p, str.data_[0], last - p));
+        if (!p) return npos;
+        if (std::memcmp(p + 1, str.data_ + 1, str.size_ - 1) == 0) return p - data_;
+        ++p;
+    }
+    return npos;
+}
+
+// 判断是否以指定前缀开始
+bool FBStringView::starts_with(FBStringView str) const {
+    return size_ >= str.size_ && std::memcmp(data_, str.data_, str.size_) == 0;
+}
+
+// 判断是否以指定后缀结束
+bool FBStringView::ends_with(FBStringView str) const {
+    return size_ >= str.size_ && std::memcmp(data_ + size_ - str.size_, str.data_, str.size_) == 0;
+}
+
+// 去掉两端的字符
+FBStringView FBStringView::trim() const {
+    return trim(FBStringSimd::whitespace());
+}
+
+FBStringView FBStringView::trim(const FBByteSet& chars) const {
+    const char* first = FBStringSimd::skipLeading(begin(), end(), chars);
+    const char* last = FBStringSimd::skipTrailing(first, end(), chars);
+    return FBStringView(first, last - first);
+}
+
+// 去掉开头的字符
+FBStringView FBStringView::ltrim() const {
+    return ltrim(FBStringSimd::whitespace());
+}
+
+FBStringView FBStringView::ltrim(const FBByteSet& chars) const {
+    const char* first = FBStringSimd::skipLeading(begin(), end(), chars);
+    return FBStringView(first, end() - first);
+}
+
+// 去掉末尾的字符
+FBStringView FBStringView::rtrim() const {
+    return rtrim(FBStringSimd::whitespace());
+}
+
+FBStringView FBStringView::rtrim(const FBByteSet& chars) const {
+    return FBStringView(data_, FBStringSimd::skipTrailing(begin(), end(), chars) - data_);
+}
+
+// 按无符号字节的字典序比较
+int FBStringView::compare(FBStringView other) const {
+    int result = std::memcmp(data_, other.data_, std::min(size_, other.size_));
+    if (result != 0) return result;
+    return size_ < other.size_ ? -1 : (size_ > other.size_ ? 1 : 0);
+}
+
+// 转换为 std::string
+std::string FBStringView::to_string() const {
+    return std::string(data_, size_);
+}
+
+// 比较运算符
+bool operator==(FBStringView lhs, FBStringView rhs) {
+    if (lhs.size() != rhs.size()) return false;
+    return lhs.data() == rhs.data() || FBStringSimd::equal(lhs.data(), rhs.data(), lhs.size());
+}
+
+bool operator!=(FBStringView lhs, FBStringView rhs) {
+    return !(lhs == rhs);
+}
+
+bool operator<(FBStringView lhs, FBStringView rhs) {
+    return lhs.compare(rhs) < 0;
+}
+
+bool operator<=(FBStringView lhs, FBStringView rhs) {
+    return lhs.compare(rhs) <= 0;
+}
+
+bool operator>(FBStringView lhs, FBStringView rhs) {
+    return lhs.compare(rhs) > 0;
+}
+
+bool operator>=(FBStringView lhs, FBStringView rhs) {
+    return lhs.compare(rhs) >= 0;
+}
+
+// 输出运算符重载
+std::ostream& operator<<(std::ostream& os, FBStringView str) {
+    return os.write(str.data(), static_cast<std::streamsize>(str.size()));
+}
@@ -0,0 +1,189 @@
+#ifndef FBSTRING_VIEW_H
+#define FBSTRING_VIEW_H
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <functional>
+#include "FBStringHash.h"
+
+class FBByteSet;
+
+// FBStringView 是对一段连续字符的只读引用，不拥有也不复制数据
+// 它是最底层的字符串类型，不依赖 FBString；被引用的存储必须比视图活得更久，且不保证以 null 结尾。
+class FBStringView {
+public:
+    // 类型定义
+    typedef char value_type;
+    typedef const char &const_reference;
+    typedef const char *const_iterator;
+    typedef const char *iterator;
+    typedef size_t size_type;
+    static const size_type npos = static_cast<size_type>(-1);
+
+    /**
+     * 默认构造函数
+     * 构造一个空视图。
+     */
+    FBStringView();
+
+    /**
+     * 引用 C 风格字符串
+     * @param str 以 null 结尾的字符串
+     */
+    FBStringView(const char* str);
+
+    /**
+     * 引用指定长度的字符序列
+     * @param data 字符序列起始位置
+     * @param size 字符个数
+     */
+    FBStringView(const char* data, size_type size);
+
+    /**
+     * 引用 std::string 的内容
+     * 写成模板是为了不参与隐式转换：FBString 同时可以转换为 std::string 和 FBStringView，
+     * 非模板构造函数会让 FBStringView(fbstr) 产生二义性。
+     * @param str std::string 对象
+     */
+    template <typename Allocator>
+    FBStringView(const std::basic_string<char, std::char_traits<char>, Allocator>& str)
+        : data_(str.data()), size_(str.size()) {}
+
+    /**
+     * 返回数据指针
+     * @return 指向第一个字符的指针
+     */
+    const char* data() const;
+
+    /**
+     * 返回视图长度
+     * @return 字符个数
+     */
+    size_type size() const;
+
+    /**
+     * 判断视图是否为空
+     * @return 为空返回 true
+     */
+    bool empty() const;
+
+    /**
+     * 迭代器
+     * @return 起始或结束位置
+     */
+    const_iterator begin() const;
+    const_iterator end() const;
+
+    /**
+     * 访问指定位置的字符（不检查边界）
+     * @param n 位置
+     * @return 字符的引用
+     */
+    const_reference operator[](size_type n) const;
+
+    /**
+     * 访问指定位置的字符
+     * @param n 位置
+     * @return 字符的引用
+     * @throws out_of_range 如果 n 超出范围
+     */
+    const_reference at(size_type n) const;
+
+    /**
+     * 取子视图
+     * @param pos 起始位置
+     * @param n 最大长度，超出部分截断
+     * @return 子视图
+     * @throws out_of_range 如果 pos 大于视图长度
+     */
+    FBStringView substr(size_type pos, size_type n = npos) const;
+
+    /**
+     * 去掉开头或末尾的 n 个字符
+     * @param n 字符个数，不能超过视图长度
+     */
+    void remove_prefix(size_type n);
+    void remove_suffix(size_type n);
+
+    /**
+     * 查找字符或子串
+     * @param c 要查找的字符
+     * @param str 要查找的子串
+     * @param pos 开始查找的位置
+     * @return 第一次出现的位置，未找到返回 npos
+     */
+    size_type find(char c, size_type pos = 0) const;
+    size_type find(FBStringView str, size_type pos = 0) const;
+
+    /**
+     * 判断是否以指定前缀或后缀开始、结束
+     * @param str 前缀或后缀
+     * @return 匹配返回 true
+     */
+    bool starts_with(FBStringView str) const;
+    bool ends_with(FBStringView str) const;
+
+    /**
+     * 去掉两端、开头或末尾的字符，返回剩余部分的视图
+     * 用 SIMD 一次判断 16 或 32 个字节是否属于要去掉的集合。
+     * @param chars 要去掉的字节集合，省略时为 ASCII 空白字符
+     * @return 剩余部分的视图
+     */
+    FBStringView trim() const;
+    FBStringView trim(const FBByteSet& chars) const;
+    FBStringView ltrim() const;
+    FBStringView ltrim(const FBByteSet& chars) const;
+    FBStringView rtrim() const;
+    FBStringView rtrim(const FBByteSet& chars) const;
+
+    /**
+     * 按无符号字节的字典序比较
+     * @param other 要比较的视图
+     * @return 小于返回负数，相等返回 0，大于返回正数
+     */
+    int compare(FBStringView other) const;
+
+    /**
+     * 转换为 std::string
+     * @return 内容的拷贝
+     */
+    std::string to_string() const;
+
+private:
+    const char* data_; /**< 数据指针 */
+    size_type size_;   /**< 字符个数 */
+};
+
+/**
+ * 比较运算符
+ * @param lhs 左操作数
+ * @param rhs 右操作数
+ * @return 比较结果
+ */
+bool operator==(FBStringView lhs, FBStringView rhs);
+bool operator!=(FBStringView lhs, FBStringView rhs);
+bool operator<(FBStringView lhs, FBStringView rhs);
+bool operator<=(FBStringView lhs, FBStringView rhs);
+bool operator>(FBStringView lhs, FBStringView rhs);
+bool operator>=(FBStringView lhs, FBStringView rhs);
+
+/**
+ * 输出运算符重载
+ * @param os 输出流对象
+ * @param str 视图
+ * @return 输出流对象
+ */
+std::ostream& operator<<(std::ostream& os, FBStringView str);
+
+namespace std {
+// 与 FBString::hash() 结果一致，可用于以视图查找 FBString 键
+template <>
+struct hash<FBStringView> {
+    size_t operator()(FBStringView str) const {
+        return static_cast<size_t>(FBStringHash::hash(str.data(), str.size()));
+    }
+};
+} // namespace std
+
+#endif // FBSTRING_VIEW_H
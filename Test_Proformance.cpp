@@ -1,4 +1,14 @@
 #include "FBString.h"
+#include "FBStringConv.h"
+#include "FBStringUnicode.h"
+#include "FBStringCodec.h"
+#include "FBStringEscape.h"
+#include "FBStringIntern.h"
+#include "FBStringMap.h"
+#include "FBStringGerman.h"
+#include "FBStringRadixTree.h"
+#include "FBStringSort.h"
+#include "FBStringTable.h"
 #include <iostream>
 #include <string>
 #include <vector>
@@ -6,19 +16,52 @@
 #include <random>
 #include <fstream>
 #include <unordered_set>
+#include <unordered_map>
+#include <map>
+#include <thread>
+#include <functional>
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <codecvt>
+#include <locale>
+#if __cplusplus >= 201703L && defined(__has_include)
+#if __has_include(<charconv>)
+#include <charconv>
+#endif
+#endif
 
 // 生成 Python 脚本
-void generatePythonScript(const std::vector<double>& stdData, const std::vector<double>& fbData, const std::string& operation, const std::string& ylabel, size_t numIterations) {
+// categories 为横轴上各数据点的名称，默认是小型、中型、大型三种字符串
+void generatePythonScript(const std::vector<double>& stdData, const std::vector<double>& fbData, const std::string& operation, const std::string& ylabel, size_t numIterations,
+                          const std::string& stdLabel = "std::string", const std::string& fbLabel = "FBString",
+                          const std::vector<std::string>& categories = std::vector<std::string>{"small", "medium", "large"},
+                          const std::string& xlabel = "String Size") {
     std::string filename = "plot_" + operation + ".py";
     std::ofstream script(filename);
 
     script << "import matplotlib.pyplot as plt\n";
-    script << "x = ['small', 'medium', 'large']\n";
-    script << "std_data = [" << stdData[0] << ", " << stdData[1] << ", " << stdData[2] << "]\n";
-    script << "fb_data = [" << fbData[0] << ", " << fbData[1] << ", " << fbData[2] << "]\n";
-    script << "plt.plot(x, std_data, 'r-', label='std::string')\n";
-    script << "plt.plot(x, fb_data, 'b-', label='FBString')\n";
-    script << "plt.xlabel('String Size')\n";
+    script << "x = [";
+    for (size_t i = 0; i < categories.size(); ++i) {
+        script << (i == 0 ? "" : ", ") << "'" << categories[i] << "'";
+    }
+    script << "]\n";
+    script << "std_data = [";
+    for (size_t i = 0; i < stdData.size(); ++i) {
+        script << (i == 0 ? "" : ", ") << stdData[i];
+    }
+    script << "]\n";
+    script << "fb_data = [";
+    for (size_t i = 0; i < fbData.size(); ++i) {
+        script << (i == 0 ? "" : ", ") << fbData[i];
+    }
+    script << "]\n";
+    script << "plt.plot(x, std_data, 'r-', label='" << stdLabel << "')\n";
+    script << "plt.plot(x, fb_data, 'b-', label='" << fbLabel << "')\n";
+    script << "plt.xlabel('" << xlabel << "')\n";
     script << "plt.ylabel('" << ylabel << "')\n";
     script << "plt.title('Performance Comparison: " << operation << " (Iterations: " << numIterations << ")')\n"; // 添加 numIterations
     script << "plt.legend()\n";
@@ -161,3 +204,2053 @@ void testStringPerformance() {
     std::vector<double> fbMemoryUsagesDouble(fbMemoryUsages.begin(), fbMemoryUsages.end());
     generatePythonScript(stdMemoryUsagesDouble, fbMemoryUsagesDouble, "memory", "Memory Usage (bytes)", numIterations);
 }
+
+// 统计拷贝与移动次数的 FBString 包装
+struct CountingFBString {
+    static size_t copies;
+    static size_t moves;
+    FBString str;
+
+    explicit CountingFBString(const char* s) : str(s) {}
+    CountingFBString(const CountingFBString& other) : str(other.str) { ++copies; }
+    CountingFBString(CountingFBString&& other) noexcept : str(std::move(other.str)) { ++moves; }
+};
+size_t CountingFBString::copies = 0;
+size_t CountingFBString::moves = 0;
+
+// 只能拷贝的 FBString 包装，模拟 FBString 没有移动操作时的行为
+struct CopyOnlyFBString {
+    static size_t copies;
+    FBString str;
+
+    explicit CopyOnlyFBString(const char* s) : str(s) {}
+    CopyOnlyFBString(const CopyOnlyFBString& other) : str(other.str) { ++copies; }
+};
+size_t CopyOnlyFBString::copies = 0;
+
+// 测试 vector 扩容时的拷贝/移动开销
+void testMoveSemanticsPerformance() {
+    const size_t numIterations = 100000;
+    const size_t stringLengths[] = {10, 100, 1000};
+    const char* testTypes[] = {"small", "medium", "large"};
+
+    std::vector<double> copyTimes, moveTimes;
+
+    for (size_t t = 0; t < 3; ++t) {
+        std::string source(stringLengths[t], 'x');
+        std::cout << "Testing vector growth with " << testTypes[t] << " strings of length " << stringLengths[t] << std::endl;
+
+        // 只能拷贝：扩容时每个元素都走 copyFrom()
+        CopyOnlyFBString::copies = 0;
+        auto start = std::chrono::high_resolution_clock::now();
+        {
+            std::vector<CopyOnlyFBString> strings;
+            for (size_t i = 0; i < numIterations; ++i) {
+                strings.emplace_back(source.c_str());
+            }
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> copyDuration = end - start;
+        copyTimes.push_back(copyDuration.count());
+        std::cout << "vector growth (copy only): " << copyDuration.count() << " seconds, "
+                  << CopyOnlyFBString::copies << " copies" << std::endl;
+
+        // 可移动：扩容时直接接管存储
+        CountingFBString::copies = 0;
+        CountingFBString::moves = 0;
+        start = std::chrono::high_resolution_clock::now();
+        {
+            std::vector<CountingFBString> strings;
+            for (size_t i = 0; i < numIterations; ++i) {
+                strings.emplace_back(source.c_str());
+            }
+        }
+        end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> moveDuration = end - start;
+        moveTimes.push_back(moveDuration.count());
+        std::cout << "vector growth (move): " << moveDuration.count() << " seconds, "
+                  << CountingFBString::copies << " copies, " << CountingFBString::moves << " moves" << std::endl;
+    }
+
+    generatePythonScript(copyTimes, moveTimes, "vector_growth", "Time (seconds)", numIterations, "copy only", "move");
+}
+
+// 测试格式化日志和指标行的性能
+void testFormatPerformance() {
+    const size_t numIterations = 1000000;
+    const char* testTypes[] = {"metric", "log", "self-referencing"};
+    const char* levels[] = {"DEBUG", "INFO", "WARN", "ERROR"};
+    const std::string paths[] = {"/api/users", "/api/orders/recent", "/static/app.js", "/health"};
+
+    std::random_device rd;
+    std::mt19937_64 generator(rd());
+    std::vector<long long> ids(numIterations);
+    std::vector<double> latencies(numIterations);
+    std::uniform_real_distribution<double> latency(0.1, 2000.0);
+    for (size_t i = 0; i < numIterations; ++i) {
+        ids[i] = static_cast<long long>(generator() % 100000000);
+        latencies[i] = latency(generator);
+    }
+
+    std::vector<double> stdTimes, fbTimes;
+
+    for (size_t t = 0; t < 3; ++t) {
+        std::cout << "Testing format of " << testTypes[t] << " lines" << std::endl;
+
+        // snprintf 写入栈上缓冲区，再由 FBString(const char*) 计算长度并复制
+        size_t totalSize = 0;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < numIterations; ++i) {
+            char buffer[256];
+            if (t == 0) {
+                std::snprintf(buffer, sizeof(buffer), "requests.latency %.2f %lld", latencies[i], ids[i]);
+                FBString str(buffer);
+                totalSize += str.size();
+            } else if (t == 1) {
+                std::snprintf(buffer, sizeof(buffer), "[%s] GET %s user=%lld latency=%.3fms status=%d",
+                              levels[i & 3], paths[(i >> 2) & 3].c_str(), ids[i], latencies[i], 200 + static_cast<int>(i % 5));
+                FBString str(buffer);
+                totalSize += str.size();
+            } else {
+                // 在已有的行后追加其自身的前缀
+                FBString str(paths[i & 3].c_str());
+                std::snprintf(buffer, sizeof(buffer), " parent=%s id=%lld", str.c_str(), ids[i]);
+                str += buffer;
+                totalSize += str.size();
+            }
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> stdDuration = end - start;
+        stdTimes.push_back(stdDuration.count());
+        std::cout << "snprintf + FBString(const char*) time: " << stdDuration.count() << " seconds, " << totalSize << " bytes" << std::endl;
+
+        // FBString::format 估算长度后直接写入存储
+        totalSize = 0;
+        start = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < numIterations; ++i) {
+            if (t == 0) {
+                FBString str = FBString::format("requests.latency {:.2f} {}", latencies[i], ids[i]);
+                totalSize += str.size();
+            } else if (t == 1) {
+                FBString str = FBString::format("[{}] GET {} user={} latency={:.3f}ms status={}",
+                                                levels[i & 3], paths[(i >> 2) & 3], ids[i], latencies[i], 200 + static_cast<int>(i % 5));
+                totalSize += str.size();
+            } else {
+                // 参数引用字符串自身，走先写入新缓冲区再交换的路径
+                FBString str(paths[i & 3].c_str());
+                str.append_format(" parent={} id={}", str, ids[i]);
+                totalSize += str.size();
+            }
+        }
+        end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> fbDuration = end - start;
+        fbTimes.push_back(fbDuration.count());
+        std::cout << "FBString::format time: " << fbDuration.count() << " seconds, " << totalSize << " bytes" << std::endl;
+    }
+
+    // 不合法的占位符必须抛出 invalid_argument，包括会溢出的参数索引、宽度和精度
+    const char* invalidFormats[] = {"{1}", "{18446744073709551616}", "{:99999999999}", "{:.99999999999f}", "{:.2147483648}"};
+    size_t rejected = 0;
+    for (size_t i = 0; i < sizeof(invalidFormats) / sizeof(invalidFormats[0]); ++i) {
+        try {
+            FBString::format(invalidFormats[i], 1.5);
+        } catch (const std::invalid_argument&) {
+            ++rejected;
+        }
+    }
+    std::cout << "Invalid placeholders rejected: " << rejected << " of " << sizeof(invalidFormats) / sizeof(invalidFormats[0])
+              << (rejected == sizeof(invalidFormats) / sizeof(invalidFormats[0]) ? "" : " (NOT ALL)") << std::endl;
+
+    generatePythonScript(stdTimes, fbTimes, "format", "Time (seconds)", numIterations, "snprintf + copy", "FBString::format",
+                         std::vector<std::string>{"metric", "log line", "self reference"}, "Line Type");
+}
+
+// 测试整数转换为字符串的性能
+void testIntegerConversionPerformance() {
+    const size_t numIterations = 1000000;
+    const int bitWidths[] = {8, 32, 64};
+    const char* testTypes[] = {"int8", "int32", "int64"};
+
+    std::random_device rd;
+    std::mt19937_64 generator(rd());
+
+    std::vector<double> stdTimes, fbTimes;
+
+    for (size_t t = 0; t < 3; ++t) {
+        std::vector<long long> values;
+        values.reserve(numIterations);
+        for (size_t i = 0; i < numIterations; ++i) {
+            long long value = static_cast<long long>(generator() >> (64 - bitWidths[t]));
+            values.push_back(i % 2 ? value : -value);
+        }
+        std::cout << "Testing integer conversion of " << testTypes[t] << " values" << std::endl;
+
+        // std::to_string 后再拷贝进 FBString
+        size_t totalSize = 0;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < numIterations; ++i) {
+            FBString str(std::to_string(values[i]));
+            totalSize += str.size();
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> stdDuration = end - start;
+        stdTimes.push_back(stdDuration.count());
+        std::cout << "std::to_string + copy time: " << stdDuration.count() << " seconds" << std::endl;
+
+        // snprintf 到栈上缓冲区后再构造 FBString
+        start = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < numIterations; ++i) {
+            char buffer[32];
+            std::snprintf(buffer, sizeof(buffer), "%lld", values[i]);
+            FBString str(buffer);
+            totalSize += str.size();
+        }
+        end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> snprintfDuration = end - start;
+        std::cout << "snprintf + copy time: " << snprintfDuration.count() << " seconds" << std::endl;
+
+        // to_fbstring 直接写入小型存储
+        start = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < numIterations; ++i) {
+            FBString str = to_fbstring(values[i]);
+            totalSize += str.size();
+        }
+        end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> fbDuration = end - start;
+        fbTimes.push_back(fbDuration.count());
+        std::cout << "to_fbstring time: " << fbDuration.count() << " seconds (checksum " << totalSize << ")" << std::endl;
+    }
+
+    generatePythonScript(stdTimes, fbTimes, "int_conversion", "Time (seconds)", numIterations, "std::to_string", "to_fbstring");
+}
+
+// 测试浮点数转换为字符串的性能
+void testFloatConversionPerformance() {
+    const size_t numIterations = 1000000;
+    const char* testTypes[] = {"two decimals", "uniform [0, 1)", "random bits"};
+
+    std::random_device rd;
+    std::mt19937_64 generator(rd());
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+    std::vector<double> stdTimes, fbTimes;
+
+    for (size_t t = 0; t < 3; ++t) {
+        std::vector<double> values;
+        values.reserve(numIterations);
+        while (values.size() < numIterations) {
+            double value;
+            if (t == 0) {
+                value = static_cast<double>(generator() % 10000000) / 100.0;
+            } else if (t == 1) {
+                value = uniform(generator);
+            } else {
+                unsigned long long bits = generator();
+                std::memcpy(&value, &bits, sizeof(value));
+                if (!std::isfinite(value)) continue;
+            }
+            values.push_back(value);
+        }
+        std::cout << "Testing float conversion of " << testTypes[t] << " values" << std::endl;
+
+        // snprintf("%.17g") 后再构造 FBString：可往返但不是最短
+        size_t totalSize = 0;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < numIterations; ++i) {
+            char buffer[32];
+            std::snprintf(buffer, sizeof(buffer), "%.17g", values[i]);
+            FBString str(buffer);
+            totalSize += str.size();
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> snprintfDuration = end - start;
+        stdTimes.push_back(snprintfDuration.count());
+        std::cout << "snprintf(%.17g) + copy time: " << snprintfDuration.count() << " seconds, " << totalSize << " bytes" << std::endl;
+
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+        // std::to_chars 最短表示后再构造 FBString
+        totalSize = 0;
+        start = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < numIterations; ++i) {
+            char buffer[32];
+            std::to_chars_result result = std::to_chars(buffer, buffer + sizeof(buffer), values[i]);
+            *result.ptr = '\0';
+            FBString str(buffer);
+            totalSize += str.size();
+        }
+        end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> toCharsDuration = end - start;
+        std::cout << "std::to_chars + copy time: " << toCharsDuration.count() << " seconds, " << totalSize << " bytes" << std::endl;
+#endif
+
+        // to_fbstring 直接写入存储
+        totalSize = 0;
+        start = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < numIterations; ++i) {
+            FBString str = to_fbstring(values[i]);
+            totalSize += str.size();
+        }
+        end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> fbDuration = end - start;
+        fbTimes.push_back(fbDuration.count());
+        std::cout << "to_fbstring time: " << fbDuration.count() << " seconds, " << totalSize << " bytes" << std::endl;
+    }
+
+    generatePythonScript(stdTimes, fbTimes, "float_conversion", "Time (seconds)", numIterations, "snprintf(%.17g)", "to_fbstring");
+}
+
+// 测试从 CSV 数值列中解析数字的性能
+void testNumericParsingPerformance() {
+    const size_t numRows = 1000000;
+    const char* testTypes[] = {"int32 column", "16-digit id column", "decimal column"};
+
+    std::random_device rd;
+    std::mt19937_64 generator(rd());
+
+    std::vector<double> stdTimes, fbTimes;
+    const size_t numSampleRows = 1000;
+    std::vector<FBString> samples[3]; // 每列的前若干行，最后拼成 CSV 文本做逐行扫描测试
+
+    for (size_t t = 0; t < 3; ++t) {
+        std::vector<FBString> column;
+        column.reserve(numRows);
+        for (size_t i = 0; i < numRows; ++i) {
+            if (t == 0) {
+                column.push_back(to_fbstring(static_cast<int>(generator() % 2000000000) - 1000000000));
+            } else if (t == 1) {
+                column.push_back(to_fbstring(1000000000000000ULL + generator() % 9000000000000000ULL));
+            } else {
+                column.push_back(FBString::format("{}.{:02}", generator() % 100000, generator() % 100));
+            }
+        }
+        std::cout << "Testing numeric parsing of " << testTypes[t] << std::endl;
+
+        // c_str() 后调用 strtoll/strtod
+        double stdSum = 0;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < numRows; ++i) {
+            char* end;
+            stdSum += t == 2 ? std::strtod(column[i].c_str(), &end) : static_cast<double>(std::strtoll(column[i].c_str(), &end, 10));
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> stdDuration = end - start;
+        stdTimes.push_back(stdDuration.count());
+        std::cout << "strtoll/strtod time: " << stdDuration.count() << " seconds, sum " << stdSum << std::endl;
+
+        // 直接在 FBString 上调用 parse
+        double fbSum = 0;
+        start = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < numRows; ++i) {
+            if (t == 2) {
+                double value = 0;
+                parse(column[i], value);
+                fbSum += value;
+            } else {
+                long long value = 0;
+                parse(column[i], value);
+                fbSum += static_cast<double>(value);
+            }
+        }
+        end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> fbDuration = end - start;
+        fbTimes.push_back(fbDuration.count());
+        std::cout << "parse time: " << fbDuration.count() << " seconds, sum " << fbSum << std::endl;
+
+        samples[t].assign(column.begin(), column.begin() + numSampleRows);
+    }
+
+    FBString csv;
+    for (size_t i = 0; i < numSampleRows; ++i) {
+        csv.append_format("{},{},{}\n", samples[0][i], samples[1][i], samples[2][i]);
+    }
+
+    // 逐行扫描 CSV：parse 返回的 ptr 直接指向分隔符，不需要切分出字段
+    const size_t numScans = 1000;
+    double stdSum = 0, fbSum = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (size_t n = 0; n < numScans; ++n) {
+        const char* p = csv.c_str();
+        const char* last = p + csv.size();
+        while (p < last) {
+            char* end;
+            stdSum += static_cast<double>(std::strtoll(p, &end, 10));
+            stdSum += static_cast<double>(std::strtoll(end + 1, &end, 10));
+            stdSum += std::strtod(end + 1, &end);
+            p = end + 1;
+        }
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> stdScan = end - start;
+
+    start = std::chrono::high_resolution_clock::now();
+    for (size_t n = 0; n < numScans; ++n) {
+        const char* p = csv.c_str();
+        const char* last = p + csv.size();
+        while (p < last) {
+            long long a = 0, b = 0;
+            double c = 0;
+            p = parse(p, last, a).ptr + 1;
+            p = parse(p, last, b).ptr + 1;
+            p = parse(p, last, c).ptr + 1;
+            fbSum += static_cast<double>(a) + static_cast<double>(b) + c;
+        }
+    }
+    end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> fbScan = end - start;
+    std::cout << "CSV scan (" << numScans << " x " << numSampleRows << " rows) strtoll/strtod: " << stdScan.count() << " seconds, parse: " << fbScan.count()
+              << " seconds, sums " << stdSum << " / " << fbSum << std::endl;
+
+    generatePythonScript(stdTimes, fbTimes, "numeric_parsing", "Time (seconds)", numRows, "strtoll/strtod", "parse");
+}
+
+// 测试把一行切分为字段的性能
+void testSplitPerformance() {
+    const size_t numLines = 100000;
+    const size_t fieldsPerLine = 16;
+    const size_t fieldSizes[] = {8, 64, 512};
+
+    std::random_device rd;
+    std::mt19937 generator(rd());
+    std::uniform_int_distribution<int> letter('a', 'z');
+
+    std::vector<double> stdTimes, fbTimes;
+
+    for (size_t t = 0; t < 3; ++t) {
+        std::vector<std::string> stdLines;
+        std::vector<FBString> fbLines;
+        stdLines.reserve(numLines);
+        fbLines.reserve(numLines);
+        for (size_t i = 0; i < numLines; ++i) {
+            std::string line;
+            for (size_t f = 0; f < fieldsPerLine; ++f) {
+                if (f != 0) line += ',';
+                for (size_t c = 0; c < fieldSizes[t]; ++c) line += static_cast<char>(letter(generator));
+            }
+            stdLines.push_back(line);
+            fbLines.push_back(FBString(line));
+        }
+        std::cout << "Testing split of lines with " << fieldSizes[t] << "-byte fields" << std::endl;
+
+        // std::string 的 find + substr，每个字段都会构造一个新字符串
+        size_t stdTotal = 0;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < numLines; ++i) {
+            const std::string& line = stdLines[i];
+            size_t pos = 0;
+            for (;;) {
+                size_t next = line.find(',', pos);
+                std::string field = line.substr(pos, next == std::string::npos ? std::string::npos : next - pos);
+                stdTotal += field.size();
+                if (next == std::string::npos) break;
+                pos = next + 1;
+            }
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> stdDuration = end - start;
+        stdTimes.push_back(stdDuration.count());
+        std::cout << "std::string find + substr time: " << stdDuration.count() << " seconds, " << stdTotal << " bytes" << std::endl;
+
+        // FBString::split 惰性产出视图
+        size_t fbTotal = 0;
+        start = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < numLines; ++i) {
+            for (FBStringView field : fbLines[i].split(',')) {
+                fbTotal += field.size();
+            }
+        }
+        end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> fbDuration = end - start;
+        fbTimes.push_back(fbDuration.count());
+        std::cout << "FBString::split time: " << fbDuration.count() << " seconds, " << fbTotal << " bytes" << std::endl;
+
+        // 写入预先分配的数组，完全不分配内存
+        FBStringView fields[fieldsPerLine];
+        size_t arrayTotal = 0;
+        start = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < numLines; ++i) {
+            size_t count = fbLines[i].split(',').into(fields, fieldsPerLine);
+            for (size_t f = 0; f < count; ++f) arrayTotal += fields[f].size();
+        }
+        end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> arrayDuration = end - start;
+        std::cout << "FBString::split into array time: " << arrayDuration.count() << " seconds, " << arrayTotal << " bytes" << std::endl;
+    }
+
+    generatePythonScript(stdTimes, fbTimes, "split", "Time (seconds)", numLines, "std::string find + substr", "FBString::split");
+}
+
+// 测试去掉首尾空白的性能
+void testTrimPerformance() {
+    const size_t numIterations = 100000;
+    const size_t contentSizes[] = {8, 100, 2000};
+    const size_t paddingSizes[] = {3, 20, 200};
+    const char whitespace[] = " \t\r\n";
+
+    std::random_device rd;
+    std::mt19937 generator(rd());
+    std::uniform_int_distribution<int> letter('a', 'z');
+
+    std::vector<double> stdTimes, fbTimes;
+
+    for (size_t t = 0; t < 3; ++t) {
+        std::vector<std::string> stdStrings;
+        stdStrings.reserve(numIterations);
+        for (size_t i = 0; i < numIterations; ++i) {
+            std::string str;
+            for (size_t c = 0; c < paddingSizes[t]; ++c) str += whitespace[generator() % 4];
+            for (size_t c = 0; c < contentSizes[t]; ++c) str += static_cast<char>(letter(generator));
+            for (size_t c = 0; c < paddingSizes[t]; ++c) str += whitespace[generator() % 4];
+            stdStrings.push_back(str);
+        }
+        std::vector<FBString> fbStrings(stdStrings.begin(), stdStrings.end());
+        std::cout << "Testing trim of " << contentSizes[t] << "-byte content with " << paddingSizes[t] << " bytes of padding on each side" << std::endl;
+
+        // find_first_not_of + find_last_not_of + substr
+        size_t stdTotal = 0;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < numIterations; ++i) {
+            const std::string& str = stdStrings[i];
+            size_t first = str.find_first_not_of(" \t\r\n");
+            size_t last = str.find_last_not_of(" \t\r\n");
+            std::string trimmed = first == std::string::npos ? std::string() : str.substr(first, last - first + 1);
+            stdTotal += trimmed.size();
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> stdDuration = end - start;
+        stdTimes.push_back(stdDuration.count());
+        std::cout << "std::string find_first_not_of + substr time: " << stdDuration.count() << " seconds, " << stdTotal << " bytes" << std::endl;
+
+        // 返回视图的 trim
+        size_t fbTotal = 0;
+        start = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < numIterations; ++i) {
+            fbTotal += FBStringView(fbStrings[i]).trim().size();
+        }
+        end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> fbDuration = end - start;
+        fbTimes.push_back(fbDuration.count());
+        std::cout << "FBStringView::trim time: " << fbDuration.count() << " seconds, " << fbTotal << " bytes" << std::endl;
+
+        // 独占存储的原地 trim
+        size_t inPlaceTotal = 0;
+        start = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < numIterations; ++i) {
+            inPlaceTotal += fbStrings[i].trim().size();
+        }
+        end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> inPlaceDuration = end - start;
+        std::cout << "FBString::trim (in place) time: " << inPlaceDuration.count() << " seconds, " << inPlaceTotal << " bytes" << std::endl;
+    }
+
+    generatePythonScript(stdTimes, fbTimes, "trim", "Time (seconds)", numIterations, "std::string find_first_not_of + substr", "FBStringView::trim");
+}
+
+// 测试 ASCII 大小写转换的性能
+void testCaseConversionPerformance() {
+    const size_t numIterations = 100000;
+    const size_t stringSizes[] = {16, 200, 4000}; // 分别落在小型、中型、大型存储
+
+    std::random_device rd;
+    std::mt19937 generator(rd());
+    std::uniform_int_distribution<int> letter(0, 51);
+
+    std::vector<double> stdTimes, fbTimes;
+
+    for (size_t t = 0; t < 3; ++t) {
+        std::vector<std::string> stdStrings;
+        stdStrings.reserve(numIterations);
+        for (size_t i = 0; i < numIterations; ++i) {
+            std::string str;
+            for (size_t c = 0; c < stringSizes[t]; ++c) {
+                int value = letter(generator);
+                str += static_cast<char>(value < 26 ? 'a' + value : 'A' + value - 26);
+            }
+            stdStrings.push_back(str);
+        }
+        std::vector<FBString> fbStrings(stdStrings.begin(), stdStrings.end());
+        std::cout << "Testing case conversion of " << stringSizes[t] << "-byte strings" << std::endl;
+
+        // 逐字节 std::toupper / std::tolower
+        size_t stdChecksum = 0;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < numIterations; ++i) {
+            std::string& str = stdStrings[i];
+            for (size_t c = 0; c < str.size(); ++c) str[c] = static_cast<char>(std::toupper(static_cast<unsigned char>(str[c])));
+            for (size_t c = 0; c < str.size(); ++c) str[c] = static_cast<char>(std::tolower(static_cast<unsigned char>(str[c])));
+            stdChecksum += static_cast<unsigned char>(str[0]);
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> stdDuration = end - start;
+        stdTimes.push_back(stdDuration.count());
+        std::cout << "std::toupper/tolower loop time: " << stdDuration.count() << " seconds, checksum " << stdChecksum << std::endl;
+
+        // 独占存储上的原地 SIMD 转换
+        size_t fbChecksum = 0;
+        start = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < numIterations; ++i) {
+            fbStrings[i].to_upper();
+            fbStrings[i].to_lower();
+            fbChecksum += static_cast<unsigned char>(fbStrings[i].c_str()[0]);
+        }
+        end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> fbDuration = end - start;
+        fbTimes.push_back(fbDuration.count());
+        std::cout << "FBString::to_upper/to_lower time: " << fbDuration.count() << " seconds, checksum " << fbChecksum << std::endl;
+
+        // 生成副本的转换（原字符串保持不变）
+        size_t copyChecksum = 0;
+        start = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < numIterations; ++i) {
+            FBString upper = fbStrings[i].to_upper_copy();
+            copyChecksum += static_cast<unsigned char>(upper.c_str()[0]);
+        }
+        end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> copyDuration = end - start;
+        std::cout << "FBString::to_upper_copy time: " << copyDuration.count() << " seconds, checksum " << copyChecksum << std::endl;
+    }
+
+    generatePythonScript(stdTimes, fbTimes, "case_conversion", "Time (seconds)", numIterations, "std::toupper/tolower loop", "FBString::to_upper/to_lower");
+}
+
+// 逐字节校验 UTF-8 的常规写法，作为对照
+static bool validateUtf8Bytewise(const std::string& str) {
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(str.data());
+    const unsigned char* end = p + str.size();
+    while (p < end) {
+        const unsigned char c = *p;
+        ptrdiff_t length;
+        unsigned char low = 0x80, high = 0xBF;
+        if (c < 0x80) length = 1;
+        else if (c >= 0xC2 && c <= 0xDF) length = 2;
+        else if (c >= 0xE0 && c <= 0xEF) { length = 3; if (c == 0xE0) low = 0xA0; else if (c == 0xED) high = 0x9F; }
+        else if (c >= 0xF0 && c <= 0xF4) { length = 4; if (c == 0xF0) low = 0x90; else if (c == 0xF4) high = 0x8F; }
+        else return false;
+        if (end - p < length) return false;
+        if (length > 1 && (p[1] < low || p[1] > high)) return false;
+        for (ptrdiff_t i = 2; i < length; ++i) {
+            if ((p[i] & 0xC0) != 0x80) return false;
+        }
+        p += length;
+    }
+    return true;
+}
+
+void testUtf8ValidationPerformance() {
+    const size_t numIterations = 100000;
+    const size_t stringSizes[] = {16, 200, 4000}; // 分别落在小型、中型、大型存储
+
+    std::random_device rd;
+    std::mt19937 generator(rd());
+    std::uniform_int_distribution<int> percent(0, 99);
+    std::uniform_int_distribution<int> letter('a', 'z');
+    std::uniform_int_distribution<unsigned> cjk(0x4E00, 0x9FFF);
+
+    std::vector<double> stdTimes, fbTimes;
+
+    for (size_t t = 0; t < 3; ++t) {
+        // 约 80% 的 ASCII 字母夹杂 3 字节的汉字
+        std::vector<std::string> stdStrings;
+        stdStrings.reserve(numIterations);
+        for (size_t i = 0; i < numIterations; ++i) {
+            std::string str;
+            while (str.size() + 3 <= stringSizes[t]) {
+                if (percent(generator) < 80) {
+                    str += static_cast<char>(letter(generator));
+                } else {
+                    const unsigned cp = cjk(generator);
+                    str += static_cast<char>(0xE0 | (cp >> 12));
+                    str += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+                    str += static_cast<char>(0x80 | (cp & 0x3F));
+                }
+            }
+            stdStrings.push_back(str);
+        }
+        std::vector<FBString> fbStrings(stdStrings.begin(), stdStrings.end());
+        std::cout << "Testing UTF-8 validation of " << stringSizes[t] << "-byte strings" << std::endl;
+
+        // 逐字节校验
+        size_t stdValid = 0;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < numIterations; ++i) {
+            stdValid += validateUtf8Bytewise(stdStrings[i]);
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> stdDuration = end - start;
+        stdTimes.push_back(stdDuration.count());
+        std::cout << "Bytewise validation time: " << stdDuration.count() << " seconds, valid " << stdValid << std::endl;
+
+        // SIMD 校验：首次调用需要扫描
+        size_t fbValid = 0;
+        start = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < numIterations; ++i) {
+            fbValid += fbStrings[i].validate_utf8();
+        }
+        end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> fbDuration = end - start;
+        fbTimes.push_back(fbDuration.count());
+        std::cout << "FBString::validate_utf8 time: " << fbDuration.count() << " seconds, valid " << fbValid << std::endl;
+
+        // 再次校验：大型存储直接读取缓存的结果
+        size_t cachedValid = 0;
+        start = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < numIterations; ++i) {
+            cachedValid += fbStrings[i].validate_utf8();
+        }
+        end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> cachedDuration = end - start;
+        std::cout << "FBString::validate_utf8 (repeated) time: " << cachedDuration.count() << " seconds, valid " << cachedValid << std::endl;
+
+        // 统计码点
+        size_t codePoints = 0;
+        start = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < numIterations; ++i) {
+            codePoints += fbStrings[i].count_code_points();
+        }
+        end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> countDuration = end - start;
+        std::cout << "FBString::count_code_points time: " << countDuration.count() << " seconds, code points " << codePoints << std::endl;
+    }
+
+    generatePythonScript(stdTimes, fbTimes, "utf8_validation", "Time (seconds)", numIterations, "Bytewise validation", "FBString::validate_utf8");
+}
+
+void testUtf16TranscodingPerformance() {
+    const size_t numIterations = 100000;
+    const size_t stringSizes[] = {16, 200, 4000}; // UTF-8 字节数：分别落在小型、中型、大型存储
+
+    std::random_device rd;
+    std::mt19937 generator(rd());
+    std::uniform_int_distribution<int> percent(0, 99);
+    std::uniform_int_distribution<int> letter('a', 'z');
+    std::uniform_int_distribution<unsigned> cjk(0x4E00, 0x9FFF);
+
+    std::vector<double> stdTimes, fbTimes;
+
+    for (size_t t = 0; t < 3; ++t) {
+        // 约 80% 的 ASCII 字母夹杂 3 字节的汉字
+        std::vector<std::string> stdStrings;
+        stdStrings.reserve(numIterations);
+        for (size_t i = 0; i < numIterations; ++i) {
+            std::string str;
+            while (str.size() + 3 <= stringSizes[t]) {
+                if (percent(generator) < 80) {
+                    str += static_cast<char>(letter(generator));
+                } else {
+                    const unsigned cp = cjk(generator);
+                    str += static_cast<char>(0xE0 | (cp >> 12));
+                    str += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+                    str += static_cast<char>(0x80 | (cp & 0x3F));
+                }
+            }
+            stdStrings.push_back(str);
+        }
+        std::vector<FBString> fbStrings(stdStrings.begin(), stdStrings.end());
+        std::cout << "Testing UTF-8 <-> UTF-16 transcoding of " << stringSizes[t] << "-byte strings" << std::endl;
+
+        // std::wstring_convert + codecvt_utf8_utf16
+        std::wstring_convert<std::codecvt_utf8_utf16<char16_t>, char16_t> converter;
+        std::vector<std::u16string> stdWide;
+        stdWide.reserve(numIterations);
+        auto start = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < numIterations; ++i) {
+            stdWide.push_back(converter.from_bytes(stdStrings[i]));
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> stdDuration = end - start;
+        stdTimes.push_back(stdDuration.count());
+        std::cout << "std::wstring_convert::from_bytes time: " << stdDuration.count() << " seconds" << std::endl;
+
+        // SIMD 校验并直接写入目标存储
+        std::vector<FBStringCore16> fbWide;
+        fbWide.reserve(numIterations);
+        start = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < numIterations; ++i) {
+            fbWide.push_back(utf8_to_utf16(fbStrings[i]));
+        }
+        end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> fbDuration = end - start;
+        fbTimes.push_back(fbDuration.count());
+        std::cout << "utf8_to_utf16 time: " << fbDuration.count() << " seconds" << std::endl;
+
+        // 反方向转换
+        size_t stdBytes = 0;
+        start = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < numIterations; ++i) {
+            stdBytes += converter.to_bytes(stdWide[i]).size();
+        }
+        end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> stdBackDuration = end - start;
+        std::cout << "std::wstring_convert::to_bytes time: " << stdBackDuration.count() << " seconds, bytes " << stdBytes << std::endl;
+
+        size_t fbBytes = 0;
+        start = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < numIterations; ++i) {
+            fbBytes += utf16_to_utf8(fbWide[i]).size();
+        }
+        end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> fbBackDuration = end - start;
+        std::cout << "utf16_to_utf8 time: " << fbBackDuration.count() << " seconds, bytes " << fbBytes << std::endl;
+    }
+
+    generatePythonScript(stdTimes, fbTimes, "utf16_transcoding", "Time (seconds)", numIterations, "std::wstring_convert", "utf8_to_utf16");
+}
+
+// 逐字节的 base64 编码，作为对比基准
+static std::string base64EncodeScalar(const std::string& data) {
+    static const char table[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string out;
+    size_t i = 0;
+    for (; i + 3 <= data.size(); i += 3) {
+        const unsigned v = (static_cast<unsigned char>(data[i]) << 16) | (static_cast<unsigned char>(data[i + 1]) << 8) |
+                           static_cast<unsigned char>(data[i + 2]);
+        out += table[v >> 18];
+        out += table[(v >> 12) & 0x3F];
+        out += table[(v >> 6) & 0x3F];
+        out += table[v & 0x3F];
+    }
+    if (i < data.size()) {
+        const bool two = data.size() - i == 2;
+        const unsigned v = (static_cast<unsigned char>(data[i]) << 16) | (two ? static_cast<unsigned char>(data[i + 1]) << 8 : 0);
+        out += table[v >> 18];
+        out += table[(v >> 12) & 0x3F];
+        out += two ? table[(v >> 6) & 0x3F] : '=';
+        out += '=';
+    }
+    return out;
+}
+
+// 逐字节的 base64 解码，作为对比基准
+static std::string base64DecodeScalar(const std::string& text) {
+    std::string out;
+    unsigned v = 0;
+    int bits = 0;
+    for (char c : text) {
+        int d;
+        if (c >= 'A' && c <= 'Z') d = c - 'A';
+        else if (c >= 'a' && c <= 'z') d = c - 'a' + 26;
+        else if (c >= '0' && c <= '9') d = c - '0' + 52;
+        else if (c == '+') d = 62;
+        else if (c == '/') d = 63;
+        else if (c == '=') break;
+        else throw std::invalid_argument("Invalid base64");
+        v = (v << 6) | static_cast<unsigned>(d);
+        bits += 6;
+        if (bits >= 8) {
+            bits -= 8;
+            out += static_cast<char>((v >> bits) & 0xFF);
+        }
+    }
+    return out;
+}
+
+// 逐字节的十六进制编码，作为对比基准
+static std::string hexEncodeScalar(const std::string& data) {
+    static const char digits[] = "0123456789abcdef";
+    std::string out;
+    for (char c : data) {
+        out += digits[static_cast<unsigned char>(c) >> 4];
+        out += digits[static_cast<unsigned char>(c) & 0x0F];
+    }
+    return out;
+}
+
+// 吞吐量，单位 GB/s
+static double gigabytesPerSecond(size_t bytes, double seconds) {
+    return static_cast<double>(bytes) / seconds / 1e9;
+}
+
+void testBase64HexPerformance() {
+    const size_t numIterations = 100000;
+    const size_t stringSizes[] = {16, 200, 4000}; // 原始数据字节数
+
+    std::random_device rd;
+    std::mt19937 generator(rd());
+    std::uniform_int_distribution<int> byte(0, 255);
+
+    std::vector<double> stdTimes, fbTimes;
+
+    for (size_t t = 0; t < 3; ++t) {
+        std::vector<std::string> blobs;
+        blobs.reserve(numIterations);
+        for (size_t i = 0; i < numIterations; ++i) {
+            std::string blob(stringSizes[t], '\0');
+            for (size_t j = 0; j < blob.size(); ++j) {
+                blob[j] = static_cast<char>(byte(generator));
+            }
+            blobs.push_back(blob);
+        }
+        const size_t totalBytes = numIterations * stringSizes[t];
+        std::cout << "Testing base64/hex codecs on " << stringSizes[t] << "-byte blobs" << std::endl;
+
+        // 现有做法：标量编码到 std::string 再复制进 FBString
+        std::vector<FBString> stdEncoded;
+        stdEncoded.reserve(numIterations);
+        auto start = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < numIterations; ++i) {
+            const std::string encoded = base64EncodeScalar(blobs[i]);
+            stdEncoded.push_back(FBString(encoded.c_str(), encoded.size()));
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> stdDuration = end - start;
+        stdTimes.push_back(stdDuration.count());
+        std::cout << "scalar base64 encode + copy: " << stdDuration.count() << " seconds, "
+                  << gigabytesPerSecond(totalBytes, stdDuration.count()) << " GB/s" << std::endl;
+
+        // SIMD 编码直接写入 FBString 的存储
+        std::vector<FBString> fbEncoded;
+        fbEncoded.reserve(numIterations);
+        start = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < numIterations; ++i) {
+            fbEncoded.push_back(to_base64(FBStringView(blobs[i].data(), blobs[i].size())));
+        }
+        end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> fbDuration = end - start;
+        fbTimes.push_back(fbDuration.count());
+        std::cout << "to_base64: " << fbDuration.count() << " seconds, "
+                  << gigabytesPerSecond(totalBytes, fbDuration.count()) << " GB/s" << std::endl;
+
+        // 复用同一个缓冲区，去掉分配开销后的内核吞吐量
+        FBString buffer;
+        size_t reusedBytes = 0;
+        start = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < numIterations; ++i) {
+            buffer.clear();
+            append_base64(buffer, FBStringView(blobs[i].data(), blobs[i].size()));
+            reusedBytes += buffer.size();
+        }
+        end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> reusedDuration = end - start;
+        std::cout << "append_base64 into a reused buffer: " << reusedDuration.count() << " seconds, "
+                  << gigabytesPerSecond(totalBytes, reusedDuration.count()) << " GB/s, chars " << reusedBytes << std::endl;
+
+        // 解码
+        size_t stdDecoded = 0;
+        start = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < numIterations; ++i) {
+            const std::string decoded = base64DecodeScalar(std::string(stdEncoded[i].c_str(), stdEncoded[i].size()));
+            stdDecoded += FBString(decoded.c_str(), decoded.size()).size();
+        }
+        end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> stdDecodeDuration = end - start;
+        std::cout << "scalar base64 decode + copy: " << stdDecodeDuration.count() << " seconds, "
+                  << gigabytesPerSecond(stdDecoded, stdDecodeDuration.count()) << " GB/s" << std::endl;
+
+        size_t fbDecoded = 0;
+        start = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < numIterations; ++i) {
+            fbDecoded += from_base64(fbEncoded[i]).size();
+        }
+        end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> fbDecodeDuration = end - start;
+        std::cout << "from_base64: " << fbDecodeDuration.count() << " seconds, "
+                  << gigabytesPerSecond(fbDecoded, fbDecodeDuration.count()) << " GB/s" << std::endl;
+
+        // 十六进制
+        size_t stdHex = 0;
+        start = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < numIterations; ++i) {
+            const std::string encoded = hexEncodeScalar(blobs[i]);
+            stdHex += FBString(encoded.c_str(), encoded.size()).size();
+        }
+        end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> stdHexDuration = end - start;
+        std::cout << "scalar hex encode + copy: " << stdHexDuration.count() << " seconds, "
+                  << gigabytesPerSecond(totalBytes, stdHexDuration.count()) << " GB/s" << std::endl;
+
+        std::vector<FBString> fbHex;
+        fbHex.reserve(numIterations);
+        start = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < numIterations; ++i) {
+            fbHex.push_back(to_hex(FBStringView(blobs[i].data(), blobs[i].size())));
+        }
+        end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> fbHexDuration = end - start;
+        std::cout << "to_hex: " << fbHexDuration.count() << " seconds, "
+                  << gigabytesPerSecond(totalBytes, fbHexDuration.count()) << " GB/s, chars " << stdHex << std::endl;
+
+        size_t fbHexDecoded = 0;
+        start = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < numIterations; ++i) {
+            fbHexDecoded += from_hex(fbHex[i]).size();
+        }
+        end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> fbHexDecodeDuration = end - start;
+        std::cout << "from_hex: " << fbHexDecodeDuration.count() << " seconds, "
+                  << gigabytesPerSecond(fbHexDecoded, fbHexDecodeDuration.count()) << " GB/s" << std::endl;
+    }
+
+    generatePythonScript(stdTimes, fbTimes, "base64_hex", "Time (seconds)", numIterations, "scalar + copy", "to_base64");
+}
+
+// 逐字节 append(1, c) 的 JSON 转义，作为对比基准
+static std::string jsonEscapeBytewise(const std::string& str) {
+    static const char digits[] = "0123456789abcdef";
+    std::string out;
+    for (char c : str) {
+        switch (c) {
+            case '"': out.append(1, '\\').append(1, '"'); break;
+            case '\\': out.append(1, '\\').append(1, '\\'); break;
+            case '\n': out.append(1, '\\').append(1, 'n'); break;
+            case '\r': out.append(1, '\\').append(1, 'r'); break;
+            case '\t': out.append(1, '\\').append(1, 't'); break;
+            case '\b': out.append(1, '\\').append(1, 'b'); break;
+            case '\f': out.append(1, '\\').append(1, 'f'); break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    out.append("\\u00");
+                    out.append(1, digits[static_cast<unsigned char>(c) >> 4]).append(1, digits[c & 0xF]);
+                } else {
+                    out.append(1, c);
+                }
+        }
+    }
+    return out;
+}
+
+void testEscapePerformance() {
+    const size_t numIterations = 100000;
+    const size_t stringSizes[] = {16, 200, 4000}; // 分别落在小型、中型、大型存储
+
+    std::random_device rd;
+    std::mt19937 generator(rd());
+    std::uniform_int_distribution<int> percent(0, 99);
+    std::uniform_int_distribution<int> printable(0x20, 0x7E);
+    const char specials[] = "\"\\\n\t<>&";
+    std::uniform_int_distribution<size_t> special(0, sizeof(specials) - 2);
+
+    std::vector<double> stdTimes, fbTimes;
+
+    for (size_t t = 0; t < 3; ++t) {
+        // 约 2% 的字节需要转义
+        std::vector<std::string> stdStrings;
+        stdStrings.reserve(numIterations);
+        for (size_t i = 0; i < numIterations; ++i) {
+            std::string str(stringSizes[t], ' ');
+            for (size_t j = 0; j < str.size(); ++j) {
+                char c = static_cast<char>(printable(generator));
+                if (percent(generator) < 2) {
+                    c = specials[special(generator)];
+                } else if (c == '"' || c == '\\' || c == '<' || c == '>' || c == '&' || c == '\'') {
+                    c = 'x';
+                }
+                str[j] = c;
+            }
+            stdStrings.push_back(str);
+        }
+        std::vector<FBString> fbStrings(stdStrings.begin(), stdStrings.end());
+        std::cout << "Testing escaping of " << stringSizes[t] << "-byte strings" << std::endl;
+
+        // 现有做法：逐字节 append(1, c)，再复制进 FBString
+        size_t stdBytes = 0;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < numIterations; ++i) {
+            const std::string escaped = jsonEscapeBytewise(stdStrings[i]);
+            stdBytes += FBString(escaped.c_str(), escaped.size()).size();
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> stdDuration = end - start;
+        stdTimes.push_back(stdDuration.count());
+        std::cout << "bytewise JSON escape + copy time: " << stdDuration.count() << " seconds, bytes " << stdBytes << std::endl;
+
+        // SIMD 扫描，整段复制到预先扩展好的存储
+        size_t fbBytes = 0;
+        std::vector<FBString> escaped;
+        escaped.reserve(numIterations);
+        start = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < numIterations; ++i) {
+            escaped.push_back(json_escape(fbStrings[i]));
+            fbBytes += escaped.back().size();
+        }
+        end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> fbDuration = end - start;
+        fbTimes.push_back(fbDuration.count());
+        std::cout << "json_escape time: " << fbDuration.count() << " seconds, bytes " << fbBytes << std::endl;
+
+        size_t unescapedBytes = 0;
+        start = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < numIterations; ++i) {
+            unescapedBytes += json_unescape(escaped[i]).size();
+        }
+        end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> unescapeDuration = end - start;
+        std::cout << "json_unescape time: " << unescapeDuration.count() << " seconds, bytes " << unescapedBytes << std::endl;
+
+        // 其它格式
+        size_t htmlBytes = 0, urlBytes = 0;
+        start = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < numIterations; ++i) {
+            htmlBytes += html_escape(fbStrings[i]).size();
+        }
+        end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> htmlDuration = end - start;
+        std::cout << "html_escape time: " << htmlDuration.count() << " seconds, bytes " << htmlBytes << std::endl;
+
+        start = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < numIterations; ++i) {
+            urlBytes += url_encode(fbStrings[i]).size();
+        }
+        end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> urlDuration = end - start;
+        std::cout << "url_encode time: " << urlDuration.count() << " seconds, bytes " << urlBytes << std::endl;
+    }
+
+    generatePythonScript(stdTimes, fbTimes, "escape", "Time (seconds)", numIterations, "append(1, c)", "json_escape");
+}
+
+void testHashPerformance() {
+    const size_t numKeys = 1000;
+    const size_t numIterations = 100000;
+    const size_t stringSizes[] = {16, 200, 4000}; // 分别落在小型、中型、大型存储
+
+    std::random_device rd;
+    std::mt19937 generator(rd());
+    std::uniform_int_distribution<int> letter('a', 'z');
+    std::uniform_int_distribution<size_t> pick(0, numKeys - 1);
+
+    std::vector<double> stdTimes, fbTimes;
+
+    for (size_t t = 0; t < 3; ++t) {
+        std::vector<FBString> keys;
+        keys.reserve(numKeys);
+        for (size_t i = 0; i < numKeys; ++i) {
+            std::string key(stringSizes[t], ' ');
+            for (size_t j = 0; j < key.size(); ++j) {
+                key[j] = static_cast<char>(letter(generator));
+            }
+            keys.push_back(FBString(key.c_str(), key.size()));
+        }
+        // 查询用的是键的副本：大型字符串与键共享缓冲区，也共享缓存的散列值
+        std::vector<FBString> queries;
+        queries.reserve(numIterations);
+        for (size_t i = 0; i < numIterations; ++i) {
+            queries.push_back(keys[pick(generator)]);
+        }
+        std::cout << "Testing hash lookups with " << stringSizes[t] << "-byte keys" << std::endl;
+
+        // 现有做法：转换为 std::string 作为键
+        std::unordered_map<std::string, size_t> stdMap;
+        for (size_t i = 0; i < numKeys; ++i) {
+            stdMap[std::string(keys[i].c_str(), keys[i].size())] = i;
+        }
+        size_t stdSum = 0;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < numIterations; ++i) {
+            stdSum += stdMap.find(std::string(queries[i].c_str(), queries[i].size()))->second;
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> stdDuration = end - start;
+        stdTimes.push_back(stdDuration.count());
+        std::cout << "std::string key lookup time: " << stdDuration.count() << " seconds, sum " << stdSum << std::endl;
+
+        // 直接以 FBString 为键
+        std::unordered_map<FBString, size_t> fbMap;
+        for (size_t i = 0; i < numKeys; ++i) {
+            fbMap[keys[i]] = i;
+        }
+        size_t fbSum = 0;
+        start = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < numIterations; ++i) {
+            fbSum += fbMap.find(queries[i])->second;
+        }
+        end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> fbDuration = end - start;
+        fbTimes.push_back(fbDuration.count());
+        std::cout << "FBString key lookup time: " << fbDuration.count() << " seconds, sum " << fbSum << std::endl;
+
+        // 不计缓存时散列函数本身的吞吐量
+        size_t stdHash = 0;
+        start = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < numIterations; ++i) {
+            stdHash ^= std::hash<std::string>()(std::string(queries[i].c_str(), queries[i].size()));
+        }
+        end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> stdHashDuration = end - start;
+        std::cout << "std::hash<std::string> (with copy) time: " << stdHashDuration.count() << " seconds, " << stdHash % 10 << std::endl;
+
+        size_t fbHash = 0;
+        start = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < numIterations; ++i) {
+            fbHash ^= std::hash<FBStringView>()(FBStringView(queries[i].c_str(), queries[i].size()));
+        }
+        end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> fbHashDuration = end - start;
+        std::cout << "std::hash<FBStringView> (uncached) time: " << fbHashDuration.count() << " seconds, "
+                  << static_cast<double>(numIterations * stringSizes[t]) / fbHashDuration.count() / 1e9 << " GB/s, " << fbHash % 10 << std::endl;
+    }
+
+    generatePythonScript(stdTimes, fbTimes, "hash_lookup", "Time (seconds)", numIterations, "std::string key", "FBString key");
+}
+
+void testInternPerformance() {
+    const size_t numIterations = 100000;
+    const size_t numDistinct = 1000; // 每个值平均重复 100 次
+    const size_t stringSizes[] = {16, 200, 4000}; // 分别落在小型、中型、大型存储
+
+    std::random_device rd;
+    std::mt19937 generator(rd());
+    std::uniform_int_distribution<int> letter('a', 'z');
+    std::uniform_int_distribution<size_t> pick(0, numDistinct - 1);
+
+    std::vector<double> stdTimes, fbTimes;
+
+    for (size_t t = 0; t < 3; ++t) {
+        std::vector<std::string> values;
+        values.reserve(numDistinct);
+        for (size_t i = 0; i < numDistinct; ++i) {
+            std::string value(stringSizes[t], ' ');
+            for (size_t j = 0; j < value.size(); ++j) {
+                value[j] = static_cast<char>(letter(generator));
+            }
+            values.push_back(value);
+        }
+        // 输入来自各自独立的缓冲区，例如逐条解析出的记录
+        std::vector<std::string> inputs;
+        inputs.reserve(numIterations);
+        for (size_t i = 0; i < numIterations; ++i) {
+            inputs.push_back(values[pick(generator)]);
+        }
+        std::cout << "Testing interning of " << stringSizes[t] << "-byte strings" << std::endl;
+
+        // 每条记录各保存一份
+        auto start = std::chrono::high_resolution_clock::now();
+        std::vector<std::string> stdStrings;
+        stdStrings.reserve(numIterations);
+        for (size_t i = 0; i < numIterations; ++i) {
+            stdStrings.push_back(inputs[i]);
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> stdDuration = end - start;
+        stdTimes.push_back(stdDuration.count());
+        std::cout << "std::string copies time: " << stdDuration.count() << " seconds, memory "
+                  << calculateMemoryUsage(stdStrings) << " bytes" << std::endl;
+
+        // 驻留后保存与池共享缓冲区的 FBString
+        FBStringInternPool pool;
+        start = std::chrono::high_resolution_clock::now();
+        std::vector<FBString> fbStrings;
+        fbStrings.reserve(numIterations);
+        for (size_t i = 0; i < numIterations; ++i) {
+            fbStrings.push_back(pool.intern(FBStringView(inputs[i].data(), inputs[i].size())).str());
+        }
+        end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> fbDuration = end - start;
+        fbTimes.push_back(fbDuration.count());
+        const FBStringInternPool::Stats stats = pool.stats();
+        std::cout << "FBStringInternPool time: " << fbDuration.count() << " seconds, memory "
+                  << calculateMemoryUsage(fbStrings) << " bytes, distinct " << stats.distinct
+                  << ", saved " << stats.savedBytes() << " bytes" << std::endl;
+
+        // 驻留句柄的相等比较只比较指针
+        std::vector<FBInternedString> handles;
+        handles.reserve(numIterations);
+        for (size_t i = 0; i < numIterations; ++i) {
+            handles.push_back(pool.intern(FBStringView(inputs[i].data(), inputs[i].size())));
+        }
+        size_t stdEqual = 0, fbEqual = 0;
+        start = std::chrono::high_resolution_clock::now();
+        for (size_t i = 1; i < numIterations; ++i) {
+            stdEqual += stdStrings[i] == stdStrings[i - 1];
+        }
+        end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> stdEqualDuration = end - start;
+        start = std::chrono::high_resolution_clock::now();
+        for (size_t i = 1; i < numIterations; ++i) {
+            fbEqual += handles[i] == handles[i - 1];
+        }
+        end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> fbEqualDuration = end - start;
+        std::cout << "std::string equality time: " << stdEqualDuration.count() << " seconds, FBInternedString equality time: "
+                  << fbEqualDuration.count() << " seconds, equal pairs " << stdEqual << "/" << fbEqual << std::endl;
+    }
+
+    generatePythonScript(stdTimes, fbTimes, "intern", "Time (seconds)", numIterations, "std::string copies", "FBStringInternPool");
+}
+
+void testConcurrentInternScaling() {
+    const size_t opsPerThread = 200000;
+    const size_t numHotKeys = 10000;
+    const size_t stringLength = 40; // 中型存储
+
+    std::random_device rd;
+    std::mt19937 generator(rd());
+    std::uniform_int_distribution<int> letter('a', 'z');
+
+    // 热键：已经驻留，每次操作都是对已有值的查找
+    std::vector<std::string> hotKeys;
+    hotKeys.reserve(numHotKeys);
+    for (size_t i = 0; i < numHotKeys; ++i) {
+        std::string key(stringLength, ' ');
+        for (size_t j = 0; j < key.size(); ++j) {
+            key[j] = static_cast<char>(letter(generator));
+        }
+        hotKeys.push_back(key);
+    }
+
+    // 从 1 个线程倍增到硬件线程数
+    const size_t maxThreads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    std::vector<size_t> threadCounts;
+    for (size_t n = 1; n < maxThreads; n *= 2) {
+        threadCounts.push_back(n);
+    }
+    threadCounts.push_back(maxThreads);
+
+    // 每个线程执行相同次数的操作，其中 1/16 是本线程独有的新值，其余是热键
+    auto run = [&](size_t numThreads, const std::function<void(FBStringView)>& internOne) {
+        std::vector<std::thread> threads;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (size_t t = 0; t < numThreads; ++t) {
+            threads.emplace_back([&, t]() {
+                std::mt19937 local(static_cast<unsigned>(t));
+                std::uniform_int_distribution<size_t> pick(0, numHotKeys - 1);
+                char fresh[32];
+                for (size_t i = 0; i < opsPerThread; ++i) {
+                    if (i % 16 == 0) {
+                        const int n = std::snprintf(fresh, sizeof(fresh), "t%zu-%zu", t, i);
+                        internOne(FBStringView(fresh, static_cast<size_t>(n)));
+                    } else {
+                        const std::string& key = hotKeys[pick(local)];
+                        internOne(FBStringView(key.data(), key.size()));
+                    }
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration<double>(end - start).count();
+    };
+
+    std::vector<double> poolTimes, setTimes;
+    std::vector<std::string> labels;
+    for (size_t numThreads : threadCounts) {
+        std::cout << "Testing concurrent interning with " << numThreads << " threads" << std::endl;
+
+        FBStringInternPool pool;
+        for (const auto& key : hotKeys) {
+            pool.intern(FBStringView(key.data(), key.size()));
+        }
+        const double poolTime = run(numThreads, [&](FBStringView s) { pool.intern(s); });
+        poolTimes.push_back(poolTime);
+        std::cout << "FBStringInternPool (mutex shards) time: " << poolTime << " seconds, "
+                  << numThreads * opsPerThread / poolTime / 1e6 << " Mops/s" << std::endl;
+
+        FBConcurrentInternSet set;
+        for (const auto& key : hotKeys) {
+            set.intern(FBStringView(key.data(), key.size()));
+        }
+        const double setTime = run(numThreads, [&](FBStringView s) { set.intern(s); });
+        setTimes.push_back(setTime);
+        std::cout << "FBConcurrentInternSet (lock-free) time: " << setTime << " seconds, "
+                  << numThreads * opsPerThread / setTime / 1e6 << " Mops/s" << std::endl;
+
+        labels.push_back(std::to_string(numThreads));
+    }
+
+    generatePythonScript(poolTimes, setTimes, "intern_scaling", "Time (seconds)", opsPerThread, "FBStringInternPool", "FBConcurrentInternSet",
+                         labels, "Threads");
+}
+
+void testStringMapPerformance() {
+    const size_t numKeys = 10000;
+    const size_t numIterations = 1000000;
+    const size_t stringSizes[] = {16, 200, 4000}; // 分别落在小型、中型、大型存储
+
+    std::random_device rd;
+    std::mt19937 generator(rd());
+    std::uniform_int_distribution<int> letter('a', 'z');
+    std::uniform_int_distribution<size_t> pick(0, numKeys - 1);
+
+    std::vector<double> stdTimes, fbTimes;
+
+    for (size_t t = 0; t < 3; ++t) {
+        // 键只保留为 std::string，查找时以 const char* 传入，模拟从外部缓冲区取得的键
+        std::vector<std::string> keys;
+        keys.reserve(numKeys);
+        for (size_t i = 0; i < numKeys; ++i) {
+            std::string key(stringSizes[t], ' ');
+            for (size_t j = 0; j < key.size(); ++j) {
+                key[j] = static_cast<char>(letter(generator));
+            }
+            keys.push_back(key);
+        }
+        std::vector<const char*> queries;
+        queries.reserve(numIterations);
+        for (size_t i = 0; i < numIterations; ++i) {
+            queries.push_back(keys[pick(generator)].c_str());
+        }
+        std::cout << "Testing string map with " << stringSizes[t] << "-byte keys" << std::endl;
+
+        // std::unordered_map：每个节点单独分配，查找前要先用 const char* 构造 FBString
+        auto start = std::chrono::high_resolution_clock::now();
+        std::unordered_map<FBString, size_t> stdMap;
+        for (size_t i = 0; i < numKeys; ++i) {
+            stdMap[FBString(keys[i].c_str(), keys[i].size())] = i;
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> stdInsert = end - start;
+        size_t stdSum = 0;
+        start = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < numIterations; ++i) {
+            stdSum += stdMap.find(FBString(queries[i]))->second;
+        }
+        end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> stdDuration = end - start;
+        stdTimes.push_back(stdDuration.count());
+        std::cout << "std::unordered_map<FBString> insert time: " << stdInsert.count() << " seconds, lookup time: " << stdDuration.count()
+                  << " seconds, sum " << stdSum << std::endl;
+
+        // FBStringMap：键值对存放在槽位数组中，直接以 const char* 查找
+        start = std::chrono::high_resolution_clock::now();
+        FBStringMap<size_t> fbMap;
+        for (size_t i = 0; i < numKeys; ++i) {
+            fbMap[keys[i]] = i;
+        }
+        end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> fbInsert = end - start;
+        size_t fbSum = 0;
+        start = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < numIterations; ++i) {
+            fbSum += fbMap.find(queries[i])->second;
+        }
+        end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> fbDuration = end - start;
+        fbTimes.push_back(fbDuration.count());
+        std::cout << "FBStringMap insert time: " << fbInsert.count() << " seconds, lookup time: " << fbDuration.count()
+                  << " seconds, sum " << fbSum << std::endl;
+
+        // 查找不存在的键：大多只比较控制字节
+        size_t misses = 0;
+        start = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < numIterations; ++i) {
+            misses += fbMap.count(FBStringView(queries[i], stringSizes[t] - 1)) == 0;
+        }
+        end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> missDuration = end - start;
+        std::cout << "FBStringMap miss lookup time: " << missDuration.count() << " seconds, misses " << misses << std::endl;
+    }
+
+    generatePythonScript(stdTimes, fbTimes, "string_map", "Time (seconds)", numIterations, "std::unordered_map<FBString>", "FBStringMap");
+}
+
+void testStringSortPerformance() {
+    const size_t numStrings = 10000000;
+    const char* const prefix = "https://example.com/api/users/"; // 共享前缀的键长度超过小型存储，内容都在堆上
+
+    std::random_device rd;
+    std::mt19937 generator(rd());
+    std::uniform_int_distribution<int> letter('a', 'z');
+    std::uniform_int_distribution<size_t> length(4, 16);
+
+    std::vector<double> stdTimes, fbTimes;
+
+    for (size_t t = 0; t < 2; ++t) {
+        std::vector<FBString> strings;
+        strings.reserve(numStrings);
+        for (size_t i = 0; i < numStrings; ++i) {
+            std::string s = t == 0 ? std::string() : std::string(prefix);
+            const size_t n = length(generator);
+            for (size_t j = 0; j < n; ++j) {
+                s.push_back(static_cast<char>(letter(generator)));
+            }
+            strings.push_back(FBString(s.c_str(), s.size()));
+        }
+        std::cout << "Testing sort of " << numStrings << (t == 0 ? " random" : " shared-prefix") << " strings" << std::endl;
+
+        // 每种排序都从同一份乱序的副本开始；副本与原字符串共享缓冲区，排序只移动不复制
+        std::vector<FBString> data(strings);
+        auto start = std::chrono::high_resolution_clock::now();
+        std::sort(data.begin(), data.end());
+        auto end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> stdDuration = end - start;
+        stdTimes.push_back(stdDuration.count());
+        std::cout << "std::sort time: " << stdDuration.count() << " seconds" << std::endl;
+
+        data = strings;
+        start = std::chrono::high_resolution_clock::now();
+        FBStringSort::sort(data);
+        end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> fbDuration = end - start;
+        fbTimes.push_back(fbDuration.count());
+        std::cout << "FBStringSort::sort time: " << fbDuration.count() << " seconds" << std::endl;
+
+        data = strings;
+        start = std::chrono::high_resolution_clock::now();
+        FBStringSort::parallelSort(data);
+        end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> parallelDuration = end - start;
+        std::cout << "FBStringSort::parallelSort time (" << std::max(1u, std::thread::hardware_concurrency()) << " threads): "
+                  << parallelDuration.count() << " seconds" << std::endl;
+    }
+
+    generatePythonScript(stdTimes, fbTimes, "string_sort", "Time (seconds)", numStrings, "std::sort", "FBStringSort::sort",
+                         std::vector<std::string>{"random", "shared prefix"}, "Keys");
+}
+
+// 改为按字比较之前 operator< 的实现：逐个 char 比较，char 有符号时 0x80 以上的字节排在前面
+struct LexicographicalLess {
+    bool operator()(const FBString& a, const FBString& b) const {
+        return std::lexicographical_compare(a.c_str(), a.c_str() + a.size(), b.c_str(), b.c_str() + b.size());
+    }
+};
+
+void testComparePerformance() {
+    const size_t numStrings = 50000;
+    const size_t numIterations = 200000;
+    const size_t stringSizes[] = {16, 200, 4000}; // 分别落在小型、中型、大型存储
+
+    std::random_device rd;
+    std::mt19937 generator(rd());
+    std::uniform_int_distribution<int> letter('a', 'z');
+
+    std::vector<double> stdTimes, fbTimes;
+
+    for (size_t t = 0; t < 3; ++t) {
+        // 只有最后 8 个字节不同，每次比较都要扫描到接近结尾
+        const std::string prefix(stringSizes[t] - 8, 'p');
+        std::vector<FBString> strings;
+        strings.reserve(numStrings);
+        for (size_t i = 0; i < numStrings; ++i) {
+            std::string s = prefix;
+            for (size_t j = 0; j < 8; ++j) {
+                s.push_back(static_cast<char>(letter(generator)));
+            }
+            strings.push_back(FBString(s.c_str(), s.size()));
+        }
+        std::uniform_int_distribution<size_t> pick(0, numStrings - 1);
+        std::vector<size_t> queries;
+        queries.reserve(numIterations);
+        for (size_t i = 0; i < numIterations; ++i) {
+            queries.push_back(pick(generator));
+        }
+        std::cout << "Testing comparisons of " << stringSizes[t] << "-byte strings" << std::endl;
+
+        // 原来的逐字节比较：排序，再在 std::map 中查找
+        std::vector<FBString> data(strings);
+        auto start = std::chrono::high_resolution_clock::now();
+        std::sort(data.begin(), data.end(), LexicographicalLess());
+        std::map<FBString, size_t, LexicographicalLess> oldMap;
+        for (size_t i = 0; i < numStrings; ++i) {
+            oldMap[strings[i]] = i;
+        }
+        size_t oldSum = 0;
+        for (size_t i = 0; i < numIterations; ++i) {
+            oldSum += oldMap.find(strings[queries[i]])->second;
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> stdDuration = end - start;
+        stdTimes.push_back(stdDuration.count());
+        std::cout << "lexicographical_compare sort + map time: " << stdDuration.count() << " seconds, sum " << oldSum << std::endl;
+
+        // 现在的 operator<：memcmp，小型存储按 3 个 64 位字比较
+        data = strings;
+        start = std::chrono::high_resolution_clock::now();
+        std::sort(data.begin(), data.end());
+        std::map<FBString, size_t> newMap;
+        for (size_t i = 0; i < numStrings; ++i) {
+            newMap[strings[i]] = i;
+        }
+        size_t newSum = 0;
+        for (size_t i = 0; i < numIterations; ++i) {
+            newSum += newMap.find(strings[queries[i]])->second;
+        }
+        end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> fbDuration = end - start;
+        fbTimes.push_back(fbDuration.count());
+        std::cout << "operator< sort + map time: " << fbDuration.count() << " seconds, sum " << newSum << std::endl;
+    }
+
+    generatePythonScript(stdTimes, fbTimes, "compare", "Time (seconds)", numIterations, "lexicographical_compare", "operator<");
+}
+
+void testEqualityPerformance() {
+    const size_t numValues = 1000;
+    const size_t numIterations = 1000000;
+    const size_t stringSizes[] = {16, 200, 4000}; // 分别落在小型、中型、大型存储
+
+    std::random_device rd;
+    std::mt19937 generator(rd());
+    std::uniform_int_distribution<int> letter('a', 'z');
+    std::uniform_int_distribution<size_t> pick(0, numValues - 1);
+
+    std::vector<double> stdTimes, fbTimes;
+
+    for (size_t t = 0; t < 3; ++t) {
+        // 缓存中的值：只有中间一个字节不同，首尾字节和长度都相同
+        const std::string base(stringSizes[t], 'v');
+        std::vector<FBString> table;
+        table.reserve(numValues);
+        for (size_t i = 0; i < numValues; ++i) {
+            std::string s = base;
+            s[s.size() / 2] = static_cast<char>(letter(generator));
+            s[s.size() / 2 + 1] = static_cast<char>(letter(generator));
+            table.push_back(FBString(s.c_str(), s.size()));
+        }
+        // 从缓存复制出来的值（中型和大型与缓存共享缓冲区），一半与缓存中的同一项比较，一半与随机一项比较
+        std::vector<FBString> copies;
+        std::vector<size_t> lhs, rhs;
+        copies.reserve(numIterations);
+        for (size_t i = 0; i < numIterations; ++i) {
+            const size_t index = pick(generator);
+            copies.push_back(table[index]);
+            lhs.push_back(index);
+            rhs.push_back(i % 2 == 0 ? index : pick(generator));
+        }
+        std::cout << "Testing equality of " << stringSizes[t] << "-byte strings" << std::endl;
+
+        // 原来的做法：比较大小后 memcmp 全部内容
+        size_t stdEqual = 0;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < numIterations; ++i) {
+            const FBString& a = copies[i];
+            const FBString& b = table[rhs[i]];
+            stdEqual += a.size() == b.size() && std::memcmp(a.c_str(), b.c_str(), a.size()) == 0;
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> stdDuration = end - start;
+        stdTimes.push_back(stdDuration.count());
+        std::cout << "size + memcmp time: " << stdDuration.count() << " seconds, equal " << stdEqual << std::endl;
+
+        size_t fbEqual = 0;
+        start = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < numIterations; ++i) {
+            fbEqual += copies[i] == table[rhs[i]];
+        }
+        end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> fbDuration = end - start;
+        fbTimes.push_back(fbDuration.count());
+        std::cout << "FBString::operator== time: " << fbDuration.count() << " seconds, equal " << fbEqual << std::endl;
+
+        // 散列值已缓存（例如值曾作为散列表的键）时，大型字符串的不相等也不必读取内容
+        for (size_t i = 0; i < numValues; ++i) {
+            table[i].hash();
+        }
+        size_t hashedEqual = 0;
+        start = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < numIterations; ++i) {
+            hashedEqual += copies[i] == table[rhs[i]];
+        }
+        end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> hashedDuration = end - start;
+        std::cout << "FBString::operator== with cached hashes time: " << hashedDuration.count() << " seconds, equal " << hashedEqual << std::endl;
+    }
+
+    generatePythonScript(stdTimes, fbTimes, "equality", "Time (seconds)", numIterations, "size + memcmp", "FBString::operator==");
+}
+
+// 估算 std::vector<FBString> 占用的内存：对象数组，加上每个中型或大型字符串的缓冲区（内容和结尾的 null）与共享头部，
+// 两次堆分配各按 16 字节计入分配器的簿记开销
+size_t estimateVectorMemory(const std::vector<FBString>& strings) {
+    const size_t kHeaderSize = 3 * sizeof(size_t);
+    const size_t kAllocOverhead = 16;
+    size_t total = sizeof(strings) + strings.capacity() * sizeof(FBString);
+    for (const auto& str : strings) {
+        if (!str.is_inline()) {
+            total += str.size() + 1 + kHeaderSize + 2 * kAllocOverhead;
+        }
+    }
+    return total;
+}
+
+void testStringTablePerformance() {
+    const size_t numStrings = 1000000;
+    const size_t stringSizes[] = {8, 32, 200}; // 较短的字符串每个对象的固定开销占比最大
+
+    std::random_device rd;
+    std::mt19937 generator(rd());
+    std::uniform_int_distribution<int> letter('a', 'z');
+
+    std::vector<double> stdMemory, fbMemory;
+    std::vector<std::string> categories;
+
+    for (size_t t = 0; t < 3; ++t) {
+        // 长度在 stringSizes[t] 附近浮动，例如逐行读入的日志或 URL
+        std::uniform_int_distribution<size_t> length(stringSizes[t] / 2, stringSizes[t] * 3 / 2);
+        std::vector<std::string> inputs;
+        inputs.reserve(numStrings);
+        for (size_t i = 0; i < numStrings; ++i) {
+            std::string s(length(generator), ' ');
+            for (size_t j = 0; j < s.size(); ++j) {
+                s[j] = static_cast<char>(letter(generator));
+            }
+            inputs.push_back(s);
+        }
+        categories.push_back(std::to_string(stringSizes[t]));
+        std::cout << "Testing table of " << numStrings << " strings of about " << stringSizes[t] << " bytes" << std::endl;
+
+        auto start = std::chrono::high_resolution_clock::now();
+        std::vector<FBString> strings;
+        strings.reserve(numStrings);
+        for (size_t i = 0; i < numStrings; ++i) {
+            strings.push_back(FBString(inputs[i].data(), inputs[i].size()));
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> stdBuild = end - start;
+
+        start = std::chrono::high_resolution_clock::now();
+        FBStringTable table;
+        table.reserve(numStrings);
+        for (size_t i = 0; i < numStrings; ++i) {
+            table.push_back(FBStringView(inputs[i].data(), inputs[i].size()));
+        }
+        table.freeze();
+        end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> fbBuild = end - start;
+
+        // 顺序遍历，累加每个字符串的首字节和长度
+        size_t stdSum = 0, fbSum = 0;
+        start = std::chrono::high_resolution_clock::now();
+        for (const auto& str : strings) {
+            stdSum += static_cast<unsigned char>(str.c_str()[0]) + str.size();
+        }
+        end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> stdScan = end - start;
+
+        start = std::chrono::high_resolution_clock::now();
+        for (FBStringView str : table) {
+            fbSum += static_cast<unsigned char>(str[0]) + str.size();
+        }
+        end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> fbScan = end - start;
+
+        const double stdPerString = static_cast<double>(estimateVectorMemory(strings)) / numStrings;
+        const double fbPerString = static_cast<double>(table.memory_usage()) / numStrings;
+        const double contentPerString = static_cast<double>(table.bytes()) / numStrings;
+        stdMemory.push_back(stdPerString);
+        fbMemory.push_back(fbPerString);
+        std::cout << "std::vector<FBString>: build " << stdBuild.count() << " seconds, scan " << stdScan.count()
+                  << " seconds, " << stdPerString << " bytes per string (content " << contentPerString << ")" << std::endl;
+        std::cout << "FBStringTable: build + freeze " << fbBuild.count() << " seconds, scan " << fbScan.count()
+                  << " seconds, " << fbPerString << " bytes per string, checksum " << (stdSum == fbSum ? "match" : "MISMATCH") << std::endl;
+    }
+
+    generatePythonScript(stdMemory, fbMemory, "string_table", "Memory per String (bytes)", numStrings, "std::vector<FBString>", "FBStringTable",
+                         categories, "String Size (bytes)");
+}
+
+void testRadixTreePerformance() {
+    const size_t numRoutes = 200000;
+    const size_t numIterations = 100000;
+    const char* const segments[] = {"api", "v1", "v2", "users", "orders", "items", "admin", "static", "images", "search",
+                                    "accounts", "billing", "reports", "settings", "profile", "health", "metrics", "internal"};
+    const size_t numSegments = sizeof(segments) / sizeof(segments[0]);
+
+    std::random_device rd;
+    std::mt19937 generator(rd());
+    std::uniform_int_distribution<size_t> pickSegment(0, numSegments - 1);
+    std::uniform_int_distribution<size_t> pickDepth(1, 4);
+    std::uniform_int_distribution<int> pickId(0, 99999);
+
+    // 路由表：若干层路径段，最后一层可能是数字 ID
+    auto randomPath = [&]() {
+        std::string path;
+        const size_t depth = pickDepth(generator);
+        for (size_t i = 0; i < depth; ++i) {
+            path += '/';
+            path += i + 1 == depth && pickId(generator) % 2 == 0 ? std::to_string(pickId(generator)) : segments[pickSegment(generator)];
+        }
+        return path;
+    };
+    std::vector<FBString> routes;
+    routes.reserve(numRoutes);
+    for (size_t i = 0; i < numRoutes; ++i) {
+        const std::string path = randomPath();
+        routes.push_back(FBString(path.c_str(), path.size()));
+    }
+    std::sort(routes.begin(), routes.end());
+    routes.erase(std::unique(routes.begin(), routes.end()), routes.end());
+
+    // 请求路径：已有的路由后面再接几段，或者完全随机的路径；前缀查询取路由的前两三段
+    std::uniform_int_distribution<size_t> pickRoute(0, routes.size() - 1);
+    std::vector<std::string> requests, prefixes;
+    for (size_t i = 0; i < numIterations; ++i) {
+        const FBString& route = routes[pickRoute(generator)];
+        requests.push_back(i % 4 == 0 ? randomPath() + randomPath() : std::string(route.c_str(), route.size()) + randomPath());
+        const std::string r(route.c_str(), route.size());
+        size_t cut = r.find('/', 1);
+        if (cut != std::string::npos) cut = r.find('/', cut + 1);
+        if (cut != std::string::npos && i % 2 == 0) cut = r.find('/', cut + 1);
+        prefixes.push_back(cut == std::string::npos ? r : r.substr(0, cut));
+    }
+
+    FBStringRadixTree<size_t> tree;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < routes.size(); ++i) {
+        tree.insert(std::make_pair(routes[i], i));
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> buildDuration = end - start;
+    std::cout << "Testing " << routes.size() << " routes, radix tree build time: " << buildDuration.count() << " seconds" << std::endl;
+    std::cout << "sorted vector<FBString> memory: " << routes.capacity() * sizeof(FBString) << " bytes, FBStringRadixTree memory: "
+              << tree.memory_usage() << " bytes (excluding key buffers)" << std::endl;
+
+    std::vector<double> stdTimes, fbTimes;
+    auto less = [](const FBString& a, FBStringView b) { return FBStringView(a) < b; };
+
+    // 精确查找：二分查找与树的查找
+    size_t stdFound = 0, fbFound = 0;
+    start = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < numIterations; ++i) {
+        const FBStringView key(prefixes[i].data(), prefixes[i].size());
+        auto it = std::lower_bound(routes.begin(), routes.end(), key, less);
+        stdFound += it != routes.end() && FBStringView(*it) == key;
+    }
+    end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> stdDuration = end - start;
+    stdTimes.push_back(stdDuration.count());
+    start = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < numIterations; ++i) {
+        fbFound += tree.contains(FBStringView(prefixes[i].data(), prefixes[i].size()));
+    }
+    end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> fbDuration = end - start;
+    fbTimes.push_back(fbDuration.count());
+    std::cout << "Exact lookup: binary search " << stdDuration.count() << " seconds, radix tree " << fbDuration.count()
+              << " seconds, found " << stdFound << "/" << fbFound << std::endl;
+
+    // 最长前缀匹配：有序数组只能对每个可能的前缀长度从长到短各做一次二分查找
+    size_t stdMatched = 0, fbMatched = 0;
+    start = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < numIterations; ++i) {
+        const FBStringView request(requests[i].data(), requests[i].size());
+        for (size_t n = request.size(); n > 0; --n) {
+            const FBStringView candidate = request.substr(0, n);
+            auto it = std::lower_bound(routes.begin(), routes.end(), candidate, less);
+            if (it != routes.end() && FBStringView(*it) == candidate) {
+                stdMatched += n;
+                break;
+            }
+        }
+    }
+    end = std::chrono::high_resolution_clock::now();
+    stdDuration = end - start;
+    stdTimes.push_back(stdDuration.count());
+    start = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < numIterations; ++i) {
+        const FBStringRadixTree<size_t>::value_type* match = tree.longest_prefix(FBStringView(requests[i].data(), requests[i].size()));
+        if (match != nullptr) fbMatched += match->first.size();
+    }
+    end = std::chrono::high_resolution_clock::now();
+    fbDuration = end - start;
+    fbTimes.push_back(fbDuration.count());
+    std::cout << "Longest prefix: binary search per length " << stdDuration.count() << " seconds, radix tree " << fbDuration.count()
+              << " seconds, matched bytes " << stdMatched << "/" << fbMatched << std::endl;
+
+    // 前缀范围：二分查找起点后向后扫描，与遍历对应的子树
+    size_t stdRange = 0, fbRange = 0;
+    start = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < numIterations; ++i) {
+        const FBStringView prefix(prefixes[i].data(), prefixes[i].size());
+        for (auto it = std::lower_bound(routes.begin(), routes.end(), prefix, less); it != routes.end() && FBStringView(*it).starts_with(prefix); ++it) {
+            ++stdRange;
+        }
+    }
+    end = std::chrono::high_resolution_clock::now();
+    stdDuration = end - start;
+    stdTimes.push_back(stdDuration.count());
+    start = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < numIterations; ++i) {
+        tree.for_each_prefix(FBStringView(prefixes[i].data(), prefixes[i].size()), [&fbRange](const FBStringRadixTree<size_t>::value_type&) { ++fbRange; });
+    }
+    end = std::chrono::high_resolution_clock::now();
+    fbDuration = end - start;
+    fbTimes.push_back(fbDuration.count());
+    std::cout << "Prefix range: lower_bound + scan " << stdDuration.count() << " seconds, radix tree " << fbDuration.count()
+              << " seconds, keys visited " << stdRange << "/" << fbRange << std::endl;
+
+    generatePythonScript(stdTimes, fbTimes, "radix_tree", "Time (seconds)", numIterations, "sorted vector<FBString>", "FBStringRadixTree",
+                         std::vector<std::string>{"exact", "longest prefix", "prefix range"}, "Operation");
+}
+
+void testGermanStringPerformance() {
+    const size_t numStrings = 1000000;
+    const size_t numIterations = 10000000;
+
+    std::random_device rd;
+    std::mt19937 generator(rd());
+    std::uniform_int_distribution<int> letter('a', 'z');
+    std::uniform_int_distribution<size_t> length(4, 40); // 约四分之一不超过 12 个字符，保存在 FBGermanString 内部
+    std::uniform_int_distribution<size_t> pick(0, numStrings - 1);
+
+    // 列数据：内容集中保存在 FBStringTable 中，FBGermanString 指向它；对照组是各自分配缓冲区的 FBString
+    FBStringTable column;
+    std::vector<FBString> strings;
+    strings.reserve(numStrings);
+    for (size_t i = 0; i < numStrings; ++i) {
+        std::string s(length(generator), ' ');
+        for (size_t j = 0; j < s.size(); ++j) {
+            s[j] = static_cast<char>(letter(generator));
+        }
+        column.push_back(FBStringView(s.data(), s.size()));
+        strings.push_back(FBString(s.c_str(), s.size()));
+    }
+    // 两个数组按同一个随机排列打乱，FBString 的缓冲区在内存中的位置与数组顺序无关
+    std::vector<size_t> order(numStrings);
+    for (size_t i = 0; i < numStrings; ++i) {
+        order[i] = i;
+    }
+    std::shuffle(order.begin(), order.end(), generator);
+    std::vector<FBString> shuffled;
+    std::vector<FBGermanString> germans;
+    shuffled.reserve(numStrings);
+    germans.reserve(numStrings);
+    for (size_t i = 0; i < numStrings; ++i) {
+        shuffled.push_back(std::move(strings[order[i]]));
+        germans.push_back(FBGermanString(column[order[i]]));
+    }
+    strings.swap(shuffled);
+    std::vector<size_t> lhs, rhs;
+    lhs.reserve(numIterations);
+    rhs.reserve(numIterations);
+    for (size_t i = 0; i < numIterations; ++i) {
+        lhs.push_back(pick(generator));
+        rhs.push_back(pick(generator));
+    }
+    std::cout << "Testing " << numStrings << " strings, sizeof(FBString) " << sizeof(FBString) << ", sizeof(FBGermanString) "
+              << sizeof(FBGermanString) << std::endl;
+
+    std::vector<double> stdTimes, fbTimes;
+
+    // 随机两两比较：前缀不同时 FBGermanString 不解引用指针
+    size_t stdLess = 0, fbLess = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < numIterations; ++i) {
+        stdLess += strings[lhs[i]] < strings[rhs[i]];
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> stdDuration = end - start;
+    stdTimes.push_back(stdDuration.count());
+    start = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < numIterations; ++i) {
+        fbLess += germans[lhs[i]] < germans[rhs[i]];
+    }
+    end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> fbDuration = end - start;
+    fbTimes.push_back(fbDuration.count());
+    std::cout << "Compare: FBString " << stdDuration.count() << " seconds, FBGermanString " << fbDuration.count()
+              << " seconds, less " << stdLess << "/" << fbLess << std::endl;
+
+    // 排序：FBGermanString 每个元素只有 16 字节，交换时移动的数据更少
+    std::vector<FBString> sortedStrings(strings);
+    start = std::chrono::high_resolution_clock::now();
+    std::sort(sortedStrings.begin(), sortedStrings.end());
+    end = std::chrono::high_resolution_clock::now();
+    stdDuration = end - start;
+    stdTimes.push_back(stdDuration.count());
+    std::vector<FBGermanString> sortedGermans(germans);
+    start = std::chrono::high_resolution_clock::now();
+    std::sort(sortedGermans.begin(), sortedGermans.end());
+    end = std::chrono::high_resolution_clock::now();
+    fbDuration = end - start;
+    fbTimes.push_back(fbDuration.count());
+    bool sameOrder = true;
+    for (size_t i = 0; i < numStrings; ++i) {
+        sameOrder = sameOrder && FBStringView(sortedStrings[i]) == sortedGermans[i].view();
+    }
+    std::cout << "std::sort: FBString " << stdDuration.count() << " seconds, FBGermanString " << fbDuration.count()
+              << " seconds, same order " << (sameOrder ? "yes" : "NO") << std::endl;
+
+    generatePythonScript(stdTimes, fbTimes, "german_string", "Time (seconds)", numIterations, "FBString", "FBGermanString",
+                         std::vector<std::string>{"compare", "sort"}, "Operation");
+}
+
+// 统计分配次数的分配器，用于比较 std::string 的堆分配
+static size_t countingAllocatorCalls = 0;
+
+template <typename T>
+struct CountingAllocator {
+    typedef T value_type;
+
+    CountingAllocator() {}
+    template <typename U>
+    CountingAllocator(const CountingAllocator<U>&) {}
+
+    T* allocate(size_t n) {
+        ++countingAllocatorCalls;
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, size_t) {
+        ::operator delete(p);
+    }
+};
+
+template <typename T, typename U>
+bool operator==(const CountingAllocator<T>&, const CountingAllocator<U>&) {
+    return true;
+}
+
+template <typename T, typename U>
+bool operator!=(const CountingAllocator<T>&, const CountingAllocator<U>&) {
+    return false;
+}
+
+typedef std::basic_string<char, std::char_traits<char>, CountingAllocator<char>> CountingString;
+
+// 测试标识符长度的字符串构造时的堆分配次数
+void testIdentifierSsoPerformance() {
+    const size_t numIterations = 1000000;
+    const size_t idLengths[] = {20, 26, 30}; // 小写字母和数字组成的标识符，例如带前缀的短哈希、订单号
+
+    std::random_device rd;
+    std::mt19937 generator(rd());
+    const char alphabet[] = "abcdefghijklmnopqrstuvwxyz0123456789";
+    std::uniform_int_distribution<size_t> pick(0, sizeof(alphabet) - 2);
+
+    std::vector<double> stdAllocations, fbAllocations;
+    std::vector<std::string> categories;
+
+    for (size_t t = 0; t < 3; ++t) {
+        std::vector<std::string> ids;
+        ids.reserve(numIterations);
+        for (size_t i = 0; i < numIterations; ++i) {
+            std::string id(idLengths[t], ' ');
+            for (size_t j = 0; j < id.size(); ++j) {
+                id[j] = alphabet[pick(generator)];
+            }
+            ids.push_back(id);
+        }
+        categories.push_back(std::to_string(idLengths[t]));
+        std::cout << "Testing " << numIterations << " identifiers of " << idLengths[t] << " characters" << std::endl;
+
+        // std::string 的分配经过计数分配器，vector 自身的分配不计入
+        std::vector<CountingString> stdStrings;
+        stdStrings.reserve(numIterations);
+        countingAllocatorCalls = 0;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < numIterations; ++i) {
+            stdStrings.push_back(CountingString(ids[i].data(), ids[i].size()));
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> stdDuration = end - start;
+        size_t stdCount = countingAllocatorCalls;
+
+        // FBString 的数据缓冲区和共享头部由计数器统计
+        std::vector<FBString> fbStrings;
+        fbStrings.reserve(numIterations);
+        size_t fbCount = 0;
+        start = std::chrono::high_resolution_clock::now();
+        {
+            FBStringAllocationCounter counter;
+            for (size_t i = 0; i < numIterations; ++i) {
+                fbStrings.push_back(FBString(ids[i].data(), ids[i].size()));
+            }
+            fbCount = counter.count();
+        }
+        end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> fbDuration = end - start;
+
+        size_t inlineCount = 0;
+        for (size_t i = 0; i < numIterations; ++i) {
+            inlineCount += fbStrings[i].is_inline();
+        }
+        stdAllocations.push_back(static_cast<double>(stdCount));
+        fbAllocations.push_back(static_cast<double>(fbCount));
+        std::cout << "std::string: " << stdDuration.count() << " seconds, " << stdCount << " heap allocations" << std::endl;
+        std::cout << "FBString: " << fbDuration.count() << " seconds, " << fbCount << " heap allocations, "
+                  << inlineCount << " strings inline" << std::endl;
+    }
+
+    generatePythonScript(stdAllocations, fbAllocations, "identifier_sso", "Heap Allocations", numIterations, "std::string", "FBString",
+                         categories, "Identifier Length");
+}
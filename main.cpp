@@ -1,14 +1,83 @@
 #include <cstdlib>
 // 声明测试函数
 void testStringPerformance();
+void testMoveSemanticsPerformance();
+void testFormatPerformance();
+void testIntegerConversionPerformance();
+void testFloatConversionPerformance();
+void testNumericParsingPerformance();
+void testSplitPerformance();
+void testTrimPerformance();
+void testCaseConversionPerformance();
+void testUtf8ValidationPerformance();
+void testUtf16TranscodingPerformance();
+void testBase64HexPerformance();
+void testEscapePerformance();
+void testHashPerformance();
+void testInternPerformance();
+void testConcurrentInternScaling();
+void testStringMapPerformance();
+void testStringSortPerformance();
+void testComparePerformance();
+void testEqualityPerformance();
+void testStringTablePerformance();
+void testRadixTreePerformance();
+void testGermanStringPerformance();
+void testIdentifierSsoPerformance();
 
 int main() {
     testStringPerformance();
+    testMoveSemanticsPerformance();
+    testFormatPerformance();
+    testIntegerConversionPerformance();
+    testFloatConversionPerformance();
+    testNumericParsingPerformance();
+    testSplitPerformance();
+    testTrimPerformance();
+    testCaseConversionPerformance();
+    testUtf8ValidationPerformance();
+    testUtf16TranscodingPerformance();
+    testBase64HexPerformance();
+    testEscapePerformance();
+    testHashPerformance();
+    testInternPerformance();
+    testConcurrentInternScaling();
+    testStringMapPerformance();
+    testStringSortPerformance();
+    testComparePerformance();
+    testEqualityPerformance();
+    testStringTablePerformance();
+    testRadixTreePerformance();
+    testGermanStringPerformance();
+    testIdentifierSsoPerformance();
 
     // 调用 Python 脚本
     system("python plot_creation.py");
     system("python plot_find.py");
     system("python plot_memory.py");
+    system("python plot_vector_growth.py");
+    system("python plot_format.py");
+    system("python plot_int_conversion.py");
+    system("python plot_float_conversion.py");
+    system("python plot_numeric_parsing.py");
+    system("python plot_split.py");
+    system("python plot_trim.py");
+    system("python plot_case_conversion.py");
+    system("python plot_utf8_validation.py");
+    system("python plot_utf16_transcoding.py");
+    system("python plot_base64_hex.py");
+    system("python plot_escape.py");
+    system("python plot_hash_lookup.py");
+    system("python plot_intern.py");
+    system("python plot_intern_scaling.py");
+    system("python plot_string_map.py");
+    system("python plot_string_sort.py");
+    system("python plot_compare.py");
+    system("python plot_equality.py");
+    system("python plot_string_table.py");
+    system("python plot_radix_tree.py");
+    system("python plot_german_string.py");
+    system("python plot_identifier_sso.py");
 
     return 0;
 }